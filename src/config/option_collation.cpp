@@ -1200,6 +1200,35 @@ auto get_assembler_cycle_tolerance(const OptionMap& options)
     }
 }
 
+fs::path get_candidate_store_path(const fs::path& source_path, const OptionMap& options)
+{
+    const auto output_path = get_output_path(options);
+    auto result = output_path ? output_path->parent_path() : fs::temp_directory_path();
+    // The source path hash keeps apart stores of sources with the same file name
+    std::ostringstream ss {};
+    ss << source_path.filename().string() << '.' << std::hex << std::hash<std::string> {}(source_path.string()) << ".ocs";
+    result /= ss.str();
+    return result;
+}
+
+boost::optional<fs::path>
+get_candidate_store(const fs::path& source_path, const coretools::VcfExtractor::Options& vcf_options, const OptionMap& options)
+{
+    auto result = get_candidate_store_path(source_path, options);
+    if (!fs::exists(result) || fs::last_write_time(result) < fs::last_write_time(source_path)
+        || !coretools::is_candidate_store_for(result, source_path, vcf_options)) {
+        logging::InfoLogger log {};
+        stream(log) << "Indexing source candidates " << source_path << " into " << result;
+        if (!coretools::make_candidate_store(VcfReader {source_path}, result, vcf_options)) {
+            logging::WarningLogger warn_log {};
+            stream(warn_log) << "Source candidates " << source_path << " contain alleles too long to index,"
+                             << " so will be read directly from the source";
+            return boost::none;
+        }
+    }
+    return result;
+}
+
 auto make_variant_generator_builder(const OptionMap& options, const boost::optional<const ReadSetProfile&> read_profile)
 {
     using namespace coretools;
@@ -1295,7 +1324,15 @@ auto make_variant_generator_builder(const OptionMap& options, const boost::optio
                 vcf_options.min_quality = options.at("min-source-candidate-quality").as<Phred<double>>().score();
             }
             vcf_options.extract_filtered = options.at("use-filtered-source-candidates").as<bool>();
-            result.add_vcf_extractor(std::move(source_path), vcf_options);
+            boost::optional<fs::path> store_path {};
+            if (options.at("index-source-candidates").as<bool>() && !CandidateStore::is_candidate_store(source_path)) {
+                store_path = get_candidate_store(source_path, vcf_options, options);
+            }
+            if (store_path) {
+                result.add_vcf_extractor(std::move(*store_path), vcf_options);
+            } else {
+                result.add_vcf_extractor(std::move(source_path), vcf_options);
+            }
         }
     }
     if (is_set("regenotype", options)) {
@@ -1609,6 +1646,10 @@ make_calling_haplotype_likelihood_model(const OptionMap& options, const boost::o
     }
     config.max_indel_error = as_unsigned("max-indel-errors", options);
     config.use_int_scores = use_int_hmm_scores(options, read_profile);
+    if (is_set("hmm-early-exit-margin", options)) {
+        using octopus::maths::constants::ln10Div10;
+        config.early_exit_margin = options.at("hmm-early-exit-margin").as<Phred<double>>().score() * ln10Div10<>;
+    }
     return HaplotypeLikelihoodModel {std::move(error_model.snv), std::move(error_model.indel), config};
 }
 
@@ -2130,6 +2171,7 @@ CallerFactory make_caller_factory(const ReferenceGenome& reference, ReadPipe& re
     auto min_phase_score = options.at("min-phase-score").as<Phred<double>>();
     vc_builder.set_min_phase_score(min_phase_score);
     vc_builder.set_early_phase_detection_policy(!options.at("disable-early-phase-detection").as<bool>());
+    vc_builder.set_read_annotation_caching(options.at("cache-read-annotations").as<bool>());
     if (!options.at("use-uniform-genotype-priors").as<bool>()) {
         vc_builder.set_snp_heterozygosity(options.at("snp-heterozygosity").as<float>());
         vc_builder.set_indel_heterozygosity(options.at("indel-heterozygosity").as<float>());
@@ -2518,6 +2560,11 @@ bool full_bamouts_requested(const OptionMap& options)
     return options.at("bamout-type").as<RealignedBAMType>() == RealignedBAMType::full;
 }
 
+bool inline_bamout_requested(const OptionMap& options)
+{
+    return options.at("inline-bamout").as<bool>();
+}
+
 unsigned max_open_read_files(const OptionMap& options)
 {
     return 2 * std::min(as_unsigned("max-open-read-files", options), count_read_paths(options));
@@ -2542,5 +2589,21 @@ boost::optional<fs::path> data_profile_request(const OptionMap& options)
     return boost::none;
 }
 
+boost::optional<fs::path> make_window_plan_request(const OptionMap& options)
+{
+    if (is_set("make-window-plan", options)) {
+        return resolve_path(options.at("make-window-plan").as<fs::path>(), options);
+    }
+    return boost::none;
+}
+
+boost::optional<fs::path> window_plan_request(const OptionMap& options)
+{
+    if (is_set("window-plan", options)) {
+        return resolve_path(options.at("window-plan").as<fs::path>(), options);
+    }
+    return boost::none;
+}
+
 } // namespace options
 } // namespace octopus
@@ -97,11 +97,16 @@ bool annotate_filter_output(const OptionMap& options);
 
 boost::optional<fs::path> bamout_request(const OptionMap& options);
 bool full_bamouts_requested(const OptionMap& options);
+bool inline_bamout_requested(const OptionMap& options);
 
 unsigned estimate_max_open_files(const OptionMap& options);
 
 boost::optional<fs::path> data_profile_request(const OptionMap& options);
 
+boost::optional<fs::path> make_window_plan_request(const OptionMap& options);
+
+boost::optional<fs::path> window_plan_request(const OptionMap& options);
+
 ReadLinkageType get_read_linkage_type(const OptionMap& options);
 
 } // namespace options
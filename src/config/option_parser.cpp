@@ -88,6 +88,10 @@ OptionMap parse_options(const int argc, const char** argv)
      po::value<MemoryFootprint>(),
      "Target working memory per thread for computation, not including read or reference data")
      
+    ("cache-read-annotations",
+     po::bool_switch()->default_value(false),
+     "Compute per-read features once per calling window rather than for each active region, using more memory")
+    
     ("max-open-read-files",
      po::value<int>()->default_value(250),
      "Limits the number of read files that are open simultaneously")
@@ -168,11 +172,26 @@ OptionMap parse_options(const int argc, const char** argv)
     ("bamout-type",
      po::value<RealignedBAMType>()->default_value(RealignedBAMType::mini),
      "Type of realigned evidence BAM to output [MINI, FULL]")
+    
+    ("inline-bamout",
+     po::bool_switch()->default_value(false),
+     "Make the evidence BAM realignments during calling, rather than in a separate pass after calling."
+     " Reads are realigned to the calls made before connecting calls are resolved and before filtering,"
+     " so the evidence may not match the final VCF. Requires multiple threads and a single input BAM"
+     " with one sample")
      
     ("data-profile",
      po::value<fs::path>(),
      "Output a profile of variation and errors found in the data")
     
+    ("make-window-plan",
+     po::value<fs::path>(),
+     "Write a plan of the calling windows for the input reads and regions to this file and exit without calling")
+    
+    ("window-plan",
+     po::value<fs::path>(),
+     "Call the windows in a plan made with --make-window-plan rather than proposing windows from the read indexes")
+    
     ("fast",
      po::bool_switch()->default_value(false),
      "Turns off some features to improve runtime, at the cost of worse calling accuracy and phasing")
@@ -367,6 +386,12 @@ OptionMap parse_options(const int argc, const char** argv)
      po::bool_switch()->default_value(false),
      "Use variants from source VCF records that have been filtered")
     
+    ("index-source-candidates",
+     po::bool_switch()->default_value(false),
+     "Convert source candidate VCFs into pre-indexed binary candidate stores (written with extension .ocs to the"
+     " output directory, or the system temporary directory when writing to stdout, and reused while newer than the"
+     " VCF and made with the same source candidate options), and read source candidates from the stores")
+    
     ("min-pileup-base-quality",
      po::value<int>()->default_value(20),
      "Only bases with quality above this value are considered for candidate generation")
@@ -578,6 +603,10 @@ OptionMap parse_options(const int argc, const char** argv)
     ("use-wide-hmm-scores",
      po::bool_switch()->default_value(false),
      "Use 32-bits rather than 16-bits for HMM scores")
+    
+    ("hmm-early-exit-margin",
+     po::value<Phred<double>>(),
+     "Stop evaluating a read against a haplotype once its likelihood is certain to be this much (phred scale) below the read's best haplotype likelihood")
 
     ("read-linkage",
      po::value<ReadLinkage>()->default_value(ReadLinkage::paired),
@@ -1169,6 +1198,8 @@ void validate(const OptionMap& vm)
     };
     conflicting_options(vm, "maternal-sample", "normal-sample");
     conflicting_options(vm, "paternal-sample", "normal-sample");
+    conflicting_options(vm, "make-window-plan", "window-plan");
+    option_dependency(vm, "inline-bamout", "bamout");
     for (const auto& option : positive_int_options) {
         check_positive(option, vm);
     }
@@ -28,6 +28,7 @@
 #include "utils/append.hpp"
 #include "utils/erase_if.hpp"
 #include "utils/map_utils.hpp"
+#include "utils/scratch_arena.hpp"
 
 namespace octopus {
 
@@ -147,8 +148,47 @@ auto convert_to_vcf(std::deque<CallWrapper>&& calls, const VcfRecordFactory& fac
 
 std::deque<VcfRecord> Caller::call(const GenomicRegion& call_region, ProgressMeter& progress_meter) const
 {
+    std::vector<GenomicRegion> skipped_regions {};
+    return call(call_region, progress_meter, skipped_regions);
+}
+
+std::deque<VcfRecord> Caller::call(const GenomicRegion& call_region, ProgressMeter& progress_meter,
+                                   std::vector<GenomicRegion>& skipped_regions) const
+{
+    ReadMap reads {};
+    return call_helper(call_region, progress_meter, skipped_regions, reads);
+}
+
+std::deque<VcfRecord> Caller::call(const GenomicRegion& call_region, ProgressMeter& progress_meter,
+                                   std::vector<GenomicRegion>& skipped_regions, ReadMap& reads) const
+{
+    return call_helper(call_region, progress_meter, skipped_regions, reads);
+}
+
+std::vector<VcfRecord> Caller::regenotype(const std::vector<Variant>& variants, ProgressMeter& progress_meter) const
+{
+    return {}; // TODO
+}
+
+auto assign_and_realign(const std::vector<AlignedRead>& reads, const Genotype<Haplotype>& genotype)
+{
+    auto result = compute_haplotype_support(genotype, reads, {AssignmentConfig::AmbiguousAction::first});
+    for (auto& p : result) {
+        realign_to_reference(p.second, p.first);
+        std::sort(std::begin(p.second), std::end(p.second));
+    }
+    return result;
+}
+
+// private methods
+
+std::deque<VcfRecord> Caller::call_helper(const GenomicRegion& call_region, ProgressMeter& progress_meter,
+                                          std::vector<GenomicRegion>& skipped_regions, ReadMap& reads) const
+{
+    // Scratch buffers used while calling the window are released when it's done
+    const ScratchArena::Scope scratch {thread_scratch_arena()};
+    skipped_regions.clear();
     ReadPipe::Report reads_report {};
-    ReadMap reads;
     if (candidate_generator_.requires_reads()) {
         reads = read_pipe_.get().fetch_reads(expand(call_region, 100), reads_report);
         add_reads(reads, candidate_generator_);
@@ -186,34 +226,22 @@ std::deque<VcfRecord> Caller::call(const GenomicRegion& call_region, ProgressMet
         likely_difficult_regions.shrink_to_fit();
     }
     const auto read_templates = make_read_templates(reads);
+    boost::optional<ReadAnnotationMap> read_annotations {};
+    if (parameters_.cache_read_annotations) read_annotations = ReadAnnotationMap {reads};
     auto haplotype_generator = make_haplotype_generator(candidates, reads, read_templates);
     for (auto& region : likely_difficult_regions) haplotype_generator.add_lagging_exclusion_zone(region);
-    auto calls = call_variants(call_region, candidates, reads, read_templates, haplotype_generator, progress_meter);
+    auto calls = call_variants(call_region, candidates, reads, read_templates, read_annotations, haplotype_generator, progress_meter, skipped_regions);
     candidates.clear();
     candidates.shrink_to_fit();
-    progress_meter.log_completed(call_region);
+    progress_meter.log_completed(call_region, count_reads(reads));
     const auto record_factory = make_record_factory(reads);
-    if (debug_log_) stream(*debug_log_) << "Converting " << calls.size() << " calls made in " << call_region << " to VCF";
-    return convert_to_vcf(std::move(calls), record_factory, call_region);
-}
-
-std::vector<VcfRecord> Caller::regenotype(const std::vector<Variant>& variants, ProgressMeter& progress_meter) const
-{
-    return {}; // TODO
-}
-
-auto assign_and_realign(const std::vector<AlignedRead>& reads, const Genotype<Haplotype>& genotype)
-{
-    auto result = compute_haplotype_support(genotype, reads, {AssignmentConfig::AmbiguousAction::first});
-    for (auto& p : result) {
-        realign_to_reference(p.second, p.first);
-        std::sort(std::begin(p.second), std::end(p.second));
+    if (debug_log_) {
+        stream(*debug_log_) << "Peak scratch memory use in " << call_region << " was " << MemoryFootprint {scratch.peak_bytes_in_use()};
+        stream(*debug_log_) << "Converting " << calls.size() << " calls made in " << call_region << " to VCF";
     }
-    return result;
+    return convert_to_vcf(std::move(calls), record_factory, call_region);
 }
 
-// private methods
-
 namespace debug {
 
 template <typename S>
@@ -399,10 +427,13 @@ Caller::call_variants(const GenomicRegion& call_region,
                       const MappableFlatSet<Variant>& candidates,
                       const ReadMap& reads,
                       const boost::optional<TemplateMap>& read_templates,
+                      const boost::optional<ReadAnnotationMap>& read_annotations,
                       HaplotypeGenerator& haplotype_generator,
-                      ProgressMeter& progress_meter) const
+                      ProgressMeter& progress_meter,
+                      std::vector<GenomicRegion>& skipped_regions) const
 {
     auto haplotype_likelihoods = make_haplotype_likelihood_cache();
+    if (read_annotations) haplotype_likelihoods.set_read_annotations(*read_annotations);
     std::deque<CallWrapper> result {};
     if (candidates.empty()) {
         if (refcalls_requested()) {
@@ -429,7 +460,7 @@ Caller::call_variants(const GenomicRegion& call_region,
     boost::variant<ReadMap, TemplateMap> active_reads;
     while (true) {
         status = generate_active_haplotypes(call_region, haplotype_generator, active_region, next_active_region,
-                                            haplotypes, next_haplotypes, backtrack_region);
+                                            haplotypes, next_haplotypes, backtrack_region, skipped_regions);
         if (status == GeneratorStatus::done) {
             if (refcalls_requested()) {
                 if (!prev_called_region) {
@@ -496,7 +527,8 @@ Caller::call_variants(const GenomicRegion& call_region,
                 haplotype_generator.remove(*phased_region);
             }
         }
-        status = generate_next_active_haplotypes(next_haplotypes, next_active_region, backtrack_region, haplotype_generator);
+        status = generate_next_active_haplotypes(next_haplotypes, next_active_region, backtrack_region,
+                                                 haplotype_generator, skipped_regions);
         if (backtrack_region) {
             // Only protect haplotypes in backtrack - or holdout - regions as these are more likely
             // to suffer from window artifacts.
@@ -510,10 +542,15 @@ Caller::call_variants(const GenomicRegion& call_region,
                               candidates, haplotypes, haplotype_likelihoods, reads, *caller_latents,
                               result, prev_called_region, completed_region);
             }
+        } else if (skipped_regions.empty() || skipped_regions.back() != active_region) {
+            // The active region isn't called either when the next one overflows
+            skipped_regions.push_back(active_region);
         }
         haplotype_likelihoods.clear();
         progress_meter.log_completed(completed_region);
     }
+    std::sort(std::begin(skipped_regions), std::end(skipped_regions));
+    skipped_regions.erase(std::unique(std::begin(skipped_regions), std::end(skipped_regions)), std::end(skipped_regions));
     return result;
 }
 
@@ -539,7 +576,8 @@ Caller::generate_active_haplotypes(const GenomicRegion& call_region,
                                    boost::optional<GenomicRegion>& next_active_region,
                                    HaplotypeBlock& haplotypes,
                                    HaplotypeBlock& next_haplotypes,
-                                   boost::optional<GenomicRegion> backtrack_region) const
+                                   boost::optional<GenomicRegion> backtrack_region,
+                                   std::vector<GenomicRegion>& skipped_regions) const
 {
     if (next_active_region) {
         haplotypes = std::move(next_haplotypes);
@@ -559,6 +597,7 @@ Caller::generate_active_haplotypes(const GenomicRegion& call_region,
             stream(warn_log) << "Skipping region " << e.region() << " as there are too many haplotypes";
             haplotype_generator.clear_progress();
             active_region = e.region();
+            skipped_regions.push_back(e.region());
             return GeneratorStatus::skipped;
         }
     }
@@ -628,7 +667,8 @@ Caller::GeneratorStatus
 Caller::generate_next_active_haplotypes(HaplotypeBlock& next_haplotypes,
                                         boost::optional<GenomicRegion>& next_active_region,
                                         boost::optional<GenomicRegion>& backtrack_region,
-                                        HaplotypeGenerator& haplotype_generator) const
+                                        HaplotypeGenerator& haplotype_generator,
+                                        std::vector<GenomicRegion>& skipped_regions) const
 {
     try {
         auto packet = haplotype_generator.generate();
@@ -639,6 +679,7 @@ Caller::generate_next_active_haplotypes(HaplotypeBlock& next_haplotypes,
         logging::WarningLogger warn_log {};
         stream(warn_log) << "Skipping region " << e.region() << " as there are too many haplotypes";
         haplotype_generator.clear_progress();
+        skipped_regions.push_back(e.region());
         return GeneratorStatus::skipped;
     }
     return GeneratorStatus::good;
@@ -1293,6 +1334,12 @@ std::vector<CallWrapper> Caller::call_reference(const GenomicRegion& region, con
     auto haplotype_likelihoods = make_haplotype_likelihood_cache();
     haplotype_likelihoods.populate(active_reads, haplotypes);
     const auto latents = infer_latents(haplotypes, haplotype_likelihoods);
+    if (is_columnar_refcalling()) {
+        const auto columns = make_refcall_columns(active_reads, *latents, region);
+        boost::optional<Phred<double>> merge_threshold {};
+        if (is_merge_block_refcalling()) merge_threshold = parameters_.refcall_block_merge_threshold;
+        return wrap(call_reference(columns, parameters_.max_refcall_posterior, merge_threshold));
+    }
     const auto pileups = make_pileups(active_reads, *latents, region);
     const auto alleles = generate_reference_alleles(region);
     return call_reference_helper(alleles, *latents, pileups);
@@ -1383,9 +1430,23 @@ auto overlap_range(std::vector<ReadPileup>& pileups, const AlignedRead& read)
 
 } // namespace
 
-auto make_pileups(const std::vector<AlignedRead>& reads, const Genotype<Haplotype>& genotype, const GenomicRegion& region)
+auto realign_overlapped(const ReadContainer& reads, const Genotype<Haplotype>& genotype, const GenomicRegion& region)
 {
-    const auto realignments = assign_and_realign(reads, genotype);
+    const auto overlapped_reads = overlap_range(reads, region);
+    const std::vector<AlignedRead> active_reads {std::cbegin(overlapped_reads), std::cend(overlapped_reads)};
+    if (!active_reads.empty()) {
+        const auto active_reads_region = encompassing_region(active_reads);
+        const auto min_genotype_region = expand(active_reads_region, max_read_length(active_reads));
+        if (!contains(genotype, min_genotype_region)) {
+            return assign_and_realign(active_reads, remap(genotype, min_genotype_region));
+        }
+    }
+    return assign_and_realign(active_reads, genotype);
+}
+
+ReadPileups make_pileups(const ReadContainer& reads, const Genotype<Haplotype>& genotype, const GenomicRegion& region)
+{
+    const auto realignments = realign_overlapped(reads, genotype, region);
     ReadPileups result {};
     result.reserve(size(region));
     for (auto position = region.begin(); position < region.end(); ++position) {
@@ -1401,22 +1462,14 @@ auto make_pileups(const std::vector<AlignedRead>& reads, const Genotype<Haplotyp
     return result;
 }
 
-ReadPileups make_pileups(const ReadContainer& reads, const Genotype<Haplotype>& genotype, const GenomicRegion& region)
+RefCallColumns make_refcall_columns(const ReadContainer& reads, const Genotype<Haplotype>& genotype,
+                                    const GenomicRegion& region, const ReferenceGenome& reference)
 {
-    const auto overlapped_reads = overlap_range(reads, region);
-    const std::vector<AlignedRead> active_reads {std::cbegin(overlapped_reads), std::cend(overlapped_reads)};
-    if (!active_reads.empty()) {
-        const auto active_reads_region = encompassing_region(active_reads);
-        const auto min_genotype_region = expand(active_reads_region, max_read_length(active_reads));
-        if (contains(genotype, min_genotype_region)) {
-            return make_pileups(active_reads, genotype, region);
-        } else {
-            const auto expanded_genotype = remap(genotype, min_genotype_region);
-            return make_pileups(active_reads, expanded_genotype, region);
-        }
-    } else {
-        return make_pileups(active_reads, genotype, region);
+    RefCallColumns result {region, reference.fetch_sequence(region)};
+    for (const auto& p : realign_overlapped(reads, genotype, region)) {
+        for (const auto& read : p.second) result.add(read);
     }
+    return result;
 }
 
 Caller::ReadPileupMap Caller::make_pileups(const ReadMap& reads, const Latents& latents, const GenomicRegion& region) const
@@ -1430,6 +1483,32 @@ Caller::ReadPileupMap Caller::make_pileups(const ReadMap& reads, const Latents&
     return result;
 }
 
+std::vector<std::unique_ptr<ReferenceCall>>
+Caller::call_reference(const RefCallColumnMap& columns,
+                       boost::optional<Phred<double>> max_posterior,
+                       boost::optional<Phred<double>> merge_threshold) const
+{
+    // Only reached if a caller claims can_call_reference_from_columns without overriding this
+    throw std::logic_error {"Caller: columnar reference calling is not supported by " + name()};
+}
+
+bool Caller::is_columnar_refcalling() const noexcept
+{
+    return can_call_reference_from_columns()
+        && (parameters_.refcall_type == RefCallType::positional || is_merge_block_refcalling());
+}
+
+Caller::RefCallColumnMap Caller::make_refcall_columns(const ReadMap& reads, const Latents& latents, const GenomicRegion& region) const
+{
+    RefCallColumnMap result {};
+    result.reserve(samples_.size());
+    for (const auto& sample : samples_) {
+        const auto called_genotype = genotype_cast<Haplotype>(call_genotype(latents, sample));
+        result.emplace(sample, octopus::make_refcall_columns(reads.at(sample), called_genotype, region, reference_));
+    }
+    return result;
+}
+
 namespace {
 
 auto get_min_quality(const std::vector<std::unique_ptr<ReferenceCall>>& refcalls)
@@ -22,6 +22,7 @@
 #include "core/types/haplotype.hpp"
 #include "core/types/indexed_haplotype.hpp"
 #include "core/tools/coretools.hpp"
+#include "core/tools/refcall_columns.hpp"
 #include "core/models/haplotype_likelihood_array.hpp"
 #include "core/tools/vcf_record_factory.hpp"
 #include "containers/mappable_flat_set.hpp"
@@ -30,6 +31,7 @@
 #include "io/variant/vcf_record.hpp"
 #include "io/reference/reference_genome.hpp"
 #include "readpipe/read_pipe.hpp"
+#include "readpipe/read_annotations.hpp"
 #include "utils/memory_footprint.hpp"
 #include "logging/progress_meter.hpp"
 #include "logging/logging.hpp"
@@ -73,6 +75,7 @@ public:
         ExecutionPolicy execution_policy;
         ReadLinkageType read_linkage;
         bool try_early_phase_detection;
+        bool cache_read_annotations;
     };
     
     using ReadMap = octopus::ReadMap;
@@ -96,6 +99,12 @@ public:
     unsigned max_callable_ploidy() const;
     
     std::deque<VcfRecord> call(const GenomicRegion& call_region, ProgressMeter& progress_meter) const;
+    // As above, but also reports the regions that were skipped as there were too many haplotypes
+    std::deque<VcfRecord> call(const GenomicRegion& call_region, ProgressMeter& progress_meter,
+                               std::vector<GenomicRegion>& skipped_regions) const;
+    // As above, but also returns the reads the calls were made from
+    std::deque<VcfRecord> call(const GenomicRegion& call_region, ProgressMeter& progress_meter,
+                               std::vector<GenomicRegion>& skipped_regions, ReadMap& reads) const;
     
     std::vector<VcfRecord> regenotype(const std::vector<Variant>& variants, ProgressMeter& progress_meter) const;
     
@@ -147,6 +156,7 @@ protected:
     virtual std::size_t do_remove_duplicates(HaplotypeBlock& haplotypes) const;
     
     using ReadPileupMap = std::unordered_map<SampleName, ReadPileups>;
+    using RefCallColumnMap = std::unordered_map<SampleName, RefCallColumns>;
     
     boost::optional<MemoryFootprint> target_max_memory() const noexcept;
     ExecutionPolicy exucution_policy() const noexcept;
@@ -170,16 +180,30 @@ private:
     call_reference(const std::vector<Allele>& alleles, const Latents& latents,
                    const ReadPileupMap& pileups) const = 0;
     
+    // Callers whose reference confidence only depends on the bases observed at each position can
+    // call reference-only regions from RefCallColumns, without building a ReadPileup per position.
+    // Those callers must also override the RefCallColumnMap overload of call_reference.
+    virtual bool can_call_reference_from_columns() const noexcept { return false; }
+    
+    virtual std::vector<std::unique_ptr<ReferenceCall>>
+    call_reference(const RefCallColumnMap& columns,
+                   boost::optional<Phred<double>> max_posterior,
+                   boost::optional<Phred<double>> merge_threshold) const;
+    
     // helper methods
     
+    std::deque<VcfRecord> call_helper(const GenomicRegion& call_region, ProgressMeter& progress_meter,
+                                      std::vector<GenomicRegion>& skipped_regions, ReadMap& reads) const;
     boost::optional<TemplateMap> make_read_templates(const ReadMap& reads) const;
     std::deque<CallWrapper>
     call_variants(const GenomicRegion& call_region,
                   const MappableFlatSet<Variant>& candidates,
                   const ReadMap& reads,
                   const boost::optional<TemplateMap>& read_templates,
+                  const boost::optional<ReadAnnotationMap>& read_annotations,
                   HaplotypeGenerator& haplotype_generator,
-                  ProgressMeter& progress_meter) const;
+                  ProgressMeter& progress_meter,
+                  std::vector<GenomicRegion>& skipped_regions) const;
     bool refcalls_requested() const noexcept;
     MappableFlatSet<Variant> generate_candidate_variants(const GenomicRegion& region) const;
     HaplotypeGenerator 
@@ -202,12 +226,14 @@ private:
     generate_active_haplotypes(const GenomicRegion& call_region, HaplotypeGenerator& haplotype_generator,
                                GenomicRegion& active_region, boost::optional<GenomicRegion>& next_active_region,
                                HaplotypeBlock& haplotypes, HaplotypeBlock& next_haplotypes, 
-                               boost::optional<GenomicRegion> backtrack_region) const;
+                               boost::optional<GenomicRegion> backtrack_region,
+                               std::vector<GenomicRegion>& skipped_regions) const;
     GeneratorStatus
     generate_next_active_haplotypes(HaplotypeBlock& next_haplotypes,
                                     boost::optional<GenomicRegion>& next_active_region,
                                     boost::optional<GenomicRegion>& backtrack_region,
-                                    HaplotypeGenerator& haplotype_generator) const;
+                                    HaplotypeGenerator& haplotype_generator,
+                                    std::vector<GenomicRegion>& skipped_regions) const;
     void remove_duplicates(HaplotypeBlock& haplotypes) const;
     bool filter_haplotypes(HaplotypeBlock& haplotypes, HaplotypeGenerator& haplotype_generator,
                            HaplotypeLikelihoodArray& haplotype_likelihoods,
@@ -249,6 +275,8 @@ private:
                                const std::vector<CallWrapper>& calls) const;
     std::vector<Allele> generate_reference_alleles(const GenomicRegion& region) const;
     ReadPileupMap make_pileups(const ReadMap& reads, const Latents& latents, const GenomicRegion& region) const;
+    bool is_columnar_refcalling() const noexcept;
+    RefCallColumnMap make_refcall_columns(const ReadMap& reads, const Latents& latents, const GenomicRegion& region) const;
     std::vector<std::unique_ptr<ReferenceCall>>
     squash_reference_calls(std::vector<std::unique_ptr<ReferenceCall>> refcalls) const;
 };
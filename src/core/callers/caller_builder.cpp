@@ -189,6 +189,12 @@ CallerBuilder& CallerBuilder::set_early_phase_detection_policy(bool use) noexcep
     return *this;
 }
 
+CallerBuilder& CallerBuilder::set_read_annotation_caching(bool b) noexcept
+{
+    params_.general.cache_read_annotations = b;
+    return *this;
+}
+
 CallerBuilder& CallerBuilder::set_snp_heterozygosity(double heterozygosity) noexcept
 {
     params_.snp_heterozygosity = heterozygosity;
@@ -65,6 +65,7 @@ public:
     CallerBuilder& set_model_posterior_policy(Caller::ModelPosteriorPolicy policy) noexcept;
     CallerBuilder& set_min_phase_score(Phred<double> score) noexcept;
     CallerBuilder& set_early_phase_detection_policy(bool use) noexcept;
+    CallerBuilder& set_read_annotation_caching(bool b) noexcept;
     CallerBuilder& set_snp_heterozygosity(double heterozygosity) noexcept;
     CallerBuilder& set_indel_heterozygosity(double heterozygosity) noexcept;
     CallerBuilder& set_max_genotypes(boost::optional<std::size_t> max) noexcept;
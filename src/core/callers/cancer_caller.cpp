@@ -33,6 +33,7 @@
 #include "utils/mappable_algorithms.hpp"
 #include "utils/maths.hpp"
 #include "utils/map_utils.hpp"
+#include "utils/select_top_k.hpp"
 #include "logging/logging.hpp"
 #include "core/types/calls/germline_variant_call.hpp"
 #include "core/types/calls/reference_call.hpp"
@@ -340,31 +341,41 @@ auto copy_greatest_probability_genotypes(const MappableBlock<G>& genotypes,
     return copy_greatest_probability_values(genotypes, probabilities, n, min_include_probability, max_exclude_probability);
 }
 
-auto calculate_posteriors_with_germline_likelihood_model(const MappableBlock<CancerGenotype<IndexedHaplotype<>>>& genotypes,
-                                                         const CancerGenotypePriorModel& prior_model,
-                                                         const model::ConstantMixtureGenotypeLikelihoodModel likelihood_model,
-                                                         const std::vector<SampleName>& samples)
-{
-    auto result = evaluate(genotypes, prior_model);
-    for (const auto& sample : samples) {
-        likelihood_model.cache().prime(sample);
-        std::transform(std::cbegin(genotypes), std::cend(genotypes), std::cbegin(result), std::begin(result),
-                       [&] (const auto& genotype, auto curr) {
-                           return curr + likelihood_model.evaluate(demote(genotype));
-                       });
-    }
-    maths::normalise_exp(result);
-    return result;
-}
-
+// Genotypes whose germline likelihood upper bound can't reach the n best are dropped without being evaluated exactly
 void filter_with_germline_model(MappableBlock<CancerGenotype<IndexedHaplotype<>>>& genotypes,
                                 const CancerGenotypePriorModel& prior_model,
                                 const model::ConstantMixtureGenotypeLikelihoodModel likelihood_model,
                                 const std::vector<SampleName>& samples,
                                 const std::size_t n)
 {
-    const auto germline_model_posteriors = calculate_posteriors_with_germline_likelihood_model(genotypes, prior_model, likelihood_model, samples);
-    genotypes = copy_greatest_probability_genotypes(genotypes, germline_model_posteriors, n);
+    if (genotypes.size() <= n) return;
+    std::vector<Genotype<IndexedHaplotype<>>> germline_genotypes {};
+    germline_genotypes.reserve(genotypes.size());
+    std::transform(std::cbegin(genotypes), std::cend(genotypes), std::back_inserter(germline_genotypes),
+                   [] (const auto& genotype) { return demote(genotype); });
+    const auto log_priors = evaluate(genotypes, prior_model);
+    auto upper_bounds = log_priors;
+    for (const auto& sample : samples) {
+        likelihood_model.cache().prime(sample);
+        std::transform(std::cbegin(germline_genotypes), std::cend(germline_genotypes), std::cbegin(upper_bounds), std::begin(upper_bounds),
+                       [&] (const auto& genotype, auto curr) {
+                           return curr + likelihood_model.evaluate_upper_bound(genotype);
+                       });
+    }
+    const auto top_indices = select_top_k_indices_with_upper_bounds(upper_bounds, n, [&] (const std::size_t idx) {
+        auto result = log_priors[idx];
+        for (const auto& sample : samples) {
+            likelihood_model.cache().prime(sample);
+            result += likelihood_model.evaluate(germline_genotypes[idx]);
+        }
+        return result;
+    });
+    MappableBlock<CancerGenotype<IndexedHaplotype<>>> result {mapped_region(genotypes)};
+    result.reserve(top_indices.size());
+    for (const auto idx : top_indices) {
+        result.push_back(std::move(genotypes[idx]));
+    }
+    genotypes = std::move(result);
 }
 
 } // namespace
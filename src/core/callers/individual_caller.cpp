@@ -19,6 +19,7 @@
 #include "containers/probability_matrix.hpp"
 #include "core/types/allele.hpp"
 #include "core/types/variant.hpp"
+#include "core/types/genotype_indexer.hpp"
 #include "core/types/calls/germline_variant_call.hpp"
 #include "core/types/calls/reference_call.hpp"
 #include "core/models/genotype/uniform_genotype_prior_model.hpp"
@@ -164,13 +165,14 @@ IndividualCaller::calculate_model_posterior(const HaplotypeBlock& haplotypes,
                                             const Latents& latents) const
 {
     const auto indexed_haplotypes = index(haplotypes);
-    const auto genotypes = generate_all_genotypes(indexed_haplotypes, parameters_.ploidy + 1);
+    // The dummy model only needs the evidence, so there's no need to hold all its genotypes at once
+    const GenotypeIndexer genotypes {static_cast<unsigned>(haplotypes.size()), parameters_.ploidy + 1};
     const auto prior_model = make_prior_model(haplotypes);
     prior_model->prime(haplotypes);
     const model::IndividualModel model {*prior_model, debug_log_};
     haplotype_likelihoods.prime(sample());
-    const auto inferences = model.evaluate(genotypes, haplotype_likelihoods);
-    return octopus::calculate_model_posterior(latents.model_log_evidence_, inferences.log_evidence);
+    const auto dummy_log_evidence = model.evaluate_log_evidence(genotypes, indexed_haplotypes, haplotype_likelihoods);
+    return octopus::calculate_model_posterior(latents.model_log_evidence_, dummy_log_evidence);
 }
 
 namespace {
@@ -525,6 +527,31 @@ IndividualCaller::call_reference(const std::vector<Allele>& alleles,
     return transform_calls(std::move(calls), sample(), parameters_.ploidy);
 }
 
+bool IndividualCaller::can_call_reference_from_columns() const noexcept
+{
+    return true;
+}
+
+std::vector<std::unique_ptr<ReferenceCall>>
+IndividualCaller::call_reference(const RefCallColumnMap& columns,
+                                 boost::optional<Phred<double>> max_posterior,
+                                 boost::optional<Phred<double>> merge_threshold) const
+{
+    const auto& sample_columns = columns.at(sample());
+    const auto blocks = make_blocks(sample_columns, {parameters_.min_refcall_posterior, max_posterior, merge_threshold});
+    std::vector<RefCall> calls {};
+    calls.reserve(blocks.size());
+    for (const auto& block : blocks) {
+        auto sequence = sample_columns.reference_sequence().substr(begin_distance(sample_columns.mapped_region(), block.region), size(block.region));
+        calls.push_back({Allele {block.region, std::move(sequence)}, block.posterior});
+    }
+    auto result = transform_calls(std::move(calls), sample(), parameters_.ploidy);
+    for (std::size_t i {0}; i < blocks.size(); ++i) {
+        result[i]->set_quality(blocks[i].quality);
+    }
+    return result;
+}
+
 const SampleName& IndividualCaller::sample() const noexcept
 {
     return samples_.front();
@@ -564,27 +591,6 @@ void select_top_k(Container& items, const Range& probabilities, const std::size_
     erase_complement_indices(items, best_indices);
 }
 
-template <typename Container, typename T, typename Compare = std::less<T>>
-void 
-sort_by_other(Container& items, const std::vector<T>& other,
-              Compare&& comp = Compare {})
-{
-    assert(items.size() == other.size());
-    using U = typename Container::value_type;
-    std::vector<std::pair<U, std::reference_wrapper<const T>>> zipped {};
-    zipped.reserve(items.size());
-    for (std::size_t i {0}; i < items.size(); ++i) {
-        zipped.emplace_back(std::move(items[i]), other[i]);
-    }
-    const auto comp_helper = [&] (const auto& lhs, const auto& rhs) {
-        return comp(lhs.second, rhs.second);
-    };
-    std::sort(std::begin(zipped), std::end(zipped), comp_helper);
-    for (std::size_t i {0}; i < items.size(); ++i) {
-        items[i] = std::move(zipped[i].first);
-    }
-}
-
 template <typename IndexType>
 void erase_duplicates(MappableBlock<Genotype<IndexedHaplotype<IndexType>>>& genotypes)
 {
@@ -624,17 +630,28 @@ IndividualCaller::propose_genotypes(const HaplotypeBlock& haplotypes,
         model::IndividualModel model {*prior_model};
         model.prime(haplotypes);
         haplotype_likelihoods.prime(sample());
+        // We dont know the right number of seed genotypes since there can be duplicates after expansion with a new haplotype.
+        constexpr int max_seed_rounds {3};
+        const auto max_seeds = max_seed_rounds * std::max(*parameters_.max_genotypes / haplotypes.size(), std::size_t {1});
         for (; ploidy < parameters_.ploidy; ++ploidy) {
             if (debug_log_) stream(*debug_log_) << "Finding good genotypes with ploidy " << ploidy << " from " << result.size();
-            const auto ploidy_inferences = model.evaluate(result, haplotype_likelihoods);
-            sort_by_other(result, ploidy_inferences.posteriors.genotype_log_probabilities);
+            // Only the best genotypes can become seeds, so the rest needn't be evaluated exactly
+            const auto top_indices = model.select_top_k_genotypes(result, max_seeds, haplotype_likelihoods);
+            const static auto is_hom_ref = [] (const auto& genotype) { return is_homozygous_reference(genotype); };
+            GenotypeBlock top_genotypes {mapped_region(haplotypes)};
+            top_genotypes.reserve(top_indices.size() + 1);
+            if (std::none_of(std::cbegin(top_indices), std::cend(top_indices), [&] (auto idx) { return is_hom_ref(result[idx]); })) {
+                const auto hom_ref_itr = std::find_if(std::cbegin(result), std::cend(result), is_hom_ref);
+                if (hom_ref_itr != std::cend(result)) top_genotypes.push_back(*hom_ref_itr);
+            }
+            // Worst first, so seeds are taken from the back
+            std::for_each(std::crbegin(top_indices), std::crend(top_indices), [&] (auto idx) { top_genotypes.push_back(result[idx]); });
+            result = std::move(top_genotypes);
             GenotypeBlock next_result {};
             next_result.reserve(*parameters_.max_genotypes);
-            // We dont know the right number of seed genotypes since there can be duplicates after expansion with a new haplotype.
-            for (int n {0}; n < 3 && next_result.size() < *parameters_.max_genotypes; ++n) {
+            for (int n {0}; n < max_seed_rounds && !result.empty() && next_result.size() < *parameters_.max_genotypes; ++n) {
                 const std::size_t num_seeds {std::max((*parameters_.max_genotypes - next_result.size()) / haplotypes.size(), std::size_t {1})};
-                auto seed_itr = std::prev(std::end(result), num_seeds);
-                const static auto is_hom_ref = [] (const auto& genotype) { return is_homozygous_reference(genotype); };
+                auto seed_itr = std::prev(std::end(result), std::min(num_seeds, result.size()));
                 if (std::find_if(seed_itr, std::end(result), is_hom_ref) == std::end(result)) {
                     // Ensure reference genotype is always included, helping to keep QUAL in reasonable range
                     const auto hom_ref_itr = std::find_if(std::begin(result), seed_itr, is_hom_ref);
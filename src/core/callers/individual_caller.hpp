@@ -96,6 +96,13 @@ private:
     call_reference(const std::vector<Allele>& alleles, const Latents& latents,
                    const ReadPileupMap& pileups) const;
     
+    bool can_call_reference_from_columns() const noexcept override;
+    
+    std::vector<std::unique_ptr<ReferenceCall>>
+    call_reference(const RefCallColumnMap& columns,
+                   boost::optional<Phred<double>> max_posterior,
+                   boost::optional<Phred<double>> merge_threshold) const override;
+    
     const SampleName& sample() const noexcept;
     
     std::unique_ptr<GenotypePriorModel> make_prior_model(const HaplotypeBlock& haplotypes) const;
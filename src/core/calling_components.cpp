@@ -178,6 +178,11 @@ BAMRealigner::Config GenomeCallingComponents::bamout_config() const noexcept
     return components_.bamout_config;
 }
 
+bool GenomeCallingComponents::inline_bamout() const noexcept
+{
+    return components_.inline_bamout;
+}
+
 boost::optional<const ReadSetProfile&> GenomeCallingComponents::reads_profile() const noexcept
 {
     if (components_.reads_profile) {
@@ -197,6 +202,20 @@ IndelProfiler::ProfileConfig GenomeCallingComponents::profiler_config() const
     return components_.profiler_config;
 }
 
+boost::optional<GenomeCallingComponents::Path> GenomeCallingComponents::make_window_plan_request() const
+{
+    return components_.make_window_plan_request;
+}
+
+boost::optional<const WindowPlan&> GenomeCallingComponents::window_plan() const noexcept
+{
+    if (components_.window_plan) {
+        return *components_.window_plan;
+    } else {
+        return boost::none;
+    }
+}
+
 bool GenomeCallingComponents::sites_only() const noexcept
 {
     return components_.sites_only;
@@ -557,6 +576,26 @@ public:
     virtual ~InputVCFError() override = default;
 };
 
+class UnsupportedInlineBamout : public UserError
+{
+    std::string do_where() const override { return "GenomeCallingComponents"; }
+    std::string do_why() const override
+    {
+        return "--inline-bamout only works for multithreaded runs with a single input BAM holding one sample";
+    }
+    std::string do_help() const override
+    {
+        return "remove --inline-bamout to make the evidence BAM in a separate pass after calling";
+    }
+};
+
+bool supports_inline_bamout(const ReadManager& read_manager, const boost::optional<unsigned> num_threads)
+{
+    // The evidence is made from the reads used for calling, which are pooled across input BAMs
+    const bool is_multithreaded {!num_threads || *num_threads > 1};
+    return is_multithreaded && read_manager.paths().size() == 1 && read_manager.all_readers_have_one_sample();
+}
+
 template <typename T>
 boost::optional<const T&> optional_cref(const boost::optional<T>& v)
 {
@@ -594,17 +633,26 @@ GenomeCallingComponents::Components::Components(ReferenceGenome&& reference, Rea
 , filter_request {}
 , bamout {options::bamout_request(options)}
 , bamout_config {}
+, inline_bamout {options::inline_bamout_requested(options)}
 , data_profile {options::data_profile_request(options)}
 , profiler_config {}
+, make_window_plan_request {options::make_window_plan_request(options)}
+, window_plan {}
 {
     drop_unused_samples(this->samples, this->read_manager);
     setup_progress_meter(options);
     set_read_buffer_size(options);
     setup_filter_read_pipe(options);
+    if (const auto window_plan_path = options::window_plan_request(options)) {
+        window_plan = read_window_plan(*window_plan_path);
+    }
     filter_request = options::filter_request(options);
     if (filter_request && !all_samples_in_vcf(samples, *filter_request)) {
         throw InputVCFError {*filter_request};
     }
+    if (bamout && inline_bamout && !supports_inline_bamout(this->read_manager, num_threads)) {
+        throw UnsupportedInlineBamout {};
+    }
     temp_directory = get_temp_directory(options);
     try {
         call_filter_factory = options::make_call_filter_factory(this->reference, this->read_pipe, options, this->temp_directory);
@@ -789,7 +837,12 @@ ContigCallingComponents::ContigCallingComponents(const GenomicRegion::ContigName
 , read_buffer_size {genome_components.read_buffer_size()}
 , output {genome_components.output()}
 , progress_meter {genome_components.progress_meter()}
-{}
+, window_plan {}
+{
+    if (genome_components.window_plan()) {
+        window_plan = std::cref(*genome_components.window_plan());
+    }
+}
 
 ContigCallingComponents::ContigCallingComponents(const GenomicRegion::ContigName& contig, VcfWriter& output,
                                                  GenomeCallingComponents& genome_components)
@@ -801,6 +854,11 @@ ContigCallingComponents::ContigCallingComponents(const GenomicRegion::ContigName
 , read_buffer_size {genome_components.read_buffer_size()}
 , output {output}
 , progress_meter {genome_components.progress_meter()}
-{}
+, window_plan {}
+{
+    if (genome_components.window_plan()) {
+        window_plan = std::cref(*genome_components.window_plan());
+    }
+}
 
 } // namespace octopus
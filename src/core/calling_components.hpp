@@ -26,6 +26,7 @@
 #include "core/csr/filters/variant_call_filter_factory.hpp"
 #include "core/tools/bam_realigner.hpp"
 #include "core/tools/indel_profiler.hpp"
+#include "core/window_plan.hpp"
 #include "utils/memory_footprint.hpp"
 #include "utils/input_reads_profiler.hpp"
 #include "logging/progress_meter.hpp"
@@ -78,9 +79,12 @@ public:
     boost::optional<Path> filter_request() const;
     boost::optional<Path> bamout() const;
     BAMRealigner::Config bamout_config() const noexcept;
+    bool inline_bamout() const noexcept;
     boost::optional<const ReadSetProfile&> reads_profile() const noexcept;
     boost::optional<Path> data_profile() const;
     IndelProfiler::ProfileConfig profiler_config() const;
+    boost::optional<Path> make_window_plan_request() const;
+    boost::optional<const WindowPlan&> window_plan() const noexcept;
     
 private:
     struct Components
@@ -120,8 +124,11 @@ private:
         boost::optional<Path> filter_request;
         boost::optional<Path> bamout;
         BAMRealigner::Config bamout_config;
+        bool inline_bamout;
         boost::optional<Path> data_profile;
         IndelProfiler::ProfileConfig profiler_config;
+        boost::optional<Path> make_window_plan_request;
+        boost::optional<WindowPlan> window_plan;
         
         // Components that require temporary directory during construction appear last to make
         // exception handling easier.
@@ -155,6 +162,7 @@ struct ContigCallingComponents
     std::size_t read_buffer_size;
     std::reference_wrapper<VcfWriter> output;
     std::reference_wrapper<ProgressMeter> progress_meter;
+    boost::optional<std::reference_wrapper<const WindowPlan>> window_plan;
     
     ContigCallingComponents() = delete;
     
@@ -220,23 +220,10 @@ FacetFactory::make(const std::vector<std::string>& names,
     if (blocks.size() > 1 && !workers.empty()) {
         std::vector<std::future<FacetBlock>> futures {};
         futures.reserve(blocks.size());
-        const auto fetch_reads = requires_reads(names);
-        const auto fetch_genotypes = requires_genotypes(names);
         for (const auto& block : blocks) {
             // It's faster to fetch reads serially from left to right, so do this outside the thread pool
-            BlockData data {};
-            data.calls = std::addressof(block);
-            if (!block.empty()) {
-                data.region = encompassing_region(block);
-                if (fetch_reads) {
-                    data.reads = read_pipe_->fetch_reads(*data.region);
-                }
-            }
-            futures.push_back(workers.push([this, &names, data {std::move(data)}, &block, fetch_genotypes] () mutable {
-                if (fetch_genotypes) {
-                    data.genotypes = extract_genotypes(block, samples_, *reference_);
-                }
-                return this->make(names, data);
+            futures.push_back(workers.push([this, &names, data {prefetch(names, block)}] () mutable {
+                return this->make_prefetched(names, std::move(data));
             }));
         }
         for (auto& fut : futures) {
@@ -251,6 +238,29 @@ FacetFactory::make(const std::vector<std::string>& names,
     return result;
 }
 
+FacetFactory::BlockData FacetFactory::prefetch(const std::vector<std::string>& names, const CallBlock& block) const
+{
+    BlockData result {};
+    result.calls = std::addressof(block);
+    if (!block.empty()) {
+        result.region = encompassing_region(block);
+        if (requires_reads(names)) {
+            result.reads = read_pipe_->fetch_reads(*result.region);
+        }
+    }
+    return result;
+}
+
+FacetFactory::FacetBlock FacetFactory::make_prefetched(const std::vector<std::string>& names, BlockData block) const
+{
+    if (names.empty()) return {};
+    check_requirements(names);
+    if (!block.calls->empty() && requires_genotypes(names)) {
+        block.genotypes = extract_genotypes(*block.calls, samples_, *reference_);
+    }
+    return make(names, block);
+}
+
 // private methods
 
 void FacetFactory::setup_facet_makers()
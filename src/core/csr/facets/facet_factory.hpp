@@ -31,6 +31,15 @@ public:
     using CallBlock  = std::vector<VcfRecord>;
     using FacetBlock = std::vector<FacetWrapper>;
     
+    // The inputs shared by the facets of a block. calls must outlive the BlockData
+    struct BlockData
+    {
+        const CallBlock* calls;
+        boost::optional<GenomicRegion> region;
+        boost::optional<ReadMap> reads;
+        boost::optional<GenotypeMap> genotypes;
+    };
+    
     FacetFactory() = delete;
     
     FacetFactory(VcfHeader input_header);
@@ -56,16 +65,12 @@ public:
     FacetWrapper make(const std::string& name, const CallBlock& block) const;
     FacetBlock make(const std::vector<std::string>& names, const CallBlock& block) const;
     std::vector<FacetBlock> make(const std::vector<std::string>& names, const std::vector<CallBlock>& blocks, ThreadPool& workers) const;
+    
+    // Splits make so reads can be fetched serially, which is fastest, while the rest runs concurrently
+    BlockData prefetch(const std::vector<std::string>& names, const CallBlock& block) const;
+    FacetBlock make_prefetched(const std::vector<std::string>& names, BlockData block) const;
 
 private:
-    struct BlockData
-    {
-        const CallBlock* calls;
-        boost::optional<GenomicRegion> region;
-        boost::optional<ReadMap> reads;
-        boost::optional<GenotypeMap> genotypes;
-    };
-    
     VcfHeader input_header_;
     std::vector<std::string> samples_;
     boost::optional<std::reference_wrapper<const ReferenceGenome>> reference_;
@@ -52,6 +52,8 @@ private:
     virtual bool passes_all_hard_filters(const MeasureVector& measures) const override;
     virtual bool passes_all_soft_filters(const MeasureVector& measures) const override;
     virtual std::vector<std::string> get_failing_vcf_filter_keys(const MeasureVector& measures) const override;
+    // the thresholds applied depend on each call, so calls are classified one at a time
+    virtual boost::optional<std::vector<ClassificationList>> classify_block(const MeasureBlock& measures, const SampleList& samples) const override { return boost::none; }
     
     std::size_t choose_filter(const MeasureVector& measures) const;
     bool passes_all_hard_filters(const MeasureVector& measures, MeasureIndexRange range) const;
@@ -63,11 +63,10 @@ DoublePassVariantCallFilter::make_registration_pass(const VcfReader& source, con
     auto annotated_vcf = get_temp_measure_annotated_vcf(source, filtered_header);
     std::size_t record_idx {0};
     if (can_measure_multiple_blocks()) {
-        for (auto p = source.iterate(); p.first != p.second;) {
-            const auto blocks = read_next_blocks(p.first, p.second, samples);
-            record(blocks, record_idx, filtered_header, samples, annotated_vcf);
-            for (const auto& block : blocks) record_idx += block.size();
-        }
+        measure_blocks(source, samples, [&] (const CallBlock& block, const MeasureBlock& measures) {
+            record(block, measures, record_idx, filtered_header, samples, annotated_vcf);
+            record_idx += block.size();
+        });
     } else if (can_measure_single_call()) {
         auto p = source.iterate();
         std::for_each(std::move(p.first), std::move(p.second),
@@ -99,18 +98,6 @@ void DoublePassVariantCallFilter::record(const CallBlock& block, const std::size
     record(block, measure(block), record_idx, dest_header, samples, annotated_vcf);
 }
 
-void DoublePassVariantCallFilter::record(const std::vector<CallBlock>& blocks, std::size_t record_idx, const VcfHeader& dest_header,
-                                         const SampleList& samples, OptionalVcfWriter& annotated_vcf) const
-{
-    const auto measures = measure(blocks);
-    assert(measures.size() == blocks.size());
-    for (auto tup : boost::combine(blocks, measures)) {
-        const auto& block = tup.get<0>();
-        record(block, tup.get<1>(), record_idx, dest_header, samples, annotated_vcf);
-        record_idx += block.size();
-    }
-}
-
 void DoublePassVariantCallFilter::record(const VcfRecord& call, const MeasureVector& measures, const std::size_t record_idx,
                                          const VcfHeader& dest_header, const SampleList& samples, OptionalVcfWriter& annotated_vcf) const
 {
@@ -66,8 +66,6 @@ private:
                 const SampleList& samples, OptionalVcfWriter& annotated_vcf) const;
     void record(const CallBlock& block, std::size_t record_idx, const VcfHeader& dest_header,
                 const SampleList& samples, OptionalVcfWriter& annotated_vcfr) const;
-    void record(const std::vector<CallBlock>& blocks, std::size_t record_idx, const VcfHeader& dest_header,
-                const SampleList& samples, OptionalVcfWriter& annotated_vcf) const;
     void record(const VcfRecord& call, const MeasureVector& measures, std::size_t record_idx, const VcfHeader& dest_header,
                 const SampleList& samples, OptionalVcfWriter& annotated_vcf) const;
     void record(const CallBlock& block, const MeasureBlock& measures, std::size_t record_idx, const VcfHeader& dest_header,
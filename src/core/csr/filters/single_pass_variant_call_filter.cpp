@@ -31,9 +31,9 @@ void SinglePassVariantCallFilter::filter(const VcfReader& source, VcfWriter& des
     if (progress_) progress_->start();
     const auto samples = source.fetch_header().samples();
     if (can_measure_multiple_blocks()) {
-        for (auto p = source.iterate(); p.first != p.second;) {
-            filter(read_next_blocks(p.first, p.second, samples), dest, dest_header, samples);
-        }
+        measure_blocks(source, samples, [&] (const CallBlock& block, const MeasureBlock& measures) {
+            filter(block, measures, dest, dest_header, samples);
+        });
     } else if (can_measure_single_call()) {
         auto p = source.iterate();
         std::for_each(std::move(p.first), std::move(p.second), [&] (const VcfRecord& call) { filter(call, dest, dest_header, samples); });
@@ -55,28 +55,33 @@ void SinglePassVariantCallFilter::filter(const CallBlock& block, VcfWriter& dest
     filter(block, measure(block), dest, dest_header, samples);
 }
 
-void SinglePassVariantCallFilter::filter(const std::vector<CallBlock>& blocks, VcfWriter& dest, const VcfHeader& dest_header, const SampleList& samples) const
-{
-    const auto measures = measure(blocks);
-    assert(measures.size() == blocks.size());
-    for (auto tup : boost::combine(blocks, measures)) {
-        filter(tup.get<0>(), tup.get<1>(), dest, dest_header, samples);
-    }
-}
-
 void SinglePassVariantCallFilter::filter(const CallBlock& block, const MeasureBlock& measures, VcfWriter& dest,
                                          const VcfHeader& dest_header, const SampleList& samples) const
 {
     assert(measures.size() == block.size());
-    for (auto tup : boost::combine(block, measures)) {
-        filter(tup.get<0>(), tup.get<1>(), dest, dest_header, samples);
+    const auto sample_classifications = classify_block(measures, samples);
+    if (sample_classifications) {
+        assert(sample_classifications->size() == block.size());
+        for (std::size_t i {0}; i < block.size(); ++i) {
+            filter(block[i], measures[i], (*sample_classifications)[i], dest, dest_header, samples);
+        }
+    } else {
+        for (auto tup : boost::combine(block, measures)) {
+            filter(tup.get<0>(), tup.get<1>(), dest, dest_header, samples);
+        }
     }
 }
 
 void SinglePassVariantCallFilter::filter(const VcfRecord& call, const MeasureVector& measures, VcfWriter& dest,
                                          const VcfHeader& dest_header, const SampleList& samples) const
 {
-    const auto sample_classifications = classify(measures, samples);
+    filter(call, measures, classify(measures, samples), dest, dest_header, samples);
+}
+
+void SinglePassVariantCallFilter::filter(const VcfRecord& call, const MeasureVector& measures,
+                                         const ClassificationList& sample_classifications,
+                                         VcfWriter& dest, const VcfHeader& dest_header, const SampleList& samples) const
+{
     const auto call_classification = merge(sample_classifications, measures);
     if (measure_annotations_requested()) {
         VcfRecord::Builder annotation_builder {call};
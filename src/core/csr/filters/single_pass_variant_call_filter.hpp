@@ -40,13 +40,16 @@ private:
     mutable boost::optional<GenomicRegion::ContigName> current_contig_;
     
     virtual Classification classify(const MeasureVector& call_measures) const = 0;
+    // Classifies every call in a block at once; none if calls must be classified one at a time
+    virtual boost::optional<std::vector<ClassificationList>> classify_block(const MeasureBlock& measures, const SampleList& samples) const { return boost::none; }
     
     void filter(const VcfReader& source, VcfWriter& dest, const VcfHeader& dest_header) const override;
     void filter(const VcfRecord& call, VcfWriter& dest, const VcfHeader& dest_header, const SampleList& samples) const;
     void filter(const CallBlock& block, VcfWriter& dest, const VcfHeader& dest_header, const SampleList& samples) const;
-    void filter(const std::vector<CallBlock>& blocks, VcfWriter& dest, const VcfHeader& dest_header, const SampleList& samples) const;
     void filter(const CallBlock& block, const MeasureBlock & measures, VcfWriter& dest, const VcfHeader& dest_header, const SampleList& samples) const;
     void filter(const VcfRecord& call, const MeasureVector& measures, VcfWriter& dest, const VcfHeader& dest_header, const SampleList& samples) const;
+    void filter(const VcfRecord& call, const MeasureVector& measures, const ClassificationList& sample_classifications,
+                VcfWriter& dest, const VcfHeader& dest_header, const SampleList& samples) const;
     ClassificationList classify(const MeasureVector& call_measures, const SampleList& samples) const;
     void log_progress(const GenomicRegion& region) const;
 };
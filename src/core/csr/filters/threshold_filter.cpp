@@ -123,6 +123,48 @@ bool ThresholdVariantCallFilter::passes_all_soft_filters(const MeasureVector& me
                               std::cbegin(soft_thresholds_));
 }
 
+boost::optional<std::vector<VariantCallFilter::ClassificationList>>
+ThresholdVariantCallFilter::classify_block(const MeasureBlock& measures, const SampleList& samples) const
+{
+    const auto num_rows = measures.size() * samples.size();
+    MeasureColumn::Mask passes_hard(num_rows, 1);
+    for (std::size_t i {0}; i < hard_thresholds_.size(); ++i) {
+        const auto values = make_measure_column(measures, i, measures_[i], samples.size());
+        if (!hard_thresholds_[i].evaluate(values, passes_hard)) return boost::none;
+    }
+    std::vector<MeasureColumn::Mask> passes_soft(soft_thresholds_.size(), MeasureColumn::Mask(num_rows, 1));
+    for (std::size_t i {0}; i < soft_thresholds_.size(); ++i) {
+        const auto measure_idx = i + hard_thresholds_.size();
+        const auto values = make_measure_column(measures, measure_idx, measures_[measure_idx], samples.size());
+        if (!soft_thresholds_[i].evaluate(values, passes_soft[i])) return boost::none;
+    }
+    std::vector<ClassificationList> result(measures.size(), ClassificationList(samples.size()));
+    std::size_t row {0};
+    for (auto& call_classifications : result) {
+        for (auto& classification : call_classifications) {
+            if (passes_hard[row]) {
+                for (std::size_t i {0}; i < soft_thresholds_.size(); ++i) {
+                    if (!passes_soft[i][row]) classification.reasons.push_back(vcf_filter_keys_[i]);
+                }
+                if (classification.reasons.empty()) {
+                    classification.category = Classification::Category::unfiltered;
+                } else {
+                    classification.category = Classification::Category::soft_filtered;
+                    if (!all_unique_filter_keys_) {
+                        std::sort(std::begin(classification.reasons), std::end(classification.reasons));
+                        classification.reasons.erase(std::unique(std::begin(classification.reasons), std::end(classification.reasons)),
+                                                     std::end(classification.reasons));
+                    }
+                }
+            } else {
+                classification.category = Classification::Category::hard_filtered;
+            }
+            ++row;
+        }
+    }
+    return result;
+}
+
 std::vector<std::string> ThresholdVariantCallFilter::get_failing_vcf_filter_keys(const MeasureVector& measures) const
 {
     std::vector<std::string> result {};
@@ -7,6 +7,9 @@
 #include <vector>
 #include <string>
 #include <functional>
+#include <type_traits>
+#include <limits>
+#include <cstddef>
 
 #include <boost/optional.hpp>
 #include <boost/variant.hpp>
@@ -15,6 +18,7 @@
 #include "single_pass_variant_call_filter.hpp"
 #include "logging/progress_meter.hpp"
 #include "../facets/facet_factory.hpp"
+#include "../measures/measure_column.hpp"
 
 namespace octopus {
 
@@ -30,6 +34,9 @@ public:
         virtual ~Threshold() = default;
         virtual std::unique_ptr<Threshold> clone() const = 0;
         virtual bool operator()(const Measure::ResultType& value) const noexcept = 0;
+        // Ands the result for each row of values into passes. Returns false (leaving passes
+        // unchanged) if this threshold can't be evaluated on columns.
+        virtual bool evaluate(const MeasureColumn& values, MeasureColumn::Mask& passes) const noexcept { return false; }
     };
     
     struct ThresholdWrapper
@@ -42,6 +49,7 @@ public:
             return *this;
         }
         bool operator()(Measure::ResultType value) const noexcept { return (*threshold)(value); }
+        bool evaluate(const MeasureColumn& values, MeasureColumn::Mask& passes) const noexcept { return threshold->evaluate(values, passes); }
         std::unique_ptr<Threshold> threshold;
     };
     
@@ -89,6 +97,7 @@ private:
     std::string do_name() const override;
     virtual void annotate(VcfHeader::Builder& header) const override;
     virtual Classification classify(const MeasureVector& measures) const override;
+    virtual boost::optional<std::vector<ClassificationList>> classify_block(const MeasureBlock& measures, const SampleList& samples) const override;
     
     virtual bool passes_all_hard_filters(const MeasureVector& measures) const;
     virtual bool passes_all_soft_filters(const MeasureVector& measures) const;
@@ -112,6 +121,23 @@ struct UnaryThreshold
     {
         return boost::apply_visitor(visitor_, value);
     }
+    bool evaluate(const MeasureColumn& values, MeasureColumn::Mask& passes) const noexcept
+    {
+        // min and max alone can't tell if any value in a row equals the target
+        if (std::is_same<Cmp, std::equal_to<>>::value && !values.single_valued) return false;
+        const auto target = static_cast<double>(visitor_.target);
+        // a negative integer target is compared as unsigned against std::size_t values
+        if (std::is_integral<T>::value && std::is_signed<T>::value && target < 0 && values.has_unsigned_values) return false;
+        const auto cmp = visitor_.cmp;
+        // NaN values are excluded from min and max, and pass or fail independently of the other values in a row
+        const bool nan_passes {!cmp(std::numeric_limits<double>::quiet_NaN(), target)};
+        const auto n = values.size();
+        for (std::size_t i {0}; i < n; ++i) {
+            passes[i] &= values.missing[i] | (!cmp(values.min[i], target) & !cmp(values.max[i], target)
+                                              & (nan_passes | !values.has_nan[i]));
+        }
+        return true;
+    }
 private:
     struct UnaryVisitor : public boost::static_visitor<bool>
     {
@@ -155,6 +181,10 @@ struct EqualThreshold : public ThresholdVariantCallFilter::Threshold
     {
         return base_(value);
     }
+    bool evaluate(const MeasureColumn& values, MeasureColumn::Mask& passes) const noexcept
+    {
+        return base_.evaluate(values, passes);
+    }
 private:
     detail::UnaryThreshold<std::equal_to<>, T> base_;
 };
@@ -171,6 +201,10 @@ struct NotEqualThreshold : public ThresholdVariantCallFilter::Threshold
     {
         return base_(value);
     }
+    bool evaluate(const MeasureColumn& values, MeasureColumn::Mask& passes) const noexcept
+    {
+        return base_.evaluate(values, passes);
+    }
 private:
     detail::UnaryThreshold<std::not_equal_to<>, T> base_;
 };
@@ -187,6 +221,10 @@ struct LessThreshold : public ThresholdVariantCallFilter::Threshold
     {
         return base_(value);
     }
+    bool evaluate(const MeasureColumn& values, MeasureColumn::Mask& passes) const noexcept
+    {
+        return base_.evaluate(values, passes);
+    }
 private:
     detail::UnaryThreshold<std::less<>, T> base_;
 };
@@ -203,6 +241,10 @@ struct LessEqualThreshold : public ThresholdVariantCallFilter::Threshold
     {
         return base_(value);
     }
+    bool evaluate(const MeasureColumn& values, MeasureColumn::Mask& passes) const noexcept
+    {
+        return base_.evaluate(values, passes);
+    }
 private:
     detail::UnaryThreshold<std::less_equal<>, T> base_;
 };
@@ -219,6 +261,10 @@ struct GreaterThreshold : public ThresholdVariantCallFilter::Threshold
     {
         return base_(value);
     }
+    bool evaluate(const MeasureColumn& values, MeasureColumn::Mask& passes) const noexcept
+    {
+        return base_.evaluate(values, passes);
+    }
 private:
     detail::UnaryThreshold<std::greater<>, T> base_;
 };
@@ -235,6 +281,10 @@ struct GreaterEqualThreshold : public ThresholdVariantCallFilter::Threshold
     {
         return base_(value);
     }
+    bool evaluate(const MeasureColumn& values, MeasureColumn::Mask& passes) const noexcept
+    {
+        return base_.evaluate(values, passes);
+    }
 private:
     detail::UnaryThreshold<std::greater_equal<>, T> base_;
 };
@@ -12,6 +12,8 @@
 #include <limits>
 #include <cmath>
 #include <thread>
+#include <memory>
+#include <exception>
 
 #include <boost/range/combine.hpp>
 #include <boost/multiprecision/gmp.hpp>
@@ -27,7 +29,7 @@
 #include "utils/string_utils.hpp"
 #include "utils/genotype_reader.hpp"
 #include "utils/append.hpp"
-#include "utils/parallel_transform.hpp"
+#include "utils/bounded_queue.hpp"
 #include "io/variant/vcf_writer.hpp"
 #include "io/variant/vcf_spec.hpp"
 
@@ -218,23 +220,6 @@ VariantCallFilter::read_next_block(VcfIterator& first, const VcfIterator& last,
     return copy_each_first(block);
 }
 
-std::vector<VariantCallFilter::CallBlock>
-VariantCallFilter::read_next_blocks(VcfIterator& first, const VcfIterator& last, const SampleList& samples) const
-{
-    std::vector<VariantCallFilter::CallBlock> result {};
-    if (can_measure_multiple_blocks()) {
-        const auto max_blocks = max_concurrent_blocks();
-        result.reserve(max_blocks);
-        while (result.size() < max_blocks) {
-            result.push_back(read_next_block(first, last, samples));
-            if (first == last || !is_same_contig(*first, result.back().front())) break;
-        }
-    } else {
-        result.push_back(read_next_block(first, last, samples));
-    }
-    return result;
-}
-
 VariantCallFilter::MeasureVector VariantCallFilter::measure(const VcfRecord& call) const
 {
     MeasureVector result(measures_.size());
@@ -267,25 +252,72 @@ VariantCallFilter::MeasureBlock VariantCallFilter::measure(const CallBlock& bloc
     return result;
 }
 
-std::vector<VariantCallFilter::MeasureBlock> VariantCallFilter::measure(const std::vector<CallBlock>& blocks) const
+void VariantCallFilter::measure_blocks(const VcfReader& source, const SampleList& samples, const MeasuredBlockVisitor& visitor) const
 {
-    std::vector<MeasureBlock> result {};
-    result.reserve(blocks.size());
-    if (is_multithreaded()) {
-        const auto facets = compute_facets(blocks);
-        if (debug_log_) {
-            stream(*debug_log_) << "Measuring " << blocks.size() << " blocks with " << workers_.size() << " threads";
+    if (!is_multithreaded()) {
+        for (auto p = source.iterate(); p.first != p.second;) {
+            const auto block = read_next_block(p.first, p.second, samples);
+            visitor(block, measure(block));
         }
-        transform(std::cbegin(blocks), std::cend(blocks), std::cbegin(facets), std::back_inserter(result),
-                  [this] (const auto& block, const auto& block_facets) {
-                      return this->measure(block, block_facets);
-                  }, workers_);
-    } else {
-        for (const CallBlock& block : blocks) {
-            result.push_back(measure(block));
+        return;
+    }
+    // Pipelined so the stages overlap: a reader thread splits the calls into blocks, a fetch thread
+    // fetches the reads for each block (serially, which is fastest) before handing it to the workers
+    // to measure, and the calling thread visits the measured blocks in input order. The queues are
+    // bounded so no stage can run too far ahead of the others.
+    using BlockPointer = std::shared_ptr<const CallBlock>;
+    struct MeasureJob
+    {
+        BlockPointer block;
+        std::future<MeasureBlock> measures;
+    };
+    const auto max_queued_blocks = max_concurrent_blocks();
+    BoundedQueue<BlockPointer> blocks {max_queued_blocks};
+    BoundedQueue<MeasureJob> jobs {max_queued_blocks};
+    std::exception_ptr reader_error {}, fetcher_error {}, visitor_error {};
+    std::thread reader {[&] () {
+        try {
+            for (auto p = source.iterate(); p.first != p.second;) {
+                if (!blocks.push(std::make_shared<const CallBlock>(read_next_block(p.first, p.second, samples)))) break;
+            }
+        } catch (...) {
+            reader_error = std::current_exception();
         }
+        blocks.close();
+    }};
+    std::thread fetcher {[&] () {
+        try {
+            while (auto block = blocks.pop()) {
+                auto data = facet_factory_.prefetch(facet_names_, **block);
+                // The job owns the block too, so a job that is abandoned on error never outlives its calls
+                auto measures = workers_.push([this, calls = *block, data = std::move(data)] () mutable {
+                    return this->measure(*calls, this->compute_facets(std::move(data)));
+                });
+                if (!jobs.push({std::move(*block), std::move(measures)})) break;
+            }
+        } catch (...) {
+            fetcher_error = std::current_exception();
+            blocks.close();
+        }
+        jobs.close();
+    }};
+    try {
+        while (auto job = jobs.pop()) {
+            visitor(*job->block, job->measures.get());
+        }
+    } catch (...) {
+        visitor_error = std::current_exception();
+        blocks.close();
+        jobs.close();
+    }
+    reader.join();
+    fetcher.join();
+    while (auto job = jobs.pop()) {
+        job->measures.wait();
+    }
+    for (const auto& error : {visitor_error, fetcher_error, reader_error}) {
+        if (error) std::rethrow_exception(error);
     }
-    return result;
 }
 
 void VariantCallFilter::write(const VcfRecord& call, const Classification& classification, VcfWriter& dest) const
@@ -511,19 +543,9 @@ Measure::FacetMap VariantCallFilter::compute_facets(const CallBlock& block) cons
     return make_map(facet_names_, facet_factory_.make(facet_names_, block));
 }
 
-std::vector<Measure::FacetMap> VariantCallFilter::compute_facets(const std::vector<CallBlock>& blocks) const
+Measure::FacetMap VariantCallFilter::compute_facets(FacetFactory::BlockData block) const
 {
-    if (debug_log_ && !blocks.empty()) {
-        const auto blocks_region = closed_region(blocks.front().front(), blocks.back().back());
-        stream(*debug_log_) << "Computing facets in blocks region " << blocks_region << " containing " << blocks.size() << " blocks";
-    }
-    auto facets = facet_factory_.make(facet_names_, blocks, workers_);
-    std::vector<Measure::FacetMap> result {};
-    result.reserve(blocks.size());
-    for (auto& block : facets) {
-        result.push_back(make_map(facet_names_, std::move(block)));
-    }
-    return result;
+    return make_map(facet_names_, facet_factory_.make_prefetched(facet_names_, std::move(block)));
 }
 
 VariantCallFilter::MeasureBlock VariantCallFilter::measure(const CallBlock& block, const Measure::FacetMap& facets) const
@@ -181,6 +181,7 @@ std::string long_name(const Measure& measure);
 std::string long_name(const MeasureWrapper& measure);
 
 bool is_missing(const Measure::ResultType& value) noexcept;
+bool is_per_sample(Measure::ResultCardinality cardinality) noexcept;
 
 template <typename T>
 T get_value_type(const Measure::ResultType& value)
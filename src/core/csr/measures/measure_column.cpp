@@ -0,0 +1,135 @@
+// Copyright (c) 2015-2020 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#include "measure_column.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <cmath>
+#include <cassert>
+
+namespace octopus { namespace csr {
+
+namespace {
+
+struct CellSummary
+{
+    double min = std::numeric_limits<double>::max(), max = std::numeric_limits<double>::lowest();
+    std::size_t num_values = 0, num_nan_values = 0;
+    bool has_unsigned_values = false;
+};
+
+class CellSummaryVisitor : public boost::static_visitor<>
+{
+public:
+    CellSummaryVisitor(CellSummary& cell) : cell_ {cell} {}
+
+    void operator()(const Measure::ValueType& value) const { boost::apply_visitor(*this, value); }
+    void operator()(bool value) const noexcept { add(value); }
+    void operator()(int value) const noexcept { add(value); }
+    void operator()(std::size_t value) const noexcept { cell_.has_unsigned_values = true; add(value); }
+    void operator()(double value) const noexcept { add(value); }
+    template <typename T>
+    void operator()(const Measure::Optional<T>& value) const
+    {
+        if (value) (*this)(*value);
+    }
+    template <typename T>
+    void operator()(const Measure::Array<T>& values) const
+    {
+        for (const auto& value : values) (*this)(value);
+    }
+
+private:
+    CellSummary& cell_;
+
+    void add(const double value) const noexcept
+    {
+        if (std::isnan(value)) {
+            ++cell_.num_nan_values;
+            ++cell_.num_values;
+            return;
+        }
+        cell_.min = std::min(cell_.min, value);
+        cell_.max = std::max(cell_.max, value);
+        ++cell_.num_values;
+    }
+};
+
+// Same indexing as get_sample_value, but without copying the sample's value out
+class SampleCellSummaryVisitor : public boost::static_visitor<>
+{
+public:
+    SampleCellSummaryVisitor(std::size_t sample_idx, CellSummary& cell) : sample_idx_ {sample_idx}, visitor_ {cell} {}
+
+    template <typename T>
+    void operator()(const T& value) const { visitor_(value); }
+    template <typename T>
+    void operator()(const Measure::Array<T>& values) const { visitor_(values[sample_idx_]); }
+    template <typename T>
+    void operator()(const Measure::Optional<Measure::Array<T>>& values) const
+    {
+        if (values) visitor_((*values)[sample_idx_]);
+    }
+
+private:
+    std::size_t sample_idx_;
+    CellSummaryVisitor visitor_;
+};
+
+void set_row(MeasureColumn& column, const std::size_t row, const CellSummary& cell) noexcept
+{
+    if (cell.num_values > 0) {
+        if (cell.num_nan_values < cell.num_values) {
+            column.min[row] = cell.min;
+            column.max[row] = cell.max;
+        } else {
+            column.min[row] = column.max[row] = std::numeric_limits<double>::quiet_NaN();
+        }
+        column.missing[row] = 0;
+        column.has_nan[row] = cell.num_nan_values > 0;
+        if (cell.num_values > 1) column.single_valued = false;
+        if (cell.has_unsigned_values) column.has_unsigned_values = true;
+    } else {
+        column.min[row] = column.max[row] = 0;
+        column.missing[row] = 1;
+        column.has_nan[row] = 0;
+    }
+}
+
+} // namespace
+
+MeasureColumn make_measure_column(const std::vector<std::vector<Measure::ResultType>>& block,
+                                  const std::size_t measure_idx, const MeasureWrapper& measure,
+                                  const std::size_t num_samples)
+{
+    MeasureColumn result {};
+    const auto num_rows = block.size() * num_samples;
+    result.min.resize(num_rows);
+    result.max.resize(num_rows);
+    result.missing.resize(num_rows);
+    result.has_nan.resize(num_rows);
+    const bool per_sample {is_per_sample(measure.cardinality())};
+    std::size_t row {0};
+    for (const auto& measures : block) {
+        assert(measure_idx < measures.size());
+        const auto& value = measures[measure_idx];
+        if (per_sample) {
+            for (std::size_t sample_idx {0}; sample_idx < num_samples; ++sample_idx, ++row) {
+                CellSummary cell {};
+                boost::apply_visitor(SampleCellSummaryVisitor {sample_idx, cell}, value);
+                set_row(result, row, cell);
+            }
+        } else {
+            CellSummary cell {};
+            boost::apply_visitor(CellSummaryVisitor {cell}, value);
+            for (std::size_t sample_idx {0}; sample_idx < num_samples; ++sample_idx, ++row) {
+                set_row(result, row, cell);
+            }
+        }
+    }
+    return result;
+}
+
+} // namespace csr
+} // namespace octopus
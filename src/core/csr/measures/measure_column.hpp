@@ -0,0 +1,44 @@
+// Copyright (c) 2015-2020 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#ifndef measure_column_hpp
+#define measure_column_hpp
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+#include "measure.hpp"
+
+namespace octopus { namespace csr {
+
+/*
+    A MeasureColumn holds one measure for a block of calls in columnar form, with one row per
+    call and sample (row = call_idx * num_samples + sample_idx).
+
+    Each row stores the minimum and maximum of the values in the sample's result. That is
+    enough to evaluate the unary thresholds, because a row passes only if all of its values
+    pass. NaN values don't order so are excluded from the minimum and maximum and flagged
+    instead; rows with only NaN values have a NaN minimum and maximum. Rows with no values
+    at all are flagged as missing.
+ */
+struct MeasureColumn
+{
+    using Mask = std::vector<std::uint8_t>;
+
+    std::vector<double> min, max;
+    Mask missing, has_nan;
+    bool single_valued = true; // no row has more than one value
+    bool has_unsigned_values = false;
+
+    std::size_t size() const noexcept { return min.size(); }
+};
+
+MeasureColumn make_measure_column(const std::vector<std::vector<Measure::ResultType>>& block,
+                                  std::size_t measure_idx, const MeasureWrapper& measure,
+                                  std::size_t num_samples);
+
+} // namespace csr
+} // namespace octopus
+
+#endif
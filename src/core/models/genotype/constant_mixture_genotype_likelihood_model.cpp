@@ -76,6 +76,118 @@ ConstantMixtureGenotypeLikelihoodModel::evaluate(const Genotype<IndexedHaplotype
     }
 }
 
+namespace {
+
+// Chosen so the tile slices of a few hundred haplotypes fit comfortably in L2
+constexpr std::size_t readTileSize {256};
+
+template <typename T>
+auto sum(const T* first, const std::size_t n) noexcept
+{
+    ConstantMixtureGenotypeLikelihoodModel::LogProbability result {0};
+    for (std::size_t i {0}; i < n; ++i) result += first[i];
+    return result;
+}
+
+} // namespace
+
+std::vector<ConstantMixtureGenotypeLikelihoodModel::LogProbability>&
+ConstantMixtureGenotypeLikelihoodModel::evaluate(const std::vector<Genotype<IndexedHaplotype<>>>& genotypes,
+                                                 std::vector<LogProbability>& result) const
+{
+    assert(likelihoods_.is_primed());
+    result.assign(genotypes.size(), 0);
+    if (genotypes.empty()) return result;
+    const auto num_likelihoods = likelihoods_.num_likelihoods();
+    if (num_likelihoods == 0) return result;
+    // Each genotype is a mixture of its unique haplotypes weighted by their multiplicity
+    mixture_components_.clear();
+    mixture_offsets_.resize(genotypes.size() + 1);
+    mixture_offsets_[0] = 0;
+    for (std::size_t genotype_idx {0}; genotype_idx < genotypes.size(); ++genotype_idx) {
+        const auto& genotype = genotypes[genotype_idx];
+        for (auto haplotype_itr = std::cbegin(genotype); haplotype_itr != std::cend(genotype);) {
+            const auto next_itr = std::find_if_not(std::next(haplotype_itr), std::cend(genotype),
+                                                   [=] (const auto& haplotype) { return haplotype == *haplotype_itr; });
+            const auto multiplicity = static_cast<unsigned>(std::distance(haplotype_itr, next_itr));
+            const auto log_weight = std::log(static_cast<LogProbability>(multiplicity) / genotype.ploidy());
+            mixture_components_.push_back({likelihoods_[*haplotype_itr].data(), log_weight});
+            haplotype_itr = next_itr;
+        }
+        mixture_offsets_[genotype_idx + 1] = mixture_components_.size();
+    }
+    std::array<LogProbability, readTileSize> max_buffer, sum_buffer;
+    for (std::size_t tile_begin {0}; tile_begin < num_likelihoods; tile_begin += readTileSize) {
+        const auto tile_size = std::min(readTileSize, num_likelihoods - tile_begin);
+        for (std::size_t genotype_idx {0}; genotype_idx < genotypes.size(); ++genotype_idx) {
+            const auto first_component = std::next(std::cbegin(mixture_components_), mixture_offsets_[genotype_idx]);
+            const auto last_component  = std::next(std::cbegin(mixture_components_), mixture_offsets_[genotype_idx + 1]);
+            const auto num_components = std::distance(first_component, last_component);
+            if (num_components == 0) continue;
+            if (num_components == 1) {
+                // homozygous
+                result[genotype_idx] += sum(first_component->log_likelihoods + tile_begin, tile_size);
+                continue;
+            }
+            {
+                const auto* log_likelihoods = first_component->log_likelihoods + tile_begin;
+                const auto log_weight = first_component->log_weight;
+                for (std::size_t i {0}; i < tile_size; ++i) {
+                    max_buffer[i] = log_likelihoods[i] + log_weight;
+                }
+            }
+            std::for_each(std::next(first_component), last_component, [&] (const auto& component) {
+                const auto* log_likelihoods = component.log_likelihoods + tile_begin;
+                for (std::size_t i {0}; i < tile_size; ++i) {
+                    max_buffer[i] = std::max(max_buffer[i], log_likelihoods[i] + component.log_weight);
+                }
+            });
+            std::fill_n(std::begin(sum_buffer), tile_size, LogProbability {0});
+            std::for_each(first_component, last_component, [&] (const auto& component) {
+                const auto* log_likelihoods = component.log_likelihoods + tile_begin;
+                for (std::size_t i {0}; i < tile_size; ++i) {
+                    sum_buffer[i] += std::exp(log_likelihoods[i] + component.log_weight - max_buffer[i]);
+                }
+            });
+            LogProbability tile_result {0};
+            for (std::size_t i {0}; i < tile_size; ++i) {
+                tile_result += max_buffer[i] + std::log(sum_buffer[i]);
+            }
+            result[genotype_idx] += tile_result;
+        }
+    }
+    return result;
+}
+
+std::vector<ConstantMixtureGenotypeLikelihoodModel::LogProbability>
+ConstantMixtureGenotypeLikelihoodModel::evaluate(const std::vector<Genotype<IndexedHaplotype<>>>& genotypes) const
+{
+    std::vector<LogProbability> result {};
+    evaluate(genotypes, result);
+    return result;
+}
+
+// ln p(read | genotype) <= max {haplotype in genotype} ln p(read | haplotype)
+ConstantMixtureGenotypeLikelihoodModel::LogProbability
+ConstantMixtureGenotypeLikelihoodModel::evaluate_upper_bound(const Genotype<IndexedHaplotype<>>& genotype) const
+{
+    assert(likelihoods_.is_primed());
+    if (genotype.ploidy() == 0) return 0.0;
+    const auto& log_likelihoods1 = likelihoods_[genotype[0]];
+    if (is_homozygous(genotype)) {
+        return std::accumulate(std::cbegin(log_likelihoods1), std::cend(log_likelihoods1), LogProbability {0});
+    }
+    buffer_.assign(std::cbegin(log_likelihoods1), std::cend(log_likelihoods1));
+    for (unsigned i {1}; i < genotype.ploidy(); ++i) {
+        if (genotype[i] == genotype[i - 1]) continue;
+        const auto* log_likelihoods = likelihoods_[genotype[i]].data();
+        for (std::size_t j {0}; j < buffer_.size(); ++j) {
+            buffer_[j] = std::max(buffer_[j], log_likelihoods[j]);
+        }
+    }
+    return sum(buffer_.data(), buffer_.size());
+}
+
 // private methods
 
 ConstantMixtureGenotypeLikelihoodModel::LogProbability
@@ -5,7 +5,9 @@
 #define constant_mixture_genotype_likelihood_model_hpp
 
 #include <vector>
+#include <cstddef>
 
+#include "containers/mappable_block.hpp"
 #include "core/types/haplotype.hpp"
 #include "core/types/indexed_haplotype.hpp"
 #include "core/types/genotype.hpp"
@@ -34,10 +36,29 @@ public:
     LogProbability evaluate(const Genotype<Haplotype>& genotype) const;
     LogProbability evaluate(const Genotype<IndexedHaplotype<>>& genotype) const;
     
+    // Batched evaluation of many genotypes. Reads are processed in tiles so the likelihoods of
+    // each haplotype are reused from cache by all genotypes containing it.
+    std::vector<LogProbability>&
+    evaluate(const std::vector<Genotype<IndexedHaplotype<>>>& genotypes, std::vector<LogProbability>& result) const;
+    std::vector<LogProbability>
+    evaluate(const std::vector<Genotype<IndexedHaplotype<>>>& genotypes) const;
+    
+    // An upper bound on evaluate(genotype) that needs no exp or log: a read's mixture likelihood
+    // is never greater than its likelihood under the best supporting haplotype in the genotype.
+    LogProbability evaluate_upper_bound(const Genotype<IndexedHaplotype<>>& genotype) const;
+    
 private:
+    struct MixtureComponent
+    {
+        const HaplotypeLikelihoodArray::LogProbability* log_likelihoods;
+        LogProbability log_weight;
+    };
+    
     const HaplotypeLikelihoodArray& likelihoods_;
     mutable std::vector<HaplotypeLikelihoodArray::LogProbability> buffer_;
     mutable std::vector<HaplotypeLikelihoodArray::LikelihoodVectorRef> likelihood_refs_;
+    mutable std::vector<MixtureComponent> mixture_components_;
+    mutable std::vector<std::size_t> mixture_offsets_;
     
     // These are just for optimisation
     LogProbability evaluate_haploid(const Genotype<Haplotype>& genotype) const;
@@ -61,6 +82,22 @@ evaluate(const Container1& genotypes, const ConstantMixtureGenotypeLikelihoodMod
     return result;
 }
 
+inline std::vector<ConstantMixtureGenotypeLikelihoodModel::LogProbability>&
+evaluate(const MappableBlock<Genotype<IndexedHaplotype<>>>& genotypes,
+         const ConstantMixtureGenotypeLikelihoodModel& model,
+         std::vector<ConstantMixtureGenotypeLikelihoodModel::LogProbability>& result)
+{
+    return model.evaluate(genotypes, result);
+}
+
+inline std::vector<ConstantMixtureGenotypeLikelihoodModel::LogProbability>&
+evaluate(const std::vector<Genotype<IndexedHaplotype<>>>& genotypes,
+         const ConstantMixtureGenotypeLikelihoodModel& model,
+         std::vector<ConstantMixtureGenotypeLikelihoodModel::LogProbability>& result)
+{
+    return model.evaluate(genotypes, result);
+}
+
 template <typename Container>
 auto evaluate(const Container& genotypes, const ConstantMixtureGenotypeLikelihoodModel& model)
 {
@@ -8,8 +8,10 @@
 #include <cmath>
 #include <cassert>
 #include <iostream>
+#include <iterator>
 
 #include "utils/maths.hpp"
+#include "utils/select_top_k.hpp"
 #include "constant_mixture_genotype_likelihood_model.hpp"
 
 namespace octopus { namespace model {
@@ -82,6 +84,43 @@ IndividualModel::evaluate(const MappableBlock<Genotype<IndexedHaplotype<>>>& gen
     return result;
 }
 
+IndividualModel::LogProbability
+IndividualModel::evaluate_log_evidence(const GenotypeIndexer& genotypes,
+                                       const MappableBlock<IndexedHaplotype<>>& haplotypes,
+                                       const HaplotypeLikelihoodArray& haplotype_likelihoods) const
+{
+    assert(genotypes.size() > 0);
+    static constexpr GenotypeIndexer::Rank batch_size {1024};
+    ConstantMixtureGenotypeLikelihoodModel likelihood_model {haplotype_likelihoods};
+    std::vector<Genotype<IndexedHaplotype<>>> batch {};
+    batch.reserve(std::min(batch_size, genotypes.size()));
+    std::vector<LogProbability> batch_log_probabilities {}, batch_log_evidences {};
+    batch_log_evidences.reserve(genotypes.size() / batch_size + 1);
+    for (GenotypeIndexer::Rank first {0}; first < genotypes.size(); first += batch_size) {
+        batch.clear();
+        generate_genotypes(genotypes, first, std::min(first + batch_size, genotypes.size()), haplotypes, std::back_inserter(batch));
+        likelihood_model.evaluate(batch, batch_log_probabilities);
+        octopus::evaluate(batch, genotype_prior_model_, batch_log_probabilities, false, true);
+        batch_log_evidences.push_back(maths::log_sum_exp(batch_log_probabilities));
+    }
+    return maths::log_sum_exp(batch_log_evidences);
+}
+
+std::vector<std::size_t>
+IndividualModel::select_top_k_genotypes(const MappableBlock<Genotype<IndexedHaplotype<>>>& genotypes, const std::size_t k,
+                                        const HaplotypeLikelihoodArray& haplotype_likelihoods) const
+{
+    ConstantMixtureGenotypeLikelihoodModel likelihood_model {haplotype_likelihoods};
+    const auto log_priors = octopus::evaluate(genotypes, genotype_prior_model_);
+    std::vector<LogProbability> upper_bounds(genotypes.size());
+    for (std::size_t i {0}; i < genotypes.size(); ++i) {
+        upper_bounds[i] = log_priors[i] + likelihood_model.evaluate_upper_bound(genotypes[i]);
+    }
+    return select_top_k_indices_with_upper_bounds(upper_bounds, k, [&] (const std::size_t i) {
+        return log_priors[i] + likelihood_model.evaluate(genotypes[i]);
+    });
+}
+
 namespace debug {
 
 using octopus::debug::print_variant_alleles;
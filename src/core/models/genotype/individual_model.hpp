@@ -12,6 +12,7 @@
 #include "core/types/haplotype.hpp"
 #include "core/models/haplotype_likelihood_array.hpp"
 #include "core/types/genotype.hpp"
+#include "core/types/genotype_indexer.hpp"
 #include "containers/mappable_block.hpp"
 #include "logging/logging.hpp"
 
@@ -57,6 +58,19 @@ public:
     evaluate(const MappableBlock<Genotype<IndexedHaplotype<>>>& genotypes,
              const HaplotypeLikelihoodArray& haplotype_likelihoods) const;
     
+    // Same as evaluate(...).log_evidence over every genotype in the index, but only materialises
+    // a small batch of genotypes at a time
+    LogProbability
+    evaluate_log_evidence(const GenotypeIndexer& genotypes,
+                          const MappableBlock<IndexedHaplotype<>>& haplotypes,
+                          const HaplotypeLikelihoodArray& haplotype_likelihoods) const;
+    
+    // Indices of the (at most) k genotypes with greatest posterior probability, most probable first.
+    // Genotypes whose likelihood upper bound keeps them out of the top k are never evaluated exactly.
+    std::vector<std::size_t>
+    select_top_k_genotypes(const MappableBlock<Genotype<IndexedHaplotype<>>>& genotypes, std::size_t k,
+                           const HaplotypeLikelihoodArray& haplotype_likelihoods) const;
+    
 private:
     const GenotypePriorModel& genotype_prior_model_;
     const MappableBlock<Haplotype>* haplotypes_;
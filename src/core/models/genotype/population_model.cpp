@@ -138,10 +138,9 @@ compute_genotype_log_likelihoods(const std::vector<SampleName>& samples,
     GenotypeLogLikelihoodMatrix result {};
     result.reserve(samples.size());
     std::transform(std::cbegin(samples), std::cend(samples), std::back_inserter(result), [&] (const auto& sample) {
-        GenotypeLogLikelihoodVector likelihoods(genotypes.size());
+        GenotypeLogLikelihoodVector likelihoods {};
         haplotype_likelihoods.prime(sample);
-        std::transform(std::cbegin(genotypes), std::cend(genotypes), std::begin(likelihoods),
-                       [&] (const auto& genotype) { return likelihood_model.evaluate(genotype); });
+        likelihood_model.evaluate(genotypes, likelihoods);
         return likelihoods;
     });
     return result;
@@ -6,10 +6,11 @@
 #include <iterator>
 #include <algorithm>
 #include <cmath>
-#include <random>
 #include <utility>
 #include <cassert>
 #include <string>
+#include <queue>
+#include <limits>
 #include <iostream>
 
 #include <boost/iterator/transform_iterator.hpp>
@@ -95,89 +96,27 @@ struct GenotypeIndexProbabilityPairGenotypeEqual
     }
 };
 
-struct GenotypeIndexProbabilityPairGenotypeLess
-{
-    bool operator()(const GenotypeIndexProbabilityPair& lhs, const GenotypeIndexProbabilityPair& rhs) const
-    {
-        return lhs.genotype < rhs.genotype;
-    }
-};
-
-struct ParentsProbabilityPair
-{
-    double probability;
-    GenotypeIndex maternal, paternal;
-};
-
-bool operator==(const ParentsProbabilityPair& lhs, const ParentsProbabilityPair& rhs) noexcept
-{
-    return lhs.probability == rhs.probability;
-}
-bool operator!=(const ParentsProbabilityPair& lhs, const ParentsProbabilityPair& rhs) noexcept
-{
-    return lhs.probability != rhs.probability;
-}
-bool operator<(const ParentsProbabilityPair& lhs, const ParentsProbabilityPair& rhs) noexcept
-{
-    return lhs.probability < rhs.probability;
-}
-bool operator>(const ParentsProbabilityPair& lhs, const ParentsProbabilityPair& rhs) noexcept
-{
-    return lhs.probability > rhs.probability;
-}
-
 auto compute_likelihoods(const TrioModel::GenotypeVector& genotypes,
                          const ConstantMixtureGenotypeLikelihoodModel& model)
 {
+    const auto likelihoods = model.evaluate(genotypes);
     std::vector<GenotypeIndexProbabilityPair> result(genotypes.size());
     for (GenotypeIndex idx {0}; idx < static_cast<GenotypeIndex>(genotypes.size()); ++idx) {
-        result[idx] = {model.evaluate(genotypes[idx]), idx};
+        result[idx] = {likelihoods[idx], idx};
     }
     return result;
 }
 
-auto compute_posteriors(const std::vector<GenotypeIndexProbabilityPair>& likelihoods,
-                        const PopulationPriorModel& prior_model,
-                        const TrioModel::GenotypeVector& genotypes)
-{
-    std::vector<double> posteriors(likelihoods.size());
-    std::transform(std::cbegin(likelihoods), std::cend(likelihoods), std::begin(posteriors),
-                   [&] (const auto& p) { return p.probability + prior_model.evaluate({genotypes[p.genotype]}); });
-    maths::normalise_exp(posteriors);
-    std::vector<GenotypeIndexProbabilityPair> result(posteriors.size());
-    std::transform(std::cbegin(likelihoods), std::cend(likelihoods), std::cbegin(posteriors), std::begin(result),
-                   [] (const auto& p, const auto posterior) noexcept {
-                       return GenotypeIndexProbabilityPair {posterior, p.genotype};
-                   });
-    return result;
-}
-
 struct TrioGenotypeData
 {
     const TrioModel::GenotypeVector& maternal, paternal, child;
 };
 
-template <typename T>
-bool all_equal(const std::vector<T>& v)
-{
-    return std::adjacent_find(std::cbegin(v), std::cend(v), std::not_equal_to<> {}) == std::cend(v);
-}
-
 struct ProbabilityGetter
 {
     template <typename T> const auto& operator()(const T& x) const noexcept { return x.probability; }
 };
 
-template <typename Iterator>
-auto compute_lost_posterior_mass(Iterator first, Iterator first_removed, Iterator last)
-{
-    using boost::make_transform_iterator;
-    const auto first_prob = make_transform_iterator(first, ProbabilityGetter {});
-    const auto first_removed_prob = make_transform_iterator(first_removed, ProbabilityGetter {});
-    const auto last_prob = make_transform_iterator(last, ProbabilityGetter {});
-    return maths::log_sum_exp(first_removed_prob, last_prob) - maths::log_sum_exp(first_prob, last_prob);
-}
-
 template <typename T>
 auto compute_min_joint(const std::vector<T>& zipped, const double max_log_mass_loss, boost::optional<double>& lost_log_mass)
 {
@@ -198,310 +137,18 @@ auto compute_min_joint(const std::vector<T>& zipped, const double max_log_mass_l
     return std::max(num_to_keep, std::size_t {1});
 }
 
-template <typename T>
-typename std::vector<T>::iterator
-reduce(std::vector<T>& zipped, std::size_t max_joint,
-       const double max_log_probability_loss,
-       boost::optional<double>& lost_log_mass)
-{
-    max_joint = std::min(max_joint, zipped.size());
-    if (all_equal(zipped)) {
-        static std::default_random_engine gen {};
-        std::shuffle(std::begin(zipped), std::end(zipped), gen);
-        const auto min_joint = static_cast<std::size_t>(std::floor(zipped.size() * (1 - std::exp(max_log_probability_loss))));
-        lost_log_mass = boost::none;
-        return std::next(std::begin(zipped), std::min(max_joint, min_joint));
-    } else {
-        auto result = std::next(std::begin(zipped), max_joint);
-        std::partial_sort(std::begin(zipped), result, std::end(zipped), std::greater<> {});
-        if (max_joint < zipped.size()) {
-            lost_log_mass = compute_lost_posterior_mass(std::begin(zipped), result, std::end(zipped));
-        }
-        if (!lost_log_mass || *lost_log_mass < max_log_probability_loss) {
-            auto num_joint = compute_min_joint(zipped, max_log_probability_loss, lost_log_mass);
-            assert(num_joint <= max_joint);
-            result = std::next(std::begin(zipped), num_joint);
-        }
-        assert(result <= std::end(zipped));
-        return result;
-    }
-}
-
-unsigned get_sample_reduction_count(const std::size_t n)
-{
-    return static_cast<unsigned>(std::sqrt(n));
-}
-
-template <typename T>
-struct ReducedVectorMap
-{
-    using Iterator = typename std::vector<T>::const_iterator;
-    Iterator first, last_to_partially_join, last_full_join, last;
-};
-
-template <typename T>
-auto make_reduction_map(const std::vector<T>& elements,
-                        const typename std::vector<T>::const_iterator last_to_combine,
-                        const TrioModel::Options& options)
-{
-    if (std::distance(std::cbegin(elements), last_to_combine) > 1) {
-        return ReducedVectorMap<T> {std::cbegin(elements), std::next(std::cbegin(elements), 1), last_to_combine, std::cend(elements)};
-    } else {
-        return ReducedVectorMap<T> {std::cbegin(elements), last_to_combine, last_to_combine, std::cend(elements)};
-    }
-}
-
-template <typename T>
-auto reduce(std::vector<T>& zipped, const TrioModel::Options& options)
-{
-    auto last_full_join = std::cend(zipped);
-    if (options.max_genotype_combinations) {
-        last_full_join = reduce(zipped, get_sample_reduction_count(*options.max_genotype_combinations), options.max_individual_log_probability_loss);
-    }
-    return make_reduction_map(zipped, last_full_join, options);
-}
-
-struct UniformPriorJointProbabilityHelper
-{
-    std::size_t index;
-    double probability;
-};
-
-bool operator==(const UniformPriorJointProbabilityHelper& lhs, const UniformPriorJointProbabilityHelper& rhs) noexcept
-{
-    return lhs.probability == rhs.probability;
-}
-bool operator!=(const UniformPriorJointProbabilityHelper& lhs, const UniformPriorJointProbabilityHelper& rhs) noexcept
-{
-    return lhs.probability != rhs.probability;
-}
-bool operator<(const UniformPriorJointProbabilityHelper& lhs, const UniformPriorJointProbabilityHelper& rhs) noexcept
-{
-    return lhs.probability < rhs.probability;
-}
-bool operator>(const UniformPriorJointProbabilityHelper& lhs, const UniformPriorJointProbabilityHelper& rhs) noexcept
-{
-    return lhs.probability > rhs.probability;
-}
-
-template <typename Iterator, typename UnaryOperation>
-auto index_zip(Iterator first, const Iterator last, UnaryOperation op)
-{
-    using T = typename std::iterator_traits<Iterator>::value_type;
-    using R = std::result_of_t<UnaryOperation(const T&)>;
-    const auto n = static_cast<std::size_t>(std::distance(first, last));
-    std::vector<std::pair<R, std::size_t>> result(n);
-    for (std::size_t idx {0}; idx < n; ++idx) {
-        result[idx] = std::make_pair(op(*first++), idx);
-    }
-    return result;
-}
-
-template <typename Iterator>
-auto order_indices_by_probability(const Iterator first, const Iterator last, std::size_t k)
-{
-    auto zipped = index_zip(first, last, [] (const auto& pair) { return pair.probability; });
-    k = std::min(zipped.size(), k);
-    const auto kth = std::next(std::begin(zipped), k);
-    std::partial_sort(std::begin(zipped), kth, std::end(zipped), std::greater<> {});
-    std::vector<std::size_t> result(k);
-    std::transform(std::begin(zipped), kth, std::begin(result), [] (const auto& p) { return p.second; });
-    return result;
-}
-
-template <typename Iterator, typename Container>
-auto select_top_k_haplotypes(const Iterator first, Iterator last, const std::size_t k, const Container& genotypes)
-{
-    const auto top_pair_indices = order_indices_by_probability(first, last, k);
-    std::set<Haplotype> result {};
-    for (const auto idx : top_pair_indices) {
-        if (result.size() >= k) break;
-        const auto& genotype = genotypes[std::next(first, idx)->genotype];
-        std::copy(std::cbegin(genotype), std::cend(genotype), std::inserter(result, std::begin(result)));
-    }
-    return result;
-}
-
-using ChildReductionMap = ReducedVectorMap<GenotypeIndexProbabilityPair>;
-
-template <typename Container>
-auto select_top_k_haplotypes(const ChildReductionMap& child, const std::size_t k, const Container& genotypes)
-{
-    return select_top_k_haplotypes(child.first, child.last_full_join, k, genotypes);
-}
-
-using ParentsProbabilityPairIterator = std::vector<ParentsProbabilityPair>::iterator;
-
-bool is_represented(const Haplotype& haplotype, const ParentsProbabilityPair& parent, const TrioGenotypeData& genotypes)
-{
-    return contains(genotypes.maternal[parent.maternal], haplotype) || contains(genotypes.paternal[parent.paternal], haplotype);
-}
-
-bool is_represented(const Haplotype& haplotype,
-                    const ParentsProbabilityPairIterator first_parent,
-                    const ParentsProbabilityPairIterator last_parent,
-                    const TrioGenotypeData& genotypes)
-{
-    return std::any_of(first_parent, last_parent, [&] (const auto& parent) { return is_represented(haplotype, parent, genotypes); });
-}
-
-auto find_represented(const Haplotype& haplotype,
-                      const ParentsProbabilityPairIterator first_parent,
-                      const ParentsProbabilityPairIterator last_parent,
-                      const TrioGenotypeData& genotypes)
-{
-    return std::find_if(first_parent, last_parent, [&] (const auto& parent) { return is_represented(haplotype, parent, genotypes); });
-}
-
-auto reduce(std::vector<ParentsProbabilityPair>& parents,
-            const ChildReductionMap& child,
-            const std::vector<GenotypeIndexProbabilityPair>& maternal_likelihoods,
-            const std::vector<GenotypeIndexProbabilityPair>& paternal_likelihoods,
-            const TrioGenotypeData& genotypes,
-            boost::optional<double>& lost_log_mass, 
-            const TrioModel::Options& options)
-{
-    if (!options.max_genotype_combinations) return make_reduction_map(parents, std::cend(parents), options);
-    const auto reduction_count = get_sample_reduction_count(*options.max_genotype_combinations);
-    auto last_full_join = reduce(parents, reduction_count, options.max_joint_log_probability_loss, lost_log_mass);
-    if (last_full_join != std::cend(parents)) {
-        std::vector<UniformPriorJointProbabilityHelper> uniform_parents(parents.size());
-        for (std::size_t i {0}; i < parents.size(); ++i) {
-            uniform_parents[i].index = i;
-            uniform_parents[i].probability = maternal_likelihoods[parents[i].maternal].probability + paternal_likelihoods[parents[i].paternal].probability;
-        }
-        uniform_parents.erase(reduce(uniform_parents, reduction_count, options.max_joint_log_probability_loss, lost_log_mass), std::cend(uniform_parents));
-        std::deque<std::size_t> new_indices {};
-        const auto num_posterior_joined = static_cast<std::size_t>(std::distance(std::begin(parents), last_full_join));
-        for (const auto& p : uniform_parents) {
-            if (p.index >= num_posterior_joined) {
-                new_indices.push_back(p.index);
-            }
-        }
-        uniform_parents.clear();
-        if (!new_indices.empty()) {
-            std::sort(std::begin(new_indices), std::end(new_indices));
-            auto curr_index = num_posterior_joined;
-            // Can use std::partition as it must do a single left-to-right pass due to ForwardIterator and complexity requirements
-            last_full_join = std::partition(last_full_join, std::end(parents), [&] (const auto& p) {
-                if (!new_indices.empty() && curr_index++ == new_indices.front()) {
-                    new_indices.pop_front();
-                    return true;
-                } else {
-                    return false;
-                }
-            });
-            assert(new_indices.empty());
-        }
-        // We want to make sure haplotypes that the child may have are survive to avoid false positive de novo child haplotypes
-        const auto top_child_haplotypes = select_top_k_haplotypes(child, 4, genotypes.child);
-        for (const auto& haplotype : top_child_haplotypes) {
-            if (!is_represented(haplotype, std::begin(parents), last_full_join, genotypes)) {
-                const auto first_represented_parent = find_represented(haplotype, last_full_join, std::end(parents), genotypes);
-                if (first_represented_parent != std::end(parents)) {
-                    std::iter_swap(first_represented_parent, last_full_join);
-                    ++last_full_join;
-                }
-            }
-        }
-    }
-    return make_reduction_map(parents, last_full_join, options);
-}
-
 bool are_parents_same_ploidy(const TrioGenotypeData& genotypes)
 {
     assert(!genotypes.maternal.empty() && !genotypes.paternal.empty());
     return genotypes.maternal.front().ploidy() == genotypes.paternal.front().ploidy();
 }
 
-auto reduce(std::vector<GenotypeIndexProbabilityPair>& likelihoods,
-            const PopulationPriorModel& prior_model,
-            boost::optional<double>& lost_log_mass,
-            const TrioModel::Options& options,
-            const TrioModel::GenotypeVector& genotypes)
-{
-    if (!options.max_genotype_combinations) return make_reduction_map(likelihoods, std::cend(likelihoods), options);
-    const auto reduction_count = get_sample_reduction_count(*options.max_genotype_combinations);
-    const auto last_likelihood_join = reduce(likelihoods, reduction_count, options.max_individual_log_probability_loss, lost_log_mass);
-    if (last_likelihood_join == std::end(likelihoods)) {
-        return make_reduction_map(likelihoods, std::cend(likelihoods), options);
-    } else if (lost_log_mass && *lost_log_mass > options.max_individual_log_probability_loss) {
-        return make_reduction_map(likelihoods, last_likelihood_join, options); // overflow
-    } else {
-        auto posteriors = compute_posteriors(likelihoods, prior_model, genotypes);
-        const auto last_posterior_join = reduce(posteriors, reduction_count, options.max_individual_log_probability_loss, lost_log_mass);
-        assert(last_posterior_join <= std::end(posteriors));
-        if (last_posterior_join != std::end(posteriors)) {
-            std::sort(std::begin(likelihoods), std::end(likelihoods), GenotypeIndexProbabilityPairGenotypeLess {});
-            std::sort(std::begin(posteriors), last_posterior_join, GenotypeIndexProbabilityPairGenotypeLess {});
-            std::vector<GenotypeIndexProbabilityPair> reordered_likelihoods {};
-            reordered_likelihoods.reserve(posteriors.size());
-            std::set_intersection(std::cbegin(likelihoods), std::cend(likelihoods),
-                                  std::begin(posteriors), last_posterior_join,
-                                  std::back_inserter(reordered_likelihoods),
-                                  GenotypeIndexProbabilityPairGenotypeLess {});
-            std::set_intersection(std::cbegin(likelihoods), std::cend(likelihoods),
-                                  last_posterior_join, std::end(posteriors),
-                                  std::back_inserter(reordered_likelihoods),
-                                  GenotypeIndexProbabilityPairGenotypeLess {});
-            likelihoods = std::move(reordered_likelihoods);
-            auto last_join = std::next(std::cbegin(likelihoods), std::distance(std::begin(posteriors), last_posterior_join));
-            return make_reduction_map(likelihoods, last_join, options);
-        } else {
-            return make_reduction_map(likelihoods, std::cend(likelihoods), options);
-        }
-    }
-}
-
 auto joint_probability(const Genotype<IndexedHaplotype<>>& mother, const Genotype<IndexedHaplotype<>>& father,
                        const PopulationPriorModel& model)
 {
     return model.evaluate({std::cref(mother), std::cref(father)});
 }
 
-auto joint_probability(const GenotypeIndexProbabilityPair& mother, const GenotypeIndexProbabilityPair& father,
-                       const TrioGenotypeData& genotypes, const PopulationPriorModel& model)
-{
-    return mother.probability + father.probability
-         + joint_probability(genotypes.maternal[mother.genotype], genotypes.paternal[father.genotype], model);
-}
-
-template <typename T1, typename T2>
-auto join_size(const ReducedVectorMap<T1>& first, const ReducedVectorMap<T2>& second) noexcept
-{
-    using std::distance;
-    std::size_t result {0};
-    result += distance(first.first, first.last_full_join) * distance(second.first, second.last_full_join);
-    result += distance(first.last_full_join, first.last) * distance(second.first, second.last_to_partially_join);
-    result += distance(second.last_full_join, second.last) * distance(first.first, first.last_to_partially_join);
-    return result;
-}
-
-auto join(const ReducedVectorMap<GenotypeIndexProbabilityPair>& maternal,
-          const ReducedVectorMap<GenotypeIndexProbabilityPair>& paternal,
-          const TrioGenotypeData& genotypes,
-          const PopulationPriorModel& model)
-{
-    std::vector<ParentsProbabilityPair> result {};
-    result.reserve(join_size(maternal, paternal));
-    std::for_each(maternal.first, maternal.last_full_join, [&] (const auto& m) {
-        std::for_each(paternal.first, paternal.last_full_join, [&] (const auto& p) {
-            result.push_back({joint_probability(m, p, genotypes, model), m.genotype, p.genotype});
-        });
-    });
-    std::for_each(maternal.last_full_join, maternal.last, [&] (const auto& m) {
-        std::for_each(paternal.first, paternal.last_to_partially_join, [&] (const auto& p) {
-            result.push_back({joint_probability(m, p, genotypes, model), m.genotype, p.genotype});
-        });
-    });
-    std::for_each(paternal.last_full_join, paternal.last, [&] (const auto& p) {
-        std::for_each(maternal.first, maternal.last_to_partially_join, [&] (const auto& m) {
-            result.push_back({joint_probability(m, p, genotypes, model), m.genotype, p.genotype});
-        });
-    });
-    return result;
-}
-
 template <typename G>
 bool all_haploid(const G& child, const G& mother, const G& father) noexcept
 {
@@ -667,77 +314,351 @@ template <> struct ProbabilityOfChildGivenParents<1, 1, 1>
 
 using JointProbability = TrioModel::Latents::JointProbability;
 
-template <typename F>
-auto joint_probability(const ParentsProbabilityPair& parents,
-                       const GenotypeIndexProbabilityPair& child,
-                       const TrioGenotypeData& genotypes,
-                       F joint_probability_function)
+template <typename JointFunctionVisitor>
+auto visit_joint_probability_function(const unsigned maternal_ploidy,
+                                      const unsigned paternal_ploidy,
+                                      const unsigned child_ploidy,
+                                      const DeNovoModel& mutation_model,
+                                      JointFunctionVisitor visitor)
 {
-    return parents.probability + child.probability
-           + joint_probability_function(genotypes.child[child.genotype], genotypes.maternal[parents.maternal], genotypes.paternal[parents.paternal]);
-}
-
-template <typename F>
-auto join(const ReducedVectorMap<ParentsProbabilityPair>& parents,
-          const ReducedVectorMap<GenotypeIndexProbabilityPair>& child,
-          const TrioGenotypeData& genotypes,
-          F jpdf)
-{
-    std::vector<JointProbability> result {};
-    result.reserve(join_size(parents, child));
-    std::for_each(parents.first, parents.last_full_join, [&] (const auto& p) {
-        std::for_each(child.first, child.last_full_join, [&] (const auto& c) {
-            result.push_back({joint_probability(p, c, genotypes, jpdf), 0.0, p.maternal, p.paternal, c.genotype});
-        });
-    });
-    std::for_each(parents.last_full_join, parents.last, [&] (const auto& p) {
-        std::for_each(child.first, child.last_to_partially_join, [&] (const auto& c) {
-            result.push_back({joint_probability(p, c, genotypes, jpdf), 0.0, p.maternal, p.paternal, c.genotype});
-        });
-    });
-    std::for_each(child.last_full_join, child.last, [&] (const auto& c) {
-        std::for_each(parents.first, parents.last_to_partially_join, [&] (const auto& p) {
-            result.push_back({joint_probability(p, c, genotypes, jpdf), 0.0, p.maternal, p.paternal, c.genotype});
-        });
-    });
-    return result;
-}
-
-auto join(const ReducedVectorMap<ParentsProbabilityPair>& parents,
-          const ReducedVectorMap<GenotypeIndexProbabilityPair>& child,
-          const TrioGenotypeData& genotypes,
-          const DeNovoModel& mutation_model)
-{
-    const auto maternal_ploidy = genotypes.maternal[parents.first->maternal].ploidy();
-    const auto paternal_ploidy = genotypes.paternal[parents.first->paternal].ploidy();
-    const auto child_ploidy    = genotypes.child[child.first->genotype].ploidy();
     if (child_ploidy == 1) {
         if (paternal_ploidy == 1) {
             if (maternal_ploidy == 0) {
-                return join(parents, child, genotypes, ProbabilityOfChildGivenParents<1, 0, 1> {mutation_model});
+                return visitor(ProbabilityOfChildGivenParents<1, 0, 1> {mutation_model});
             }
             if (maternal_ploidy == 1) {
-                return join(parents, child, genotypes, ProbabilityOfChildGivenParents<1, 1, 1> {mutation_model});
+                return visitor(ProbabilityOfChildGivenParents<1, 1, 1> {mutation_model});
             }
             if (maternal_ploidy == 2) {
-                return join(parents, child, genotypes, ProbabilityOfChildGivenParents<1, 2, 1> {mutation_model});
+                return visitor(ProbabilityOfChildGivenParents<1, 2, 1> {mutation_model});
             }
         }
     } else if (child_ploidy == 2) {
         if (maternal_ploidy == 2) {
             if (paternal_ploidy == 1) {
-                return join(parents, child, genotypes, ProbabilityOfChildGivenParents<2, 2, 1> {mutation_model});
+                return visitor(ProbabilityOfChildGivenParents<2, 2, 1> {mutation_model});
             }
             if (paternal_ploidy == 2) {
-                return join(parents, child, genotypes, ProbabilityOfChildGivenParents<2, 2, 2> {mutation_model});
+                return visitor(ProbabilityOfChildGivenParents<2, 2, 2> {mutation_model});
             }
         }
     } else if (child_ploidy == 3 && maternal_ploidy == 3 && paternal_ploidy == 3) {
-        return join(parents, child, genotypes, ProbabilityOfChildGivenParents<3, 3, 3> {mutation_model});
+        return visitor(ProbabilityOfChildGivenParents<3, 3, 3> {mutation_model});
     }
     throw std::runtime_error {"TrioModel: unimplemented joint probability function"};
 }
 
+// The joint search ranks each sample's genotypes by their likelihood plus their own population prior,
+// which stands in for the joint parental prior and the inheritance probability of the child
+auto compute_search_scores(const std::vector<GenotypeIndexProbabilityPair>& likelihoods,
+                           const PopulationPriorModel& prior_model,
+                           const TrioModel::GenotypeVector& genotypes)
+{
+    auto result = likelihoods;
+    for (auto& p : result) {
+        p.probability += prior_model.evaluate({genotypes[p.genotype]});
+    }
+    std::sort(std::begin(result), std::end(result), std::greater<> {});
+    return result;
+}
+
+void remove_negligible_genotypes(std::vector<GenotypeIndexProbabilityPair>& scores,
+                                 const TrioModel::Options& options,
+                                 boost::optional<double>& lost_log_mass)
+{
+    boost::optional<double> sample_lost_log_mass {};
+    const auto num_to_keep = compute_min_joint(scores, options.max_individual_log_probability_loss, sample_lost_log_mass);
+    scores.erase(std::next(std::cbegin(scores), num_to_keep), std::cend(scores));
+    if (sample_lost_log_mass) {
+        lost_log_mass = lost_log_mass ? std::max(*lost_log_mass, *sample_lost_log_mass) : *sample_lost_log_mass;
+    }
+}
+
+// A node in the best-first trio search. Indices are ranks into the sorted search scores, and the
+// score of a node is the sum of the three sample scores.
+struct TrioSearchNode
+{
+    double score, parents_prior;
+    bool has_parents_prior;
+    GenotypeIndex maternal, paternal, child;
+};
+
+bool operator<(const TrioSearchNode& lhs, const TrioSearchNode& rhs) noexcept
+{
+    return lhs.score < rhs.score;
+}
+
+// log(exp(a) - exp(b)) for a >= b
+double log_subtract_exp(const double a, const double b) noexcept
+{
+    if (b >= a) return std::numeric_limits<double>::lowest();
+    return a + std::log1p(-std::exp(b - a));
+}
+
+auto log_sum_probabilities(const std::vector<GenotypeIndexProbabilityPair>& scores)
+{
+    using boost::make_transform_iterator;
+    return maths::log_sum_exp(make_transform_iterator(std::cbegin(scores), ProbabilityGetter {}),
+                              make_transform_iterator(std::cend(scores), ProbabilityGetter {}));
+}
+
+struct TrioSearchData
+{
+    // likelihoods are indexed by genotype, scores are sorted
+    const std::vector<GenotypeIndexProbabilityPair>& maternal_likelihoods, paternal_likelihoods, child_likelihoods;
+    const std::vector<GenotypeIndexProbabilityPair>& maternal_scores, paternal_scores, child_scores;
+};
+
+using HaplotypeIndex = IndexedHaplotype<>::IndexType;
+
+void mark_represented(const Genotype<IndexedHaplotype<>>& genotype, std::vector<bool>& represented)
+{
+    for (const auto& haplotype : genotype) {
+        if (haplotype.index() >= represented.size()) represented.resize(haplotype.index() + 1, false);
+        represented[haplotype.index()] = true;
+    }
+}
+
+bool is_represented(const HaplotypeIndex haplotype, const std::vector<bool>& represented) noexcept
+{
+    return haplotype < represented.size() && represented[haplotype];
+}
+
+bool contains(const Genotype<IndexedHaplotype<>>& genotype, const HaplotypeIndex haplotype)
+{
+    return std::any_of(std::cbegin(genotype), std::cend(genotype),
+                       [=] (const auto& h) noexcept { return h.index() == haplotype; });
+}
+
+auto find_first_containing(const std::vector<GenotypeIndexProbabilityPair>& scores,
+                           const TrioModel::GenotypeVector& genotypes,
+                           const HaplotypeIndex haplotype)
+{
+    const auto itr = std::find_if(std::cbegin(scores), std::cend(scores),
+                                  [&] (const auto& p) { return contains(genotypes[p.genotype], haplotype); });
+    return static_cast<GenotypeIndex>(std::distance(std::cbegin(scores), itr));
+}
+
+// The child's top haplotypes and the number of top child genotypes they come from
+auto select_top_child_haplotypes(const TrioSearchData& data, const TrioGenotypeData& genotypes, const std::size_t k)
+{
+    std::vector<HaplotypeIndex> haplotypes {};
+    GenotypeIndex num_genotypes {0};
+    for (const auto& p : data.child_scores) {
+        if (haplotypes.size() >= k) break;
+        ++num_genotypes;
+        for (const auto& haplotype : genotypes.child[p.genotype]) {
+            if (std::find(std::cbegin(haplotypes), std::cend(haplotypes), haplotype.index()) == std::cend(haplotypes)) {
+                haplotypes.push_back(haplotype.index());
+            }
+        }
+    }
+    return std::make_pair(std::move(haplotypes), num_genotypes);
+}
+
+template <typename F>
+auto best_first_join(const TrioSearchData& data,
+                     const TrioGenotypeData& genotypes,
+                     const PopulationPriorModel& prior_model,
+                     F jpdf,
+                     const TrioModel::Options& options,
+                     boost::optional<double>& lost_log_mass)
+{
+    // Enumerates (mother, father, child) in non-increasing order of their search score without building any
+    // cross products. Each triple (i, j, k) has a unique predecessor ((i, j, k - 1), (i, j - 1, 0), or
+    // (i - 1, 0, 0)) with a score at least as large, so the frontier is always a valid best-first queue and
+    // no visited set is required.
+    // The search is heuristic: the search score uses each sample's own population prior in place of the
+    // joint parental prior and inheritance probability, so it is not a bound on the joint probability and
+    // joints are not visited in exact joint probability order. The sum of all scores factorises over
+    // samples, so the unvisited score mass is known exactly and is used as the estimate of the lost joint
+    // mass; the search stops once this falls below max_joint_log_probability_loss.
+    assert(!data.maternal_scores.empty() && !data.paternal_scores.empty() && !data.child_scores.empty());
+    using maths::log_sum_exp;
+    const auto total_score_mass = log_sum_probabilities(data.maternal_scores)
+                                + log_sum_probabilities(data.paternal_scores)
+                                + log_sum_probabilities(data.child_scores);
+    const auto max_joint = options.max_genotype_combinations ? std::max(*options.max_genotype_combinations, std::size_t {1})
+                                                             : std::numeric_limits<std::size_t>::max();
+    // The child haplotype safeguard joins below are taken from the max_genotype_combinations budget
+    const auto top_child_haplotypes = select_top_child_haplotypes(data, genotypes, 4);
+    const auto max_safeguard_joint = top_child_haplotypes.first.size() * top_child_haplotypes.second;
+    const auto max_search_joint = max_joint > max_safeguard_joint ? max_joint - max_safeguard_joint : std::size_t {1};
+    const auto make_node = [&] (GenotypeIndex m, GenotypeIndex p, GenotypeIndex c) noexcept -> TrioSearchNode {
+        const auto score = data.maternal_scores[m].probability + data.paternal_scores[p].probability + data.child_scores[c].probability;
+        return {score, 0.0, false, m, p, c};
+    };
+    const auto evaluate_parents_prior = [&] (const TrioSearchNode& node) {
+        const auto mother = data.maternal_scores[node.maternal].genotype, father = data.paternal_scores[node.paternal].genotype;
+        return joint_probability(genotypes.maternal[mother], genotypes.paternal[father], prior_model);
+    };
+    const auto evaluate_joint = [&] (const TrioSearchNode& node) -> JointProbability {
+        const auto mother = data.maternal_scores[node.maternal].genotype;
+        const auto father = data.paternal_scores[node.paternal].genotype;
+        const auto child  = data.child_scores[node.child].genotype;
+        const auto log_probability = data.maternal_likelihoods[mother].probability
+                                   + data.paternal_likelihoods[father].probability
+                                   + data.child_likelihoods[child].probability
+                                   + node.parents_prior
+                                   + jpdf(genotypes.child[child], genotypes.maternal[mother], genotypes.paternal[father]);
+        return {log_probability, 0.0, mother, father, child};
+    };
+    const auto num_maternal = static_cast<GenotypeIndex>(data.maternal_scores.size());
+    const auto num_paternal = static_cast<GenotypeIndex>(data.paternal_scores.size());
+    const auto num_child    = static_cast<GenotypeIndex>(data.child_scores.size());
+    std::priority_queue<TrioSearchNode> frontier {};
+    frontier.push(make_node(0, 0, 0));
+    std::vector<JointProbability> result {};
+    std::vector<bool> represented_parent_haplotypes {};
+    auto visited_score_mass = std::numeric_limits<double>::lowest();
+    auto remaining_score_mass = total_score_mass;
+    while (!frontier.empty() && result.size() < max_search_joint) {
+        auto node = frontier.top();
+        frontier.pop();
+        if (!node.has_parents_prior) {
+            node.parents_prior = evaluate_parents_prior(node);
+            node.has_parents_prior = true;
+        }
+        result.push_back(evaluate_joint(node));
+        visited_score_mass = result.size() == 1 ? node.score : log_sum_exp(visited_score_mass, node.score);
+        if (node.child + 1 < num_child) {
+            auto successor = make_node(node.maternal, node.paternal, node.child + 1);
+            successor.parents_prior = node.parents_prior; // same parents
+            successor.has_parents_prior = true;
+            frontier.push(successor);
+        }
+        if (node.child == 0) {
+            // first visit of these parents
+            mark_represented(genotypes.maternal[data.maternal_scores[node.maternal].genotype], represented_parent_haplotypes);
+            mark_represented(genotypes.paternal[data.paternal_scores[node.paternal].genotype], represented_parent_haplotypes);
+            if (node.paternal + 1 < num_paternal) {
+                frontier.push(make_node(node.maternal, node.paternal + 1, 0));
+            }
+            if (node.paternal == 0 && node.maternal + 1 < num_maternal) {
+                frontier.push(make_node(node.maternal + 1, 0, 0));
+            }
+        }
+        remaining_score_mass = log_subtract_exp(total_score_mass, visited_score_mass);
+        if (remaining_score_mass - total_score_mass < options.max_joint_log_probability_loss) break;
+    }
+    if (!frontier.empty()) {
+        const auto lost_mass = remaining_score_mass - total_score_mass;
+        lost_log_mass = lost_log_mass ? std::max(*lost_log_mass, lost_mass) : lost_mass;
+        // We want to make sure haplotypes that the child may have are represented in some parent to avoid
+        // false positive de novo child haplotypes. Parents that haven't been visited are joined with the
+        // child genotypes the haplotypes were selected from.
+        for (const auto haplotype : top_child_haplotypes.first) {
+            if (result.size() >= max_joint) break;
+            if (is_represented(haplotype, represented_parent_haplotypes)) continue;
+            const auto maternal = find_first_containing(data.maternal_scores, genotypes.maternal, haplotype);
+            const auto paternal = find_first_containing(data.paternal_scores, genotypes.paternal, haplotype);
+            if (maternal == num_maternal && paternal == num_paternal) continue;
+            auto parents = paternal == num_paternal ? make_node(maternal, 0, 0) : make_node(0, paternal, 0);
+            if (maternal < num_maternal && paternal < num_paternal) {
+                const auto with_mother = make_node(maternal, 0, 0);
+                if (with_mother.score > parents.score) parents = with_mother;
+            }
+            parents.parents_prior = evaluate_parents_prior(parents);
+            for (GenotypeIndex child {0}; child < top_child_haplotypes.second && result.size() < max_joint; ++child) {
+                parents.child = child;
+                result.push_back(evaluate_joint(parents));
+            }
+            mark_represented(genotypes.maternal[data.maternal_scores[parents.maternal].genotype], represented_parent_haplotypes);
+            mark_represented(genotypes.paternal[data.paternal_scores[parents.paternal].genotype], represented_parent_haplotypes);
+        }
+    }
+    return result;
+}
+
+auto best_first_join(const TrioSearchData& data,
+                     const TrioGenotypeData& genotypes,
+                     const PopulationPriorModel& prior_model,
+                     const DeNovoModel& mutation_model,
+                     const TrioModel::Options& options,
+                     boost::optional<double>& lost_log_mass)
+{
+    const auto maternal_ploidy = genotypes.maternal[data.maternal_scores.front().genotype].ploidy();
+    const auto paternal_ploidy = genotypes.paternal[data.paternal_scores.front().genotype].ploidy();
+    const auto child_ploidy    = genotypes.child[data.child_scores.front().genotype].ploidy();
+    return visit_joint_probability_function(maternal_ploidy, paternal_ploidy, child_ploidy, mutation_model,
+                                            [&] (auto jpdf) {
+                                                return best_first_join(data, genotypes, prior_model, jpdf, options, lost_log_mass);
+                                            });
+}
+
+auto probability_of_child_given_parent(const Genotype<IndexedHaplotype<>>& child,
+                                       const Genotype<IndexedHaplotype<>>& parent,
+                                       const DeNovoModel& mutation_model)
+{
+    if (is_haploid(child) && is_haploid(parent)) {
+        return mutation_model.evaluate(child[0], parent[0]);
+    }
+    return 0.0; // TODO
+}
+
+// A node in the best-first allosome search, which is the two sample analogue of TrioSearchNode
+struct AllosomeSearchNode
+{
+    double score;
+    GenotypeIndex parent, child;
+};
+
+bool operator<(const AllosomeSearchNode& lhs, const AllosomeSearchNode& rhs) noexcept
+{
+    return lhs.score < rhs.score;
+}
+
+// As the trio best_first_join, but joining one parent with the child
+auto best_first_join(const std::vector<GenotypeIndexProbabilityPair>& parent_likelihoods,
+                     const std::vector<GenotypeIndexProbabilityPair>& child_likelihoods,
+                     const std::vector<GenotypeIndexProbabilityPair>& parent_scores,
+                     const std::vector<GenotypeIndexProbabilityPair>& child_scores,
+                     const TrioModel::GenotypeVector& parent_genotypes,
+                     const TrioModel::GenotypeVector& child_genotypes,
+                     const DeNovoModel& mutation_model,
+                     const TrioModel::Options& options,
+                     boost::optional<double>& lost_log_mass)
+{
+    assert(!parent_scores.empty() && !child_scores.empty());
+    using maths::log_sum_exp;
+    const auto total_score_mass = log_sum_probabilities(parent_scores) + log_sum_probabilities(child_scores);
+    const auto max_joint = options.max_genotype_combinations ? std::max(*options.max_genotype_combinations, std::size_t {1})
+                                                             : std::numeric_limits<std::size_t>::max();
+    const auto make_node = [&] (GenotypeIndex p, GenotypeIndex c) noexcept -> AllosomeSearchNode {
+        return {parent_scores[p].probability + child_scores[c].probability, p, c};
+    };
+    const auto num_parent = static_cast<GenotypeIndex>(parent_scores.size());
+    const auto num_child  = static_cast<GenotypeIndex>(child_scores.size());
+    std::priority_queue<AllosomeSearchNode> frontier {};
+    frontier.push(make_node(0, 0));
+    std::vector<JointProbability> result {};
+    auto visited_score_mass = std::numeric_limits<double>::lowest();
+    auto remaining_score_mass = total_score_mass;
+    while (!frontier.empty() && result.size() < max_joint) {
+        const auto node = frontier.top();
+        frontier.pop();
+        const auto parent = parent_scores[node.parent].genotype;
+        const auto child  = child_scores[node.child].genotype;
+        const auto log_probability = parent_likelihoods[parent].probability + child_likelihoods[child].probability
+                                   + probability_of_child_given_parent(child_genotypes[child], parent_genotypes[parent], mutation_model);
+        result.push_back({log_probability, 0.0, parent, parent, child});
+        visited_score_mass = result.size() == 1 ? node.score : log_sum_exp(visited_score_mass, node.score);
+        if (node.child + 1 < num_child) {
+            frontier.push(make_node(node.parent, node.child + 1));
+        }
+        if (node.child == 0 && node.parent + 1 < num_parent) {
+            frontier.push(make_node(node.parent + 1, 0));
+        }
+        remaining_score_mass = log_subtract_exp(total_score_mass, visited_score_mass);
+        if (remaining_score_mass - total_score_mass < options.max_joint_log_probability_loss) break;
+    }
+    if (!frontier.empty()) {
+        const auto lost_mass = remaining_score_mass - total_score_mass;
+        lost_log_mass = lost_log_mass ? std::max(*lost_log_mass, lost_mass) : lost_mass;
+    }
+    return result;
+}
+
 auto extract_probabilities(const std::vector<JointProbability>& joint_likelihoods)
 {
     std::vector<double> result(joint_likelihoods.size());
@@ -771,9 +692,6 @@ void print(const std::string& sample,
            const Container& genotypes, const std::vector<GenotypeIndexProbabilityPair>& ps,
            std::size_t n = 5);
 template <typename S>
-void print(S&& stream, const TrioGenotypeData& genotypes, std::vector<ParentsProbabilityPair> ps, std::size_t n = 5);
-void print(const TrioGenotypeData& genotypes, std::vector<ParentsProbabilityPair> ps, std::size_t n = 5);
-template <typename S>
 void print(S&& stream, const TrioGenotypeData& genotypes, std::vector<JointProbability> ps, std::size_t n = 5);
 void print(const TrioGenotypeData& genotypes, std::vector<JointProbability> ps, std::size_t n = 5);
 
@@ -808,26 +726,23 @@ TrioModel::evaluate(const GenotypeVector& maternal_genotypes,
         debug::print(stream(*debug_log_), "child", genotypes.child, child_likelihoods);
     }
     boost::optional<double> lost_log_mass {};
-    auto reduced_maternal_likelihoods = maternal_likelihoods;
-    const auto reduced_maternal_likelihoods_info = reduce(reduced_maternal_likelihoods, prior_model_, lost_log_mass, options_, genotypes.maternal);
-    auto reduced_paternal_likelihoods = paternal_likelihoods;
-    const auto reduced_paternal_likelihoods_info = reduce(reduced_paternal_likelihoods, prior_model_, lost_log_mass, options_, genotypes.paternal);
-    const auto reduced_child_likelihoods_info    = reduce(child_likelihoods, prior_model_, lost_log_mass, options_, genotypes.child);
-    auto parental_likelihoods = join(reduced_maternal_likelihoods_info, reduced_paternal_likelihoods_info, genotypes, prior_model_);
-    if (debug_log_) debug::print(stream(*debug_log_), genotypes, parental_likelihoods);
-    const auto reduced_parental_likelihoods = reduce(parental_likelihoods, reduced_child_likelihoods_info, maternal_likelihoods, paternal_likelihoods, genotypes, lost_log_mass, options_);
-    maternal_likelihoods.clear();
-    maternal_likelihoods.shrink_to_fit();
-    reduced_maternal_likelihoods.clear();
-    reduced_maternal_likelihoods.shrink_to_fit();
-    paternal_likelihoods.clear();
-    paternal_likelihoods.shrink_to_fit();
-    reduced_paternal_likelihoods.clear();
-    reduced_paternal_likelihoods.shrink_to_fit();
-    auto joint_likelihoods = join(reduced_parental_likelihoods, reduced_child_likelihoods_info, genotypes, mutation_model_);
+    auto maternal_scores = compute_search_scores(maternal_likelihoods, prior_model_, genotypes.maternal);
+    remove_negligible_genotypes(maternal_scores, options_, lost_log_mass);
+    auto paternal_scores = compute_search_scores(paternal_likelihoods, prior_model_, genotypes.paternal);
+    remove_negligible_genotypes(paternal_scores, options_, lost_log_mass);
+    auto child_scores = compute_search_scores(child_likelihoods, prior_model_, genotypes.child);
+    remove_negligible_genotypes(child_scores, options_, lost_log_mass);
+    const TrioSearchData search_data {maternal_likelihoods, paternal_likelihoods, child_likelihoods,
+                                      maternal_scores, paternal_scores, child_scores};
+    auto joint_likelihoods = best_first_join(search_data, genotypes, prior_model_, mutation_model_, options_, lost_log_mass);
+    clear(maternal_likelihoods);
+    clear(paternal_likelihoods);
+    clear(child_likelihoods);
+    clear(maternal_scores);
+    clear(paternal_scores);
+    clear(child_scores);
     if (debug_log_) debug::print(stream(*debug_log_), genotypes, joint_likelihoods);
     const auto evidence = normalise_exp(joint_likelihoods);
-    if (lost_log_mass) *lost_log_mass *= 2 * std::distance(reduced_child_likelihoods_info.first, reduced_child_likelihoods_info.last_full_join);
     return {std::move(joint_likelihoods), evidence, lost_log_mass};
 }
 
@@ -837,52 +752,6 @@ TrioModel::evaluate(const GenotypeVector& genotypes, const HaplotypeLikelihoodAr
     return evaluate(genotypes, genotypes, genotypes, haplotype_likelihoods);
 }
 
-auto probability_of_child_given_parent(const Genotype<IndexedHaplotype<>>& child,
-                                       const Genotype<IndexedHaplotype<>>& parent,
-                                       const DeNovoModel& mutation_model)
-{
-    if (is_haploid(child) && is_haploid(parent)) {
-        return mutation_model.evaluate(child[0], parent[0]);
-    }
-    return 0.0; // TODO
-}
-
-auto joint_probability(const GenotypeIndexProbabilityPair& parent,
-                       const GenotypeIndexProbabilityPair& child,
-                       const TrioModel::GenotypeVector& parent_genotypes,
-                       const TrioModel::GenotypeVector& child_genotypes,
-                       const DeNovoModel& mutation_model)
-{
-    return parent.probability + child.probability
-           + probability_of_child_given_parent(child_genotypes[child.genotype], parent_genotypes[parent.genotype], mutation_model);
-}
-
-auto join(const ReducedVectorMap<GenotypeIndexProbabilityPair>& parent,
-          const ReducedVectorMap<GenotypeIndexProbabilityPair>& child,
-          const TrioModel::GenotypeVector& parent_genotypes,
-          const TrioModel::GenotypeVector& child_genotypes,
-          const DeNovoModel& mutation_model)
-{
-    std::vector<JointProbability> result {};
-    result.reserve(join_size(parent, child));
-    std::for_each(parent.first, parent.last_full_join, [&] (const auto& p) {
-        std::for_each(child.first, child.last_full_join, [&] (const auto& c) {
-            result.push_back({joint_probability(p, c, parent_genotypes, child_genotypes, mutation_model), 0.0, p.genotype, p.genotype, c.genotype});
-        });
-    });
-    std::for_each(parent.last_full_join, parent.last, [&] (const auto& p) {
-        std::for_each(child.first, child.last_to_partially_join, [&] (const auto& c) {
-            result.push_back({joint_probability(p, c, parent_genotypes, child_genotypes, mutation_model), 0.0, p.genotype, p.genotype, c.genotype});
-        });
-    });
-    std::for_each(child.last_full_join, child.last, [&] (const auto& c) {
-        std::for_each(parent.first, parent.last_to_partially_join, [&] (const auto& p) {
-            result.push_back({joint_probability(p, c, parent_genotypes, child_genotypes, mutation_model), 0.0, p.genotype, p.genotype, c.genotype});
-        });
-    });
-    return result;
-}
-
 TrioModel::InferredLatents
 TrioModel::evaluate_allosome(const GenotypeVector& parent_genotypes,
                              const GenotypeVector& child_genotypes,
@@ -893,16 +762,20 @@ TrioModel::evaluate_allosome(const GenotypeVector& parent_genotypes,
     assert(haplotype_likelihoods.is_primed());
     auto child_likelihoods = compute_likelihoods(child_genotypes, likelihood_model);
     if (debug_log_) debug::print(stream(*debug_log_), "child", child_genotypes, child_likelihoods);
-    boost::optional<double> lost_log_mass {};
-    const auto reduced_child_likelihoods = reduce(child_likelihoods, prior_model_, lost_log_mass, options_, child_genotypes);
     auto parent_likelihoods = compute_likelihoods(parent_genotypes, likelihood_model);
     if (debug_log_) debug::print(stream(*debug_log_), "parent", child_genotypes, parent_likelihoods);
-    const auto reduced_parent_likelihoods = reduce(parent_likelihoods, prior_model_, lost_log_mass, options_, parent_genotypes);
     haplotype_likelihoods.prime(trio_.child());
-    auto joint_likelihoods = join(reduced_parent_likelihoods, reduced_child_likelihoods, parent_genotypes, child_genotypes, mutation_model_);
-    if (lost_log_mass) *lost_log_mass *= 2 * std::distance(reduced_child_likelihoods.first, reduced_child_likelihoods.last_full_join);
+    boost::optional<double> lost_log_mass {};
+    auto parent_scores = compute_search_scores(parent_likelihoods, prior_model_, parent_genotypes);
+    remove_negligible_genotypes(parent_scores, options_, lost_log_mass);
+    auto child_scores = compute_search_scores(child_likelihoods, prior_model_, child_genotypes);
+    remove_negligible_genotypes(child_scores, options_, lost_log_mass);
+    auto joint_likelihoods = best_first_join(parent_likelihoods, child_likelihoods, parent_scores, child_scores,
+                                             parent_genotypes, child_genotypes, mutation_model_, options_, lost_log_mass);
     clear(parent_likelihoods);
     clear(child_likelihoods);
+    clear(parent_scores);
+    clear(child_scores);
     const auto evidence = normalise_exp(joint_likelihoods);
     if (debug_log_) {
         const TrioGenotypeData genotypes {parent_genotypes, parent_genotypes, child_genotypes};
@@ -941,28 +814,6 @@ void print(const std::string& sample,
     print(std::cout, sample, genotypes, std::move(ps), n);
 }
 
-template <typename S>
-void print(S&& stream, const TrioGenotypeData& genotypes, std::vector<ParentsProbabilityPair> ps, const std::size_t n)
-{
-    stream << "joint parents" << ":\n";
-    const auto nth = std::next(std::begin(ps), std::min(ps.size(), n));
-    std::partial_sort(std::begin(ps), nth, std::end(ps),
-                      [] (const auto& lhs, const auto& rhs) {
-                          return lhs.probability > rhs.probability;
-                      });
-    std::for_each(std::begin(ps), nth, [&] (const auto& p) {
-        using octopus::debug::print_variant_alleles;
-        print_variant_alleles(stream, genotypes.maternal[p.maternal]);
-        stream << " | ";
-        print_variant_alleles(stream, genotypes.paternal[p.paternal]);
-        stream << " " << p.probability << "\n";
-    });
-}
-
-void print(const TrioGenotypeData& genotypes, std::vector<ParentsProbabilityPair> ps, std::size_t n)
-{
-    print(std::cout, genotypes, std::move(ps), n);
-}
 
 template <typename S>
 void print(S&& stream, const TrioGenotypeData& genotypes, std::vector<JointProbability> ps, const std::size_t n)
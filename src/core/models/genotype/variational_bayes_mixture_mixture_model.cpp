@@ -199,23 +199,18 @@ auto inner_product(const T1& lhs, const T2& rhs) noexcept
     return std::inner_product(std::cbegin(lhs), std::cend(lhs), std::cbegin(rhs), T {0});
 }
 
-template <typename T>
-inline auto digamma_diff(const T a, const T b)
-{
-    using boost::math::digamma;
-    return digamma(a) - digamma(b);
-}
-
 template <typename T>
 auto dirichlet_expectation_log(const std::vector<T>& concentrations)
 {
-    std::vector<T> result(concentrations.size());
     if (concentrations.size() > 1) {
-        const auto alpha_0 = sum(concentrations);
-        std::transform(std::cbegin(concentrations), std::cend(concentrations), std::begin(result),
-                       [=] (auto alpha) { return digamma_diff(alpha, alpha_0); });
+        const auto digamma_0 = boost::math::digamma(sum(concentrations));
+        auto result = concentrations;
+        maths::digamma_each(result);
+        for (auto& x : result) x -= digamma_0;
+        return result;
+    } else {
+        return std::vector<T>(concentrations.size());
     }
-    return result;
 }
 
 template <typename T>
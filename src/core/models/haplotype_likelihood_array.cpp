@@ -6,11 +6,47 @@
 #include <utility>
 #include <cassert>
 #include <deque>
+#include <limits>
+#include <algorithm>
+
+#include <boost/functional/hash.hpp>
 
 #include "utils/erase_if.hpp"
 
 namespace octopus {
 
+namespace {
+
+// The haplotype kmer table and mapping counts are cleared after each haplotype, so are kept by
+// each thread rather than being reallocated for every population
+
+template <unsigned char K>
+KmerHashTable& get_haplotype_hashes()
+{
+    thread_local KmerHashTable result {init_kmer_hash_table<K>()};
+    clear_kmer_hash_table(result);
+    return result;
+}
+
+MappedIndexCounts& get_mapping_counts(const KmerHashTable& haplotype_hashes)
+{
+    thread_local MappedIndexCounts result {};
+    result.assign(haplotype_hashes.second, 0);
+    return result;
+}
+
+// Reads are copied into each active region so are identified by content
+std::uint64_t fingerprint(const AlignedRead& read)
+{
+    std::size_t result {ReadHash {}(read)};
+    boost::hash_combine(result, read.name());
+    boost::hash_combine(result, read.sequence());
+    boost::hash_combine(result, read.is_marked_reverse_mapped());
+    return result;
+}
+
+} // namespace
+
 // public methods
 
 HaplotypeLikelihoodArray::HaplotypeLikelihoodArray(const unsigned num_haplotypes_hint,
@@ -47,6 +83,16 @@ HaplotypeLikelihoodArray::TemplatePacket::TemplatePacket(Iterator first, Iterato
 , num_templates {static_cast<std::size_t>(std::distance(first, last))}
 {}
 
+void HaplotypeLikelihoodArray::set_read_annotations(const ReadAnnotationMap& annotations) noexcept
+{
+    read_annotations_ = std::cref(annotations);
+}
+
+void HaplotypeLikelihoodArray::clear_read_annotations() noexcept
+{
+    read_annotations_ = boost::none;
+}
+
 void HaplotypeLikelihoodArray::populate(const ReadMap& reads,
                                         const MappableBlock<Haplotype>& haplotypes,
                                         boost::optional<FlankState> flank_state)
@@ -61,36 +107,78 @@ void HaplotypeLikelihoodArray::populate(const ReadMap& reads,
     assert(reads.size() == read_iterators_.size());
     const auto num_samples = reads.size();
     // Precompute all read hashes so we don't have to recompute for each haplotype
-    std::vector<std::vector<KmerPerfectHashes>> read_hashes {};
+    auto& arena = thread_scratch_arena();
+    const ScratchArena::Scope scratch {arena};
+    KmerHashesBuffer computed_read_hashes {arena};
+    ScratchVector<ScratchVector<KmerHashesRef>> read_hashes {arena};
+    ScratchVector<ScratchVector<std::uint64_t>> read_fingerprints {arena};
+    // The best likelihood of each read over the haplotypes evaluated so far, which bounds later evaluations
+    ScratchVector<ScratchVector<LogProbability>> best_likelihoods {arena};
     read_hashes.reserve(num_samples);
+    read_fingerprints.reserve(num_samples);
+    best_likelihoods.reserve(num_samples);
     for (const auto& t : read_iterators_) {
-        std::vector<KmerPerfectHashes> sample_read_hashes {};
+        ScratchVector<KmerHashesRef> sample_read_hashes {arena};
         sample_read_hashes.reserve(t.num_reads);
         std::transform(t.first, t.last, std::back_inserter(sample_read_hashes),
-                       [] (const AlignedRead& read) { return compute_kmer_hashes<mapperKmerSize>(read.sequence()); });
+                       [&] (const AlignedRead& read) { return get_kmer_hashes(read, computed_read_hashes); });
         read_hashes.emplace_back(std::move(sample_read_hashes));
+        ScratchVector<std::uint64_t> sample_read_fingerprints {arena};
+        sample_read_fingerprints.reserve(t.num_reads);
+        std::transform(t.first, t.last, std::back_inserter(sample_read_fingerprints),
+                       [] (const AlignedRead& read) { return fingerprint(read); });
+        read_fingerprints.emplace_back(std::move(sample_read_fingerprints));
+        best_likelihoods.emplace_back(t.num_reads, std::numeric_limits<LogProbability>::lowest(), arena);
     }
-    auto haplotype_hashes = init_kmer_hash_table<mapperKmerSize>();
+    const auto& early_exit_margin = likelihood_model_.config().early_exit_margin;
+    // Only likelihoods used by this population are kept for the next one
+    std::swap(reusable_likelihoods_, previous_reusable_likelihoods_);
+    reusable_likelihoods_.clear();
+    auto& haplotype_hashes = get_haplotype_hashes<mapperKmerSize>();
     const auto first_mapping_position = std::begin(mapping_positions_);
     likelihoods_.resize(haplotypes.size(), std::vector<LikelihoodVector>(num_samples));
     for (std::size_t haplotype_idx {0}; haplotype_idx < haplotypes.size(); ++haplotype_idx) {
         const auto& haplotype = haplotypes[haplotype_idx];
         populate_kmer_hash_table<mapperKmerSize>(haplotype.sequence(), haplotype_hashes);
-        auto haplotype_mapping_counts = init_mapping_counts(haplotype_hashes);
+        auto& haplotype_mapping_counts = get_mapping_counts(haplotype_hashes);
         likelihood_model_.reset(haplotype, flank_state);
         for (std::size_t sample_idx {0}; sample_idx < num_samples; ++sample_idx) {
             auto& likelihoods = likelihoods_[haplotype_idx][sample_idx];
             const auto& t = read_iterators_[sample_idx];
             likelihoods.resize(t.num_reads);
-            std::transform(t.first, t.last, std::cbegin(read_hashes[sample_idx]), std::begin(likelihoods),
-                           [&] (const AlignedRead& read, const auto& read_hashes) {
-                               const auto last_mapping_position = map_query_to_target(read_hashes, haplotype_hashes,
-                                                                                      haplotype_mapping_counts,
-                                                                                      first_mapping_position,
-                                                                                      maxMappingPositions);
-                               reset_mapping_counts(haplotype_mapping_counts);
-                               return likelihood_model_.evaluate(read, first_mapping_position, last_mapping_position);
-                           });
+            auto read_itr = t.first;
+            for (std::size_t read_idx {0}; read_idx < t.num_reads; ++read_idx, ++read_itr) {
+                const AlignedRead& read {*read_itr};
+                const auto last_mapping_position = map_query_to_target(read_hashes[sample_idx][read_idx].get(), haplotype_hashes,
+                                                                       haplotype_mapping_counts,
+                                                                       first_mapping_position,
+                                                                       maxMappingPositions);
+                reset_mapping_counts(haplotype_mapping_counts);
+                auto& best_likelihood = best_likelihoods[sample_idx][read_idx];
+                const auto window = likelihood_model_.window_fingerprint(read, first_mapping_position, last_mapping_position);
+                if (window) {
+                    const ReusableLikelihoodKey key {read_fingerprints[sample_idx][read_idx], *window};
+                    auto reused_itr = reusable_likelihoods_.find(key);
+                    if (reused_itr == std::cend(reusable_likelihoods_)) {
+                        const auto previous_itr = previous_reusable_likelihoods_.find(key);
+                        if (previous_itr != std::cend(previous_reusable_likelihoods_)) {
+                            reused_itr = reusable_likelihoods_.emplace(key, previous_itr->second).first;
+                        }
+                    }
+                    if (reused_itr != std::cend(reusable_likelihoods_)) {
+                        likelihoods[read_idx] = reused_itr->second;
+                    } else {
+                        likelihoods[read_idx] = likelihood_model_.evaluate(read, first_mapping_position, last_mapping_position, best_likelihood);
+                        // Likelihoods capped by an early exit depend on the other haplotypes so are not reusable
+                        if (!early_exit_margin || likelihoods[read_idx] >= best_likelihood - *early_exit_margin) {
+                            reusable_likelihoods_.emplace(key, likelihoods[read_idx]);
+                        }
+                    }
+                } else {
+                    likelihoods[read_idx] = likelihood_model_.evaluate(read, first_mapping_position, last_mapping_position, best_likelihood);
+                }
+                best_likelihood = std::max(likelihoods[read_idx], best_likelihood);
+            }
         }
         clear_kmer_hash_table(haplotype_hashes);
         haplotype_indices_.emplace(haplotype, haplotype_idx);
@@ -112,26 +200,29 @@ void HaplotypeLikelihoodArray::populate(const TemplateMap& reads,
     assert(reads.size() == template_iterators_.size());
     const auto num_samples = reads.size();
     // Precompute all read hashes so we don't have to recompute for each haplotype
-    std::vector<std::vector<std::vector<KmerPerfectHashes>>> template_hashes {};
+    auto& arena = thread_scratch_arena();
+    const ScratchArena::Scope scratch {arena};
+    KmerHashesBuffer computed_read_hashes {arena};
+    ScratchVector<ScratchVector<ScratchVector<KmerHashesRef>>> template_hashes {arena};
     template_hashes.reserve(num_samples);
     for (const auto& t : template_iterators_) {
-        std::vector<std::vector<KmerPerfectHashes>> sample_read_hashes {};
+        ScratchVector<ScratchVector<KmerHashesRef>> sample_read_hashes {arena};
         sample_read_hashes.reserve(t.num_templates);
-        std::transform(t.first, t.last, std::back_inserter(sample_read_hashes), [] (const AlignedTemplate& reads) {
-            std::vector<KmerPerfectHashes> result {};
+        std::transform(t.first, t.last, std::back_inserter(sample_read_hashes), [&] (const AlignedTemplate& reads) {
+            ScratchVector<KmerHashesRef> result {arena};
             result.reserve(reads.size());
-            for (const auto& read : reads) result.push_back(compute_kmer_hashes<mapperKmerSize>(read.sequence()));
+            for (const auto& read : reads) result.push_back(get_kmer_hashes(read, computed_read_hashes));
             return result;
         });
         template_hashes.emplace_back(std::move(sample_read_hashes));
     }
-    auto haplotype_hashes = init_kmer_hash_table<mapperKmerSize>();
+    auto& haplotype_hashes = get_haplotype_hashes<mapperKmerSize>();
     thread_local std::vector<HaplotypeLikelihoodModel::MappingPositionVector> mapping_positions {};
     likelihoods_.resize(haplotypes.size(), std::vector<LikelihoodVector>(num_samples));
     for (std::size_t haplotype_idx {0}; haplotype_idx < haplotypes.size(); ++haplotype_idx) {
         const auto& haplotype = haplotypes[haplotype_idx];
         populate_kmer_hash_table<mapperKmerSize>(haplotype.sequence(), haplotype_hashes);
-        auto haplotype_mapping_counts = init_mapping_counts(haplotype_hashes);
+        auto& haplotype_mapping_counts = get_mapping_counts(haplotype_hashes);
         likelihood_model_.reset(haplotype, flank_state);
         for (std::size_t sample_idx {0}; sample_idx < num_samples; ++sample_idx) {
             auto& likelihoods = likelihoods_[haplotype_idx][sample_idx];
@@ -143,7 +234,7 @@ void HaplotypeLikelihoodArray::populate(const TemplateMap& reads,
                                assert(read_template.size() == template_hashes.size());
                                for (std::size_t i {0}; i < template_hashes.size(); ++i) {
                                    mapping_positions[i].resize(maxMappingPositions);
-                                   mapping_positions[i].erase(map_query_to_target(template_hashes[i], haplotype_hashes,
+                                   mapping_positions[i].erase(map_query_to_target(template_hashes[i].get(), haplotype_hashes,
                                                                                   haplotype_mapping_counts,
                                                                                   std::begin(mapping_positions[i]),
                                                                                   maxMappingPositions),
@@ -291,6 +382,17 @@ void HaplotypeLikelihoodArray::set_template_iterators_and_sample_indices(const T
     }
 }
 
+HaplotypeLikelihoodArray::KmerHashesRef
+HaplotypeLikelihoodArray::get_kmer_hashes(const AlignedRead& read, KmerHashesBuffer& buffer) const
+{
+    if (read_annotations_) {
+        const auto annotation = read_annotations_->get().find(read);
+        if (annotation) return std::cref(annotation->kmer_hashes);
+    }
+    buffer.push_back(compute_kmer_hashes<mapperKmerSize>(read.sequence()));
+    return std::cref(buffer.back());
+}
+
 void HaplotypeLikelihoodArray::reset(MappableBlock<Haplotype> haplotypes)
 {
     assert(haplotypes.size() <= haplotypes_.size());
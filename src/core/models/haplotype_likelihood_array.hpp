@@ -12,6 +12,9 @@
 #include <iostream>
 #include <iomanip>
 #include <limits>
+#include <deque>
+#include <utility>
+#include <cstdint>
 
 #include <boost/optional.hpp>
 
@@ -22,6 +25,8 @@
 #include "core/types/haplotype.hpp"
 #include "core/types/indexed_haplotype.hpp"
 #include "utils/kmer_mapper.hpp"
+#include "utils/scratch_arena.hpp"
+#include "readpipe/read_annotations.hpp"
 #include "haplotype_likelihood_model.hpp"
 
 namespace octopus {
@@ -59,6 +64,15 @@ public:
     
     ~HaplotypeLikelihoodArray() = default;
     
+    // Populating uses the kmer hashes of annotated reads rather than recomputing them
+    void set_read_annotations(const ReadAnnotationMap& annotations) noexcept;
+    void clear_read_annotations() noexcept;
+    
+    // Read likelihoods are reused for haplotypes that look the same to the read (see
+    // HaplotypeLikelihoodModel::window_fingerprint), both within a population and from the
+    // previous one, which usually covers an overlapping active region. clear() keeps them.
+    // If the model has an early_exit_margin, read likelihoods further than the margin below the
+    // read's best likelihood are upper bounds rather than exact.
     void populate(const ReadMap& reads,
                   const MappableBlock<Haplotype>& haplotypes,
                   boost::optional<FlankState> flank_state = boost::none);
@@ -98,7 +112,10 @@ private:
     static constexpr unsigned char mapperKmerSize {6};
     static constexpr std::size_t maxMappingPositions {10};
     
+    static_assert(mapperKmerSize == ReadAnnotationMap::kmer_size, "read annotations must use the mapper kmer size");
+    
     HaplotypeLikelihoodModel likelihood_model_;
+    boost::optional<std::reference_wrapper<const ReadAnnotationMap>> read_annotations_;
     
     struct ReadPacket
     {
@@ -123,6 +140,15 @@ private:
     
     mutable boost::optional<std::size_t> primed_sample_;
     
+    using ReusableLikelihoodKey = std::pair<std::uint64_t, std::uint64_t>; // read and window fingerprints
+    struct ReusableLikelihoodKeyHash
+    {
+        std::size_t operator()(const ReusableLikelihoodKey& key) const noexcept { return key.first ^ (key.second * 0x9e3779b97f4a7c15); }
+    };
+    using ReusableLikelihoodMap = std::unordered_map<ReusableLikelihoodKey, LogProbability, ReusableLikelihoodKeyHash>;
+    
+    ReusableLikelihoodMap reusable_likelihoods_, previous_reusable_likelihoods_;
+    
     // Just to optimise population
     std::vector<ReadPacket> read_iterators_;
     std::vector<TemplatePacket> template_iterators_;
@@ -130,6 +156,9 @@ private:
     
     void set_read_iterators_and_sample_indices(const ReadMap& reads);
     void set_template_iterators_and_sample_indices(const TemplateMap& reads);
+    using KmerHashesRef = std::reference_wrapper<const KmerPerfectHashes>;
+    using KmerHashesBuffer = std::deque<KmerPerfectHashes, ScratchAllocator<KmerPerfectHashes>>;
+    KmerHashesRef get_kmer_hashes(const AlignedRead& read, KmerHashesBuffer& buffer) const;
 };
 
 // non-member methods
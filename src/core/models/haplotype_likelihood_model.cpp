@@ -75,12 +75,16 @@ void HaplotypeLikelihoodModel::reset(const Haplotype& haplotype, boost::optional
     if (indel_error_model_) {
         indel_error_model_->set_penalties(haplotype, haplotype_gap_open_penalities_, haplotype_gap_extend_penalities_);
     }
+    haplotype_forward_prefix_hashes_.clear();
+    haplotype_reverse_prefix_hashes_.clear();
 }
 
 void HaplotypeLikelihoodModel::clear() noexcept
 {
     haplotype_ = nullptr;
     haplotype_flank_state_ = boost::none;
+    haplotype_forward_prefix_hashes_.clear();
+    haplotype_reverse_prefix_hashes_.clear();
 }
 
 HaplotypeLikelihoodModel::HaplotypeLikelihoodModel()
@@ -136,6 +140,8 @@ HaplotypeLikelihoodModel::HaplotypeLikelihoodModel(const HaplotypeLikelihoodMode
     haplotype_gap_extend_penalities_ = other.haplotype_gap_extend_penalities_;
     config_ = other.config_;
     hmm_ = other.hmm_;
+    haplotype_forward_prefix_hashes_ = other.haplotype_forward_prefix_hashes_;
+    haplotype_reverse_prefix_hashes_ = other.haplotype_reverse_prefix_hashes_;
 }
 
 HaplotypeLikelihoodModel& HaplotypeLikelihoodModel::operator=(const HaplotypeLikelihoodModel& other)
@@ -162,6 +168,8 @@ void swap(HaplotypeLikelihoodModel& lhs, HaplotypeLikelihoodModel& rhs) noexcept
     swap(lhs.haplotype_gap_extend_penalities_, rhs.haplotype_gap_extend_penalities_);
     swap(lhs.config_, rhs.config_);
     swap(lhs.hmm_, rhs.hmm_);
+    swap(lhs.haplotype_forward_prefix_hashes_, rhs.haplotype_forward_prefix_hashes_);
+    swap(lhs.haplotype_reverse_prefix_hashes_, rhs.haplotype_reverse_prefix_hashes_);
 }
 
 bool HaplotypeLikelihoodModel::can_use_flank_state() const noexcept
@@ -258,10 +266,36 @@ max_score(const AlignedRead& read, const Haplotype& haplotype,
     return max_log_probability;
 }
 
+namespace {
+
+using LogProbability = HaplotypeLikelihoodModel::LogProbability;
+
+// The largest pair HMM score that could give a read likelihood of at least min_likelihood
+int max_hmm_score(const LogProbability min_likelihood, const LogProbability ln_prob_mapped, const LogProbability ln_prob_missmapped)
+{
+    if (min_likelihood <= ln_prob_missmapped) return std::numeric_limits<int>::max();
+    using octopus::maths::constants::ln10Div10;
+    const auto min_ln_prob_given_mapped = std::log(std::exp(min_likelihood) - std::exp(ln_prob_missmapped)) - ln_prob_mapped;
+    const auto result = -min_ln_prob_given_mapped / ln10Div10<>;
+    if (result >= std::numeric_limits<int>::max()) return std::numeric_limits<int>::max();
+    return result > 0 ? static_cast<int>(result) : 0;
+}
+
+} // namespace
+
 HaplotypeLikelihoodModel::LogProbability
 HaplotypeLikelihoodModel::evaluate(const AlignedRead& read,
                                    MappingPositionItr first_mapping_position,
                                    MappingPositionItr last_mapping_position) const
+{
+    return this->evaluate(read, first_mapping_position, last_mapping_position, std::numeric_limits<LogProbability>::lowest());
+}
+
+HaplotypeLikelihoodModel::LogProbability
+HaplotypeLikelihoodModel::evaluate(const AlignedRead& read,
+                                   MappingPositionItr first_mapping_position,
+                                   MappingPositionItr last_mapping_position,
+                                   const LogProbability best_likelihood) const
 {
     if (haplotype_ == nullptr) {
         throw std::runtime_error {"HaplotypeLikelihoodModel: no buffered Haplotype"};
@@ -280,22 +314,28 @@ HaplotypeLikelihoodModel::evaluate(const AlignedRead& read,
         model.lhs_flank_size = 0;
         model.rhs_flank_size = 0;
     }
-    hmm_.set(model);
-    const auto ln_prob_given_mapped = max_score(read, *haplotype_, first_mapping_position, last_mapping_position, hmm_);
+    // This calculation is approximately
+    // p(read | hap) = p(read missmapped) p(read | hap, missmapped)
+    //                  + p(read correctly mapped) p(read | hap, correctly mapped)
+    // = p(read correctly mapped) p(read | hap, correctly mapped)
+    //      + p(read missmapped)
+    // assuming p(read | hap, missmapped) = 1
+    LogProbability ln_prob_missmapped {std::numeric_limits<LogProbability>::lowest()}, ln_prob_mapped {0};
     if (config_.use_mapping_quality) {
-        // This calculation is approximately
-        // p(read | hap) = p(read missmapped) p(read | hap, missmapped)
-        //                  + p(read correctly mapped) p(read | hap, correctly mapped)
-        // = p(read correctly mapped) p(read | hap, correctly mapped)
-        //      + p(read missmapped)
-        // assuming p(read | hap, missmapped) = 1
         auto mapping_quality = read.mapping_quality();
         if (config_.mapping_quality_cap_trigger && mapping_quality >= *config_.mapping_quality_cap_trigger) {
             mapping_quality = config_.mapping_quality_cap;
         }
         using octopus::maths::constants::ln10Div10;
-        const auto ln_prob_missmapped = -ln10Div10<> * mapping_quality;
-        const auto ln_prob_mapped = std::log(1.0 - std::exp(ln_prob_missmapped));
+        ln_prob_missmapped = -ln10Div10<> * mapping_quality;
+        ln_prob_mapped = std::log(1.0 - std::exp(ln_prob_missmapped));
+    }
+    if (config_.early_exit_margin) {
+        model.max_score = max_hmm_score(best_likelihood - *config_.early_exit_margin, ln_prob_mapped, ln_prob_missmapped);
+    }
+    hmm_.set(model);
+    const auto ln_prob_given_mapped = max_score(read, *haplotype_, first_mapping_position, last_mapping_position, hmm_);
+    if (config_.use_mapping_quality) {
         const auto result = maths::log_sum_exp(ln_prob_mapped + ln_prob_given_mapped, ln_prob_missmapped);
         return result > -1e-15 ? 0.0 : result;
     } else {
@@ -430,6 +470,124 @@ HaplotypeLikelihoodModel::align(const AlignedRead& read, MappingPositionItr firs
     return result;
 }
 
+namespace {
+
+// Window hashes are polynomial hashes modulo the Mersenne prime 2^61 - 1
+constexpr std::uint64_t hashModulus {(std::uint64_t {1} << 61) - 1}, hashBase {0x1f3d5b79a2c4e681 % hashModulus};
+
+std::uint64_t mul_mod(const std::uint64_t a, const std::uint64_t b) noexcept
+{
+    const auto product = static_cast<unsigned __int128>(a) * b;
+    const auto result = static_cast<std::uint64_t>(product & hashModulus) + static_cast<std::uint64_t>(product >> 61);
+    return result >= hashModulus ? result - hashModulus : result;
+}
+
+std::uint64_t pow_mod(std::uint64_t base, std::size_t exponent) noexcept
+{
+    std::uint64_t result {1};
+    for (; exponent > 0; exponent >>= 1, base = mul_mod(base, base)) {
+        if (exponent & 1) result = mul_mod(result, base);
+    }
+    return result;
+}
+
+std::uint64_t mix(std::uint64_t x) noexcept
+{
+    x ^= x >> 30; x *= 0xbf58476d1ce4e5b9;
+    x ^= x >> 27; x *= 0x94d049bb133111eb;
+    return x ^ (x >> 31);
+}
+
+void hash_combine(std::uint64_t& seed, const std::uint64_t value) noexcept
+{
+    seed = mix(seed ^ (value + 0x9e3779b97f4a7c15 + (seed << 6) + (seed >> 2)));
+}
+
+template <typename Penalties, typename Mask>
+void compute_window_prefix_hashes(const Haplotype::NucleotideSequence& sequence,
+                                  const Penalties& gap_open, const Penalties& gap_extend,
+                                  const Mask& snv_mask, const Penalties& snv_priors,
+                                  std::vector<std::uint64_t>& result)
+{
+    const static auto byte = [] (auto value) -> std::uint64_t { return static_cast<std::uint8_t>(value); };
+    result.resize(sequence.size() + 1);
+    result[0] = 0;
+    for (std::size_t i {0}; i < sequence.size(); ++i) {
+        const auto column = byte(sequence[i]) | byte(gap_open[i]) << 8 | byte(gap_extend[i]) << 16
+                          | byte(snv_mask[i]) << 24 | byte(snv_priors[i]) << 32;
+        result[i + 1] = (mul_mod(result[i], hashBase) + column + 1) % hashModulus;
+    }
+}
+
+std::uint64_t window_hash(const std::vector<std::uint64_t>& prefix_hashes, const std::size_t begin, const std::size_t end) noexcept
+{
+    const auto shifted = mul_mod(prefix_hashes[begin], pow_mod(hashBase, end - begin));
+    return (prefix_hashes[end] + hashModulus - shifted) % hashModulus;
+}
+
+} // namespace
+
+boost::optional<std::uint64_t>
+HaplotypeLikelihoodModel::window_fingerprint(const AlignedRead& read,
+                                             MappingPositionItr first_mapping_position,
+                                             MappingPositionItr last_mapping_position) const
+{
+    if (haplotype_ == nullptr || !contains(*haplotype_, read)) return boost::none;
+    // The mapping positions max_score evaluates when none need shifting into range
+    window_mapping_positions_.assign(first_mapping_position, last_mapping_position);
+    window_mapping_positions_.push_back(begin_distance(*haplotype_, read));
+    const auto is_out_of_range = [&] (auto position) { return !is_in_range(position, read, *haplotype_, hmm_); };
+    window_mapping_positions_.erase(std::remove_if(std::begin(window_mapping_positions_), std::end(window_mapping_positions_), is_out_of_range),
+                                    std::end(window_mapping_positions_));
+    if (window_mapping_positions_.empty()) return boost::none;
+    std::sort(std::begin(window_mapping_positions_), std::end(window_mapping_positions_));
+    window_mapping_positions_.erase(std::unique(std::begin(window_mapping_positions_), std::end(window_mapping_positions_)),
+                                    std::end(window_mapping_positions_));
+    if (haplotype_forward_prefix_hashes_.empty()) {
+        compute_prefix_hashes();
+        if (haplotype_forward_prefix_hashes_.empty()) return boost::none;
+    }
+    const auto pad = min_flank_pad(hmm_);
+    const auto window_begin = window_mapping_positions_.front() - pad;
+    const auto window_end = window_mapping_positions_.back() + sequence_size(read) + pad;
+    const auto& prefix_hashes = read.is_marked_reverse_mapped() ? haplotype_reverse_prefix_hashes_ : haplotype_forward_prefix_hashes_;
+    std::uint64_t result {window_hash(prefix_hashes, window_begin, window_end)};
+    hash_combine(result, window_end - window_begin);
+    // Flank boundaries relative to the window, clamped where every alignment in the window sees the same flank size
+    const auto haplotype_length = static_cast<std::int64_t>(sequence_size(*haplotype_));
+    std::int64_t lhs_flank_end {0}, rhs_flank_begin {haplotype_length};
+    if (haplotype_flank_state_) {
+        lhs_flank_end = haplotype_flank_state_->lhs_flank;
+        rhs_flank_begin -= haplotype_flank_state_->rhs_flank;
+    }
+    hash_combine(result, std::max(lhs_flank_end - static_cast<std::int64_t>(window_begin), std::int64_t {0}));
+    hash_combine(result, std::min(rhs_flank_begin, static_cast<std::int64_t>(window_end)) - static_cast<std::int64_t>(window_begin));
+    for (const auto position : window_mapping_positions_) {
+        hash_combine(result, position - window_begin);
+    }
+    return result;
+}
+
+// private methods
+
+void HaplotypeLikelihoodModel::compute_prefix_hashes() const
+{
+    assert(haplotype_ != nullptr);
+    const auto length = sequence_size(*haplotype_);
+    const auto has_length = [=] (const auto& values) { return values.size() == length; };
+    if (!has_length(haplotype_gap_open_penalities_) || !has_length(haplotype_gap_extend_penalities_)
+        || !has_length(haplotype_snv_forward_mask_) || !has_length(haplotype_snv_forward_priors_)
+        || !has_length(haplotype_snv_reverse_mask_) || !has_length(haplotype_snv_reverse_priors_)) {
+        return;
+    }
+    compute_window_prefix_hashes(haplotype_->sequence(), haplotype_gap_open_penalities_, haplotype_gap_extend_penalities_,
+                                 haplotype_snv_forward_mask_, haplotype_snv_forward_priors_, haplotype_forward_prefix_hashes_);
+    compute_window_prefix_hashes(haplotype_->sequence(), haplotype_gap_open_penalities_, haplotype_gap_extend_penalities_,
+                                 haplotype_snv_reverse_mask_, haplotype_snv_reverse_priors_, haplotype_reverse_prefix_hashes_);
+}
+
+// non-member methods
+
 HaplotypeLikelihoodModel make_haplotype_likelihood_model(const std::string label, bool use_mapping_quality)
 {
     HaplotypeLikelihoodModel::Config config {};
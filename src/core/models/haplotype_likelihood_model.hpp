@@ -41,6 +41,8 @@ public:
         bool use_flank_state = true;
         unsigned max_indel_error = 8;
         bool use_int_scores = false;
+        // Stop evaluating a read once its log likelihood is certain to be this far below the best given
+        boost::optional<LogProbability> early_exit_margin = boost::none;
     };
     
     struct FlankState
@@ -93,6 +95,10 @@ public:
     LogProbability evaluate(const AlignedRead& read) const;
     LogProbability evaluate(const AlignedRead& read, const MappingPositionVector& mapping_positions) const;
     LogProbability evaluate(const AlignedRead& read, MappingPositionItr first_mapping_position, MappingPositionItr last_mapping_position) const;
+    // As above, but if early_exit_margin is set then results further than the margin below best_likelihood
+    // are only upper bounds (that are still further than the margin below best_likelihood)
+    LogProbability evaluate(const AlignedRead& read, MappingPositionItr first_mapping_position, MappingPositionItr last_mapping_position,
+                            LogProbability best_likelihood) const;
     
     // ln p(read template | haplotype, model)
     LogProbability evaluate(const AlignedTemplate& reads) const;
@@ -102,6 +108,13 @@ public:
     Alignment align(const AlignedRead& read, const MappingPositionVector& mapping_positions) const;
     Alignment align(const AlignedRead& read, MappingPositionItr first_mapping_position, MappingPositionItr last_mapping_position) const;
     
+    // A fingerprint of everything evaluate(read, first_mapping_position, last_mapping_position) uses from the
+    // buffered haplotype: the window of haplotype sequence the read can align to, the error model parameters
+    // and flank state over that window, and the mapping positions relative to it. A read has the same likelihood
+    // against any haplotypes with equal fingerprints. None if the read can't be aligned without being shifted.
+    boost::optional<std::uint64_t>
+    window_fingerprint(const AlignedRead& read, MappingPositionItr first_mapping_position, MappingPositionItr last_mapping_position) const;
+    
 private:
     using HMM = hmm::PairHMM<hmm::MutationModel>;
     
@@ -118,6 +131,12 @@ private:
     std::vector<Penalty> haplotype_gap_open_penalities_, haplotype_gap_extend_penalities_;
     Config config_;
     mutable HMM hmm_;
+    
+    // Prefix hashes of the haplotype sequence and model parameters, only computed if fingerprints are requested
+    mutable std::vector<std::uint64_t> haplotype_forward_prefix_hashes_, haplotype_reverse_prefix_hashes_;
+    mutable std::vector<MappingPosition> window_mapping_positions_;
+    
+    void compute_prefix_hashes() const;
 };
 
 class HaplotypeLikelihoodModel::ShortHaplotypeError : public std::runtime_error
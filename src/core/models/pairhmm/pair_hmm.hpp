@@ -26,6 +26,7 @@
 #include "utils/maths.hpp"
 #include "simd_pair_hmm_factory.hpp"
 #include "simd_pair_hmm_wrapper.hpp"
+#include "ungapped_score.hpp"
 
 namespace octopus { namespace hmm {
 
@@ -84,6 +85,8 @@ struct Parameters
     PenaltyOrNull mismatch = {};
     SizetOrNull lhs_flank_size = {}, rhs_flank_size = {};
     short nuc_prior = 2;
+    // Evaluation may stop once the score must exceed this, returning a score that is still above it
+    int max_score = std::numeric_limits<int>::max();
 };
 
 using MutationModel                  = Parameters<const PenaltyVector&, const PenaltyVector&, const NucleotideVector&, const PenaltyVector&, NullType, std::size_t>;
@@ -355,6 +358,23 @@ auto data(const RangeOrConstant& value, std::size_t index) noexcept
     return data(value, index, std::is_class<RangeOrConstant> {});
 }
 
+template <typename Range>
+int min_value(const Range& values, std::size_t index, std::size_t count, std::true_type) noexcept
+{
+    const auto first = std::next(std::cbegin(values), index);
+    return *std::min_element(first, std::next(first, count));
+}
+template <typename T>
+int min_value(const T& value, std::size_t, std::size_t, std::false_type) noexcept
+{
+    return value;
+}
+template <typename RangeOrConstant>
+int min_value(const RangeOrConstant& value, std::size_t index, std::size_t count) noexcept
+{
+    return min_value(value, index, count, std::is_class<RangeOrConstant> {});
+}
+
 template <typename Sequence1,
           typename Sequence2,
           typename PairHMM,
@@ -377,7 +397,8 @@ align(const Sequence1& truth,
                      target.size(),
                      data(hmm_params.gap_open, alignment_offset),
                      data(hmm_params.gap_extend, alignment_offset),
-                     hmm_params.nuc_prior);
+                     hmm_params.nuc_prior,
+                     hmm_params.max_score);
 }
 template <typename Sequence1,
           typename Sequence2,
@@ -403,7 +424,8 @@ align(const Sequence1& truth,
                      data(hmm_params.snv_priors, alignment_offset),
                      data(hmm_params.gap_open, alignment_offset),
                      data(hmm_params.gap_extend, alignment_offset),
-                     hmm_params.nuc_prior);
+                     hmm_params.nuc_prior,
+                     hmm_params.max_score);
 }
 template <typename Sequence1,
           typename Sequence2,
@@ -691,6 +713,82 @@ discount_flank_score(int& score,
                          std::is_same<decltype(hmm_params.lhs_flank_size), NullType> {});
 }
 
+template <typename Sequence1,
+          typename Sequence2,
+          typename PairHMMParameters>
+int
+ungapped_score(const Sequence1& truth,
+               const Sequence2& target,
+               const std::vector<std::uint8_t>& target_base_qualities,
+               const std::size_t target_offset,
+               const PairHMMParameters& hmm_params,
+               const int max_score,
+               std::true_type) noexcept
+{
+    const auto qualities = reinterpret_cast<const std::int8_t*>(target_base_qualities.data());
+    return simd::ungapped_score(truth.data() + target_offset, target.data(), qualities, target.size(), max_score);
+}
+template <typename Sequence1,
+          typename Sequence2,
+          typename PairHMMParameters>
+int
+ungapped_score(const Sequence1& truth,
+               const Sequence2& target,
+               const std::vector<std::uint8_t>& target_base_qualities,
+               const std::size_t target_offset,
+               const PairHMMParameters& hmm_params,
+               const int max_score,
+               std::false_type) noexcept
+{
+    const auto qualities = reinterpret_cast<const std::int8_t*>(target_base_qualities.data());
+    return simd::ungapped_score(truth.data() + target_offset, target.data(), qualities, target.size(),
+                                data(hmm_params.snv_mask, target_offset), data(hmm_params.snv_priors, target_offset),
+                                max_score);
+}
+template <typename Sequence1,
+          typename Sequence2,
+          typename PairHMMParameters>
+int
+ungapped_score(const Sequence1& truth,
+               const Sequence2& target,
+               const std::vector<std::uint8_t>& target_base_qualities,
+               const std::size_t target_offset,
+               const PairHMMParameters& hmm_params,
+               const int max_score) noexcept
+{
+    return ungapped_score(truth, target, target_base_qualities, target_offset, hmm_params, max_score,
+                          std::is_same<decltype(hmm_params.snv_mask), NullType> {});
+}
+
+// The banded alignment score is the ungapped score at target_offset if no other alignment in the
+// window can beat it. Gapped alignments pay at least one gap open penalty, and ungapped alignments on
+// the other diagonals are only scored until they reach the ungapped score, usually within a few bases.
+template <typename Sequence1,
+          typename Sequence2,
+          typename PairHMMParameters>
+bool
+try_ungapped_evaluate(const Sequence1& truth,
+                      const Sequence2& target,
+                      const std::vector<std::uint8_t>& target_base_qualities,
+                      const std::size_t target_offset,
+                      const int alignment_offset,
+                      const int truth_alignment_size,
+                      const PairHMMParameters& hmm_params,
+                      int& result) noexcept
+{
+    const auto min_gap_open = min_value(hmm_params.gap_open, alignment_offset, truth_alignment_size);
+    result = ungapped_score(truth, target, target_base_qualities, target_offset, hmm_params, min_gap_open + 1);
+    if (result > min_gap_open) return false;
+    const auto target_size = static_cast<int>(target.size());
+    for (auto offset = alignment_offset; offset + target_size <= alignment_offset + truth_alignment_size; ++offset) {
+        if (offset != static_cast<int>(target_offset)
+            && ungapped_score(truth, target, target_base_qualities, offset, hmm_params, result) < result) {
+            return false;
+        }
+    }
+    return true;
+}
+
 template <typename Sequence1,
           typename Sequence2,
           typename PairHMM,
@@ -712,7 +810,11 @@ simd_evaluate_helper(const Sequence1& truth,
     if (alignment_offset + truth_alignment_size > truth_size) {
         return std::numeric_limits<double>::lowest();
     }
-    auto score = align(truth, target, target_base_qualities, alignment_offset, hmm, hmm_params);
+    int score;
+    if (!try_ungapped_evaluate(truth, target, target_base_qualities, target_offset,
+                               alignment_offset, truth_alignment_size, hmm_params, score)) {
+        score = align(truth, target, target_base_qualities, alignment_offset, hmm, hmm_params);
+    }
     return -ln10Div10<> * static_cast<double>(score);
 }
 template <typename Sequence1,
@@ -737,7 +839,11 @@ simd_evaluate_helper(const Sequence1& truth,
         return std::numeric_limits<double>::lowest();
     }
     if (!use_adjusted_alignment_score(truth, target, target_offset, hmm, hmm_params)) {
-        auto score = align(truth, target, target_base_qualities, alignment_offset, hmm, hmm_params);
+        int score;
+        if (!try_ungapped_evaluate(truth, target, target_base_qualities, target_offset,
+                                   alignment_offset, truth_alignment_size, hmm_params, score)) {
+            score = align(truth, target, target_base_qualities, alignment_offset, hmm, hmm_params);
+        }
         return -ln10Div10<> * static_cast<double>(score);
     } else {
         thread_local std::vector<char> align1 {}, align2 {};
@@ -9,11 +9,14 @@
 #endif
 
 #include <cstddef>
+#include <cstdint>
 #include <algorithm>
 #include <iterator>
 #include <cassert>
 #include <limits>
 #include <vector>
+#include <array>
+#include <cstring>
 #include <emmintrin.h>
 #include <immintrin.h>
 
@@ -21,6 +24,9 @@
 
 namespace octopus { namespace hmm { namespace simd {
 
+// The phred penalty for aligning any target base to an N in the truth
+constexpr int n_penalty {2};
+
 template <typename InstructionSet,
           template <class> class InitializerType>
 class PairHMM : private InstructionSet
@@ -57,11 +63,13 @@ private:
     constexpr static ScoreType infinity_tolerance_ {0x7FF};
     constexpr static ScoreType infinity_ {std::numeric_limits<ScoreType>::max() - infinity_tolerance_};
     constexpr static int trace_bits_ {2};
-    constexpr static ScoreType n_score_ {2 << trace_bits_};
+    constexpr static ScoreType n_score_ {n_penalty << trace_bits_};
     
     constexpr static ScoreType max_quality_score_ {64}; // maximum reasonable phred base quality
     constexpr static ScoreType null_score_ {std::numeric_limits<ScoreType>::min()}; // baseline for score zero
     
+    constexpr static int no_max_score_ {std::numeric_limits<int>::max()};
+    
     constexpr static int match_label_  {0};
     constexpr static int insert_label_ {1};
     constexpr static int delete_label_ {3};
@@ -143,6 +151,14 @@ private:
         current = _add(current, _min(_andnot(_cmpeq(_targetwin, _truthwin), _qualitieswin), _truthnqual));
     }
     
+    static ScoreType min_word(const VectorType& vec) noexcept
+    {
+        std::array<ScoreType, band_size_> words;
+        static_assert(sizeof(words) == sizeof(VectorType), "size error");
+        std::memcpy(words.data(), &vec, sizeof(words));
+        return *std::min_element(std::cbegin(words), std::cend(words));
+    }
+    
     auto make_traceback_array(int target_len, int) const noexcept { return SmallVector(2 * (target_len + band_size_) + 1); }
     auto make_traceback_array(int target_len, NullType) const noexcept { return NullType {}; }
     
@@ -250,11 +266,15 @@ private:
                  const SnvMaskArrayOrNull snv_mask,
                  const SnvBaseQualityCapArrayOrNull snv_prior,
                  const ScoreType nuc_prior,
+                 const int max_score,
                  PositionOrNull& first_pos,
                  CharArrayOrNull align1,
                  CharArrayOrNull align2) const noexcept
     {
         assert(target_len > 0 && truth_len > band_size_ && (truth_len == target_len + 2 * band_size_ - 1));
+        // Scores at or above infinity can't be told apart, so bounds there are ignored
+        const bool is_bounded {max_score < ((std::int64_t {infinity_} - null_score_) >> trace_bits_)};
+        const std::int64_t max_raw_score {is_bounded ? null_score_ + (std::int64_t {max_score} << trace_bits_) : 0};
         const static VectorType _inf = vectorise(infinity_);
         const auto _nuc_prior = vectorise_left_shift_bits<trace_bits_>(nuc_prior);
         auto _truthwin     = vectorise(truth);
@@ -296,6 +316,12 @@ private:
             _d1 = _insert_bottom(_left_shift_word(_d1), infinity_);
             _i1 = _add(_min(_add(_i2, _gap_extend), _add(_m2, _gap_open)), _nuc_prior);
             update_traceback(_backpointers, s, _m1, _i1, _d1);
+            if (is_bounded && s / 2 >= band_size_ && s / 2 < target_len && (s / 2) % band_size_ == 0) {
+                // Once the band is fully initialised every alignment passes through this antidiagonal or the
+                // last one, and penalties are never negative, so no alignment can score less than their best cell
+                const auto min_score = min_word(_min(_min(_m1, _min(_i1, _d1)), _min(_m2, _min(_i2, _d2))));
+                if (min_score > max_raw_score) return static_cast<int>((min_score - std::int64_t {null_score_}) >> trace_bits_);
+            }
             // S odd. Truth needs updating; target is current
             const auto pos = band_size_ + s / 2;
             const bool pos_in_range {pos < truth_len};
@@ -447,10 +473,11 @@ public:
           const int target_len,
           const OpenPenaltyArrayOrConstant gap_open,
           const ExtendPenaltyArrayOrConstant gap_extend,
-          short nuc_prior) const noexcept
+          short nuc_prior,
+          int max_score = no_max_score_) const noexcept
     {
         constexpr static NullType null {};
-        return align_helper(truth, target, qualities, truth_len, target_len, gap_open, gap_extend, null, null, nuc_prior, null, null, null);
+        return align_helper(truth, target, qualities, truth_len, target_len, gap_open, gap_extend, null, null, nuc_prior, max_score, null, null, null);
     }
     
     template <typename OpenPenaltyArrayOrConstant,
@@ -465,10 +492,11 @@ public:
           const std::int8_t* snv_prior,
           const OpenPenaltyArrayOrConstant gap_open,
           const ExtendPenaltyArrayOrConstant gap_extend,
-          short nuc_prior) const noexcept
+          short nuc_prior,
+          int max_score = no_max_score_) const noexcept
     {
         constexpr static NullType null {};
-        return align_helper(truth, target, qualities, truth_len, target_len, gap_open, gap_extend, snv_mask, snv_prior, nuc_prior, null, null, null);
+        return align_helper(truth, target, qualities, truth_len, target_len, gap_open, gap_extend, snv_mask, snv_prior, nuc_prior, max_score, null, null, null);
     }
     
     template <typename OpenPenaltyArrayOrConstant,
@@ -487,7 +515,7 @@ public:
           char* align2) const noexcept
     {
         constexpr static NullType null {};
-        return align_helper(truth, target, qualities, truth_len, target_len, gap_open, gap_extend, null, null, nuc_prior, first_pos, align1, align2);
+        return align_helper(truth, target, qualities, truth_len, target_len, gap_open, gap_extend, null, null, nuc_prior, no_max_score_, first_pos, align1, align2);
     }
     
     template <typename OpenPenaltyArrayOrConstant,
@@ -507,7 +535,7 @@ public:
           char* align1,
           char* align2) const noexcept
     {
-        return align_helper(truth, target, qualities, truth_len, target_len, gap_open, gap_extend, snv_mask, snv_prior, nuc_prior, first_pos, align1, align2);
+        return align_helper(truth, target, qualities, truth_len, target_len, gap_open, gap_extend, snv_mask, snv_prior, nuc_prior, no_max_score_, first_pos, align1, align2);
     }
     
     template <typename OpenPenaltyArrayOrConstant,
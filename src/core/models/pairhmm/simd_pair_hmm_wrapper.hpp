@@ -5,6 +5,7 @@
 #define simd_pair_hmm_wrapper_hpp
 
 #include <tuple>
+#include <limits>
 
 #include <boost/variant.hpp>
 
@@ -97,10 +98,11 @@ public:
           const int target_len,
           const OpenPenaltyArrayOrConstant gap_open,
           const ExtendPenaltyArrayOrConstant gap_extend,
-          short nuc_prior) const noexcept
+          short nuc_prior,
+          int max_score = std::numeric_limits<int>::max()) const noexcept
     {
         return boost::apply_visitor([&] (const auto& hmm) noexcept {
-            return hmm.align(truth, target, qualities, truth_len, target_len, gap_open, gap_extend, nuc_prior);
+            return hmm.align(truth, target, qualities, truth_len, target_len, gap_open, gap_extend, nuc_prior, max_score);
         }, hmm_);
     }
     template <typename OpenPenaltyArrayOrConstant,
@@ -115,10 +117,11 @@ public:
           const std::int8_t* snv_prior,
           const OpenPenaltyArrayOrConstant gap_open,
           const ExtendPenaltyArrayOrConstant gap_extend,
-          short nuc_prior) const noexcept
+          short nuc_prior,
+          int max_score = std::numeric_limits<int>::max()) const noexcept
     {
         return boost::apply_visitor([&] (const auto& hmm) noexcept {
-            return hmm.align(truth, target, qualities, truth_len, target_len, snv_mask, snv_prior, gap_open, gap_extend, nuc_prior);
+            return hmm.align(truth, target, qualities, truth_len, target_len, snv_mask, snv_prior, gap_open, gap_extend, nuc_prior, max_score);
         }, hmm_);
     }
     template <typename OpenPenaltyArrayOrConstant,
@@ -0,0 +1,90 @@
+// Copyright (c) 2015-2020 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#ifndef ungapped_score_hpp
+#define ungapped_score_hpp
+
+#include <cstdint>
+#include <algorithm>
+#include <emmintrin.h>
+
+#include "simd_pair_hmm.hpp"
+
+namespace octopus { namespace hmm { namespace simd {
+
+namespace detail {
+
+constexpr std::uint8_t ungapped_n_score {n_penalty};
+
+inline __m128i load(const void* values) noexcept
+{
+    return _mm_loadu_si128(reinterpret_cast<const __m128i*>(values));
+}
+
+// Lanes of mask are all ones or all zeros
+inline __m128i cap(const __m128i values, const __m128i mask, const __m128i caps) noexcept
+{
+    return _mm_min_epu8(values, _mm_or_si128(_mm_and_si128(mask, caps), _mm_andnot_si128(mask, _mm_set1_epi8(-1))));
+}
+
+} // namespace detail
+
+/*
+    The score of target aligned to truth without gaps, i.e. the sum of the phred penalties the pair HMM
+    match state gives each base. If snv_mask isn't null, mismatches to the SNV mask base are capped by the
+    SNV prior. Bases are scored 16 at a time and scoring stops once the sum reaches max_score, so the
+    result is only exact if it's less than max_score.
+ */
+inline int
+ungapped_score(const char* truth,
+               const char* target,
+               const std::int8_t* qualities,
+               const int target_len,
+               const char* snv_mask,
+               const std::int8_t* snv_priors,
+               const int max_score) noexcept
+{
+    using namespace detail;
+    constexpr int block_size {16};
+    const auto zero = _mm_setzero_si128();
+    const auto n_base = _mm_set1_epi8('N'), n_score = _mm_set1_epi8(ungapped_n_score);
+    auto sums = zero;
+    int result {0}, i {0};
+    for (; i + block_size <= target_len && result < max_score; i += block_size) {
+        const auto truth_block = load(truth + i), target_block = load(target + i);
+        auto penalties = load(qualities + i);
+        if (snv_mask != nullptr) {
+            penalties = cap(penalties, _mm_cmpeq_epi8(load(snv_mask + i), target_block), load(snv_priors + i));
+        }
+        penalties = cap(penalties, _mm_cmpeq_epi8(truth_block, n_base), n_score);
+        penalties = _mm_andnot_si128(_mm_cmpeq_epi8(truth_block, target_block), penalties);
+        sums = _mm_add_epi64(sums, _mm_sad_epu8(penalties, zero));
+        result = _mm_cvtsi128_si32(sums) + _mm_cvtsi128_si32(_mm_srli_si128(sums, 8));
+    }
+    for (; i < target_len && result < max_score; ++i) {
+        if (truth[i] == target[i]) continue;
+        auto penalty = static_cast<std::uint8_t>(qualities[i]);
+        if (snv_mask != nullptr && snv_mask[i] == target[i]) {
+            penalty = std::min(penalty, static_cast<std::uint8_t>(snv_priors[i]));
+        }
+        if (truth[i] == 'N') penalty = std::min(penalty, ungapped_n_score);
+        result += penalty;
+    }
+    return result;
+}
+
+inline int
+ungapped_score(const char* truth,
+               const char* target,
+               const std::int8_t* qualities,
+               const int target_len,
+               const int max_score) noexcept
+{
+    return ungapped_score(truth, target, qualities, target_len, nullptr, nullptr, max_score);
+}
+
+} // namespace simd
+} // namespace hmm
+} // namespace octopus
+
+#endif
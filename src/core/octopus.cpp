@@ -5,7 +5,6 @@
 
 #include <vector>
 #include <deque>
-#include <queue>
 #include <map>
 #include <set>
 #include <algorithm>
@@ -48,6 +47,8 @@
 #include "logging/error_handler.hpp"
 #include "core/tools/vcf_header_factory.hpp"
 #include "io/variant/vcf.hpp"
+#include "io/read/read_writer.hpp"
+#include "io/read/annotated_aligned_read.hpp"
 #include "utils/timing.hpp"
 #include "exceptions/program_error.hpp"
 #include "exceptions/system_error.hpp"
@@ -56,6 +57,8 @@
 #include "readpipe/buffered_read_pipe.hpp"
 #include "core/tools/bam_realigner.hpp"
 #include "core/tools/indel_profiler.hpp"
+#include "core/window_plan.hpp"
+#include "utils/system_utils.hpp"
 
 #include "timers.hpp" // BENCHMARK
 
@@ -303,6 +306,15 @@ auto find_max_window(const ContigCallingComponents& components,
     return result;
 }
 
+auto propose_planned_call_subregion(const WindowPlan& plan, const GenomicRegion& remaining_call_region)
+{
+    const auto window = plan.find_window(remaining_call_region);
+    if (!window || window->region.end() >= remaining_call_region.end()) {
+        return remaining_call_region;
+    }
+    return GenomicRegion {remaining_call_region.contig_name(), remaining_call_region.begin(), window->region.end()};
+}
+
 auto propose_call_subregion(const ContigCallingComponents& components,
                             const GenomicRegion& remaining_call_region,
                             const WindowConfig& config)
@@ -310,6 +322,9 @@ auto propose_call_subregion(const ContigCallingComponents& components,
     if (is_empty(remaining_call_region)) {
         return remaining_call_region;
     }
+    if (components.window_plan && components.window_plan->get().has_windows(contig_name(remaining_call_region))) {
+        return propose_planned_call_subregion(*components.window_plan, remaining_call_region);
+    }
     auto target = remaining_call_region;
     if (config.max_size && size(target) > *config.max_size) {
         target = head_region(target, *config.max_size);
@@ -406,7 +421,177 @@ void resolve_connecting_calls(std::vector<VcfRecord>& old_connecting_calls,
     }
 }
 
-void run_octopus_on_contig(ContigCallingComponents&& components)
+using ContigCallingComponentFactory    = std::function<ContigCallingComponents()>;
+using ContigCallingComponentFactoryMap = std::map<ContigName, ContigCallingComponentFactory>;
+
+auto find_first_lhs_connecting(const std::deque<VcfRecord>& lhs_calls, const GenomicRegion& rhs_region)
+{
+    const auto rhs_begin = mapped_begin(rhs_region);
+    return std::find_if(std::cbegin(lhs_calls), std::cend(lhs_calls),
+                        [&rhs_begin] (const auto& call) { return mapped_end(call) > rhs_begin; });
+}
+
+auto find_last_rhs_connecting(const GenomicRegion& lhs_region, const std::deque<VcfRecord>& rhs_calls)
+{
+    const auto lhs_end = mapped_end(lhs_region);
+    return std::find_if_not(std::cbegin(rhs_calls), std::cend(rhs_calls),
+                            [&lhs_end] (const auto& call) { return mapped_begin(call) < lhs_end; });
+}
+
+// Regions skipped because they have too many haplotypes are re-called in smaller windows, as the
+// haplotype generator will usually manage the smaller windows. Windows are split at the lowest
+// coverage positions near evenly spaced boundaries, as fewer reads (and so haplotypes) span these.
+// Only skipped regions are re-called: windows that are slow but don't overflow the haplotype limit
+// can't be interrupted once calling starts, so they are not split.
+constexpr unsigned num_split_windows {4};
+constexpr unsigned max_split_depth {2};
+constexpr GenomicRegion::Size min_split_window_size {50};
+
+std::vector<GenomicRegion>
+split_at_coverage_minima(const GenomicRegion& region, const ContigCallingComponents& components)
+{
+    const auto region_size = size(region);
+    if (region_size < num_split_windows * min_split_window_size) return {region};
+    std::vector<int> depth_changes(region_size + 1, 0);
+    components.read_manager.get().iterate(components.samples.get(), region, [&] (const SampleName&, ContigRegion read_region) {
+        const auto begin = std::max(read_region.begin(), region.begin()) - region.begin();
+        const auto end = std::min(read_region.end(), region.end()) - region.begin();
+        ++depth_changes[begin];
+        --depth_changes[end];
+        return true;
+    });
+    std::vector<int> depths(region_size);
+    std::partial_sum(std::cbegin(depth_changes), std::prev(std::cend(depth_changes)), std::begin(depths));
+    std::vector<GenomicRegion> result {};
+    result.reserve(num_split_windows);
+    const auto stride = region_size / num_split_windows;
+    GenomicRegion::Position window_begin {0};
+    for (unsigned i {1}; i < num_split_windows; ++i) {
+        const auto search_begin = std::max(i * stride - stride / 2, window_begin + min_split_window_size);
+        const auto search_end = std::min(i * stride + stride / 2, region_size - min_split_window_size);
+        if (search_begin >= search_end) continue;
+        const auto split_itr = std::min_element(std::next(std::cbegin(depths), search_begin), std::next(std::cbegin(depths), search_end));
+        const auto split = static_cast<GenomicRegion::Position>(std::distance(std::cbegin(depths), split_itr));
+        result.push_back(GenomicRegion {region.contig_name(), region.begin() + window_begin, region.begin() + split});
+        window_begin = split;
+    }
+    result.push_back(GenomicRegion {region.contig_name(), region.begin() + window_begin, region.end()});
+    return result;
+}
+
+// Counts the calling threads in use, so threads the task scheduler leaves idle can re-call skipped
+// regions without exceeding --threads.
+class CallingThreadBudget
+{
+public:
+    CallingThreadBudget(unsigned num_threads) : num_free_ {num_threads}, mutex_ {}, cv_ {} {}
+    
+    bool try_acquire()
+    {
+        std::lock_guard<std::mutex> lock {mutex_};
+        if (num_free_ == 0) return false;
+        --num_free_;
+        return true;
+    }
+    
+    void release()
+    {
+        std::unique_lock<std::mutex> lock {mutex_};
+        ++num_free_;
+        lock.unlock();
+        cv_.notify_all();
+    }
+    
+    void wait_until_available()
+    {
+        std::unique_lock<std::mutex> lock {mutex_};
+        cv_.wait(lock, [this] () { return num_free_ > 0; });
+    }
+    
+private:
+    unsigned num_free_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+};
+
+std::deque<VcfRecord>
+call_split_region(const GenomicRegion& region, const ContigCallingComponentFactory& calling_components,
+                  boost::optional<CallingThreadBudget&> thread_budget, unsigned depth);
+
+std::deque<VcfRecord>
+recall_skipped_regions(std::deque<VcfRecord> calls, std::vector<GenomicRegion> skipped_regions,
+                       const GenomicRegion& call_region, const ContigCallingComponentFactory& calling_components,
+                       boost::optional<CallingThreadBudget&> thread_budget, const unsigned depth)
+{
+    if (skipped_regions.empty() || depth >= max_split_depth) return calls;
+    std::sort(std::begin(skipped_regions), std::end(skipped_regions));
+    for (const auto& skipped_region : extract_covered_regions(skipped_regions)) {
+        const auto region = overlapped_region(skipped_region, call_region);
+        if (!region) continue;
+        static auto debug_log = get_debug_log();
+        if (debug_log) stream(*debug_log) << "Re-calling skipped region " << *region << " in smaller windows";
+        auto split_calls = call_split_region(*region, calling_components, thread_budget, depth);
+        if (split_calls.empty()) continue;
+        // As in resolve_connecting_calls, calls from the smaller windows are preferred
+        const auto split_calls_region = encompassing_region(split_calls);
+        const auto first_connecting = find_first_lhs_connecting(calls, split_calls_region);
+        const auto last_connecting = find_last_rhs_connecting(split_calls_region, calls);
+        const auto insert_itr = calls.erase(first_connecting, std::max(first_connecting, last_connecting));
+        calls.insert(insert_itr, std::make_move_iterator(std::begin(split_calls)), std::make_move_iterator(std::end(split_calls)));
+    }
+    return calls;
+}
+
+std::deque<VcfRecord>
+call_window(const GenomicRegion& window, const ContigCallingComponents& components,
+            const ContigCallingComponentFactory& calling_components,
+            boost::optional<CallingThreadBudget&> thread_budget, const unsigned depth)
+{
+    std::vector<GenomicRegion> skipped_regions {};
+    auto calls = components.caller->call(window, components.progress_meter, skipped_regions);
+    return recall_skipped_regions(std::move(calls), std::move(skipped_regions), window, calling_components, thread_budget, depth + 1);
+}
+
+std::deque<VcfRecord>
+call_split_region(const GenomicRegion& region, const ContigCallingComponentFactory& calling_components,
+                  boost::optional<CallingThreadBudget&> thread_budget, const unsigned depth)
+{
+    const auto components = calling_components();
+    const auto windows = split_at_coverage_minima(region, components);
+    if (windows.size() < 2) return {};
+    // Each window runs on its own thread if one is free, otherwise it's called on this thread when its calls are needed
+    std::vector<std::future<std::deque<VcfRecord>>> window_calls {};
+    window_calls.reserve(windows.size());
+    for (const auto& window : windows) {
+        if (thread_budget && thread_budget->try_acquire()) {
+            window_calls.push_back(std::async(std::launch::async, [&calling_components, thread_budget, depth, window] () {
+                try {
+                    auto result = call_window(window, calling_components(), calling_components, thread_budget, depth);
+                    thread_budget->release();
+                    return result;
+                } catch (...) {
+                    thread_budget->release();
+                    throw;
+                }
+            }));
+        } else {
+            window_calls.push_back(std::async(std::launch::deferred, [&components, &calling_components, thread_budget, depth, window] () {
+                return call_window(window, components, calling_components, thread_budget, depth);
+            }));
+        }
+    }
+    std::deque<VcfRecord> result {};
+    for (auto& future : window_calls) {
+        auto calls = future.get();
+        if (!result.empty() && !calls.empty()) {
+            result.erase(find_first_lhs_connecting(result, encompassing_region(calls)), std::cend(result));
+        }
+        utils::append(std::move(calls), result);
+    }
+    return result;
+}
+
+void run_octopus_on_contig(ContigCallingComponents&& components, const ContigCallingComponentFactory& calling_components)
 {
     // TODO: refactor to use connection resolution developed for multithreaded version
     static auto debug_log = get_debug_log();
@@ -426,7 +611,9 @@ void run_octopus_on_contig(ContigCallingComponents&& components)
         if (debug_log) stream(*debug_log) << "Processing subregion " << subregion;
         
         try {
-            calls = components.caller->call(subregion, components.progress_meter);
+            std::vector<GenomicRegion> skipped_regions {};
+            calls = components.caller->call(subregion, components.progress_meter, skipped_regions);
+            calls = recall_skipped_regions(std::move(calls), std::move(skipped_regions), subregion, calling_components, boost::none, 0);
         } catch(...) {
             // TODO: which exceptions can we recover from?
             throw;
@@ -462,7 +649,8 @@ void run_octopus_single_threaded(GenomeCallingComponents& components)
     #endif
     components.progress_meter().start();
     for (const auto& contig : components.contigs()) {
-        run_octopus_on_contig(ContigCallingComponents {contig, components});
+        const ContigCallingComponentFactory calling_components {[&components, &contig] () { return ContigCallingComponents {contig, components}; }};
+        run_octopus_on_contig(calling_components(), calling_components);
     }
     components.progress_meter().stop();
     #ifdef BENCHMARK
@@ -529,16 +717,46 @@ TempVcfWriterMap make_temp_vcf_writers(const GenomeCallingComponents& components
     return result;
 }
 
+bool is_inline_bam_realignment_requested(const GenomeCallingComponents& components)
+{
+    // Unsupported setups are rejected when the components are made
+    return components.bamout() && components.inline_bamout();
+}
+
+// Evidence BAM parts are only opened when the first reads for a contig are written, as there may be
+// more contigs than files that can be open at once
+// Evidence is written to a sequence of temporary parts, each holding consecutive evidence for one contig.
+// Only the last part is open; it's closed when evidence for another contig arrives.
+struct TempEvidenceWriters
+{
+    boost::optional<boost::filesystem::path> template_bam = boost::none;
+    boost::filesystem::path directory = {};
+    std::vector<std::pair<ContigName, boost::filesystem::path>> parts = {};
+    std::unique_ptr<io::ReadWriter> open_part = nullptr;
+};
+
+TempEvidenceWriters make_temp_evidence_writers(const GenomeCallingComponents& components)
+{
+    TempEvidenceWriters result {};
+    if (is_inline_bam_realignment_requested(components)) {
+        result.template_bam = components.read_manager().paths().front();
+        result.directory = *components.temp_directory();
+    }
+    return result;
+}
+
 struct Task : public Mappable<Task>
 {
     GenomicRegion region;
     ExecutionPolicy policy;
+    double cost; // estimated, relative to other tasks
     
     Task() = delete;
     
-    Task(GenomicRegion region, ExecutionPolicy policy = ExecutionPolicy::seq)
+    Task(GenomicRegion region, ExecutionPolicy policy = ExecutionPolicy::seq, double cost = 0)
     : region {std::move(region)}
     , policy {policy}
+    , cost {cost}
     {};
     
     const GenomicRegion& mapped_region() const noexcept { return region; }
@@ -571,8 +789,10 @@ private:
     std::vector<ContigName> contigs_;
 };
 
-using TaskQueue = std::queue<Task>;
+using TaskQueue = std::deque<Task>;
 using TaskMap   = std::map<ContigName, TaskQueue, ContigOrder>;
+// The regions of tasks that have been, or must be, dispatched before the last dispatched task of each contig
+using UnfinishedTaskMap = std::map<ContigName, std::set<ContigRegion>>;
 
 auto count_tasks(const TaskMap& tasks) noexcept
 {
@@ -593,6 +813,24 @@ struct TaskMakerSyncPacket
     std::atomic_bool all_done;
 };
 
+double estimate_task_cost(const ContigCallingComponents& components, const GenomicRegion& window, const std::size_t num_reads)
+{
+    if (num_reads == 0) return 0;
+    const auto repeat_fraction = calculate_repeat_fraction(components.reference.get().fetch_sequence(window));
+    return estimate_calling_cost(window, num_reads, repeat_fraction);
+}
+
+double estimate_task_cost(const ContigCallingComponents& components, const GenomicRegion& window)
+{
+    if (components.window_plan) {
+        const auto planned_window = components.window_plan->get().find_window(window);
+        if (planned_window && contains(planned_window->region, window) && !is_empty(planned_window->region)) {
+            return planned_window->cost * size(window) / size(planned_window->region);
+        }
+    }
+    return estimate_task_cost(components, window, components.read_manager.get().count_reads(components.samples, window));
+}
+
 void make_region_tasks(const GenomicRegion& region,
                        const ContigCallingComponents& components,
                        const ExecutionPolicy policy,
@@ -605,9 +843,10 @@ void make_region_tasks(const GenomicRegion& region,
     std::unique_lock<std::mutex> lock {sync.mutex, std::defer_lock};
     auto subregion = propose_call_subregion(components, region, window_config);
     if (ends_equal(subregion, region)) {
+        const auto cost = estimate_task_cost(components, subregion);
         lock.lock();
         sync.cv.wait(lock, [&] () { return sync.ready; });
-        result.emplace(std::move(subregion), policy);
+        result.emplace_back(std::move(subregion), policy, cost);
         ++sync.num_tasks;
         if (last_region_in_contig) {
             sync.finished.at(region.contig_name()) = true;
@@ -616,13 +855,13 @@ void make_region_tasks(const GenomicRegion& region,
         lock.unlock();
         sync.cv.notify_one();
     } else {
-        std::deque<GenomicRegion> batch {};
-        batch.push_back(subregion);
+        std::deque<Task> batch {};
+        batch.emplace_back(subregion, policy, estimate_task_cost(components, subregion));
         bool done {false};
         while (true) {
             while (batch.size() < std::max(sync.batch_size_hint.load(), 1u) || !sync.waiting) {
                 subregion = propose_call_subregion(components, subregion, region, window_config);
-                batch.push_back(subregion);
+                batch.emplace_back(subregion, policy, estimate_task_cost(components, subregion));
                 assert(!ends_before(region, subregion));
                 if (ends_equal(subregion, region)) {
                     done = true;
@@ -633,8 +872,8 @@ void make_region_tasks(const GenomicRegion& region,
             assert(!lock.owns_lock());
             lock.lock();
             sync.cv.wait(lock, [&] () { return sync.ready; });
-            for (auto&& r : batch) result.emplace(std::move(r), policy);
             sync.num_tasks += batch.size();
+            utils::append(std::move(batch), result);
             if (done) {
                 if (last_region_in_contig) {
                     sync.finished.at(region.contig_name()) = true;
@@ -750,16 +989,38 @@ unsigned calculate_num_task_threads(const GenomeCallingComponents& components)
     return num_cores;
 }
 
-Task pop(TaskMap& tasks, TaskMakerSyncPacket& sync)
+auto find_most_expensive_task(TaskMap& tasks)
+{
+    auto result = std::make_pair(std::end(tasks), TaskQueue::iterator {});
+    for (auto contig_task_itr = std::begin(tasks); contig_task_itr != std::end(tasks); ++contig_task_itr) {
+        auto& contig_tasks = contig_task_itr->second;
+        // Ties go to the first task so equal cost tasks are dispatched in order
+        const auto task_itr = std::max_element(std::begin(contig_tasks), std::end(contig_tasks),
+                                               [] (const Task& lhs, const Task& rhs) { return lhs.cost < rhs.cost; });
+        if (task_itr != std::end(contig_tasks) && (result.first == std::end(tasks) || task_itr->cost > result.second->cost)) {
+            result = std::make_pair(contig_task_itr, task_itr);
+        }
+    }
+    return result;
+}
+
+// Tasks are dispatched most expensive first, so long running windows (e.g. high depth or repetitive regions)
+// don't start late and leave threads idle at the end of the run. Completed tasks are still written in order
+// as write_or_buffer buffers a task until all the tasks before it in unfinished_tasks have completed.
+Task pop(TaskMap& tasks, TaskMakerSyncPacket& sync, UnfinishedTaskMap& unfinished_tasks)
 {
     assert(!tasks.empty());
     std::unique_lock<std::mutex> lock {sync.mutex};
     sync.ready = false;
     assert(sync.num_tasks > 0);
-    const auto contig_task_itr = std::begin(tasks);
-    assert(!contig_task_itr->second.empty());
-    const auto result = std::move(contig_task_itr->second.front());
-    contig_task_itr->second.pop();
+    const auto p = find_most_expensive_task(tasks);
+    const auto contig_task_itr = p.first;
+    assert(contig_task_itr != std::end(tasks));
+    auto& contig_unfinished_tasks = unfinished_tasks.at(contig_task_itr->first);
+    std::for_each(std::begin(contig_task_itr->second), std::next(p.second),
+                  [&] (const Task& task) { contig_unfinished_tasks.insert(contig_region(task)); });
+    const auto result = std::move(*p.second);
+    contig_task_itr->second.erase(p.second);
     if (sync.finished.at(contig_task_itr->first) && contig_task_itr->second.empty()) {
         static auto debug_log = get_debug_log();
         if (debug_log) stream(*debug_log) << "Finished calling contig " << contig_task_itr->first;
@@ -774,8 +1035,9 @@ Task pop(TaskMap& tasks, TaskMakerSyncPacket& sync)
 
 struct CompletedTask : public Task
 {
-    CompletedTask(Task task) : Task {std::move(task)}, calls {}, runtime {} {}
+    CompletedTask(Task task) : Task {std::move(task)}, calls {}, evidence {}, runtime {} {}
     std::deque<VcfRecord> calls;
+    std::vector<AnnotatedAlignedRead> evidence;
     utils::TimeInterval runtime;
 };
 
@@ -800,54 +1062,71 @@ struct CallerSyncPacket
     std::atomic_uint num_finished;
 };
 
+// Each calling task's thread is pinned to the NUMA node with the fewest running tasks. The reads, haplotypes
+// and likelihoods a task allocates are first touched by its own thread, so they stay in the node's local memory.
+class NumaWorkerPlacement
+{
+public:
+    using Node = std::size_t;
+    
+    NumaWorkerPlacement() : node_cpus_ {get_numa_node_cpus()}, num_workers_(node_cpus_.size(), 0), mutex_ {} {}
+    
+    std::size_t num_nodes() const noexcept { return node_cpus_.size(); }
+    
+    boost::optional<Node> place_current_thread()
+    {
+        if (num_nodes() < 2) return boost::none;
+        std::unique_lock<std::mutex> lock {mutex_};
+        // Choose the node with the fewest workers per allowed CPU, so unevenly sized nodes load evenly
+        boost::optional<Node> node {};
+        for (Node n {0}; n < num_nodes(); ++n) {
+            if (node_cpus_[n].empty()) continue;
+            if (!node || num_workers_[n] * node_cpus_[*node].size() < num_workers_[*node] * node_cpus_[n].size()) {
+                node = n;
+            }
+        }
+        if (!node) return boost::none;
+        ++num_workers_[*node];
+        lock.unlock();
+        if (!bind_current_thread(node_cpus_[*node])) {
+            release(*node);
+            return boost::none;
+        }
+        return node;
+    }
+    
+    void release(const Node node)
+    {
+        std::lock_guard<std::mutex> lock {mutex_};
+        assert(num_workers_[node] > 0);
+        --num_workers_[node];
+    }
+    
+private:
+    std::vector<CpuList> node_cpus_;
+    std::vector<unsigned> num_workers_;
+    std::mutex mutex_;
+};
+
 template<typename R>
 bool is_ready(const std::future<R>& f)
 {
     return f.valid() && f.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
 }
 
-auto run(Task task, ContigCallingComponents components, CallerSyncPacket& sync)
-{
-    static auto debug_log = get_debug_log();
-    if (debug_log) stream(*debug_log) << "Spawning task " << task;
-    return std::async(std::launch::async, [task = std::move(task), components = std::move(components), &sync] () {
-        try {
-            CompletedTask result {task};
-            result.runtime.start = std::chrono::system_clock::now();
-            result.calls = components.caller->call(task.region, components.progress_meter);
-            result.runtime.end = std::chrono::system_clock::now();
-            std::unique_lock<std::mutex> lock {sync.mutex};
-            ++sync.num_finished;
-            lock.unlock();
-            sync.cv.notify_all();
-            return result;
-        } catch (const std::exception& e) {
-            logging::ErrorLogger error_log {};
-            stream(error_log) << "Encountered a problem whilst calling " << task << "(" << e.what() << ")";
-            using namespace std::chrono_literals;
-            std::this_thread::sleep_for(2s); // Try to make sure the error is logged before raising
-            std::unique_lock<std::mutex> lock {sync.mutex};
-            ++sync.num_finished;
-            lock.unlock();
-            sync.cv.notify_all();
-            throw;
-        }
-    });
-}
-
 using CompletedTaskMap = std::map<ContigName, std::map<ContigRegion, CompletedTask>>;
 using HoldbackTask = boost::optional<std::reference_wrapper<const CompletedTask>>;
 
 auto get_writable_completed_tasks(CompletedTask&& task, CompletedTaskMap::mapped_type& buffered_tasks,
-                                  TaskQueue& running_tasks, HoldbackTask& holdback)
+                                  UnfinishedTaskMap::mapped_type& unfinished_tasks, HoldbackTask& holdback)
 {
     std::deque<CompletedTask> result {std::move(task)};
-    while (!running_tasks.empty()) {
-        const auto itr = buffered_tasks.find(contig_region(running_tasks.front()));
+    while (!unfinished_tasks.empty()) {
+        const auto itr = buffered_tasks.find(*std::cbegin(unfinished_tasks));
         if (itr != std::end(buffered_tasks)) {
             result.push_back(std::move(itr->second));
             buffered_tasks.erase(itr);
-            running_tasks.pop();
+            unfinished_tasks.erase(std::cbegin(unfinished_tasks));
         } else {
             break;
         }
@@ -862,33 +1141,16 @@ auto get_writable_completed_tasks(CompletedTask&& task, CompletedTaskMap::mapped
     return result;
 }
 
-using ContigCallingComponentFactory    = std::function<ContigCallingComponents()>;
-using ContigCallingComponentFactoryMap = std::map<ContigName, ContigCallingComponentFactory>;
-
-auto make_contig_calling_component_factory_map(GenomeCallingComponents& components)
+auto make_contig_calling_component_factory_map(GenomeCallingComponents& components, const unsigned num_threads)
 {
     ContigCallingComponentFactoryMap result {};
     for (const auto& contig : components.contigs()) {
-        result.emplace(contig, [&components, contig] () -> ContigCallingComponents
-                       { return ContigCallingComponents {contig, components}; });
+        result.emplace(contig, [&components, contig, num_threads] () -> ContigCallingComponents
+                       { return make_contig_components(contig, components, num_threads); });
     }
     return result;
 }
 
-auto find_first_lhs_connecting(const std::deque<VcfRecord>& lhs_calls, const GenomicRegion& rhs_region)
-{
-    const auto rhs_begin = mapped_begin(rhs_region);
-    return std::find_if(std::cbegin(lhs_calls), std::cend(lhs_calls),
-                        [&rhs_begin] (const auto& call) { return mapped_end(call) > rhs_begin; });
-}
-
-auto find_last_rhs_connecting(const GenomicRegion& lhs_region, const std::deque<VcfRecord>& rhs_calls)
-{
-    const auto lhs_end = mapped_end(lhs_region);
-    return std::find_if_not(std::cbegin(rhs_calls), std::cend(rhs_calls),
-                            [&lhs_end] (const auto& call) { return mapped_begin(call) < lhs_end; });
-}
-
 void resolve_connecting_calls(CompletedTask& lhs, CompletedTask& rhs,
                               const ContigCallingComponentFactory& calling_components)
 {
@@ -919,15 +1181,83 @@ void resolve_connecting_calls(std::deque<CompletedTask>& adjacent_tasks,
                   [&] (auto& rhs) { resolve_connecting_calls(*lhs++, rhs, calling_components); });
 }
 
+auto realign_evidence(const BAMRealigner& realigner, const ReadMap& reads, const std::deque<VcfRecord>& calls,
+                      const GenomicRegion& region, const ReferenceGenome& reference)
+{
+    BAMRealigner::Report report {};
+    return realigner.realign(reads, {std::cbegin(calls), std::cend(calls)}, region, reference, report);
+}
+
+auto run(Task task, ContigCallingComponents components, const ContigCallingComponentFactory& calling_components,
+         boost::optional<const BAMRealigner&> evidence_realigner, NumaWorkerPlacement& placement,
+         CallingThreadBudget& thread_budget, CallerSyncPacket& sync)
+{
+    static auto debug_log = get_debug_log();
+    if (debug_log) stream(*debug_log) << "Spawning task " << task;
+    return std::async(std::launch::async, [task = std::move(task), components = std::move(components), &calling_components,
+                                           evidence_realigner, &placement, &thread_budget, &sync] () {
+        const auto node = placement.place_current_thread();
+        try {
+            CompletedTask result {task};
+            result.runtime.start = std::chrono::system_clock::now();
+            std::vector<GenomicRegion> skipped_regions {};
+            ReadMap reads {};
+            result.calls = components.caller->call(task.region, components.progress_meter, skipped_regions, reads);
+            result.calls = recall_skipped_regions(std::move(result.calls), std::move(skipped_regions), task.region,
+                                                  calling_components, thread_budget, 0);
+            if (evidence_realigner) {
+                // The reads and calls are still in memory, so there's no need to fetch them again after calling
+                result.evidence = realign_evidence(*evidence_realigner, reads, result.calls, task.region, components.reference);
+            }
+            result.runtime.end = std::chrono::system_clock::now();
+            if (node) placement.release(*node);
+            thread_budget.release();
+            std::unique_lock<std::mutex> lock {sync.mutex};
+            ++sync.num_finished;
+            lock.unlock();
+            sync.cv.notify_all();
+            return result;
+        } catch (const std::exception& e) {
+            logging::ErrorLogger error_log {};
+            stream(error_log) << "Encountered a problem whilst calling " << task << "(" << e.what() << ")";
+            using namespace std::chrono_literals;
+            std::this_thread::sleep_for(2s); // Try to make sure the error is logged before raising
+            if (node) placement.release(*node);
+            thread_budget.release();
+            std::unique_lock<std::mutex> lock {sync.mutex};
+            ++sync.num_finished;
+            lock.unlock();
+            sync.cv.notify_all();
+            throw;
+        }
+    });
+}
+
 struct TaskWriterSyncPacket
 {
     std::condition_variable cv;
     std::mutex mutex;
     std::deque<CompletedTask> tasks = {};
-    bool done = false;
+    bool done = false, finished = false;
 };
 
-void write(std::deque<CompletedTask>& tasks, TempVcfWriterMap& writers)
+void write(std::vector<AnnotatedAlignedRead>&& evidence, const ContigName& contig, TempEvidenceWriters& writers)
+{
+    if (evidence.empty()) return;
+    if (writers.parts.empty() || writers.parts.back().first != contig) {
+        assert(writers.template_bam);
+        writers.open_part.reset();
+        auto part_path = writers.directory;
+        part_path /= "evidence_" + std::to_string(writers.parts.size()) + "_temp.bam";
+        writers.open_part = std::make_unique<io::ReadWriter>(part_path, *writers.template_bam);
+        writers.parts.emplace_back(contig, std::move(part_path));
+    }
+    *writers.open_part << evidence;
+    evidence.clear();
+    evidence.shrink_to_fit();
+}
+
+void write(std::deque<CompletedTask>& tasks, TempVcfWriterMap& writers, TempEvidenceWriters& evidence_writers)
 {
     static auto debug_log = get_debug_log();
     for (auto&& task : tasks) {
@@ -936,11 +1266,12 @@ void write(std::deque<CompletedTask>& tasks, TempVcfWriterMap& writers)
         }
         auto& writer = writers.at(contig_name(task));
         write_calls(std::move(task.calls), writer);
+        write(std::move(task.evidence), contig_name(task), evidence_writers);
     }
     tasks.clear();
 }
 
-void write_temp_vcf_helper(TempVcfWriterMap& writers, TaskWriterSyncPacket& sync)
+void write_temp_vcf_helper(TempVcfWriterMap& writers, TempEvidenceWriters& evidence_writers, TaskWriterSyncPacket& sync)
 {
     try {
         std::unique_lock<std::mutex> lock {sync.mutex, std::defer_lock};
@@ -952,8 +1283,12 @@ void write_temp_vcf_helper(TempVcfWriterMap& writers, TaskWriterSyncPacket& sync
             std::swap(sync.tasks, buffer);
             lock.unlock();
             sync.cv.notify_one();
-            write(buffer, writers);
+            write(buffer, writers, evidence_writers);
         }
+        lock.lock();
+        sync.finished = true;
+        lock.unlock();
+        sync.cv.notify_all();
         logging::DebugLogger debug_log {};
         debug_log << "Task writer finished";
     } catch (const Error& e) {
@@ -973,18 +1308,10 @@ void write_temp_vcf_helper(TempVcfWriterMap& writers, TaskWriterSyncPacket& sync
     }
 }
 
-std::thread make_task_writer_thread(TempVcfWriterMap& temp_writers, TaskWriterSyncPacket& writer_sync)
-{
-    return std::thread {write_temp_vcf_helper, std::ref(temp_writers), std::ref(writer_sync)};
-}
-
-void write(std::deque<CompletedTask>&& tasks, VcfWriter& temp_vcf)
+std::thread make_task_writer_thread(TempVcfWriterMap& temp_writers, TempEvidenceWriters& temp_evidence_writers,
+                                    TaskWriterSyncPacket& writer_sync)
 {
-    static auto debug_log = get_debug_log();
-    for (auto&& task : tasks) {
-        if (debug_log) stream(*debug_log) << "Writing completed task " << task << " that finished in " << duration(task);
-        write_calls(std::move(task.calls), temp_vcf);
-    }
+    return std::thread {write_temp_vcf_helper, std::ref(temp_writers), std::ref(temp_evidence_writers), std::ref(writer_sync)};
 }
 
 void write(std::deque<CompletedTask>&& tasks, TaskWriterSyncPacket& sync)
@@ -997,13 +1324,14 @@ void write(std::deque<CompletedTask>&& tasks, TaskWriterSyncPacket& sync)
 
 // A CompletedTask can only be written if all proceeding tasks have completed (either written or buffered)
 void write_or_buffer(CompletedTask&& task, CompletedTaskMap::mapped_type& buffered_tasks,
-                     TaskQueue& running_tasks, HoldbackTask& holdback,
+                     UnfinishedTaskMap::mapped_type& unfinished_tasks, HoldbackTask& holdback,
                      TaskWriterSyncPacket& sync, const ContigCallingComponentFactory& calling_components)
 {
     static auto debug_log = get_debug_log();
-    if (is_same_region(task, running_tasks.front())) {
-        running_tasks.pop();
-        auto writable_tasks = get_writable_completed_tasks(std::move(task), buffered_tasks, running_tasks, holdback);
+    assert(!unfinished_tasks.empty());
+    if (contig_region(task) == *std::cbegin(unfinished_tasks)) {
+        unfinished_tasks.erase(std::cbegin(unfinished_tasks));
+        auto writable_tasks = get_writable_completed_tasks(std::move(task), buffered_tasks, unfinished_tasks, holdback);
         assert(holdback == boost::none);
         resolve_connecting_calls(writable_tasks, calling_components);
         // Keep the last task buffered to enable connection resolution when the next task finishes
@@ -1026,6 +1354,9 @@ void wait_until_finished(TaskWriterSyncPacket& sync)
     sync.done = true;
     lock.unlock();
     sync.cv.notify_one();
+    // The writer may still be writing the last tasks it took, which must come before any remaining tasks
+    lock.lock();
+    sync.cv.wait(lock, [&] () { return sync.finished; });
 }
 
 using FutureCompletedTasks = std::vector<std::future<CompletedTask>>;
@@ -1081,21 +1412,21 @@ void resolve_connecting_calls(RemainingTaskMap& remaining_tasks,
     }
 }
 
-void write(RemainingTaskMap&& remaining_tasks, TempVcfWriterMap& temp_vcfs)
+void write(RemainingTaskMap&& remaining_tasks, TempVcfWriterMap& temp_vcfs, TempEvidenceWriters& temp_evidence)
 {
     for (auto& p : remaining_tasks) {
-        write(std::move(p.second), temp_vcfs.at(p.first));
+        write(p.second, temp_vcfs, temp_evidence);
     }
 }
 
 void write_remaining_tasks(FutureCompletedTasks& futures, CompletedTaskMap& buffered_tasks, TempVcfWriterMap& temp_vcfs,
-                           const ContigCallingComponentFactoryMap& calling_components)
+                           TempEvidenceWriters& temp_evidence, const ContigCallingComponentFactoryMap& calling_components)
 {
     static auto debug_log = get_debug_log();
     if (debug_log) stream(*debug_log) << "Waiting for " << futures.size() << " running tasks to finish";
     auto remaining_tasks = extract_remaining_tasks(futures, buffered_tasks);
     resolve_connecting_calls(remaining_tasks, calling_components);
-    write(std::move(remaining_tasks), temp_vcfs);
+    write(std::move(remaining_tasks), temp_vcfs, temp_evidence);
 }
 
 auto extract_writers(TempVcfWriterMap&& vcfs)
@@ -1122,6 +1453,27 @@ void merge(TempVcfWriterMap&& temp_vcf_writers, GenomeCallingComponents& compone
     merge(temp_readers, components.output(), components.contigs());
 }
 
+void concatenate(TempEvidenceWriters&& temp_evidence, const GenomeCallingComponents& components)
+{
+    static auto debug_log = get_debug_log();
+    assert(temp_evidence.template_bam && components.bamout());
+    temp_evidence.open_part.reset();
+    std::vector<boost::filesystem::path> parts {};
+    parts.reserve(temp_evidence.parts.size());
+    // Parts are concatenated in BAM header order, and in write order within each contig, so the evidence BAM is sorted
+    for (const auto& contig : io::ReadReader {*temp_evidence.template_bam}.reference_contigs()) {
+        for (const auto& part : temp_evidence.parts) {
+            if (part.first == contig) parts.push_back(part.second);
+        }
+    }
+    if (debug_log) stream(*debug_log) << "Concatenating " << parts.size() << " temporary evidence BAM files";
+    if (parts.empty()) {
+        io::ReadWriter {*components.bamout(), *temp_evidence.template_bam}; // header only
+    } else {
+        io::concatenate(parts, *components.bamout());
+    }
+}
+
 void run_octopus_multi_threaded(GenomeCallingComponents& components)
 {
     using namespace std::chrono_literals;
@@ -1142,23 +1494,37 @@ void run_octopus_multi_threaded(GenomeCallingComponents& components)
     task_maker_thread.detach();
     
     FutureCompletedTasks futures(num_task_threads);
-    TaskMap running_tasks {ContigOrder {components.contigs()}};
+    UnfinishedTaskMap unfinished_tasks {};
     CompletedTaskMap buffered_tasks {};
     std::map<ContigName, HoldbackTask> holdbacks {};
     // Populate all the maps first so we can make unchecked accesses
     for (const auto& contig : components.contigs()) {
-        running_tasks.emplace(contig, TaskMap::mapped_type {});
+        unfinished_tasks.emplace(contig, UnfinishedTaskMap::mapped_type {});
         buffered_tasks.emplace(contig, CompletedTaskMap::mapped_type {});
         holdbacks.emplace(contig, boost::none);
     }
     
     CallerSyncPacket caller_sync {};
-    const auto calling_components = make_contig_calling_component_factory_map(components);
+    const auto calling_components = make_contig_calling_component_factory_map(components, num_task_threads);
+    NumaWorkerPlacement numa_placement {};
+    CallingThreadBudget thread_budget {num_task_threads};
+    if (debug_log && numa_placement.num_nodes() > 1) {
+        stream(*debug_log) << "Placing calling tasks on " << numa_placement.num_nodes() << " NUMA nodes";
+    }
+    std::unique_ptr<BAMRealigner> evidence_realigner {};
+    if (is_inline_bam_realignment_requested(components)) {
+        auto realigner_config = components.bamout_config();
+        realigner_config.max_threads = 1; // reads are realigned on the calling threads
+        evidence_realigner = std::make_unique<BAMRealigner>(std::move(realigner_config));
+        if (debug_log) *debug_log << "Realigning evidence reads during calling";
+    }
     unsigned num_idle_futures {0};
+    bool waiting_for_thread {false};
     
     auto temp_writers = make_temp_vcf_writers(components);
+    auto temp_evidence_writers = make_temp_evidence_writers(components);
     TaskWriterSyncPacket task_writer_sync {};
-    auto task_writer_thread = make_task_writer_thread(temp_writers, task_writer_sync);
+    auto task_writer_thread = make_task_writer_thread(temp_writers, temp_evidence_writers, task_writer_sync);
     if (!task_writer_thread.joinable()) {
         logging::FatalLogger fatal_log {};
         fatal_log << "Unable to make task writer thread";
@@ -1195,23 +1561,29 @@ void run_octopus_multi_threaded(GenomeCallingComponents& components)
         }
         pending_task_lock.unlock();
         num_idle_futures = 0;
+        waiting_for_thread = false;
         for (auto& future : futures) {
             if (is_ready(future)) {
                 auto completed_task = future.get();
                 const auto& contig = contig_name(completed_task.region);
                 write_or_buffer(std::move(completed_task), buffered_tasks.at(contig),
-                                running_tasks.at(contig), holdbacks.at(contig),
+                                unfinished_tasks.at(contig), holdbacks.at(contig),
                                 task_writer_sync, calling_components.at(contig));
                 --caller_sync.num_finished;
             }
             if (!future.valid()) {
                 pending_task_lock.lock();
-                if (task_maker_sync.num_tasks > 0) {
+                if (task_maker_sync.num_tasks > 0 && thread_budget.try_acquire()) {
                     pending_task_lock.unlock(); // As pop will need to lock the mutex too == deadlock
-                    auto task = pop(pending_tasks, task_maker_sync);
-                    future = run(task, calling_components.at(contig_name(task))(), caller_sync);
-                    running_tasks.at(contig_name(task)).push(std::move(task));
+                    auto task = pop(pending_tasks, task_maker_sync, unfinished_tasks);
+                    const auto& contig_calling_components = calling_components.at(contig_name(task));
+                    boost::optional<const BAMRealigner&> task_evidence_realigner {};
+                    if (evidence_realigner) task_evidence_realigner = *evidence_realigner;
+                    future = run(task, contig_calling_components(), contig_calling_components, task_evidence_realigner,
+                                 numa_placement, thread_budget, caller_sync);
                 } else {
+                    // Tasks may be waiting while skipped regions are re-called on the idle threads
+                    if (task_maker_sync.num_tasks > 0) waiting_for_thread = true;
                     pending_task_lock.unlock();
                     ++num_idle_futures;
                 }
@@ -1224,19 +1596,23 @@ void run_octopus_multi_threaded(GenomeCallingComponents& components)
             std::unique_lock<std::mutex> lock {caller_sync.mutex};
             caller_sync.cv.wait(lock, [&] () { return caller_sync.num_finished > 0; });
             task_maker_sync.waiting = true;
+        } else if (waiting_for_thread && caller_sync.num_finished == 0) {
+            // Finishing tasks also release their threads, so this can't miss a finished task
+            thread_budget.wait_until_available();
         } else {
             if (debug_log) stream(*debug_log) << "There are " << num_idle_futures << " idle futures";
         }
     }
     assert(task_maker_sync.num_tasks == 0);
     assert(pending_tasks.empty());
-    running_tasks.clear();
+    unfinished_tasks.clear();
     holdbacks.clear(); // holdbacks are just references to buffered tasks
     if (debug_log) *debug_log << "Finished making new tasks. Waiting for task writer to complete existing jobs";
     wait_until_finished(task_writer_sync);
-    write_remaining_tasks(futures, buffered_tasks, temp_writers, calling_components);
+    write_remaining_tasks(futures, buffered_tasks, temp_writers, temp_evidence_writers, calling_components);
     components.progress_meter().stop();
     merge(std::move(temp_writers), components);
+    if (evidence_realigner) concatenate(std::move(temp_evidence_writers), components);
 }
 
 } // namespace
@@ -1563,6 +1939,9 @@ auto get_haplotype_bam_paths(const boost::filesystem::path& prefix, const unsign
 
 void run_bam_realign(GenomeCallingComponents& components)
 {
+    if (is_inline_bam_realignment_requested(components)) {
+        return; // already made during calling
+    }
     if (is_bam_realignment_requested(components)) {
         if (check_bam_realign(components)) {
             components.read_manager().close();
@@ -1585,16 +1964,18 @@ void run_bam_realign(GenomeCallingComponents& components)
                         return;
                     }
                 }
+                std::vector<BAMRealigner::PathPair> bams {};
                 for (const auto& bamin_path : components.read_manager().paths()) {
                     auto bamout_path = bamout_directory;
                     bamout_path /= bamin_path.filename();
                     if (bamin_path != bamout_path) {
-                        realign(bamin_path, get_bam_realignment_vcf(components), bamout_path, components.reference(), components.bamout_config());
+                        bams.emplace_back(bamin_path, std::move(bamout_path));
                     } else {
                         logging::WarningLogger warn_log {};
                         stream(warn_log) << "Cannot make evidence bam " << bamout_path << " as it is an input bam";
                     }
                 }
+                realign(bams, get_bam_realignment_vcf(components), components.reference(), components.bamout_config());
             }
         }
     }
@@ -1628,8 +2009,43 @@ void run_post_calling_requests(GenomeCallingComponents& components)
     run_bam_realign(components);
 }
 
+WindowPlan make_window_plan(GenomeCallingComponents& components)
+{
+    // Windows are sized for the per-thread read buffer, as they would be when calling
+    const auto num_threads = is_multithreaded(components) ? calculate_num_task_threads(components) : 1u;
+    const auto window_config = default_window_config;
+    WindowPlan result {};
+    for (const auto& contig : components.contigs()) {
+        const auto contig_components = make_contig_components(contig, components, num_threads);
+        for (const auto& region : contig_components.regions) {
+            auto window = propose_call_subregion(contig_components, region, window_config);
+            while (!is_empty(window)) {
+                const auto num_reads = components.read_manager().count_reads(components.samples(), window);
+                result.add(window, num_reads, estimate_task_cost(contig_components, window, num_reads));
+                if (ends_equal(window, region)) break;
+                window = propose_call_subregion(contig_components, window, region, window_config);
+            }
+        }
+    }
+    return result;
+}
+
+void run_window_planner(GenomeCallingComponents& components)
+{
+    logging::InfoLogger info_log {};
+    info_log << "Making window plan";
+    const auto plan = make_window_plan(components);
+    write(plan, *components.make_window_plan_request());
+    stream(info_log) << "Window plan with " << plan.size() << " windows written to " << *components.make_window_plan_request();
+}
+
 void run_octopus(GenomeCallingComponents& components, UserCommandInfo info)
 {
+    if (components.make_window_plan_request()) {
+        run_window_planner(components);
+        cleanup(components);
+        return;
+    }
     run_variant_calling(components, std::move(info));
     run_post_calling_requests(components);
     cleanup(components);
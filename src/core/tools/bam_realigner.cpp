@@ -9,10 +9,14 @@
 #include <numeric>
 #include <utility>
 #include <thread>
+#include <future>
+#include <chrono>
+#include <string>
 #include <cmath>
 #include <cassert>
 
 #include <boost/functional/hash.hpp>
+#include <boost/filesystem/operations.hpp>
 
 #include "basics/genomic_region.hpp"
 #include "basics/cigar_string.hpp"
@@ -25,6 +29,7 @@
 #include "utils/read_stats.hpp"
 #include "utils/random_select.hpp"
 #include "utils/maths.hpp"
+#include "utils/map_utils.hpp"
 #include "read_assigner.hpp"
 #include "read_realigner.hpp"
 
@@ -358,31 +363,156 @@ auto move_merge(Container&& src, std::vector<T>& dst)
 BAMRealigner::Report
 BAMRealigner::realign(ReadReader& src, VcfReader& variants, ReadWriter& dst,
                       const ReferenceGenome& reference, SampleList samples) const
+{
+    return realign(src, variants.iterate(), dst, reference, samples, config_.max_buffer);
+}
+
+BAMRealigner::Report BAMRealigner::realign(ReadReader& src, VcfReader& variants, ReadWriter& dst,
+                                           const ReferenceGenome& reference) const
+{
+    return realign(src, variants, dst, reference, src.extract_samples());
+}
+
+BAMRealigner::Report
+BAMRealigner::realign(const Path& src, const VcfReader::Path& variants, const Path& dst,
+                      const ReferenceGenome& reference) const
+{
+    return realign(std::vector<PathPair> {{src, dst}}, variants, reference).front();
+}
+
+namespace {
+
+auto make_part_path(const BAMRealigner::Path& dst, const std::size_t part_idx)
+{
+    auto result = dst;
+    result += ".part" + std::to_string(part_idx) + ".bam";
+    return result;
+}
+
+void remove_parts(const std::vector<BAMRealigner::Path>& parts)
+{
+    boost::system::error_code ec {};
+    for (const auto& part : parts) {
+        boost::filesystem::remove(part, ec);
+        auto index = part;
+        index += ".bai";
+        boost::filesystem::remove(index, ec);
+    }
+}
+
+} // namespace
+
+std::vector<BAMRealigner::Report>
+BAMRealigner::realign(const std::vector<PathPair>& bams, const VcfReader::Path& variants,
+                      const ReferenceGenome& reference) const
+{
+    std::vector<std::vector<Path>> parts(bams.size());
+    std::vector<std::vector<std::future<Report>>> part_reports(bams.size());
+    const VcfReader vcf {variants};
+    // Each concurrent task has its own write buffer, so they share the buffer budget
+    const auto num_concurrent_tasks = std::max(workers_.size(), std::size_t {1});
+    const MemoryFootprint task_max_buffer {std::max(config_.max_buffer.bytes() / num_concurrent_tasks, std::size_t {1})};
+    for (std::size_t bam_idx {0}; bam_idx < bams.size(); ++bam_idx) {
+        const auto& src = bams[bam_idx].first;
+        const auto& dst = bams[bam_idx].second;
+        const ReadReader src_bam {src};
+        const auto samples = src_bam.extract_samples();
+        // Contigs are visited in BAM header order so the concatenated parts are sorted
+        for (const auto& contig : src_bam.reference_contigs()) {
+            if (vcf.count_records(contig) == 0) continue;
+            auto part = make_part_path(dst, parts[bam_idx].size());
+            parts[bam_idx].push_back(part);
+            auto realign_contig = [this, &src, &variants, &reference, samples, contig, task_max_buffer, part = std::move(part)] () {
+                ReadReader contig_src {src};
+                VcfReader contig_variants {variants};
+                ReadWriter contig_dst {part, src};
+                return realign(contig_src, contig_variants.iterate(contig), contig_dst, reference, samples, task_max_buffer);
+            };
+            if (workers_.empty()) {
+                part_reports[bam_idx].push_back(std::async(std::launch::deferred, std::move(realign_contig)));
+            } else {
+                part_reports[bam_idx].push_back(workers_.push(std::move(realign_contig)));
+            }
+        }
+    }
+    std::vector<Report> result(bams.size(), Report {0, 0});
+    for (std::size_t bam_idx {0}; bam_idx < bams.size(); ++bam_idx) {
+        try {
+            for (auto& part_report : part_reports[bam_idx]) {
+                const auto report = part_report.get();
+                result[bam_idx].n_reads_assigned += report.n_reads_assigned;
+                result[bam_idx].n_reads_unassigned += report.n_reads_unassigned;
+            }
+            if (parts[bam_idx].empty()) {
+                ReadWriter {bams[bam_idx].second, bams[bam_idx].first}; // header only
+            } else {
+                io::concatenate(parts[bam_idx], bams[bam_idx].second);
+            }
+        } catch (...) {
+            for (std::size_t i {bam_idx}; i < bams.size(); ++i) {
+                // Deferred parts were never started, but running parts still need to finish writing
+                for (auto& part_report : part_reports[i]) {
+                    if (part_report.valid() && part_report.wait_for(std::chrono::seconds {0}) != std::future_status::deferred) {
+                        part_report.wait();
+                    }
+                }
+                remove_parts(parts[i]);
+            }
+            throw;
+        }
+        remove_parts(parts[bam_idx]);
+    }
+    return result;
+}
+
+namespace {
+
+auto copy_reads_beginning_in(const ReadContainer& reads, const GenomicRegion& region, const bool primary_only)
+{
+    std::vector<AlignedRead> result {};
+    std::copy_if(std::cbegin(reads), std::cend(reads), std::back_inserter(result), [&] (const AlignedRead& read) {
+        return (!primary_only || is_primary_alignment(read))
+               && mapped_begin(read) >= region.begin() && mapped_begin(read) < region.end();
+    });
+    return result;
+}
+
+} // namespace
+
+std::vector<AnnotatedAlignedRead>
+BAMRealigner::realign(const ReadMap& reads, const std::vector<VcfRecord>& calls, const GenomicRegion& region,
+                      const ReferenceGenome& reference, Report& report) const
+{
+    std::vector<AnnotatedAlignedRead> result {};
+    auto genotypes = extract_genotypes(calls, extract_keys(reads), reference);
+    for (const auto& p : reads) {
+        auto sample_reads = copy_reads_beginning_in(p.second, region, config_.primary_only);
+        auto realigned_reads = realign(sample_reads, genotypes[p.first], reference, report);
+        // As in the BAM pass, reads away from the calls are only kept in full evidence BAMs
+        if (config_.copy_hom_ref_reads) {
+            move_merge(to_annotated(std::move(sample_reads)), realigned_reads);
+        }
+        move_merge(std::move(realigned_reads), result);
+    }
+    return result;
+}
+
+// private methods
+
+BAMRealigner::Report
+BAMRealigner::realign(ReadReader& src, VcfReader::RecordIteratorPair variants, ReadWriter& dst,
+                      const ReferenceGenome& reference, const SampleList& samples, const MemoryFootprint max_buffer) const
 {
     io::BufferedReadWriter<AnnotatedAlignedRead>::Config writer_config {};
-    writer_config.max_buffer_footprint = config_.max_buffer;
+    writer_config.max_buffer_footprint = max_buffer;
     io::BufferedReadWriter<AnnotatedAlignedRead> writer {dst, writer_config};
     Report report {};
     BatchList batch {};
     boost::optional<GenomicRegion> batch_region {};
-    for (auto p = variants.iterate(); p.first != p.second;) {
+    for (auto p = std::move(variants); p.first != p.second;) {
         std::tie(batch, batch_region) = read_next_batch(p.first, p.second, src, reference, samples, batch_region);
         for (auto& sample : batch) {
-            std::vector<AlignedRead> genotype_reads {};
-            std::vector<AnnotatedAlignedRead> realigned_reads {};
-            auto sample_reads_itr = std::begin(sample.reads);
-            for (const auto& genotype : sample.genotypes) {
-                const auto padded_genotype_region = expand(mapped_region(genotype), 1);
-                const auto overlapped_reads = bases(overlap_range(sample_reads_itr, std::end(sample.reads), padded_genotype_region));
-                genotype_reads.assign(std::make_move_iterator(overlapped_reads.begin()),
-                                      std::make_move_iterator(overlapped_reads.end()));
-                sample_reads_itr = sample.reads.erase(overlapped_reads.begin(), overlapped_reads.end());
-                auto bad_reads = to_annotated(remove_unalignable_reads(genotype_reads));
-                auto realignments = assign_and_realign(genotype_reads, genotype, reference, config_.alignment_model, config_.read_linkage, report);
-                report.n_reads_unassigned += bad_reads.size();
-                move_merge(bad_reads, realignments);
-                move_merge(realignments, realigned_reads);
-            }
+            auto realigned_reads = realign(sample.reads, sample.genotypes, reference, report);
             move_merge(to_annotated(std::move(sample.reads)), realigned_reads);
             writer << realigned_reads;
         }
@@ -391,14 +521,28 @@ BAMRealigner::realign(ReadReader& src, VcfReader& variants, ReadWriter& dst,
     return report;
 }
 
-BAMRealigner::Report BAMRealigner::realign(ReadReader& src, VcfReader& variants, ReadWriter& dst,
-                                           const ReferenceGenome& reference) const
+std::vector<AnnotatedAlignedRead>
+BAMRealigner::realign(std::vector<AlignedRead>& reads, const MappableFlatSet<Genotype<Haplotype>>& genotypes,
+                      const ReferenceGenome& reference, Report& report) const
 {
-    return realign(src, variants, dst, reference, src.extract_samples());
+    std::vector<AlignedRead> genotype_reads {};
+    std::vector<AnnotatedAlignedRead> result {};
+    auto reads_itr = std::begin(reads);
+    for (const auto& genotype : genotypes) {
+        const auto padded_genotype_region = expand(mapped_region(genotype), 1);
+        const auto overlapped_reads = bases(overlap_range(reads_itr, std::end(reads), padded_genotype_region));
+        genotype_reads.assign(std::make_move_iterator(overlapped_reads.begin()),
+                              std::make_move_iterator(overlapped_reads.end()));
+        reads_itr = reads.erase(overlapped_reads.begin(), overlapped_reads.end());
+        auto bad_reads = to_annotated(remove_unalignable_reads(genotype_reads));
+        auto realignments = assign_and_realign(genotype_reads, genotype, reference, config_.alignment_model, config_.read_linkage, report);
+        report.n_reads_unassigned += bad_reads.size();
+        move_merge(bad_reads, realignments);
+        move_merge(realignments, result);
+    }
+    return result;
 }
 
-// private methods
-
 namespace {
 
 GenomicRegion get_phase_set(const VcfRecord& record, const SampleName& sample)
@@ -560,11 +704,16 @@ BAMRealigner::Report
 realign(io::ReadReader::Path src, VcfReader::Path variants, io::ReadWriter::Path dst,
         const ReferenceGenome& reference, BAMRealigner::Config config)
 {
-    io::ReadWriter dst_bam {std::move(dst), src};
-    io::ReadReader src_bam {std::move(src)};
-    VcfReader vcf {std::move(variants)};
     BAMRealigner realigner {std::move(config)};
-    return realigner.realign(src_bam, vcf, dst_bam, reference);
+    return realigner.realign(src, variants, dst, reference);
+}
+
+std::vector<BAMRealigner::Report>
+realign(const std::vector<BAMRealigner::PathPair>& bams, VcfReader::Path variants,
+        const ReferenceGenome& reference, BAMRealigner::Config config)
+{
+    BAMRealigner realigner {std::move(config)};
+    return realigner.realign(bams, variants, reference);
 }
 
 } // namespace octopus
@@ -5,10 +5,12 @@
 #define bam_realigner_hpp
 
 #include <vector>
+#include <utility>
 #include <cstddef>
 
 #include <boost/optional.hpp>
 
+#include "config/common.hpp"
 #include "basics/aligned_read.hpp"
 #include "core/types/haplotype.hpp"
 #include "core/types/genotype.hpp"
@@ -17,6 +19,7 @@
 #include "io/reference/reference_genome.hpp"
 #include "io/read/read_reader.hpp"
 #include "io/read/read_writer.hpp"
+#include "io/read/annotated_aligned_read.hpp"
 #include "io/variant/vcf_reader.hpp"
 #include "utils/memory_footprint.hpp"
 #include "utils/thread_pool.hpp"
@@ -30,6 +33,8 @@ public:
     using ReadWriter = io::ReadWriter;
     using SampleName = ReadReader::SampleName;
     using SampleList = std::vector<SampleName>;
+    using Path       = ReadReader::Path;
+    using PathPair   = std::pair<Path, Path>; // source and destination BAMs
     
     struct Config
     {
@@ -63,6 +68,19 @@ public:
     Report realign(ReadReader& src, VcfReader& variants, ReadWriter& dst,
                    const ReferenceGenome& reference) const;
     
+    // Each contig with calls is realigned on the worker pool into a sorted partial BAM, and the
+    // parts are then concatenated into the destination BAM. Contigs from all the BAMs share the pool.
+    Report realign(const Path& src, const VcfReader::Path& variants, const Path& dst,
+                   const ReferenceGenome& reference) const;
+    std::vector<Report> realign(const std::vector<PathPair>& bams, const VcfReader::Path& variants,
+                                const ReferenceGenome& reference) const;
+    
+    // Realigns reads that are already in memory, such as the reads used to make the calls, rather
+    // than fetching them from a BAM. Only reads that begin in region are realigned.
+    std::vector<AnnotatedAlignedRead> realign(const ReadMap& reads, const std::vector<VcfRecord>& calls,
+                                              const GenomicRegion& region, const ReferenceGenome& reference,
+                                              Report& report) const;
+    
 private:
     using VcfIterator = VcfReader::RecordIterator;
     using CallBlock   = std::vector<VcfRecord>;
@@ -77,6 +95,10 @@ private:
     Config config_;
     mutable ThreadPool workers_;
     
+    Report realign(ReadReader& src, VcfReader::RecordIteratorPair variants, ReadWriter& dst,
+                   const ReferenceGenome& reference, const SampleList& samples, MemoryFootprint max_buffer) const;
+    std::vector<AnnotatedAlignedRead> realign(std::vector<AlignedRead>& reads, const MappableFlatSet<Genotype<Haplotype>>& genotypes,
+                                              const ReferenceGenome& reference, Report& report) const;
     CallBlock read_next_block(VcfIterator& first, const VcfIterator& last, const SampleList& samples) const;
     BatchListRegionPair read_next_batch(VcfIterator& first, const VcfIterator& last, ReadReader& src,
                                         const ReferenceGenome& reference, const SampleList& samples,
@@ -90,6 +112,9 @@ realign(io::ReadReader::Path src, VcfReader::Path variants, io::ReadWriter::Path
 BAMRealigner::Report
 realign(io::ReadReader::Path src, VcfReader::Path variants, io::ReadWriter::Path dst,
         const ReferenceGenome& reference, BAMRealigner::Config config);
+std::vector<BAMRealigner::Report>
+realign(const std::vector<BAMRealigner::PathPair>& bams, VcfReader::Path variants,
+        const ReferenceGenome& reference, BAMRealigner::Config config);
 
 } // namespace octopus
 
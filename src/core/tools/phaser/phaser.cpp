@@ -5,12 +5,16 @@
 
 #include <deque>
 #include <map>
+#include <unordered_map>
 #include <algorithm>
 #include <numeric>
 #include <cstddef>
 #include <cmath>
 #include <utility>
 #include <iostream>
+#include <bitset>
+#include <limits>
+#include <cstdint>
 
 #include <boost/functional/hash.hpp>
 #include <boost/graph/adjacency_list.hpp>
@@ -40,7 +44,6 @@ Phaser::Phaser(Config config) : config_ {config} {}
 namespace {
 
 using CompressedGenotype = Genotype<IndexedHaplotype<>>;
-using SharedGenotype = Genotype<SharedHaplotype>;
 
 template <typename Range>
 auto minmax_ploidy(const Range& genotypes) noexcept
@@ -232,162 +235,260 @@ Phaser::phase(const MappableBlock<Haplotype>& haplotypes,
 
 namespace {
 
-using GenotypeChunk = SharedGenotype;
-using GenotypeChunkPosteriorMap = std::unordered_map<GenotypeChunk, double>;
+using AlleleVector = std::vector<Allele>;
 
-struct GenotypeInfo
+/*
+    Allele indicator bitsets for one site. Bit a of a genotype's bitset is set if any haplotype
+    in the genotype has allele a at the site. The allele of each haplotype in the genotype is kept
+    too, so the phase of two sites can be compared without copying genotype chunks.
+ */
+struct SiteAlleleBitsets
 {
-    using AlleleIndex = std::uint8_t;
-    using AlleleIndexSet = std::vector<AlleleIndex>;
-    AlleleIndexSet alleles;
+    using AlleleIndex = std::uint16_t;
+    using Word = std::uint64_t;
+    
+    static constexpr AlleleIndex no_allele {std::numeric_limits<AlleleIndex>::max()};
+    static constexpr std::size_t word_size {std::numeric_limits<Word>::digits};
+    
+    std::size_t num_words, max_ploidy;
+    std::vector<Word> bitsets; // num_words per genotype
+    std::vector<AlleleIndex> haplotype_alleles; // max_ploidy per genotype, padded with no_allele
+    
+    const Word* bitset(const std::size_t genotype_idx) const noexcept
+    {
+        return bitsets.data() + genotype_idx * num_words;
+    }
+    const AlleleIndex* alleles(const std::size_t genotype_idx) const noexcept
+    {
+        return haplotype_alleles.data() + genotype_idx * max_ploidy;
+    }
 };
 
-using GenotypeInfoVector = std::vector<GenotypeInfo>;
-using GenotypeInfoMatrix = std::vector<GenotypeInfoVector>;
+constexpr SiteAlleleBitsets::AlleleIndex SiteAlleleBitsets::no_allele;
+constexpr std::size_t SiteAlleleBitsets::word_size;
 
-using AlleleVector = std::vector<Allele>;
+using SiteAlleleBitsetsVector = std::vector<SiteAlleleBitsets>;
 
-GenotypeInfo compute_genotype_info(const Genotype<Allele>& genotype, AlleleVector& alleles)
+auto num_words(const std::size_t num_bits) noexcept
 {
-    GenotypeInfo::AlleleIndexSet indices(genotype.ploidy());
-    const auto get_allele_index = [&] (const Allele& allele) -> GenotypeInfo::AlleleIndex {
-        const auto allele_itr = std::find(std::cbegin(alleles), std::cend(alleles), allele);
-        if (allele_itr != std::cend(alleles)) {
-            return std::distance(std::cbegin(alleles), allele_itr);
-        }
-        alleles.push_back(allele);
-        return alleles.size() - 1;
-    };
-    std::transform(std::cbegin(genotype), std::cend(genotype), std::begin(indices), get_allele_index);
-    std::sort(std::begin(indices), std::end(indices));
-    indices.erase(std::unique(std::begin(indices), std::end(indices)), std::end(indices));
-    return {std::move(indices)};
+    return std::max((num_bits + SiteAlleleBitsets::word_size - 1) / SiteAlleleBitsets::word_size, std::size_t {1});
 }
 
-GenotypeInfoVector compute_genotype_info(const std::vector<CompressedGenotype>& genotypes, const GenomicRegion& region)
+void set_bit(const std::size_t idx, SiteAlleleBitsets::Word* bitset) noexcept
 {
-    GenotypeInfoVector result(genotypes.size());
+    bitset[idx / SiteAlleleBitsets::word_size] |= SiteAlleleBitsets::Word {1} << (idx % SiteAlleleBitsets::word_size);
+}
+
+std::size_t count_bits(const SiteAlleleBitsets::Word* bitset, const std::size_t num_words) noexcept
+{
+    return std::accumulate(bitset, bitset + num_words, std::size_t {0}, [] (auto curr, auto word) {
+        return curr + std::bitset<SiteAlleleBitsets::word_size> {word}.count();
+    });
+}
+
+// The number of set bits before bit idx
+std::size_t count_bits_before(const std::size_t idx, const SiteAlleleBitsets::Word* bitset) noexcept
+{
+    const auto word_idx = idx / SiteAlleleBitsets::word_size;
+    const auto mask = (SiteAlleleBitsets::Word {1} << (idx % SiteAlleleBitsets::word_size)) - 1;
+    return count_bits(bitset, word_idx) + std::bitset<SiteAlleleBitsets::word_size> {bitset[word_idx] & mask}.count();
+}
+
+SiteAlleleBitsets
+make_site_allele_bitsets(const std::vector<CompressedGenotype>& genotypes, const GenomicRegion& site, const unsigned max_ploidy)
+{
+    using AlleleIndex = SiteAlleleBitsets::AlleleIndex;
+    SiteAlleleBitsets result {};
+    result.max_ploidy = max_ploidy;
+    result.haplotype_alleles.assign(genotypes.size() * max_ploidy, SiteAlleleBitsets::no_allele);
     AlleleVector alleles {};
     alleles.reserve(5);
-    transform_each(std::cbegin(genotypes), std::cend(genotypes),
-                  [&] (const auto& element) { return copy<Allele>(element, region); }, 
-                  [&] (const auto& genotype) { return compute_genotype_info(genotype, alleles); },
-                  std::begin(result));
+    // Genotypes share haplotypes, so each haplotype's allele is only copied once
+    std::vector<AlleleIndex> haplotype_allele_cache {};
+    const auto get_allele_index = [&] (const IndexedHaplotype<>& haplotype) -> AlleleIndex {
+        if (haplotype.index() >= haplotype_allele_cache.size()) {
+            haplotype_allele_cache.resize(haplotype.index() + 1, SiteAlleleBitsets::no_allele);
+        }
+        auto& result = haplotype_allele_cache[haplotype.index()];
+        if (result == SiteAlleleBitsets::no_allele) {
+            auto allele = copy<Allele>(haplotype.haplotype(), site);
+            const auto allele_itr = std::find(std::cbegin(alleles), std::cend(alleles), allele);
+            result = std::distance(std::cbegin(alleles), allele_itr);
+            if (allele_itr == std::cend(alleles)) alleles.push_back(std::move(allele));
+        }
+        return result;
+    };
+    for (std::size_t genotype_idx {0}; genotype_idx < genotypes.size(); ++genotype_idx) {
+        assert(genotypes[genotype_idx].ploidy() <= max_ploidy);
+        std::transform(std::cbegin(genotypes[genotype_idx]), std::cend(genotypes[genotype_idx]),
+                       std::next(std::begin(result.haplotype_alleles), genotype_idx * max_ploidy), get_allele_index);
+    }
+    result.num_words = num_words(alleles.size());
+    result.bitsets.assign(genotypes.size() * result.num_words, 0);
+    for (std::size_t genotype_idx {0}; genotype_idx < genotypes.size(); ++genotype_idx) {
+        const auto genotype_alleles = result.alleles(genotype_idx);
+        const auto genotype_bitset = result.bitsets.data() + genotype_idx * result.num_words;
+        for (std::size_t k {0}; k < max_ploidy && genotype_alleles[k] != SiteAlleleBitsets::no_allele; ++k) {
+            set_bit(genotype_alleles[k], genotype_bitset);
+        }
+    }
     return result;
 }
 
-auto compute_genotype_info(const std::vector<CompressedGenotype>& genotypes, const std::vector<GenomicRegion>& regions)
+auto make_site_allele_bitsets(const std::vector<CompressedGenotype>& genotypes, const std::vector<GenomicRegion>& sites)
 {
-    GenotypeInfoMatrix result {};
-    result.reserve(regions.size());
-    for (const auto& region : regions) {
-        result.push_back(compute_genotype_info(genotypes, region));
+    const auto max_ploidy = minmax_ploidy(genotypes).second;
+    SiteAlleleBitsetsVector result {};
+    result.reserve(sites.size());
+    for (const auto& site : sites) {
+        result.push_back(make_site_allele_bitsets(genotypes, site, max_ploidy));
     }
     return result;
 }
 
-bool is_heterozygous(std::size_t genotype_index, const GenotypeInfoVector& info) noexcept
+bool is_heterozygous(const std::size_t genotype_idx, const SiteAlleleBitsets& site) noexcept
 {
-    return info[genotype_index].alleles.size() > 1;
+    return count_bits(site.bitset(genotype_idx), site.num_words) > 1;
 }
 
-bool is_very_likely_homozygous(const GenomicRegion& region, 
-                               const Phaser::SampleGenotypePosteriorMap& genotype_posteriors, 
-                               const GenotypeInfoVector& info)
+bool is_very_likely_homozygous(const std::vector<double>& genotype_posteriors, const SiteAlleleBitsets& site)
 {
     assert(!genotype_posteriors.empty());
-    const static auto posterior_less = [] (const auto& lhs, const auto& rhs) { return lhs.second < rhs.second; };
-    const auto map_posterior_itr = std::max_element(std::cbegin(genotype_posteriors), std::cend(genotype_posteriors), posterior_less);
-    const auto map_posterior = map_posterior_itr->second;
-    return map_posterior > 0.9999 && !is_heterozygous(std::distance(std::cbegin(genotype_posteriors), map_posterior_itr), info);
+    const auto map_posterior_itr = std::max_element(std::cbegin(genotype_posteriors), std::cend(genotype_posteriors));
+    return *map_posterior_itr > 0.9999 && !is_heterozygous(std::distance(std::cbegin(genotype_posteriors), map_posterior_itr), site);
 }
 
-auto copy_each_helper(const std::vector<CompressedGenotype>& genotypes,
-                      const std::vector<GenomicRegion>& sites,
-                      const std::size_t lhs, const std::size_t rhs)
+/*
+    Computes pairwise phase qualities from the site allele bitsets.
+    
+    Genotypes that are heterozygous at both sites are grouped by their allele sets at each site.
+    Within a group, genotypes differ only in how the alleles at the two sites are paired on the
+    haplotypes (the genotype 'chunk'), which is encoded as the bitset of right-hand alleles paired
+    with each left-hand allele. The phase error is the posterior mass of the group that isn't on the
+    group's most probable chunk. Duplicate chunks are found by hashing the group and chunk bitsets.
+    The buffers are reused between site pairs.
+ */
+class PairwisePhaseScorer
 {
-    if (!are_adjacent(sites[lhs], sites[rhs])) {
-        const std::vector<GenomicRegion> sites_tmp {sites[lhs], sites[rhs]};
-        return copy_each<GenotypeChunk::ElementType>(genotypes, sites_tmp);
-    } else {
-        assert(is_before(sites[lhs], sites[rhs]));
-        const auto site = closed_region(sites[lhs], sites[rhs]);
-        return copy_each<GenotypeChunk::ElementType>(genotypes, site);
-    }
-}
+public:
+    PairwisePhaseScorer(const SiteAlleleBitsetsVector& sites, const std::vector<double>& genotype_posteriors)
+    : sites_ {sites}
+    , genotype_posteriors_ {genotype_posteriors}
+    {}
+    
+    Phred<double> score(std::size_t lhs, std::size_t rhs);
+    
+private:
+    using Word = SiteAlleleBitsets::Word;
+    
+    struct Chunk
+    {
+        std::size_t genotype_idx, key_idx;
+        double posterior;
+    };
+    
+    const SiteAlleleBitsetsVector& sites_;
+    const std::vector<double>& genotype_posteriors_;
+    std::vector<Chunk> chunks_;
+    std::vector<Word> keys_;
+    std::unordered_multimap<std::size_t, std::size_t> chunk_lookup_; // hash -> chunk index
+    
+    void add(std::size_t genotype_idx, const SiteAlleleBitsets& lhs, const SiteAlleleBitsets& rhs);
+    bool is_same_group(const Chunk& lhs_chunk, const Chunk& rhs_chunk, const SiteAlleleBitsets& lhs, const SiteAlleleBitsets& rhs) const noexcept;
+};
 
-auto
-compute_chunk_set_posteriors(const std::vector<CompressedGenotype>& genotypes,
-                             const std::vector<GenomicRegion>& sites,
-                             const std::size_t lhs, const std::size_t rhs,
-                             const Phaser::SampleGenotypePosteriorMap& genotype_posteriors,
-                             const GenotypeInfoMatrix& info)
+Phred<double> PairwisePhaseScorer::score(const std::size_t lhs, const std::size_t rhs)
 {
-    auto chunks = copy_each_helper(genotypes, sites, lhs, rhs);
-    using AlleleIndexSetRef = std::reference_wrapper<const GenotypeInfo::AlleleIndexSet>;
-    using AlleleIndexSetRefPair = std::pair<AlleleIndexSetRef, AlleleIndexSetRef>;
-    const static auto allele_index_pair_hasher = [] (const auto& p) {
-        std::size_t result {};
-        boost::hash_combine(result, p.first.get());
-        boost::hash_combine(result, p.second.get());
-        return result;
-    };
-    const static auto allele_index_pair_equal = [] (const auto& lhs, const auto& rhs) {
-        return lhs.first.get() == rhs.first.get() && lhs.second.get() == rhs.second.get();
+    const auto& lhs_site = sites_[lhs];
+    const auto& rhs_site = sites_[rhs];
+    chunks_.clear();
+    keys_.clear();
+    chunk_lookup_.clear();
+    for (std::size_t genotype_idx {0}; genotype_idx < genotype_posteriors_.size(); ++genotype_idx) {
+        if (is_heterozygous(genotype_idx, lhs_site) && is_heterozygous(genotype_idx, rhs_site)) {
+            add(genotype_idx, lhs_site, rhs_site);
+        }
+    }
+    const auto group_less = [&] (const Chunk& lhs_chunk, const Chunk& rhs_chunk) {
+        const auto lhs_first = lhs_site.bitset(lhs_chunk.genotype_idx), rhs_first = lhs_site.bitset(rhs_chunk.genotype_idx);
+        const auto p = std::mismatch(lhs_first, lhs_first + lhs_site.num_words, rhs_first);
+        if (p.first != lhs_first + lhs_site.num_words) return *p.first < *p.second;
+        return std::lexicographical_compare(rhs_site.bitset(lhs_chunk.genotype_idx), rhs_site.bitset(lhs_chunk.genotype_idx) + rhs_site.num_words,
+                                            rhs_site.bitset(rhs_chunk.genotype_idx), rhs_site.bitset(rhs_chunk.genotype_idx) + rhs_site.num_words);
     };
-    using AlleleIndexSetPairPosteriorMap = std::unordered_map<AlleleIndexSetRefPair, GenotypeChunkPosteriorMap,
-                                                              decltype(allele_index_pair_hasher), decltype(allele_index_pair_equal)>;
-    AlleleIndexSetPairPosteriorMap chunk_set_posteriors {10, allele_index_pair_hasher, allele_index_pair_equal};
-    for (std::size_t g {0}; g < genotypes.size(); ++g) {
-        if (is_heterozygous(g, info[lhs]) && is_heterozygous(g, info[rhs])) {
-            collapse(chunks[g]);
-            const auto index_pair = std::make_pair(std::cref(info[lhs][g].alleles), std::cref(info[rhs][g].alleles));
-            chunk_set_posteriors[index_pair][chunks[g]] += genotype_posteriors[genotypes[g]];
+    std::sort(std::begin(chunks_), std::end(chunks_), group_less);
+    double heterozygous_mass {0}, total_not_map_posterior {0};
+    for (auto group_itr = std::cbegin(chunks_); group_itr != std::cend(chunks_);) {
+        const auto group_end = std::find_if_not(std::next(group_itr), std::cend(chunks_), [&] (const Chunk& chunk) {
+            return is_same_group(*group_itr, chunk, lhs_site, rhs_site); });
+        double group_mass {0}, group_map_posterior {0};
+        std::for_each(group_itr, group_end, [&] (const Chunk& chunk) {
+            group_mass += chunk.posterior;
+            group_map_posterior = std::max(chunk.posterior, group_map_posterior);
+        });
+        heterozygous_mass += group_mass;
+        // subnormal numbers can cause divide by zero problems here when ffast-math is used.
+        if (std::distance(group_itr, group_end) > 1 && !maths::is_subnormal(group_mass)) {
+            total_not_map_posterior += group_mass - group_map_posterior;
         }
+        group_itr = group_end;
     }
-    std::vector<std::vector<double>> result {};
-    result.reserve(chunk_set_posteriors.size());
-    for (const auto& p : chunk_set_posteriors) {
-        result.push_back(extract_values(p.second));
+    if (maths::is_subnormal(heterozygous_mass) || heterozygous_mass <= 0) total_not_map_posterior = 0;
+    return probability_false_to_phred(total_not_map_posterior);
+}
+
+void PairwisePhaseScorer::add(const std::size_t genotype_idx, const SiteAlleleBitsets& lhs, const SiteAlleleBitsets& rhs)
+{
+    // The key has one rhs allele bitset for each allele in the lhs allele bitset, in allele order
+    const auto key_idx = keys_.size();
+    const auto lhs_alleles = lhs.alleles(genotype_idx);
+    const auto rhs_alleles = rhs.alleles(genotype_idx);
+    const auto lhs_bitset = lhs.bitset(genotype_idx);
+    keys_.resize(key_idx + count_bits(lhs_bitset, lhs.num_words) * rhs.num_words, 0);
+    for (std::size_t k {0}; k < lhs.max_ploidy && lhs_alleles[k] != SiteAlleleBitsets::no_allele; ++k) {
+        const auto lhs_allele_rank = count_bits_before(lhs_alleles[k], lhs_bitset);
+        set_bit(rhs_alleles[k], keys_.data() + key_idx + lhs_allele_rank * rhs.num_words);
+    }
+    const auto posterior = genotype_posteriors_[genotype_idx];
+    const auto key_first = std::next(std::cbegin(keys_), key_idx);
+    std::size_t hash {0};
+    boost::hash_range(hash, lhs_bitset, lhs_bitset + lhs.num_words);
+    boost::hash_range(hash, rhs.bitset(genotype_idx), rhs.bitset(genotype_idx) + rhs.num_words);
+    boost::hash_range(hash, key_first, std::cend(keys_));
+    const auto candidates = chunk_lookup_.equal_range(hash);
+    const auto duplicate_itr = std::find_if(candidates.first, candidates.second, [&] (const auto& p) {
+        const auto& chunk = chunks_[p.second];
+        return is_same_group(chunk, {genotype_idx, key_idx, posterior}, lhs, rhs)
+               && std::equal(key_first, std::cend(keys_), std::next(std::cbegin(keys_), chunk.key_idx));
+    });
+    if (duplicate_itr != candidates.second) {
+        chunks_[duplicate_itr->second].posterior += posterior;
+        keys_.resize(key_idx);
+    } else {
+        chunk_lookup_.emplace(hash, chunks_.size());
+        chunks_.push_back({genotype_idx, key_idx, posterior});
     }
-    return result;
 }
 
-auto compute_phase_quality(const std::vector<CompressedGenotype>& genotypes,
-                           const std::vector<GenomicRegion>& sites,
+bool PairwisePhaseScorer::is_same_group(const Chunk& lhs_chunk, const Chunk& rhs_chunk,
+                                        const SiteAlleleBitsets& lhs, const SiteAlleleBitsets& rhs) const noexcept
+{
+    return std::equal(lhs.bitset(lhs_chunk.genotype_idx), lhs.bitset(lhs_chunk.genotype_idx) + lhs.num_words, lhs.bitset(rhs_chunk.genotype_idx))
+        && std::equal(rhs.bitset(lhs_chunk.genotype_idx), rhs.bitset(lhs_chunk.genotype_idx) + rhs.num_words, rhs.bitset(rhs_chunk.genotype_idx));
+}
+
+auto compute_phase_quality(const std::vector<GenomicRegion>& sites,
                            const std::size_t lhs, const std::size_t rhs,
-                           const Phaser::SampleGenotypePosteriorMap& genotype_posteriors,
-                           const GenotypeInfoMatrix& info)
+                           const std::vector<double>& genotype_posteriors,
+                           const SiteAlleleBitsetsVector& site_bitsets,
+                           PairwisePhaseScorer& scorer)
 {
     if (overlaps(sites[lhs], sites[rhs])
-     || is_very_likely_homozygous(sites[lhs], genotype_posteriors, info[lhs])
-     || is_very_likely_homozygous(sites[rhs], genotype_posteriors, info[rhs])) {
+     || is_very_likely_homozygous(genotype_posteriors, site_bitsets[lhs])
+     || is_very_likely_homozygous(genotype_posteriors, site_bitsets[rhs])) {
         return probability_false_to_phred(0.0); // maximum quality
     }
-    auto chunk_set_posteriors = compute_chunk_set_posteriors(genotypes, sites, lhs, rhs, genotype_posteriors, info);
-    std::vector<double> set_weights(chunk_set_posteriors.size());
-    const static auto sum_probabilities = [] (const auto& probs) {
-         return std::accumulate(std::cbegin(probs), std::cend(probs), 0.0); };
-    std::transform(std::cbegin(chunk_set_posteriors), std::cend(chunk_set_posteriors), 
-                   std::begin(set_weights), sum_probabilities);
-    double total_not_map_posterior {0};
-    // subnormal numbers can cause divide by zero problems here when ffast-math is used.
-    const auto heterozygous_mass = maths::normalise(set_weights);
-    if (!maths::is_subnormal(heterozygous_mass) && heterozygous_mass > 0) {
-        for (std::size_t set_idx {0}; set_idx < chunk_set_posteriors.size(); ++set_idx) {
-            auto& posteriors = chunk_set_posteriors[set_idx];
-            if (posteriors.size() > 1 && !maths::is_subnormal(maths::normalise(posteriors))) {
-                for (auto& p : posteriors) p *= set_weights[set_idx];
-                assert(!posteriors.empty());
-                const auto map_posterior_itr = std::max_element(std::cbegin(posteriors), std::cend(posteriors));
-                const auto not_map_posterior = std::accumulate(std::cbegin(posteriors), map_posterior_itr,    
-                                               std::accumulate(std::next(map_posterior_itr), std::cend(posteriors), 0.0));
-                total_not_map_posterior += not_map_posterior;
-            }
-        }
-        total_not_map_posterior *= heterozygous_mass;
-    }
-    return probability_false_to_phred(total_not_map_posterior);
+    return scorer.score(lhs, rhs);
 }
 
 } // namespace
@@ -476,7 +577,11 @@ Phaser::phase_sample(const std::vector<GenomicRegion>& sites,
     using std::cbegin; using std::cend;
     using CompletePhaseGraph = boost::adjacency_list<boost::listS, boost::listS, boost::undirectedS, std::size_t>;
     using CompletePhaseGraphVertex = boost::graph_traits<CompletePhaseGraph>::vertex_descriptor;
-    const auto genotype_info = compute_genotype_info(genotypes, sites);
+    const auto site_bitsets = make_site_allele_bitsets(genotypes, sites);
+    std::vector<double> posteriors(genotypes.size());
+    std::transform(cbegin(genotype_posteriors), cend(genotype_posteriors), std::begin(posteriors),
+                   [] (const auto& p) { return p.second; });
+    PairwisePhaseScorer phase_scorer {site_bitsets, posteriors};
     CompletePhaseGraph phase_graph {};
     std::vector<CompletePhaseGraphVertex> vertices(sites.size());
     for (std::size_t idx {0}; idx < sites.size(); ++idx) {
@@ -485,8 +590,8 @@ Phaser::phase_sample(const std::vector<GenomicRegion>& sites,
     PhaseQualityTable pairwise_phase_qualities(sites.size(), PhaseQualityTable::value_type(sites.size()));
     for (std::size_t lhs_region_idx {0}; lhs_region_idx < sites.size() - 1; ++lhs_region_idx) {
         for (auto rhs_region_idx = lhs_region_idx + 1; rhs_region_idx < sites.size(); ++rhs_region_idx) {
-            const auto phase_quality = compute_phase_quality(genotypes, sites, lhs_region_idx, rhs_region_idx,
-                                                             genotype_posteriors, genotype_info);
+            const auto phase_quality = compute_phase_quality(sites, lhs_region_idx, rhs_region_idx, posteriors,
+                                                             site_bitsets, phase_scorer);
             if (phase_quality >= config_.min_phase_quality) {
                 boost::add_edge(vertices[lhs_region_idx], vertices[rhs_region_idx], phase_graph);
             }
@@ -0,0 +1,170 @@
+// Copyright (c) 2015-2020 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#include "refcall_columns.hpp"
+
+#include <array>
+#include <limits>
+#include <algorithm>
+#include <utility>
+#include <cmath>
+#include <cassert>
+
+#include "basics/cigar_string.hpp"
+#include "utils/maths.hpp"
+
+namespace octopus {
+
+namespace {
+
+struct QualityLnLikelihoods
+{
+    using Table = std::array<double, std::numeric_limits<RefCallColumns::BaseQuality>::max() + 1>;
+    Table match, mismatch, het;
+};
+
+const QualityLnLikelihoods& get_quality_ln_likelihoods()
+{
+    static const QualityLnLikelihoods result {[] () {
+        QualityLnLikelihoods tables {};
+        for (std::size_t quality {0}; quality < tables.match.size(); ++quality) {
+            const double phred = std::max(quality, std::size_t {1});
+            tables.mismatch[quality] = phred * -maths::constants::ln10Div10<>;
+            tables.match[quality] = std::log(1.0 - std::pow(10.0, -phred / 10.0));
+            tables.het[quality] = maths::log_sum_exp(tables.match[quality], tables.mismatch[quality]) - std::log(2);
+        }
+        return tables;
+    }()};
+    return result;
+}
+
+} // namespace
+
+RefCallColumns::RefCallColumns(GenomicRegion region, NucleotideSequence reference_sequence)
+: region_ {std::move(region)}
+, reference_sequence_ {std::move(reference_sequence)}
+, depths_(octopus::size(region_), 0)
+, hom_ref_ln_likelihoods_(octopus::size(region_), 0.0)
+, het_ln_likelihoods_(octopus::size(region_), 0.0)
+{
+    assert(reference_sequence_.size() == octopus::size(region_));
+}
+
+const GenomicRegion& RefCallColumns::mapped_region() const noexcept
+{
+    return region_;
+}
+
+const RefCallColumns::NucleotideSequence& RefCallColumns::reference_sequence() const noexcept
+{
+    return reference_sequence_;
+}
+
+std::size_t RefCallColumns::size() const noexcept
+{
+    return depths_.size();
+}
+
+void RefCallColumns::add(const AlignedRead& read)
+{
+    const auto& sequence = read.sequence();
+    const auto& qualities = read.base_qualities();
+    auto position = mapped_begin(read);
+    const auto in_region = [this] (auto position) { return region_.begin() <= position && position < region_.end(); };
+    // Bases from unaligned_begin up to the current sequence index are waiting for the next reference position
+    std::size_t sequence_idx {0}, unaligned_begin {0};
+    for (const auto& op : read.cigar()) {
+        if (position >= region_.end()) break;
+        // Soft clipped bases are mapped, so are compared against the reference like matches
+        if (is_match_or_substitution(op) || op.flag() == CigarOperation::Flag::softClipped) {
+            for (CigarOperation::Size i {0}; i < op.size(); ++i, ++position, ++sequence_idx) {
+                if (in_region(position)) {
+                    const auto offset = static_cast<std::size_t>(position - region_.begin());
+                    if (unaligned_begin == sequence_idx && sequence[sequence_idx] == reference_sequence_[offset]) {
+                        add_reference(offset, qualities[sequence_idx]);
+                    } else {
+                        for (auto idx = unaligned_begin; idx <= sequence_idx; ++idx) {
+                            add_non_reference(offset, qualities[idx]);
+                        }
+                    }
+                }
+                unaligned_begin = sequence_idx + 1;
+            }
+        } else if (advances_reference(op)) {
+            if (unaligned_begin < sequence_idx && in_region(position)) {
+                const auto offset = static_cast<std::size_t>(position - region_.begin());
+                for (auto idx = unaligned_begin; idx < sequence_idx; ++idx) {
+                    add_non_reference(offset, qualities[idx]);
+                }
+            }
+            position += op.size();
+            unaligned_begin = sequence_idx;
+        } else if (advances_sequence(op)) {
+            sequence_idx += op.size();
+        }
+    }
+}
+
+unsigned RefCallColumns::depth(const std::size_t offset) const noexcept
+{
+    return depths_[offset];
+}
+
+Phred<double> RefCallColumns::homozygous_reference_posterior(const std::size_t offset) const noexcept
+{
+    if (depths_[offset] == 0) return Phred<double> {3.0};
+    const auto het_ln_posterior = het_ln_likelihoods_[offset] - maths::log_sum_exp(hom_ref_ln_likelihoods_[offset], het_ln_likelihoods_[offset]);
+    return log_probability_false_to_phred(het_ln_posterior);
+}
+
+// private methods
+
+void RefCallColumns::add_reference(const std::size_t offset, const BaseQuality quality) noexcept
+{
+    const auto& ln_likelihoods = get_quality_ln_likelihoods();
+    ++depths_[offset];
+    hom_ref_ln_likelihoods_[offset] += ln_likelihoods.match[quality];
+    het_ln_likelihoods_[offset] += ln_likelihoods.het[quality];
+}
+
+void RefCallColumns::add_non_reference(const std::size_t offset, const BaseQuality quality) noexcept
+{
+    const auto& ln_likelihoods = get_quality_ln_likelihoods();
+    ++depths_[offset];
+    hom_ref_ln_likelihoods_[offset] += ln_likelihoods.mismatch[quality];
+    het_ln_likelihoods_[offset] += ln_likelihoods.het[quality];
+}
+
+// non-member methods
+
+std::vector<RefCallBlock> make_blocks(const RefCallColumns& columns, const RefCallBlockParameters& parameters)
+{
+    const auto cap = [&] (const Phred<double> posterior) {
+        return parameters.max_posterior ? std::min(posterior, *parameters.max_posterior) : posterior;
+    };
+    const auto& region = columns.mapped_region();
+    std::vector<RefCallBlock> result {};
+    boost::optional<RefCallBlock> block {};
+    for (std::size_t offset {0}; offset < columns.size(); ++offset) {
+        const auto posterior = columns.homozygous_reference_posterior(offset);
+        if (posterior < parameters.min_posterior) {
+            if (block) result.push_back(std::move(*block));
+            block = boost::none;
+            continue;
+        }
+        const auto quality = cap(posterior);
+        if (block && parameters.merge_threshold
+            && std::abs(cap(block->posterior).score() - quality.score()) < parameters.merge_threshold->score()) {
+            block->region = expand_rhs(block->region, 1);
+            block->quality = std::min(block->quality, quality);
+        } else {
+            if (block) result.push_back(std::move(*block));
+            const auto position = static_cast<GenomicRegion::Position>(region.begin() + offset);
+            block = RefCallBlock {GenomicRegion {region.contig_name(), position, position + 1}, quality, posterior};
+        }
+    }
+    if (block) result.push_back(std::move(*block));
+    return result;
+}
+
+} // namespace octopus
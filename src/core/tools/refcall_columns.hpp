@@ -0,0 +1,83 @@
+// Copyright (c) 2015-2020 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#ifndef refcall_columns_hpp
+#define refcall_columns_hpp
+
+#include <vector>
+#include <cstddef>
+
+#include <boost/optional.hpp>
+
+#include "basics/genomic_region.hpp"
+#include "basics/aligned_read.hpp"
+#include "basics/phred.hpp"
+
+namespace octopus {
+
+/*
+    RefCallColumns summarises the reads in a reference-only region for reference confidence
+    calling. Rather than one ReadPileup per position, it keeps flat per-position columns of
+    depth and of the log likelihoods of the homozygous reference and heterozygous genotypes,
+    which is all the reference confidence model needs.
+
+    Each read is walked once along its CIGAR. As with ReadPileup, soft clipped bases are treated
+    as aligned, and inserted bases belong to the next reference position, which then doesn't
+    match the reference.
+ */
+class RefCallColumns
+{
+public:
+    using NucleotideSequence = AlignedRead::NucleotideSequence;
+    using BaseQuality        = AlignedRead::BaseQuality;
+
+    RefCallColumns() = delete;
+
+    RefCallColumns(GenomicRegion region, NucleotideSequence reference_sequence);
+
+    RefCallColumns(const RefCallColumns&)            = default;
+    RefCallColumns& operator=(const RefCallColumns&) = default;
+    RefCallColumns(RefCallColumns&&)                 = default;
+    RefCallColumns& operator=(RefCallColumns&&)      = default;
+
+    ~RefCallColumns() = default;
+
+    const GenomicRegion& mapped_region() const noexcept;
+    const NucleotideSequence& reference_sequence() const noexcept;
+    std::size_t size() const noexcept;
+
+    void add(const AlignedRead& read);
+
+    unsigned depth(std::size_t offset) const noexcept;
+    Phred<double> homozygous_reference_posterior(std::size_t offset) const noexcept;
+
+private:
+    GenomicRegion region_;
+    NucleotideSequence reference_sequence_;
+    std::vector<unsigned> depths_;
+    std::vector<double> hom_ref_ln_likelihoods_, het_ln_likelihoods_;
+
+    void add_reference(std::size_t offset, BaseQuality quality) noexcept;
+    void add_non_reference(std::size_t offset, BaseQuality quality) noexcept;
+};
+
+struct RefCallBlock
+{
+    GenomicRegion region;
+    Phred<double> quality, posterior;
+};
+
+struct RefCallBlockParameters
+{
+    Phred<double> min_posterior;
+    boost::optional<Phred<double>> max_posterior, merge_threshold;
+};
+
+// Positions below min_posterior are skipped, and the rest are capped at max_posterior. Adjacent
+// positions are merged while their quality is within merge_threshold of the first position in the
+// block, and the block quality is the minimum. Without a merge_threshold each position is a block.
+std::vector<RefCallBlock> make_blocks(const RefCallColumns& columns, const RefCallBlockParameters& parameters);
+
+} // namespace octopus
+
+#endif
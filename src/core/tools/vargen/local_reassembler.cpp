@@ -141,6 +141,23 @@ bool LocalReassembler::Bin::empty() const noexcept
     return forward_read_sequences.empty() && reverse_read_sequences.empty();
 }
 
+void LocalReassembler::AssemblerCache::clear() noexcept
+{
+    assembler = boost::none;
+    reads.clear();
+    references.clear();
+}
+
+void LocalReassembler::AssemblerCache::evict_references()
+{
+    // Kmers are views of the sequence they were first seen in, and only pop_front leaves the
+    // remaining sequences in place
+    while (!references.empty() && is_before(references.front().region, region)
+           && !(assembler && assembler->is_viewing(references.front().sequence))) {
+        references.pop_front();
+    }
+}
+
 bool LocalReassembler::do_requires_reads() const noexcept
 {
     return true;
@@ -350,15 +367,17 @@ std::vector<Variant> LocalReassembler::do_generate(const RegionSet& regions) con
     if (bins.empty()) return {};
     std::deque<Variant> candidates {};
     if (execution_policy_ == ExecutionPolicy::seq || bins.size() < 2) {
+        AssemblerCacheMap assembler_caches {};
         for (auto& bin : bins) {
             if (debug_log_) {
                 stream(*debug_log_) << "Assembling " << bin.size() << " reads in bin " << mapped_region(bin);
             }
-            const auto num_default_failures = try_assemble_with_defaults(bin, candidates);
+            const auto num_default_failures = try_assemble_with_defaults(bin, candidates, &assembler_caches);
             if (num_default_failures == default_kmer_sizes_.size()) {
                 try_assemble_with_fallbacks(bin, candidates);
             }
             bin.clear();
+            for (auto& p : assembler_caches) p.second.evict_references();
         }
     } else {
         const std::size_t num_threads {4};
@@ -489,11 +508,11 @@ void log_failure(L& log, const char* type, const unsigned k)
 
 } // namespace
 
-unsigned LocalReassembler::try_assemble_with_defaults(const Bin& bin, std::deque<Variant>& result) const
+unsigned LocalReassembler::try_assemble_with_defaults(const Bin& bin, std::deque<Variant>& result, AssemblerCacheMap* caches) const
 {
     unsigned num_failures {0};
     for (const auto k : default_kmer_sizes_) {
-        const auto status = assemble_bin(k, bin, result);
+        const auto status = caches ? assemble_bin(k, bin, (*caches)[k], result) : assemble_bin(k, bin, result);
         switch (status) {
             case AssemblerStatus::success:
                 log_success(debug_log_, "Default", k);
@@ -565,6 +584,69 @@ void LocalReassembler::load(const Bin& bin, Assembler& assembler) const
     }
 }
 
+void LocalReassembler::load(const Bin& bin, AssemblerCache& cache) const
+{
+    assert(cache.assembler);
+    load(bin, *cache.assembler);
+    cache.reads.reserve(bin.size());
+    for (const auto& read : bin.forward_read_sequences) {
+        cache.reads.emplace(std::addressof(read.sequence.get()), AssemblerCache::ReadRecord {read, Assembler::Direction::forward});
+    }
+    for (const auto& read : bin.reverse_read_sequences) {
+        cache.reads.emplace(std::addressof(read.sequence.get()), AssemblerCache::ReadRecord {read, Assembler::Direction::reverse});
+    }
+}
+
+bool LocalReassembler::can_slide(const AssemblerCache& cache, const Bin& bin, const GenomicRegion& assemble_region) const
+{
+    if (!cache.assembler || !is_same_contig(cache.region, assemble_region)) return false;
+    if (begins_before(assemble_region, cache.region)) return false;
+    if (overlap_size(cache.region, assemble_region) < static_cast<GenomicRegion::Distance>(cache.assembler->kmer_size())) return false;
+    // Removing a read costs about the same as inserting one, so only slide if that is cheaper than rebuilding
+    std::size_t num_kept_reads {0};
+    for (const auto& read : bin.forward_read_sequences) {
+        num_kept_reads += cache.reads.count(std::addressof(read.sequence.get()));
+    }
+    for (const auto& read : bin.reverse_read_sequences) {
+        num_kept_reads += cache.reads.count(std::addressof(read.sequence.get()));
+    }
+    const auto num_removed_reads  = cache.reads.size() - num_kept_reads;
+    const auto num_inserted_reads = bin.size() - num_kept_reads;
+    return num_removed_reads + num_inserted_reads < bin.size();
+}
+
+void LocalReassembler::slide(AssemblerCache& cache, const Bin& bin, const GenomicRegion& assemble_region) const
+{
+    assert(cache.assembler && !cache.references.empty());
+    auto& assembler = *cache.assembler;
+    assembler.slide_reference(cache.references.back().sequence, begin_distance(cache.region, assemble_region));
+    AssemblerCache::ReadRecordMap bin_reads {};
+    bin_reads.reserve(bin.size());
+    for (const auto& read : bin.forward_read_sequences) {
+        bin_reads.emplace(std::addressof(read.sequence.get()), AssemblerCache::ReadRecord {read, Assembler::Direction::forward});
+    }
+    for (const auto& read : bin.reverse_read_sequences) {
+        bin_reads.emplace(std::addressof(read.sequence.get()), AssemblerCache::ReadRecord {read, Assembler::Direction::reverse});
+    }
+    for (const auto& p : cache.reads) {
+        if (bin_reads.count(p.first) == 0) {
+            assembler.remove_read(p.second.data.sequence, p.second.data.base_qualities, p.second.direction);
+        }
+    }
+    // Insert in bin order so the graph layout does not depend on read addresses
+    for (const auto& read : bin.forward_read_sequences) {
+        if (cache.reads.count(std::addressof(read.sequence.get())) == 0) {
+            assembler.insert_read(read.sequence, read.base_qualities, Assembler::Direction::forward);
+        }
+    }
+    for (const auto& read : bin.reverse_read_sequences) {
+        if (cache.reads.count(std::addressof(read.sequence.get())) == 0) {
+            assembler.insert_read(read.sequence, read.base_qualities, Assembler::Direction::reverse);
+        }
+    }
+    cache.reads = std::move(bin_reads);
+}
+
 LocalReassembler::AssemblerStatus
 LocalReassembler::assemble_bin(const unsigned kmer_size, const Bin& bin, std::deque<Variant>& result) const
 {
@@ -582,6 +664,36 @@ LocalReassembler::assemble_bin(const unsigned kmer_size, const Bin& bin, std::de
     }
 }
 
+LocalReassembler::AssemblerStatus
+LocalReassembler::assemble_bin(const unsigned kmer_size, const Bin& bin, AssemblerCache& cache, std::deque<Variant>& result) const
+{
+    if (bin.empty()) return AssemblerStatus::success;
+    const auto assemble_region = propose_assembler_region(bin.region, kmer_size);
+    if (size(assemble_region) < kmer_size) return AssemblerStatus::failed;
+    auto reference_sequence = reference_.get().fetch_sequence(assemble_region);
+    if (!utils::is_canonical_dna(reference_sequence)) return AssemblerStatus::failed;
+    if (can_slide(cache, bin, assemble_region)) {
+        cache.references.push_back({assemble_region, std::move(reference_sequence)});
+        slide(cache, bin, assemble_region);
+    } else {
+        cache.clear();
+        cache.references.push_back({assemble_region, std::move(reference_sequence)});
+        cache.assembler.emplace(Assembler::Parameters {kmer_size, 0.01}, cache.references.back().sequence);
+        if (cache.assembler->is_unique_reference()) {
+            load(bin, cache);
+        }
+    }
+    cache.region = assemble_region;
+    if (cache.assembler->is_unique_reference()) {
+        // The cached graph must stay unpruned, so assemble a copy
+        Assembler assembler {*cache.assembler};
+        return try_assemble_region(assembler, cache.references.back().sequence, assemble_region, result);
+    } else {
+        cache.clear();
+        return AssemblerStatus::failed;
+    }
+}
+
 bool is_inversion(const Assembler::Variant& v) noexcept
 {
     return v.ref.size() > 2
@@ -6,6 +6,7 @@
 
 #include <vector>
 #include <map>
+#include <unordered_map>
 #include <cstddef>
 #include <functional>
 #include <memory>
@@ -113,6 +114,33 @@ private:
     
     using BinList = std::deque<Bin>;
     
+    // Overlapping bins share most of their reads, so the unpruned graph of the last bin
+    // assembled with each default kmer size is kept and slid onto the next bin.
+    struct AssemblerCache
+    {
+        struct ReadRecord
+        {
+            Bin::ReadData data;
+            Assembler::Direction direction;
+        };
+        using ReadRecordMap = std::unordered_map<const NucleotideSequence*, ReadRecord>;
+        struct ReferenceRecord
+        {
+            GenomicRegion region;
+            NucleotideSequence sequence;
+        };
+        
+        GenomicRegion region;
+        boost::optional<Assembler> assembler;
+        ReadRecordMap reads;
+        std::deque<ReferenceRecord> references;
+        
+        void clear() noexcept;
+        // Frees references before the current region that no kmers view anymore
+        void evict_references();
+    };
+    using AssemblerCacheMap = std::unordered_map<unsigned, AssemblerCache>;
+    
     enum class AssemblerStatus { success, partial_success, failed };
     
     ExecutionPolicy execution_policy_;
@@ -130,11 +158,15 @@ private:
     void prepare_bins(const GenomicRegion& active_region, BinList& bins) const;
     bool should_assemble_bin(const Bin& bin) const;
     void finalise_bins(BinList& bins, const RegionSet& active_regions) const;
-    unsigned try_assemble_with_defaults(const Bin& bin, std::deque<Variant>& result) const;
+    unsigned try_assemble_with_defaults(const Bin& bin, std::deque<Variant>& result, AssemblerCacheMap* caches = nullptr) const;
     void try_assemble_with_fallbacks(const Bin& bin, std::deque<Variant>& result) const;
     GenomicRegion propose_assembler_region(const GenomicRegion& input_region, unsigned kmer_size) const;
     void load(const Bin& bin, Assembler& assembler) const;
+    void load(const Bin& bin, AssemblerCache& cache) const;
+    bool can_slide(const AssemblerCache& cache, const Bin& bin, const GenomicRegion& assemble_region) const;
+    void slide(AssemblerCache& cache, const Bin& bin, const GenomicRegion& assemble_region) const;
     AssemblerStatus assemble_bin(unsigned kmer_size, const Bin& bin, std::deque<Variant>& result) const;
+    AssemblerStatus assemble_bin(unsigned kmer_size, const Bin& bin, AssemblerCache& cache, std::deque<Variant>& result) const;
     AssemblerStatus try_assemble_region(Assembler& assembler, const NucleotideSequence& reference_sequence,
                                         const GenomicRegion& reference_region, std::deque<Variant>& result) const;
     double calculate_min_bubble_score(const GenomicRegion& assemble_region) const;
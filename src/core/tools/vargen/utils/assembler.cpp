@@ -11,6 +11,8 @@
 #include <limits>
 #include <cassert>
 #include <iostream>
+#include <functional>
+#include <memory>
 
 #include <boost/functional/hash.hpp>
 #include <boost/property_map/property_map.hpp>
@@ -79,6 +81,41 @@ Assembler::Assembler(const Parameters params, const NucleotideSequence& referenc
     insert_reference_into_empty_graph(reference);
 }
 
+Assembler::Assembler(const Assembler& other)
+: params_ {other.params_}
+, reference_kmers_ {other.reference_kmers_}
+, reference_head_position_ {other.reference_head_position_}
+, graph_ {}
+, vertex_cache_ {}
+, reference_vertices_ {}
+, reference_edges_ {}
+{
+    std::unordered_map<Vertex, Vertex> vertex_map {};
+    vertex_map.reserve(boost::num_vertices(other.graph_));
+    vertex_cache_.reserve(other.vertex_cache_.size());
+    std::size_t index {0};
+    const auto vertices = boost::vertices(other.graph_);
+    std::for_each(vertices.first, vertices.second, [&] (const Vertex u) {
+        const auto& node = other.graph_[u];
+        const auto v = boost::add_vertex({index++, node.kmer, node.is_reference}, graph_);
+        vertex_map.emplace(u, v);
+        vertex_cache_.emplace(node.kmer, v);
+    });
+    const auto edges = boost::edges(other.graph_);
+    std::for_each(edges.first, edges.second, [&] (const Edge e) {
+        boost::add_edge(vertex_map.at(boost::source(e, other.graph_)), vertex_map.at(boost::target(e, other.graph_)),
+                        other.graph_[e], graph_);
+    });
+    for (const Vertex u : other.reference_vertices_) {
+        reference_vertices_.push_back(vertex_map.at(u));
+    }
+    for (const Edge e : other.reference_edges_) {
+        const auto u = vertex_map.at(boost::source(e, other.graph_));
+        const auto v = vertex_map.at(boost::target(e, other.graph_));
+        reference_edges_.push_back(boost::edge(u, v, graph_).first);
+    }
+}
+
 unsigned Assembler::kmer_size() const noexcept
 {
     return params_.kmer_size;
@@ -184,8 +221,9 @@ void Assembler::insert_read(const NucleotideSequence& sequence,
                         auto ref_vertex_itr = std::next(std::cbegin(reference_vertices_), ref_offset);
                         auto ref_edge_itr = std::next(std::cbegin(reference_edges_), ref_offset);
                         ++ref_kmer_itr;
+                        ++base_quality_itr;
                         for (; next_kmer_end <= std::cend(sequence) && ref_kmer_itr < std::cend(reference_kmers_);
-                               ++next_kmer_begin, ++next_kmer_end, ++ref_kmer_itr, ++ref_vertex_itr, ++ref_edge_itr) {
+                               ++next_kmer_begin, ++next_kmer_end, ++ref_kmer_itr, ++ref_vertex_itr, ++ref_edge_itr, ++base_quality_itr) {
                             if (std::equal(next_kmer_begin, next_kmer_end, std::cbegin(*ref_kmer_itr))) {
                                 assert(ref_edge_itr != std::cend(reference_edges_));
                                 increment_weight(*ref_edge_itr, is_forward_strand, *base_quality_itr);
@@ -198,6 +236,7 @@ void Assembler::insert_read(const NucleotideSequence& sequence,
                         }
                         kmer_begin = std::prev(next_kmer_begin);
                         kmer_end   = std::prev(next_kmer_end);
+                        --base_quality_itr;
                         assert(kmer_end <= std::cend(sequence));
                         kmer = Kmer {kmer_begin, kmer_end};
                     }
@@ -209,6 +248,110 @@ void Assembler::insert_read(const NucleotideSequence& sequence,
     }
 }
 
+void Assembler::remove_read(const NucleotideSequence& sequence,
+                            const BaseQualityVector& base_qualities,
+                            const Direction strand)
+{
+    if (sequence.size() < kmer_size()) return;
+    const bool is_forward_strand {strand == Direction::forward};
+    auto kmer_begin = std::cbegin(sequence);
+    auto kmer_end   = std::next(kmer_begin, kmer_size());
+    auto base_quality_itr = std::next(std::cbegin(base_qualities), kmer_size());
+    std::vector<Vertex> read_vertices {};
+    read_vertices.reserve(count_kmers(sequence, kmer_size()));
+    auto prev_vertex_itr = vertex_cache_.find(Kmer {kmer_begin, kmer_end});
+    if (prev_vertex_itr != std::cend(vertex_cache_)) {
+        read_vertices.push_back(prev_vertex_itr->second);
+    }
+    ++kmer_begin;
+    ++kmer_end;
+    for (; kmer_end <= std::cend(sequence); ++kmer_begin, ++kmer_end, ++base_quality_itr) {
+        const auto vertex_itr = vertex_cache_.find(Kmer {kmer_begin, kmer_end});
+        if (vertex_itr != std::cend(vertex_cache_)) {
+            if (prev_vertex_itr != std::cend(vertex_cache_)) {
+                Edge e; bool e_in_graph;
+                std::tie(e, e_in_graph) = boost::edge(prev_vertex_itr->second, vertex_itr->second, graph_);
+                assert(e_in_graph);
+                if (e_in_graph) {
+                    decrement_weight(e, is_forward_strand, *base_quality_itr);
+                    if (graph_[e].weight == 0 && !is_reference(e)) {
+                        remove_edge(e);
+                    }
+                }
+            }
+            read_vertices.push_back(vertex_itr->second);
+        }
+        prev_vertex_itr = vertex_itr;
+    }
+    std::sort(std::begin(read_vertices), std::end(read_vertices));
+    read_vertices.erase(std::unique(std::begin(read_vertices), std::end(read_vertices)), std::end(read_vertices));
+    for (const Vertex v : read_vertices) {
+        if (!is_reference(v) && boost::in_degree(v, graph_) == 0 && boost::out_degree(v, graph_) == 0) {
+            remove_vertex(v);
+        }
+    }
+}
+
+void Assembler::slide_reference(const NucleotideSequence& sequence, const std::size_t offset)
+{
+    if (is_reference_empty() || offset >= reference_kmers_.size() || sequence.size() < kmer_size()) {
+        throw std::runtime_error {"Assembler: slid reference must overlap the current reference"};
+    }
+    const auto num_new_kmers = count_kmers(sequence, kmer_size());
+    const auto num_shared_kmers = std::min(reference_kmers_.size() - offset, num_new_kmers);
+    const auto last_shared_kmer_begin = std::next(std::cbegin(sequence), num_shared_kmers - 1);
+    if (!(reference_kmers_[offset] == Kmer {std::cbegin(sequence), std::next(std::cbegin(sequence), kmer_size())})
+        || !(reference_kmers_[offset + num_shared_kmers - 1] == Kmer {last_shared_kmer_begin, std::next(last_shared_kmer_begin, kmer_size())})) {
+        throw std::runtime_error {"Assembler: slid reference must overlap the current reference"};
+    }
+    for (std::size_t i {0}; i < offset; ++i) {
+        demote_reference_head();
+    }
+    while (reference_kmers_.size() > num_new_kmers) {
+        demote_reference_tail();
+    }
+    auto kmer_begin = std::next(std::cbegin(sequence), reference_kmers_.size());
+    auto kmer_end   = std::next(kmer_begin, kmer_size());
+    for (; kmer_end <= std::cend(sequence); ++kmer_begin, ++kmer_end) {
+        const auto u = reference_tail();
+        reference_kmers_.emplace_back(kmer_begin, kmer_end);
+        const auto& kmer = reference_kmers_.back();
+        Vertex v;
+        if (contains_kmer(kmer)) {
+            v = vertex_cache_.at(kmer);
+            set_vertex_reference(v);
+        } else {
+            const auto new_vertex = add_vertex(kmer, true);
+            if (!new_vertex) {
+                throw NonCanonicalReferenceSequence {sequence};
+            }
+            v = *new_vertex;
+        }
+        Edge e; bool e_in_graph;
+        std::tie(e, e_in_graph) = boost::edge(u, v, graph_);
+        if (e_in_graph) {
+            set_edge_reference(e);
+        } else {
+            e = add_reference_edge(u, v);
+        }
+        reference_vertices_.push_back(v);
+        reference_edges_.push_back(e);
+    }
+    reference_head_position_ = 0;
+}
+
+bool Assembler::is_viewing(const NucleotideSequence& sequence) const
+{
+    const std::less<const char*> before {};
+    const auto first = sequence.data(), last = sequence.data() + sequence.size();
+    const auto is_view = [&] (const Kmer& kmer) {
+        const auto kmer_first = std::addressof(*kmer.begin());
+        return !before(kmer_first, first) && before(kmer_first, last);
+    };
+    return std::any_of(std::cbegin(reference_kmers_), std::cend(reference_kmers_), is_view)
+        || std::any_of(std::cbegin(vertex_cache_), std::cend(vertex_cache_), [&] (const auto& p) { return is_view(p.first); });
+}
+
 std::size_t Assembler::num_kmers() const noexcept
 {
     return vertex_cache_.size();
@@ -635,6 +778,18 @@ void Assembler::increment_weight(const Edge e, const bool is_forward, const int
     if (is_forward) ++edge.forward_strand_weight;
 }
 
+void Assembler::decrement_weight(const Edge e, const bool is_forward, const int base_quality)
+{
+    auto& edge = graph_[e];
+    assert(edge.weight > 0);
+    --edge.weight;
+    edge.base_quality_sum -= base_quality;
+    if (is_forward) {
+        assert(edge.forward_strand_weight > 0);
+        --edge.forward_strand_weight;
+    }
+}
+
 void Assembler::set_vertex_reference(const Vertex v)
 {
     graph_[v].is_reference = true;
@@ -731,6 +886,45 @@ Assembler::Vertex Assembler::prev_reference(const Vertex v) const
     return boost::source(*itr, graph_);
 }
 
+void Assembler::demote_reference_head()
+{
+    const auto u = reference_head();
+    if (!reference_edges_.empty()) {
+        const auto e = reference_edges_.front();
+        if (graph_[e].weight == 0) {
+            remove_edge(e);
+        } else {
+            graph_[e].is_reference = false;
+        }
+    }
+    pop_reference_head();
+    demote_reference_vertex(u);
+}
+
+void Assembler::demote_reference_tail()
+{
+    const auto v = reference_tail();
+    if (!reference_edges_.empty()) {
+        const auto e = reference_edges_.back();
+        if (graph_[e].weight == 0) {
+            remove_edge(e);
+        } else {
+            graph_[e].is_reference = false;
+        }
+    }
+    pop_reference_tail();
+    demote_reference_vertex(v);
+}
+
+void Assembler::demote_reference_vertex(const Vertex v)
+{
+    // The reference path is unique so v cannot appear elsewhere in the reference
+    graph_[v].is_reference = false;
+    if (boost::in_degree(v, graph_) == 0 && boost::out_degree(v, graph_) == 0) {
+        remove_vertex(v);
+    }
+}
+
 std::size_t Assembler::num_reference_kmers() const
 {
     const auto p = boost::vertices(graph_);
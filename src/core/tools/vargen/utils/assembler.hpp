@@ -54,7 +54,7 @@ public:
     Assembler(Parameters params);
     Assembler(Parameters params, const NucleotideSequence& reference);
     
-    Assembler(const Assembler&)            = delete;
+    Assembler(const Assembler&);
     Assembler& operator=(const Assembler&) = delete;
     Assembler(Assembler&&)                 = default;
     Assembler& operator=(Assembler&&)      = default;
@@ -73,6 +73,21 @@ public:
                      const BaseQualityVector& base_qualities,
                      Direction strand);
     
+    // Removes a read previously threaded into the graph with insert_read.
+    // Non-reference kmers left without any edges are removed.
+    void remove_read(const NucleotideSequence& sequence,
+                     const BaseQualityVector& base_qualities,
+                     Direction strand);
+    
+    // Moves the reference to the given sequence, which must begin offset bases after the
+    // current reference head and share at least one kmer with the current reference.
+    // Kmers that leave the reference are kept as non-reference kmers if reads support them.
+    // As with insert_reference, the sequence must outlive any kmers that view it.
+    void slide_reference(const NucleotideSequence& sequence, std::size_t offset);
+    
+    // Returns true if any kmer in the graph or reference is a view of the given sequence
+    bool is_viewing(const NucleotideSequence& sequence) const;
+    
     // Returns the current number of unique kmers in the graph
     std::size_t num_kmers() const noexcept;
     
@@ -218,6 +233,7 @@ private:
     void remove_edge(Vertex u, Vertex v);
     void remove_edge(Edge e);
     void increment_weight(Edge e, bool is_forward, int base_quality);
+    void decrement_weight(Edge e, bool is_forward, int base_quality);
     void set_vertex_reference(Vertex v);
     void set_vertex_reference(const Kmer& kmer);
     void set_edge_reference(Edge e);
@@ -236,6 +252,9 @@ private:
     Vertex reference_tail() const;
     Vertex next_reference(Vertex u) const;
     Vertex prev_reference(Vertex v) const;
+    void demote_reference_head();
+    void demote_reference_tail();
+    void demote_reference_vertex(Vertex v);
     bool is_dangling_branch(Vertex v) const;
     boost::optional<Vertex> find_joining_kmer(Vertex v) const;
     std::size_t num_reference_kmers() const;
@@ -0,0 +1,437 @@
+// Copyright (c) 2015-2020 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#include "candidate_store.hpp"
+
+#include <array>
+#include <algorithm>
+#include <iterator>
+#include <limits>
+#include <cstring>
+#include <cmath>
+#include <stdexcept>
+
+#include <boost/filesystem/operations.hpp>
+
+#include "concepts/mappable.hpp"
+#include "exceptions/malformed_file_error.hpp"
+#include "exceptions/unwritable_file_error.hpp"
+
+namespace octopus { namespace coretools {
+
+/*
+    File layout (native byte order):
+
+    header: magic[8] | version (u32) | flags (u32) | index offset (u64) | metadata length (u32) | metadata
+    blocks: records (record_size * n) | packed alleles
+    index:  num contigs (u32) | { name length (u32) | name | num blocks (u32) | { offset (u64) | num records (u32) | first begin (u32) | max end (u32) } }
+
+    record: begin (u32) | ref length (u16) | alt length (u16) | allele offset (u32) | encoding (u8) | pad (3) | [allele frequency (f32)]
+ */
+
+namespace {
+
+constexpr std::array<char, 8> magic {{'O', 'C', 'T', 'C', 'A', 'N', 'D', 'S'}};
+constexpr std::uint32_t version {2};
+constexpr std::uint32_t has_allele_frequencies_flag {1};
+constexpr std::size_t fixed_header_size {28}; // excluding the metadata
+constexpr std::size_t base_record_size {16};
+constexpr std::size_t allele_frequency_size {4};
+constexpr std::size_t block_index_entry_size {20};
+
+enum class AlleleEncoding : std::uint8_t { two_bit, raw };
+
+auto record_size(const bool has_allele_frequencies) noexcept
+{
+    return base_record_size + (has_allele_frequencies ? allele_frequency_size : 0);
+}
+
+template <typename T>
+void append(const T value, std::vector<char>& buffer)
+{
+    const auto bytes = reinterpret_cast<const char*>(&value);
+    buffer.insert(std::end(buffer), bytes, bytes + sizeof(T));
+}
+
+template <typename T>
+void write_value(const T value, std::ofstream& out)
+{
+    out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+T read(const char* data) noexcept
+{
+    T result;
+    std::memcpy(&result, data, sizeof(T));
+    return result;
+}
+
+std::int8_t two_bit_code(const char base) noexcept
+{
+    switch (base) {
+        case 'A': return 0;
+        case 'C': return 1;
+        case 'G': return 2;
+        case 'T': return 3;
+        default: return -1;
+    }
+}
+
+bool is_two_bit_encodable(const Variant::NucleotideSequence& sequence) noexcept
+{
+    return std::all_of(std::cbegin(sequence), std::cend(sequence), [] (char base) { return two_bit_code(base) >= 0; });
+}
+
+void pack(const Variant::NucleotideSequence& ref, const Variant::NucleotideSequence& alt, std::vector<char>& result)
+{
+    const auto num_bases = ref.size() + alt.size();
+    const auto first_byte = result.size();
+    result.resize(first_byte + (num_bases + 3) / 4, 0);
+    std::size_t i {0};
+    for (const auto& sequence : {std::cref(ref), std::cref(alt)}) {
+        for (const char base : sequence.get()) {
+            result[first_byte + i / 4] |= static_cast<char>(two_bit_code(base) << (2 * (i % 4)));
+            ++i;
+        }
+    }
+}
+
+Variant::NucleotideSequence unpack(const char* data, const std::size_t first_base, const std::size_t num_bases)
+{
+    static constexpr std::array<char, 4> bases {{'A', 'C', 'G', 'T'}};
+    Variant::NucleotideSequence result(num_bases, 'N');
+    for (std::size_t i {0}; i < num_bases; ++i) {
+        const auto j = first_base + i;
+        result[i] = bases[(static_cast<unsigned char>(data[j / 4]) >> (2 * (j % 4))) & 3u];
+    }
+    return result;
+}
+
+class MalformedCandidateStore : public MalformedFileError
+{
+    std::string do_where() const override { return "CandidateStore"; }
+    
+    std::string do_help() const override
+    {
+        return "remake the store from the source VCF";
+    }
+public:
+    MalformedCandidateStore(boost::filesystem::path file, std::string reason)
+    : MalformedFileError {std::move(file), "candidate store"}
+    {
+        set_reason(std::move(reason));
+    }
+};
+
+class UnwritableCandidateStore : public UnwritableFileError
+{
+    std::string do_where() const override { return "CandidateStore::Writer"; }
+public:
+    UnwritableCandidateStore(boost::filesystem::path file) : UnwritableFileError {std::move(file), "candidate store"} {}
+};
+
+} // namespace
+
+// CandidateStore
+
+CandidateStore::CandidateStore(Path file)
+: file_ {std::move(file)}
+, data_ {}
+, metadata_ {}
+, has_allele_frequencies_ {false}
+, index_ {}
+{
+    if (!is_candidate_store(file_)) {
+        throw MalformedCandidateStore {file_, "the file is not a candidate store"};
+    }
+    data_.open(file_.string());
+    if (data_.size() < fixed_header_size) {
+        throw MalformedCandidateStore {file_, "the header is truncated"};
+    }
+    const auto flags = read<std::uint32_t>(data_.data() + magic.size() + sizeof(std::uint32_t));
+    has_allele_frequencies_ = flags & has_allele_frequencies_flag;
+    const auto metadata_length = read<std::uint32_t>(data_.data() + fixed_header_size - sizeof(std::uint32_t));
+    if (data_.size() - fixed_header_size < metadata_length) {
+        throw MalformedCandidateStore {file_, "the header is truncated"};
+    }
+    metadata_.assign(data_.data() + fixed_header_size, metadata_length);
+    read_index(read<std::uint64_t>(data_.data() + magic.size() + 2 * sizeof(std::uint32_t)));
+}
+
+bool CandidateStore::is_candidate_store(const Path& file)
+{
+    std::ifstream in {file.string(), std::ios::binary};
+    std::array<char, magic.size()> file_magic {};
+    if (!in.read(file_magic.data(), file_magic.size()) || file_magic != magic) return false;
+    std::uint32_t file_version {};
+    in.read(reinterpret_cast<char*>(&file_version), sizeof(file_version));
+    return in && file_version == version;
+}
+
+const CandidateStore::Path& CandidateStore::path() const noexcept
+{
+    return file_;
+}
+
+const std::string& CandidateStore::metadata() const noexcept
+{
+    return metadata_;
+}
+
+bool CandidateStore::has_allele_frequencies() const noexcept
+{
+    return has_allele_frequencies_;
+}
+
+std::vector<GenomicRegion::ContigName> CandidateStore::contigs() const
+{
+    std::vector<GenomicRegion::ContigName> result {};
+    result.reserve(index_.size());
+    for (const auto& p : index_) result.push_back(p.first);
+    std::sort(std::begin(result), std::end(result));
+    return result;
+}
+
+std::vector<CandidateStore::Candidate> CandidateStore::fetch(const GenomicRegion& region) const
+{
+    std::vector<Candidate> result {};
+    const auto contig_itr = index_.find(region.contig_name());
+    if (contig_itr == std::cend(index_)) return result;
+    const auto& blocks = contig_itr->second;
+    // Blocks are sorted by first_begin and max_end is non-decreasing, so the blocks that may
+    // overlap the region are contiguous
+    const auto first_block = std::partition_point(std::cbegin(blocks), std::cend(blocks),
+                                                  [&] (const Block& block) { return block.max_end < region.begin(); });
+    const auto last_block = std::partition_point(first_block, std::cend(blocks),
+                                                 [&] (const Block& block) { return block.first_begin <= region.end(); });
+    std::for_each(first_block, last_block, [&] (const Block& block) { fetch(region, block, result); });
+    return result;
+}
+
+// private methods
+
+void CandidateStore::read_index(const std::uint64_t offset)
+{
+    const auto file_size = data_.size();
+    const auto blocks_begin = fixed_header_size + metadata_.size();
+    if (offset < blocks_begin || offset + sizeof(std::uint32_t) > file_size) {
+        throw MalformedCandidateStore {file_, "the block index is missing; the file may be truncated"};
+    }
+    auto data = data_.data() + offset;
+    const auto end = data_.data() + file_size;
+    const auto num_contigs = read<std::uint32_t>(data);
+    data += sizeof(std::uint32_t);
+    index_.reserve(num_contigs);
+    for (std::uint32_t c {0}; c < num_contigs; ++c) {
+        if (end - data < static_cast<std::ptrdiff_t>(sizeof(std::uint32_t))) {
+            throw MalformedCandidateStore {file_, "the block index is truncated"};
+        }
+        const auto name_length = read<std::uint32_t>(data);
+        data += sizeof(std::uint32_t);
+        if (end - data < static_cast<std::ptrdiff_t>(name_length + sizeof(std::uint32_t))) {
+            throw MalformedCandidateStore {file_, "the block index is truncated"};
+        }
+        GenomicRegion::ContigName contig {data, name_length};
+        data += name_length;
+        const auto num_blocks = read<std::uint32_t>(data);
+        data += sizeof(std::uint32_t);
+        if (end - data < static_cast<std::ptrdiff_t>(num_blocks * block_index_entry_size)) {
+            throw MalformedCandidateStore {file_, "the block index is truncated"};
+        }
+        std::vector<Block> blocks(num_blocks);
+        for (auto& block : blocks) {
+            block.offset      = read<std::uint64_t>(data);
+            block.num_records = read<std::uint32_t>(data + 8);
+            block.first_begin = read<std::uint32_t>(data + 12);
+            block.max_end     = read<std::uint32_t>(data + 16);
+            data += block_index_entry_size;
+            // Blocks lie between the header and the index
+            if (block.offset < blocks_begin || block.offset > offset
+                || (offset - block.offset) / record_size(has_allele_frequencies_) < block.num_records) {
+                throw MalformedCandidateStore {file_, "a block of contig " + contig + " lies outside the candidate data"};
+            }
+        }
+        index_.emplace(std::move(contig), std::move(blocks));
+    }
+}
+
+void CandidateStore::fetch(const GenomicRegion& region, const Block& block, std::vector<Candidate>& result) const
+{
+    const auto record_bytes = record_size(has_allele_frequencies_);
+    const auto records = data_.data() + block.offset;
+    const auto alleles = records + block.num_records * record_bytes;
+    // read_index checked that the records are in the file, but the alleles must be checked too
+    const auto max_allele_bytes = static_cast<std::size_t>((data_.data() + data_.size()) - alleles);
+    for (std::uint32_t i {0}; i < block.num_records; ++i) {
+        const auto record = records + i * record_bytes;
+        const auto begin = read<std::uint32_t>(record);
+        if (begin > region.end()) break;
+        const auto ref_length = read<std::uint16_t>(record + 4);
+        const auto alt_length = read<std::uint16_t>(record + 6);
+        if (begin + ref_length < region.begin()) continue;
+        const auto allele_offset = read<std::uint32_t>(record + 8);
+        const auto encoding = static_cast<AlleleEncoding>(read<std::uint8_t>(record + 12));
+        const auto num_bases = static_cast<std::size_t>(ref_length) + alt_length;
+        const auto allele_bytes = encoding == AlleleEncoding::two_bit ? (num_bases + 3) / 4 : num_bases;
+        if (allele_offset > max_allele_bytes || max_allele_bytes - allele_offset < allele_bytes) {
+            throw MalformedCandidateStore {file_, "a record's alleles lie outside the file"};
+        }
+        Variant::NucleotideSequence ref, alt;
+        if (encoding == AlleleEncoding::two_bit) {
+            ref = unpack(alleles + allele_offset, 0, ref_length);
+            alt = unpack(alleles + allele_offset, ref_length, alt_length);
+        } else {
+            ref.assign(alleles + allele_offset, ref_length);
+            alt.assign(alleles + allele_offset + ref_length, alt_length);
+        }
+        Variant variant {region.contig_name(), begin, std::move(ref), std::move(alt)};
+        if (!overlaps(variant, region)) continue;
+        boost::optional<float> allele_frequency {};
+        if (has_allele_frequencies_) {
+            const auto frequency = read<float>(record + base_record_size);
+            if (!std::isnan(frequency)) allele_frequency = frequency;
+        }
+        result.push_back({std::move(variant), allele_frequency});
+    }
+}
+
+// CandidateStore::Writer
+
+CandidateStore::Writer::Writer(Path file)
+: Writer {std::move(file), Options {}}
+{}
+
+CandidateStore::Writer::Writer(Path file, Options options)
+: file_ {std::move(file)}
+, options_ {options}
+, out_ {file_.string(), std::ios::binary | std::ios::trunc}
+, index_ {}
+, written_contigs_ {}
+, block_records_ {}
+, block_alleles_ {}
+, num_block_records_ {0}
+, block_first_begin_ {0}
+, last_begin_ {0}
+, max_end_ {0}
+, offset_ {fixed_header_size + options_.metadata.size()}
+, closed_ {false}
+{
+    if (!out_) {
+        throw UnwritableCandidateStore {file_};
+    }
+    if (options_.block_size == 0) options_.block_size = 1;
+    // The index offset is filled in by close
+    out_.write(magic.data(), magic.size());
+    write_value(version, out_);
+    write_value(options_.store_allele_frequencies ? has_allele_frequencies_flag : std::uint32_t {0}, out_);
+    write_value(std::uint64_t {0}, out_);
+    write_value(static_cast<std::uint32_t>(options_.metadata.size()), out_);
+    out_.write(options_.metadata.data(), options_.metadata.size());
+}
+
+CandidateStore::Writer::~Writer()
+{
+    try {
+        close();
+    } catch (...) {}
+}
+
+void CandidateStore::Writer::write(const Variant& variant, const boost::optional<float> allele_frequency)
+{
+    if (closed_) {
+        throw std::runtime_error {"CandidateStore::Writer: writing to closed store " + file_.string()};
+    }
+    const auto& contig = contig_name(variant);
+    if (index_.empty() || index_.back().first != contig) {
+        start_contig(contig);
+    }
+    const auto begin = mapped_begin(variant);
+    if (begin < last_begin_) {
+        throw std::runtime_error {"CandidateStore::Writer: candidates must be written in position order"};
+    }
+    const auto& ref = ref_sequence(variant);
+    const auto& alt = alt_sequence(variant);
+    constexpr auto max_allele_length = std::numeric_limits<std::uint16_t>::max();
+    if (ref.size() > max_allele_length || alt.size() > max_allele_length) {
+        throw std::invalid_argument {"CandidateStore::Writer: allele too long"};
+    }
+    if (num_block_records_ == 0) block_first_begin_ = begin;
+    append(static_cast<std::uint32_t>(begin), block_records_);
+    append(static_cast<std::uint16_t>(ref.size()), block_records_);
+    append(static_cast<std::uint16_t>(alt.size()), block_records_);
+    append(static_cast<std::uint32_t>(block_alleles_.size()), block_records_);
+    if (is_two_bit_encodable(ref) && is_two_bit_encodable(alt)) {
+        append(static_cast<std::uint8_t>(AlleleEncoding::two_bit), block_records_);
+        pack(ref, alt, block_alleles_);
+    } else {
+        append(static_cast<std::uint8_t>(AlleleEncoding::raw), block_records_);
+        block_alleles_.insert(std::end(block_alleles_), std::cbegin(ref), std::cend(ref));
+        block_alleles_.insert(std::end(block_alleles_), std::cbegin(alt), std::cend(alt));
+    }
+    block_records_.resize(block_records_.size() + 3, 0);
+    if (options_.store_allele_frequencies) {
+        append(allele_frequency ? *allele_frequency : std::numeric_limits<float>::quiet_NaN(), block_records_);
+    }
+    last_begin_ = begin;
+    max_end_ = std::max(max_end_, mapped_end(variant));
+    ++num_block_records_;
+    if (num_block_records_ == options_.block_size) {
+        flush_block();
+    }
+}
+
+void CandidateStore::Writer::close()
+{
+    if (closed_) return;
+    closed_ = true;
+    flush_block();
+    const auto index_offset = offset_;
+    write_value(static_cast<std::uint32_t>(index_.size()), out_);
+    for (const auto& contig_blocks : index_) {
+        write_value(static_cast<std::uint32_t>(contig_blocks.first.size()), out_);
+        out_.write(contig_blocks.first.data(), contig_blocks.first.size());
+        write_value(static_cast<std::uint32_t>(contig_blocks.second.size()), out_);
+        for (const auto& block : contig_blocks.second) {
+            write_value(block.offset, out_);
+            write_value(block.num_records, out_);
+            write_value(static_cast<std::uint32_t>(block.first_begin), out_);
+            write_value(static_cast<std::uint32_t>(block.max_end), out_);
+        }
+    }
+    out_.seekp(magic.size() + 2 * sizeof(std::uint32_t));
+    write_value(index_offset, out_);
+    out_.close();
+    if (!out_) {
+        throw UnwritableCandidateStore {file_};
+    }
+}
+
+// private methods
+
+void CandidateStore::Writer::start_contig(const GenomicRegion::ContigName& contig)
+{
+    flush_block();
+    if (written_contigs_.count(contig) > 0) {
+        throw std::runtime_error {"CandidateStore::Writer: candidates on contig " + contig + " must be written together"};
+    }
+    written_contigs_.insert(contig);
+    index_.emplace_back(contig, std::vector<Block> {});
+    last_begin_ = 0;
+    max_end_ = 0;
+}
+
+void CandidateStore::Writer::flush_block()
+{
+    if (num_block_records_ == 0) return;
+    out_.write(block_records_.data(), block_records_.size());
+    out_.write(block_alleles_.data(), block_alleles_.size());
+    index_.back().second.push_back({offset_, num_block_records_, block_first_begin_, max_end_});
+    offset_ += block_records_.size() + block_alleles_.size();
+    block_records_.clear();
+    block_alleles_.clear();
+    num_block_records_ = 0;
+}
+
+} // namespace coretools
+} // namespace octopus
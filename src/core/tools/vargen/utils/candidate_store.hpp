@@ -0,0 +1,139 @@
+// Copyright (c) 2015-2020 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#ifndef candidate_store_hpp
+#define candidate_store_hpp
+
+#include <vector>
+#include <string>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+
+#include <boost/filesystem/path.hpp>
+#include <boost/optional.hpp>
+#include <boost/iostreams/device/mapped_file.hpp>
+
+#include "basics/genomic_region.hpp"
+#include "core/types/variant.hpp"
+
+namespace octopus { namespace coretools {
+
+/*
+    A CandidateStore is a compact, position-sorted, read-only file of candidate variants.
+
+    Alleles are 2-bit packed (unless they contain non-ACGT bases) and records are grouped into
+    fixed size blocks with a per-contig block index. The file is memory mapped, so a region
+    query is a binary search of the index and a scan of the overlapping blocks. Queries don't
+    modify any state and can be made concurrently without locking.
+
+    The header carries a free-form metadata string, which the store's maker can use to record
+    how the candidates were selected.
+ */
+class CandidateStore
+{
+public:
+    using Path = boost::filesystem::path;
+
+    struct Candidate
+    {
+        Variant variant;
+        boost::optional<float> allele_frequency;
+    };
+
+    class Writer;
+
+    CandidateStore() = delete;
+
+    CandidateStore(Path file);
+
+    CandidateStore(const CandidateStore&)            = delete;
+    CandidateStore& operator=(const CandidateStore&) = delete;
+    CandidateStore(CandidateStore&&)                 = default;
+    CandidateStore& operator=(CandidateStore&&)      = default;
+
+    ~CandidateStore() = default;
+
+    static bool is_candidate_store(const Path& file);
+
+    const Path& path() const noexcept;
+    const std::string& metadata() const noexcept;
+    bool has_allele_frequencies() const noexcept;
+    std::vector<GenomicRegion::ContigName> contigs() const;
+
+    std::vector<Candidate> fetch(const GenomicRegion& region) const;
+
+private:
+    struct Block
+    {
+        std::uint64_t offset;
+        std::uint32_t num_records;
+        GenomicRegion::Position first_begin, max_end; // max_end is a running maximum over the contig
+    };
+
+    using BlockIndex = std::unordered_map<GenomicRegion::ContigName, std::vector<Block>>;
+
+    Path file_;
+    boost::iostreams::mapped_file_source data_;
+    std::string metadata_;
+    bool has_allele_frequencies_;
+    BlockIndex index_;
+
+    void read_index(std::uint64_t offset);
+    void fetch(const GenomicRegion& region, const Block& block, std::vector<Candidate>& result) const;
+};
+
+/*
+    Writes a CandidateStore. Candidates must be written in non-decreasing begin position, and
+    all candidates on a contig must be written together.
+ */
+class CandidateStore::Writer
+{
+public:
+    struct Options
+    {
+        std::size_t block_size = 1024;
+        bool store_allele_frequencies = false;
+        std::string metadata = "";
+    };
+
+    Writer() = delete;
+
+    Writer(Path file);
+    Writer(Path file, Options options);
+
+    Writer(const Writer&)            = delete;
+    Writer& operator=(const Writer&) = delete;
+    Writer(Writer&&)                 = delete;
+    Writer& operator=(Writer&&)      = delete;
+
+    ~Writer();
+
+    void write(const Variant& variant, boost::optional<float> allele_frequency = boost::none);
+    void close();
+
+private:
+    using ContigBlocks = std::pair<GenomicRegion::ContigName, std::vector<Block>>;
+
+    Path file_;
+    Options options_;
+    std::ofstream out_;
+    std::vector<ContigBlocks> index_;
+    std::unordered_set<GenomicRegion::ContigName> written_contigs_;
+    std::vector<char> block_records_, block_alleles_;
+    std::uint32_t num_block_records_;
+    GenomicRegion::Position block_first_begin_, last_begin_, max_end_;
+    std::uint64_t offset_;
+    bool closed_;
+
+    void start_contig(const GenomicRegion::ContigName& contig);
+    void flush_block();
+};
+
+} // namespace coretools
+} // namespace octopus
+
+#endif
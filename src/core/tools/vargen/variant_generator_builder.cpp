@@ -70,7 +70,11 @@ VariantGenerator VariantGeneratorBuilder::build(const ReferenceGenome& reference
         result.add(std::make_unique<LocalReassembler>(reference, *local_reassembler_));
     }
     for (auto packet : vcf_extractors_) {
-        result.add(std::make_unique<VcfExtractor>(std::make_unique<VcfReader>(packet.file), packet.options));
+        if (CandidateStore::is_candidate_store(packet.file)) {
+            result.add(std::make_unique<VcfExtractor>(std::make_shared<const CandidateStore>(packet.file), packet.options));
+        } else {
+            result.add(std::make_unique<VcfExtractor>(std::make_unique<VcfReader>(packet.file), packet.options));
+        }
     }
     if (repeat_scanner_) {
         result.add(std::make_unique<RepeatScanner>(reference, *repeat_scanner_));
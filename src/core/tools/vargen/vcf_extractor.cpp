@@ -7,11 +7,19 @@
 #include <algorithm>
 #include <iterator>
 #include <utility>
+#include <string>
+#include <stdexcept>
+#include <limits>
+#include <cstdint>
+#include <sstream>
+
+#include <boost/filesystem/operations.hpp>
 
 #include "io/variant/vcf_spec.hpp"
 #include "io/variant/vcf_record.hpp"
 #include "utils/sequence_utils.hpp"
 #include "utils/append.hpp"
+#include "exceptions/malformed_file_error.hpp"
 
 namespace octopus { namespace coretools {
 
@@ -21,11 +29,18 @@ VcfExtractor::VcfExtractor(std::unique_ptr<VcfReader> reader)
 
 VcfExtractor::VcfExtractor(std::unique_ptr<VcfReader> reader, Options options)
 : reader_ {std::move(reader)}
+, store_ {}
 , options_ {options}
 {
     reader_->close();
 }
 
+VcfExtractor::VcfExtractor(std::shared_ptr<const CandidateStore> store, Options options)
+: reader_ {}
+, store_ {std::move(store)}
+, options_ {options}
+{}
+
 std::unique_ptr<VariantGenerator> VcfExtractor::do_clone() const
 {
     return std::make_unique<VcfExtractor>(*this);
@@ -47,55 +62,74 @@ auto make_allele(const Iterator first_base, const Iterator last_base)
 }
 
 template <typename Container>
-void extract_variants(const VcfRecord& record, Container& result, const bool split_complex)
+void extract_variants(const VcfRecord& record, const VcfRecord::NucleotideSequence& alt_allele,
+                      Container& result, const bool split_complex)
 {
-    for (const auto& alt_allele : record.alt()) {
-        if (is_canonical(alt_allele)) {
-            const auto& ref_allele = record.ref();
-            if (ref_allele.size() != alt_allele.size()) {
-                auto begin = record.pos();
-                const auto p = std::mismatch(std::cbegin(ref_allele), std::cend(ref_allele),
-                                             std::cbegin(alt_allele), std::cend(alt_allele));
-                if (p.first != std::cend(ref_allele) && alt_allele.size() > ref_allele.size()) {
-                    const auto ref_pad_size = std::distance(std::cbegin(ref_allele), p.first);
-                    begin += ref_pad_size;
-                    const auto remaining_ref_size = ref_allele.size() - ref_pad_size;
-                    if (split_complex) {
-                        // Split non-reference padded insertions into snv (or mnv) and insertion with empty
-                        // reference (e.g. A -> TT makes two variants A -> T and -> T).
-                        const auto first_alt_end = std::next(p.second, remaining_ref_size);
-                        result.emplace_back(record.chrom(), begin - 1,
-                                            make_allele(p.first, std::cend(ref_allele)),
-                                            make_allele(p.second, first_alt_end));
-                        begin += remaining_ref_size;
-                        result.emplace_back(record.chrom(), begin - 1, "",
-                                            make_allele(first_alt_end, std::cend(alt_allele)));
-                    } else {
-                        // otherwise extract as complete MNV
-                        result.emplace_back(record.chrom(), begin - 1,
-                                            make_allele(p.first, std::cend(ref_allele)),
-                                            make_allele(p.second, std::cend(alt_allele)));
-                    }
-                } else {
-                    begin += std::distance(std::cbegin(ref_allele), p.first);
-                    result.emplace_back(record.chrom(), begin - 1,
-                                        make_allele(p.first, std::cend(ref_allele)),
-                                        make_allele(p.second, std::cend(alt_allele)));
-                }
+    if (!is_canonical(alt_allele)) return;
+    const auto& ref_allele = record.ref();
+    if (ref_allele.size() != alt_allele.size()) {
+        auto begin = record.pos();
+        const auto p = std::mismatch(std::cbegin(ref_allele), std::cend(ref_allele),
+                                     std::cbegin(alt_allele), std::cend(alt_allele));
+        if (p.first != std::cend(ref_allele) && alt_allele.size() > ref_allele.size()) {
+            const auto ref_pad_size = std::distance(std::cbegin(ref_allele), p.first);
+            begin += ref_pad_size;
+            const auto remaining_ref_size = ref_allele.size() - ref_pad_size;
+            if (split_complex) {
+                // Split non-reference padded insertions into snv (or mnv) and insertion with empty
+                // reference (e.g. A -> TT makes two variants A -> T and -> T).
+                const auto first_alt_end = std::next(p.second, remaining_ref_size);
+                result.emplace_back(record.chrom(), begin - 1,
+                                    make_allele(p.first, std::cend(ref_allele)),
+                                    make_allele(p.second, first_alt_end));
+                begin += remaining_ref_size;
+                result.emplace_back(record.chrom(), begin - 1, "",
+                                    make_allele(first_alt_end, std::cend(alt_allele)));
             } else {
-                using utils::capitalise_copy;
-                result.emplace_back(record.chrom(), record.pos() - 1,
-                                    capitalise_copy(record.ref()),
-                                    capitalise_copy(alt_allele));
+                // otherwise extract as complete MNV
+                result.emplace_back(record.chrom(), begin - 1,
+                                    make_allele(p.first, std::cend(ref_allele)),
+                                    make_allele(p.second, std::cend(alt_allele)));
             }
+        } else {
+            begin += std::distance(std::cbegin(ref_allele), p.first);
+            result.emplace_back(record.chrom(), begin - 1,
+                                make_allele(p.first, std::cend(ref_allele)),
+                                make_allele(p.second, std::cend(alt_allele)));
         }
+    } else {
+        using utils::capitalise_copy;
+        result.emplace_back(record.chrom(), record.pos() - 1,
+                            capitalise_copy(record.ref()),
+                            capitalise_copy(alt_allele));
     }
 }
 
+template <typename Container>
+void extract_variants(const VcfRecord& record, Container& result, const bool split_complex)
+{
+    for (const auto& alt_allele : record.alt()) {
+        extract_variants(record, alt_allele, result, split_complex);
+    }
+}
+
+bool is_good(const VcfRecord& record, const VcfExtractor::Options& options)
+{
+    if (!options.extract_filtered && is_filtered(record)) return false;
+    return !options.min_quality || (record.qual() && *record.qual() >= *options.min_quality);
+}
+
 } // namespace
 
 std::vector<Variant> VcfExtractor::do_generate(const RegionSet& regions) const
 {
+    if (store_) {
+        std::vector<Variant> result {};
+        for (const auto& region : regions) {
+            utils::append(fetch_stored_variants(region), result);
+        }
+        return result;
+    }
     reader_->open();
     std::vector<Variant> result {};
     for (const auto& region : regions) {
@@ -114,7 +148,7 @@ std::vector<Variant> VcfExtractor::fetch_variants(const GenomicRegion& region) c
 {
   std::deque<Variant> variants {};
     for (auto p = reader_->iterate(region, VcfReader::UnpackPolicy::sites); p.first != p.second; ++p.first) {
-        if (is_good(*p.first)) {
+        if (is_good(*p.first, options_)) {
             extract_variants(*p.first, variants, options_.split_complex);
         }
     }
@@ -125,10 +159,141 @@ std::vector<Variant> VcfExtractor::fetch_variants(const GenomicRegion& region) c
     return result;
 }
 
-bool VcfExtractor::is_good(const VcfRecord& record) const
+std::vector<Variant> VcfExtractor::fetch_stored_variants(const GenomicRegion& region) const
 {
-    if (!options_.extract_filtered && is_filtered(record)) return false;
-    return !options_.min_quality || (record.qual() && *record.qual() >= *options_.min_quality);
+    auto candidates = store_->fetch(region);
+    std::vector<Variant> result {};
+    result.reserve(candidates.size());
+    for (auto& candidate : candidates) {
+        result.push_back(std::move(candidate.variant));
+    }
+    return result; // the store is sorted and unique
+}
+
+namespace {
+
+auto extract_allele_frequencies(const VcfRecord& record)
+{
+    std::vector<boost::optional<float>> result(record.alt().size());
+    if (record.has_info("AF")) {
+        const auto& values = record.info_value("AF");
+        if (values.size() == result.size()) {
+            std::transform(std::cbegin(values), std::cend(values), std::begin(result),
+                           [] (const VcfRecord::ValueType& value) -> boost::optional<float> {
+                               if (value == vcfspec::missingValue) return boost::none;
+                               try {
+                                   return std::stof(value);
+                               } catch (const std::logic_error&) {
+                                   return boost::none;
+                               }
+                           });
+        }
+    }
+    return result;
+}
+
+bool is_storable(const Variant& variant) noexcept
+{
+    static constexpr std::size_t max_allele_length {std::numeric_limits<std::uint16_t>::max()};
+    return ref_sequence(variant).size() <= max_allele_length && alt_sequence(variant).size() <= max_allele_length;
+}
+
+using StoreCandidateBuffer = std::vector<CandidateStore::Candidate>;
+
+void write_candidates(StoreCandidateBuffer& buffer, const StoreCandidateBuffer::iterator last, CandidateStore::Writer& writer)
+{
+    std::stable_sort(std::begin(buffer), last, [] (const auto& lhs, const auto& rhs) { return lhs.variant < rhs.variant; });
+    for (auto itr = std::begin(buffer); itr != last; ) {
+        writer.write(itr->variant, itr->allele_frequency);
+        itr = std::find_if(std::next(itr), last, [itr] (const auto& candidate) { return candidate.variant != itr->variant; });
+    }
+    buffer.erase(std::begin(buffer), last);
+}
+
+void write_candidates_before(StoreCandidateBuffer& buffer, const GenomicRegion::Position position, CandidateStore::Writer& writer)
+{
+    const auto last = std::partition(std::begin(buffer), std::end(buffer),
+                                     [=] (const auto& candidate) { return mapped_begin(candidate.variant) < position; });
+    write_candidates(buffer, last, writer);
+}
+
+auto make_store_metadata(const boost::filesystem::path& source, const VcfExtractor::Options& options,
+                         const bool store_allele_frequencies)
+{
+    std::ostringstream ss {};
+    ss.precision(std::numeric_limits<double>::max_digits10);
+    ss << "source=" << source.string()
+       << ";max_variant_size=" << options.max_variant_size
+       << ";extract_filtered=" << options.extract_filtered
+       << ";min_quality=";
+    if (options.min_quality) ss << *options.min_quality; else ss << '.';
+    ss << ";split_complex=" << options.split_complex
+       << ";allele_frequencies=" << store_allele_frequencies;
+    return ss.str();
+}
+
+// Removes the file on destruction unless released
+struct TemporaryFile
+{
+    boost::filesystem::path path;
+    bool released = false;
+    ~TemporaryFile() { if (!released) { boost::system::error_code ec {}; boost::filesystem::remove(path, ec); } }
+};
+
+} // namespace
+
+bool make_candidate_store(const VcfReader& source, const boost::filesystem::path& store,
+                          VcfExtractor::Options options, const bool store_allele_frequencies)
+{
+    static constexpr std::size_t max_buffer_size {65'536};
+    // Write to a unique file and rename, so concurrent runs never see a partial store
+    TemporaryFile tmp_store {store.parent_path() / boost::filesystem::unique_path(store.filename().string() + ".%%%%-%%%%-%%%%.tmp")};
+    {
+        CandidateStore::Writer::Options writer_options {};
+        writer_options.store_allele_frequencies = store_allele_frequencies;
+        writer_options.metadata = make_store_metadata(source.path(), options, store_allele_frequencies);
+        CandidateStore::Writer writer {tmp_store.path, writer_options};
+        StoreCandidateBuffer buffer {};
+        std::vector<Variant> alt_variants {};
+        boost::optional<GenomicRegion::ContigName> contig {};
+        for (auto p = source.iterate(VcfReader::UnpackPolicy::sites); p.first != p.second; ++p.first) {
+            const VcfRecord& record {*p.first};
+            if (contig && record.chrom() != *contig) {
+                write_candidates(buffer, std::end(buffer), writer);
+            } else if (buffer.size() >= max_buffer_size) {
+                // extracted variants never begin before their record, so anything before this record is final
+                write_candidates_before(buffer, record.pos() - 1, writer);
+            }
+            contig = record.chrom();
+            if (!is_good(record, options)) continue;
+            const auto allele_frequencies = store_allele_frequencies ? extract_allele_frequencies(record)
+                                                                    : std::vector<boost::optional<float>>(record.alt().size());
+            for (std::size_t i {0}; i < record.alt().size(); ++i) {
+                alt_variants.clear();
+                extract_variants(record, record.alt()[i], alt_variants, options.split_complex);
+                for (auto& variant : alt_variants) {
+                    if (!is_storable(variant)) return false;
+                    buffer.push_back({std::move(variant), allele_frequencies[i]});
+                }
+            }
+        }
+        write_candidates(buffer, std::end(buffer), writer);
+        writer.close();
+    }
+    boost::filesystem::rename(tmp_store.path, store);
+    tmp_store.released = true;
+    return true;
+}
+
+bool is_candidate_store_for(const boost::filesystem::path& store, const boost::filesystem::path& source,
+                            VcfExtractor::Options options, const bool store_allele_frequencies)
+{
+    if (!CandidateStore::is_candidate_store(store)) return false;
+    try {
+        return CandidateStore {store}.metadata() == make_store_metadata(source, options, store_allele_frequencies);
+    } catch (const MalformedFileError&) {
+        return false;
+    }
 }
 
 } // namespace coretools
@@ -13,6 +13,7 @@
 #include "io/variant/vcf.hpp"
 #include "core/types/variant.hpp"
 #include "variant_generator.hpp"
+#include "utils/candidate_store.hpp"
 
 namespace octopus {
 
@@ -35,6 +36,9 @@ public:
     
     VcfExtractor(std::unique_ptr<VcfReader> reader);
     VcfExtractor(std::unique_ptr<VcfReader> reader, Options options);
+    // Candidates are read from a pre-indexed store; the record filters in Options
+    // are applied when the store is made (see make_candidate_store)
+    VcfExtractor(std::shared_ptr<const CandidateStore> store, Options options);
     
     VcfExtractor(const VcfExtractor&)            = default;
     VcfExtractor& operator=(const VcfExtractor&) = default;
@@ -49,12 +53,23 @@ private:
     std::string name() const override;
     
     mutable std::shared_ptr<VcfReader> reader_;
+    std::shared_ptr<const CandidateStore> store_;
     Options options_;
     
     std::vector<Variant> fetch_variants(const GenomicRegion& region) const;
-    bool is_good(const VcfRecord& record) const;
+    std::vector<Variant> fetch_stored_variants(const GenomicRegion& region) const;
 };
 
+// Writes all candidates that a VcfExtractor with the given options would extract from source
+// into a CandidateStore. The source must be position sorted. Returns false, leaving store
+// untouched, if some candidate can't be stored (i.e. has an allele longer than 65,535 bases).
+bool make_candidate_store(const VcfReader& source, const boost::filesystem::path& store,
+                          VcfExtractor::Options options, bool store_allele_frequencies = true);
+
+// True if store was made by make_candidate_store from source with the same options
+bool is_candidate_store_for(const boost::filesystem::path& store, const boost::filesystem::path& source,
+                            VcfExtractor::Options options, bool store_allele_frequencies = true);
+
 } // namespace coretools
 } // namespace octopus
 
@@ -0,0 +1,132 @@
+// Copyright (c) 2015-2020 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#include "genotype_indexer.hpp"
+
+#include <limits>
+#include <algorithm>
+#include <stdexcept>
+
+namespace octopus {
+
+// Counting is done with the binomial identity
+//
+//   |{genotypes with ploidy r + 1 whose smallest element index is >= n - x}| = C(x + r, r + 1)
+//
+// so the number of genotypes that sort before one whose j-th index is a (given the indices before
+// it, the last of which is prev) is C(n - prev + r, r + 1) - C(n - a + r, r + 1), with r = ploidy - j - 1.
+
+namespace {
+
+using Rank = GenotypeIndexer::Rank;
+
+constexpr Rank saturated {std::numeric_limits<Rank>::max()};
+
+Rank saturating_add(const Rank a, const Rank b) noexcept
+{
+    return a > saturated - b ? saturated : a + b;
+}
+
+} // namespace
+
+GenotypeIndexer::GenotypeIndexer(const unsigned num_elements, const unsigned ploidy)
+: num_elements_ {num_elements}
+, ploidy_ {ploidy}
+, size_ {0}
+, binomials_ {}
+{
+    if (num_elements_ > static_cast<unsigned>(std::numeric_limits<ElementIndex>::max()) + 1) {
+        throw std::overflow_error {"GenotypeIndexer: too many elements"};
+    }
+    // Pascal's triangle up to C(num_elements + ploidy, ploidy + 1)
+    const auto max_n = num_elements_ + ploidy_, width = ploidy_ + 2;
+    binomials_.assign((max_n + 1) * width, 0);
+    for (unsigned n {0}; n <= max_n; ++n) {
+        binomials_[n * width] = 1;
+        for (unsigned k {1}; k < width && k <= n; ++k) {
+            binomials_[n * width + k] = saturating_add(binomials_[(n - 1) * width + k - 1], binomials_[(n - 1) * width + k]);
+        }
+    }
+    if (num_elements_ > 0) {
+        size_ = choose(num_elements_ + ploidy_ - 1, ploidy_);
+        if (size_ == saturated) throw std::overflow_error {"GenotypeIndexer: too many genotypes"};
+    }
+}
+
+unsigned GenotypeIndexer::num_elements() const noexcept
+{
+    return num_elements_;
+}
+
+unsigned GenotypeIndexer::ploidy() const noexcept
+{
+    return ploidy_;
+}
+
+GenotypeIndexer::Rank GenotypeIndexer::size() const noexcept
+{
+    return size_;
+}
+
+GenotypeIndexer::Rank GenotypeIndexer::rank(const ElementIndex* indices) const noexcept
+{
+    Rank result {0};
+    unsigned prev {0};
+    for (unsigned j {0}; j < ploidy_; ++j) {
+        const unsigned r {ploidy_ - j - 1}, a {indices[j]};
+        assert(prev <= a && a < num_elements_);
+        result += choose(num_elements_ - prev + r, r + 1) - choose(num_elements_ - a + r, r + 1);
+        prev = a;
+    }
+    return result;
+}
+
+void GenotypeIndexer::unrank(Rank rank, ElementIndex* result) const noexcept
+{
+    assert(rank < size_);
+    unsigned prev {0};
+    for (unsigned j {0}; j < ploidy_; ++j) {
+        const unsigned r {ploidy_ - j - 1};
+        const auto base = choose(num_elements_ - prev + r, r + 1);
+        auto a = prev;
+        while (a + 1 < num_elements_ && base - choose(num_elements_ - (a + 1) + r, r + 1) <= rank) ++a;
+        rank -= base - choose(num_elements_ - a + r, r + 1);
+        result[j] = static_cast<ElementIndex>(a);
+        prev = a;
+    }
+}
+
+void GenotypeIndexer::unrank(const Rank first, const Rank last, std::vector<ElementIndex>& result) const
+{
+    if (first >= last) return;
+    assert(last <= size_);
+    const auto offset = result.size();
+    result.resize(offset + (last - first) * ploidy_);
+    auto indices = result.data() + offset;
+    unrank(first, indices);
+    for (auto rank = first + 1; rank < last; ++rank) {
+        std::copy(indices, indices + ploidy_, indices + ploidy_);
+        indices += ploidy_;
+        next(indices);
+    }
+}
+
+bool GenotypeIndexer::next(ElementIndex* indices) const noexcept
+{
+    unsigned j {ploidy_};
+    while (j > 0 && indices[j - 1] + 1u == num_elements_) --j;
+    if (j == 0) return false;
+    const auto a = static_cast<ElementIndex>(indices[j - 1] + 1);
+    std::fill(indices + j - 1, indices + ploidy_, a);
+    return true;
+}
+
+// private methods
+
+GenotypeIndexer::Rank GenotypeIndexer::choose(const unsigned n, const unsigned k) const noexcept
+{
+    assert(k < ploidy_ + 2 && n <= num_elements_ + ploidy_);
+    return k > n ? 0 : binomials_[n * (ploidy_ + 2) + k];
+}
+
+} // namespace octopus
@@ -0,0 +1,94 @@
+// Copyright (c) 2015-2020 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#ifndef genotype_indexer_hpp
+#define genotype_indexer_hpp
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <cassert>
+
+#include "genotype.hpp"
+
+namespace octopus {
+
+/*
+    GenotypeIndexer numbers every genotype of a given ploidy over a set of elements (i.e. every
+    multiset of element indices) without generating them. A genotype's rank is its position in
+    the order used by generate_all_genotypes: element indices sorted ascending, compared
+    lexicographically. So rank r here is the r-th genotype generate_all_genotypes would return.
+
+    Models that only need to visit each genotype once can unrank small batches as they go
+    instead of materialising num_genotypes(num_elements, ploidy) Genotypes up front.
+ */
+class GenotypeIndexer
+{
+public:
+    using ElementIndex = std::uint16_t;
+    using Rank         = std::size_t;
+
+    GenotypeIndexer() = delete;
+
+    // Throws std::overflow_error if the genotypes can't be numbered by Rank
+    GenotypeIndexer(unsigned num_elements, unsigned ploidy);
+
+    GenotypeIndexer(const GenotypeIndexer&)            = default;
+    GenotypeIndexer& operator=(const GenotypeIndexer&) = default;
+    GenotypeIndexer(GenotypeIndexer&&)                 = default;
+    GenotypeIndexer& operator=(GenotypeIndexer&&)      = default;
+
+    ~GenotypeIndexer() = default;
+
+    unsigned num_elements() const noexcept;
+    unsigned ploidy() const noexcept;
+    Rank size() const noexcept;
+
+    // indices must point to ploidy element indices in ascending order
+    Rank rank(const ElementIndex* indices) const noexcept;
+    void unrank(Rank rank, ElementIndex* result) const noexcept;
+
+    // Appends the element indices of genotypes [first, last), ploidy at a time
+    void unrank(Rank first, Rank last, std::vector<ElementIndex>& result) const;
+
+    // Moves indices to the next genotype, returning false if it was the last
+    bool next(ElementIndex* indices) const noexcept;
+
+private:
+    unsigned num_elements_, ploidy_;
+    Rank size_;
+    std::vector<Rank> binomials_;
+
+    Rank choose(unsigned n, unsigned k) const noexcept;
+};
+
+template <typename Range>
+auto make_genotype(const GenotypeIndexer::ElementIndex* indices, const unsigned ploidy, const Range& elements)
+{
+    detail::GenotypeType<Range> result {ploidy};
+    for (unsigned i {0}; i < ploidy; ++i) {
+        result.emplace(elements[indices[i]]);
+    }
+    return result;
+}
+
+// Appends genotypes [first, last) of elements
+template <typename Range, typename OutputIterator>
+OutputIterator
+generate_genotypes(const GenotypeIndexer& indexer, const GenotypeIndexer::Rank first, const GenotypeIndexer::Rank last,
+                   const Range& elements, OutputIterator result)
+{
+    assert(elements.size() == indexer.num_elements());
+    if (first >= last) return result;
+    std::vector<GenotypeIndexer::ElementIndex> indices(indexer.ploidy());
+    indexer.unrank(first, indices.data());
+    for (auto rank = first; rank < last; ++rank) {
+        *result++ = make_genotype(indices.data(), indexer.ploidy(), elements);
+        indexer.next(indices.data());
+    }
+    return result;
+}
+
+} // namespace octopus
+
+#endif
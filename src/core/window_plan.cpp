@@ -0,0 +1,197 @@
+// Copyright (c) 2015-2020 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#include "window_plan.hpp"
+
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <algorithm>
+#include <iterator>
+#include <iomanip>
+#include <utility>
+#include <cassert>
+
+#include "exceptions/malformed_file_error.hpp"
+#include "exceptions/missing_file_error.hpp"
+#include "exceptions/unwritable_file_error.hpp"
+
+namespace octopus {
+
+namespace {
+
+const std::string plan_header {"##fileformat=octopus-window-plan-v1"};
+
+class MalformedWindowPlan : public MalformedFileError
+{
+    std::string do_where() const override { return "read_window_plan"; }
+
+    std::string do_help() const override
+    {
+        return "remake the plan with --make-window-plan";
+    }
+public:
+    MalformedWindowPlan(boost::filesystem::path file, std::string reason)
+    : MalformedFileError {std::move(file), "window plan"}
+    {
+        set_reason(std::move(reason));
+    }
+};
+
+class MissingWindowPlan : public MissingFileError
+{
+    std::string do_where() const override { return "read_window_plan"; }
+public:
+    MissingWindowPlan(boost::filesystem::path file) : MissingFileError {std::move(file), "window plan"} {}
+};
+
+class UnwritableWindowPlan : public UnwritableFileError
+{
+    std::string do_where() const override { return "write"; }
+public:
+    UnwritableWindowPlan(boost::filesystem::path file) : UnwritableFileError {std::move(file), "window plan"} {}
+};
+
+} // namespace
+
+void WindowPlan::add(GenomicRegion region, const std::size_t num_reads)
+{
+    const auto cost = estimate_calling_cost(region, num_reads);
+    add(std::move(region), num_reads, cost);
+}
+
+void WindowPlan::add(GenomicRegion region, const std::size_t num_reads, const double cost)
+{
+    add({std::move(region), num_reads, cost});
+}
+
+bool WindowPlan::empty() const noexcept
+{
+    return size_ == 0;
+}
+
+std::size_t WindowPlan::size() const noexcept
+{
+    return size_;
+}
+
+const std::vector<GenomicRegion::ContigName>& WindowPlan::contigs() const noexcept
+{
+    return contigs_;
+}
+
+bool WindowPlan::has_windows(const GenomicRegion::ContigName& contig) const noexcept
+{
+    return windows_.count(contig) == 1;
+}
+
+const WindowPlan::WindowList& WindowPlan::windows(const GenomicRegion::ContigName& contig) const
+{
+    return windows_.at(contig);
+}
+
+boost::optional<const WindowPlan::Window&> WindowPlan::find_window(const GenomicRegion& region) const
+{
+    const auto contig_itr = windows_.find(region.contig_name());
+    if (contig_itr == std::cend(windows_)) return boost::none;
+    const auto& windows = contig_itr->second;
+    const auto itr = std::upper_bound(std::cbegin(windows), std::cend(windows), region.begin(),
+                                      [] (const auto position, const Window& window) { return position < window.region.end(); });
+    if (itr == std::cend(windows)) return boost::none;
+    return *itr;
+}
+
+// private methods
+
+void WindowPlan::add(Window window)
+{
+    const auto& contig = window.region.contig_name();
+    auto itr = windows_.find(contig);
+    if (itr == std::end(windows_)) {
+        contigs_.push_back(contig);
+        itr = windows_.emplace(contig, WindowList {}).first;
+    }
+    assert(itr->second.empty() || itr->second.back().region.end() <= window.region.begin());
+    itr->second.push_back(std::move(window));
+    ++size_;
+}
+
+// non-member methods
+
+double calculate_repeat_fraction(const std::string& sequence)
+{
+    // A base is repetitive if it's in a run of at least min_run_length bases that each match the
+    // base one period back, for some period up to max_period. This is a single linear scan per
+    // period, so it's cheap enough to run on every window.
+    static constexpr std::size_t max_period {4}, min_run_length {8};
+    if (sequence.size() <= max_period) return 0;
+    std::vector<bool> repetitive(sequence.size(), false);
+    for (std::size_t period {1}; period <= max_period; ++period) {
+        std::size_t run_begin {period};
+        for (std::size_t i {period}; i <= sequence.size(); ++i) {
+            if (i == sequence.size() || sequence[i] != sequence[i - period] || sequence[i] == 'N') {
+                if (i - run_begin >= min_run_length) {
+                    std::fill(std::next(std::begin(repetitive), run_begin - period), std::next(std::begin(repetitive), i), true);
+                }
+                run_begin = i + 1;
+            }
+        }
+    }
+    const auto num_repetitive = std::count(std::cbegin(repetitive), std::cend(repetitive), true);
+    return static_cast<double>(num_repetitive) / sequence.size();
+}
+
+double estimate_calling_cost(const GenomicRegion& window, const std::size_t num_reads, const double repeat_fraction) noexcept
+{
+    // Calling time is dominated by the number of reads that need to be processed, but repeats
+    // generate many more candidate haplotypes per read
+    static constexpr double repeat_cost_factor {4};
+    return num_reads * (1 + repeat_cost_factor * repeat_fraction);
+}
+
+void write(const WindowPlan& plan, const WindowPlan::Path& file)
+{
+    std::ofstream out {file.string()};
+    if (!out) throw UnwritableWindowPlan {file};
+    out << plan_header << '\n' << "#contig\tbegin\tend\treads\tcost\n";
+    out << std::setprecision(6);
+    for (const auto& contig : plan.contigs()) {
+        for (const auto& window : plan.windows(contig)) {
+            out << contig << '\t' << window.region.begin() << '\t' << window.region.end() << '\t'
+                << window.num_reads << '\t' << window.cost << '\n';
+        }
+    }
+    if (!out) throw UnwritableWindowPlan {file};
+}
+
+WindowPlan read_window_plan(const WindowPlan::Path& file)
+{
+    std::ifstream in {file.string()};
+    if (!in) throw MissingWindowPlan {file};
+    std::string line {};
+    if (!std::getline(in, line) || line != plan_header) {
+        throw MalformedWindowPlan {file, "the file does not start with the window plan header"};
+    }
+    WindowPlan result {};
+    std::size_t line_number {1};
+    while (std::getline(in, line)) {
+        ++line_number;
+        if (line.empty() || line.front() == '#') continue;
+        std::istringstream ss {line};
+        GenomicRegion::ContigName contig {};
+        GenomicRegion::Position begin, end;
+        WindowPlan::Window window {};
+        if (!(std::getline(ss, contig, '\t') >> begin >> end >> window.num_reads >> window.cost) || contig.empty() || end < begin) {
+            throw MalformedWindowPlan {file, "line " + std::to_string(line_number) + " is not a valid window"};
+        }
+        window.region = GenomicRegion {std::move(contig), begin, end};
+        if (result.has_windows(window.region.contig_name())
+            && result.windows(window.region.contig_name()).back().region.end() > begin) {
+            throw MalformedWindowPlan {file, "window on line " + std::to_string(line_number) + " is out of order"};
+        }
+        result.add(std::move(window));
+    }
+    return result;
+}
+
+} // namespace octopus
@@ -0,0 +1,90 @@
+// Copyright (c) 2015-2020 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#ifndef window_plan_hpp
+#define window_plan_hpp
+
+#include <vector>
+#include <string>
+#include <cstddef>
+#include <unordered_map>
+#include <iosfwd>
+
+#include <boost/filesystem/path.hpp>
+#include <boost/optional.hpp>
+
+#include "basics/genomic_region.hpp"
+
+namespace octopus {
+
+/*
+    A WindowPlan is the list of calling windows for a set of reads and calling regions, with the
+    number of reads each window was sized for and an estimate of its relative calling cost.
+
+    Proposing windows requires scanning the read indexes, so a plan can be made once (with
+    --make-window-plan) and then reused by later runs on the same reads, or shared between
+    scatter/gather jobs, without repeating the scan.
+
+    Plans are stored as tab-separated text, one window per line:
+
+        contig  begin  end  reads  cost
+ */
+class WindowPlan
+{
+public:
+    using Path = boost::filesystem::path;
+
+    struct Window
+    {
+        GenomicRegion region;
+        std::size_t num_reads;
+        double cost;
+    };
+
+    using WindowList = std::vector<Window>;
+
+    WindowPlan() = default;
+
+    WindowPlan(const WindowPlan&)            = default;
+    WindowPlan& operator=(const WindowPlan&) = default;
+    WindowPlan(WindowPlan&&)                 = default;
+    WindowPlan& operator=(WindowPlan&&)      = default;
+
+    ~WindowPlan() = default;
+
+    // Windows must be added in order, and must not overlap, within each contig
+    void add(GenomicRegion region, std::size_t num_reads);
+    void add(GenomicRegion region, std::size_t num_reads, double cost);
+
+    bool empty() const noexcept;
+    std::size_t size() const noexcept;
+
+    const std::vector<GenomicRegion::ContigName>& contigs() const noexcept;
+    bool has_windows(const GenomicRegion::ContigName& contig) const noexcept;
+    const WindowList& windows(const GenomicRegion::ContigName& contig) const;
+
+    // Returns the first window on the region's contig that ends after the region begins
+    boost::optional<const Window&> find_window(const GenomicRegion& region) const;
+
+private:
+    std::vector<GenomicRegion::ContigName> contigs_;
+    std::unordered_map<GenomicRegion::ContigName, WindowList> windows_;
+    std::size_t size_ = 0;
+
+    void add(Window window);
+
+    friend WindowPlan read_window_plan(const Path& file);
+};
+
+// The fraction of bases in short tandem repeats, which make haplotypes harder to resolve
+double calculate_repeat_fraction(const std::string& sequence);
+
+// A relative cost, only meaningful for comparing windows in the same run
+double estimate_calling_cost(const GenomicRegion& window, std::size_t num_reads, double repeat_fraction = 0) noexcept;
+
+void write(const WindowPlan& plan, const WindowPlan::Path& file);
+WindowPlan read_window_plan(const WindowPlan::Path& file);
+
+} // namespace octopus
+
+#endif
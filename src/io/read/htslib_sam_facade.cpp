@@ -175,6 +175,15 @@ bool is_cram(const boost::filesystem::path& file)
     return file.extension().string() == ".cram";
 }
 
+// sam_itr_querys resolves contig names through a lookup table that htslib builds lazily on
+// first use. Build it up front so handles sharing the header only ever read it.
+void init_name_lookup(bam_hdr_t* header)
+{
+    if (header && header->n_targets > 0) {
+        bam_name2id(header, header->target_name[0]);
+    }
+}
+
 } // namespace
 
 HtslibSamFacade::HtslibSamFacade(Path file_path)
@@ -212,6 +221,7 @@ HtslibSamFacade::HtslibSamFacade(Path file_path)
     }
     try {
         init_maps();
+        init_name_lookup(hts_header_.get());
     } catch(...) {
         close();
         throw;
@@ -225,6 +235,17 @@ HtslibSamFacade::HtslibSamFacade(Path file_path)
     std::sort(std::begin(samples_), std::end(samples_));
 }
 
+HtslibSamFacade::HtslibSamFacade(const HtslibSamFacade& other, HtsFilePtr hts_file, std::shared_ptr<hts_idx_t> hts_index)
+: file_path_ {other.file_path_}
+, hts_file_ {std::move(hts_file)}
+, hts_header_ {other.hts_header_}
+, hts_index_ {std::move(hts_index)}
+, hts_targets_ {other.hts_targets_}
+, contig_names_ {other.contig_names_}
+, sample_names_ {other.sample_names_}
+, samples_ {other.samples_}
+{}
+
 auto open_hts_writable_file(const boost::filesystem::path& path)
 {
     std::string mode {"[w]"};
@@ -254,7 +275,7 @@ HtslibSamFacade::HtslibSamFacade(Path sam_out, Path sam_template)
 HtslibSamFacade::~HtslibSamFacade()
 {
     if (!hts_index_) {
-        hts_header_.reset(nullptr);
+        hts_header_.reset();
         hts_file_.reset(nullptr);
         if (sam_index_build(file_path_.c_str(), 0) < 0) {
             return;
@@ -271,16 +292,31 @@ void HtslibSamFacade::open()
 {
     hts_file_.reset(sam_open(file_path_.string().c_str(), "r"));
     if (hts_file_) {
-        hts_header_.reset(sam_hdr_read(hts_file_.get()));
-        hts_index_.reset(sam_index_load(hts_file_.get(), file_path_.c_str()));
+        hts_header_.reset(sam_hdr_read(hts_file_.get()), HtsHeaderDeleter {});
+        hts_index_.reset(sam_index_load(hts_file_.get(), file_path_.c_str()), HtsIndexDeleter {});
+        init_name_lookup(hts_header_.get());
     }
 }
 
 void HtslibSamFacade::close()
 {
     hts_file_.reset(nullptr);
-    hts_header_.reset(nullptr);
-    hts_index_.reset(nullptr);
+    hts_header_.reset();
+    hts_index_.reset();
+}
+
+std::unique_ptr<IReadReaderImpl> HtslibSamFacade::duplicate() const
+{
+    if (!is_open()) return nullptr;
+    HtsFilePtr hts_file {open_hts_file(file_path_), HtsFileDeleter {}};
+    if (!hts_file) return nullptr;
+    auto hts_index = hts_index_;
+    if (hts_file->is_cram) {
+        // CRAM indices are bound to the file handle they were loaded with
+        hts_index.reset(sam_index_load(hts_file.get(), file_path_.c_str()), HtsIndexDeleter {});
+        if (!hts_index) return nullptr;
+    }
+    return std::unique_ptr<HtslibSamFacade> {new HtslibSamFacade {*this, std::move(hts_file), std::move(hts_index)}};
 }
 
 GenomicRegion::Size HtslibSamFacade::reference_size(const GenomicRegion::ContigName& contig) const
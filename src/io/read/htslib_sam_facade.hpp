@@ -113,6 +113,8 @@ public:
     std::vector<GenomicRegion::ContigName> reference_contigs() const override;
     boost::optional<std::vector<GenomicRegion::ContigName>> mapped_contigs() const override;
     
+    std::unique_ptr<IReadReaderImpl> duplicate() const override;
+    
     void write(const AlignedRead& read);
     void write(const AnnotatedAlignedRead& read);
     
@@ -127,11 +129,11 @@ private:
     };
     struct HtsHeaderDeleter
     {
-        void operator()(bam_hdr_t* header) const { bam_hdr_destroy(header); }
+        void operator()(bam_hdr_t* header) const { if (header) bam_hdr_destroy(header); }
     };
     struct HtsIndexDeleter
     {
-        void operator()(hts_idx_t* index) const { hts_idx_destroy(index); }
+        void operator()(hts_idx_t* index) const { if (index) hts_idx_destroy(index); }
     };
     struct HtsBam1Deleter
     {
@@ -176,11 +178,14 @@ private:
         std::unique_ptr<bam1_t, HtsBam1Deleter> hts_bam1_;
     };
     
+    using HtsFilePtr = std::unique_ptr<htsFile, HtsFileDeleter>;
+    
     Path file_path_;
     
-    std::unique_ptr<htsFile, HtsFileDeleter> hts_file_;
-    std::unique_ptr<bam_hdr_t, HtsHeaderDeleter> hts_header_;
-    std::unique_ptr<hts_idx_t, HtsIndexDeleter> hts_index_;
+    // The header and (BAM) index are shared read-only between duplicated handles
+    HtsFilePtr hts_file_;
+    std::shared_ptr<bam_hdr_t> hts_header_;
+    std::shared_ptr<hts_idx_t> hts_index_;
     
     std::unordered_map<GenomicRegion::ContigName, HtsTid> hts_targets_;
     std::unordered_map<HtsTid, GenomicRegion::ContigName> contig_names_;
@@ -188,6 +193,8 @@ private:
     
     std::vector<SampleName> samples_;
     
+    HtslibSamFacade(const HtslibSamFacade& other, HtsFilePtr hts_file, std::shared_ptr<hts_idx_t> hts_index);
+    
     void init_maps();
     HtsTid get_htslib_target(const GenomicRegion::ContigName& contig) const;
     const GenomicRegion::ContigName& get_contig_name(HtsTid target) const;
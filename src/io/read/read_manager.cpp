@@ -551,7 +551,15 @@ void ReadManager::open_initial_files()
 
 ReadReader ReadManager::make_reader(const Path& reader_path) const
 {
-    return ReadReader {reader_path};
+    return ReadReader {reader_path, max_handles_per_reader()};
+}
+
+unsigned ReadManager::max_handles_per_reader() const noexcept
+{
+    // When every file fits within the open file limit, share the spare capacity between the
+    // readers' handle pools; otherwise each reader gets a single handle as readers are swapped.
+    if (num_files_ == 0 || num_files_ > max_open_files_) return 1;
+    return max_open_files_ / num_files_;
 }
 
 bool ReadManager::all_readers_are_open() const noexcept
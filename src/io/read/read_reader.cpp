@@ -77,16 +77,22 @@ auto make_reader(const boost::filesystem::path& file_path)
 
 } //namespace
 
-ReadReader::ReadReader(const boost::filesystem::path& file_path)
+ReadReader::ReadReader(const boost::filesystem::path& file_path, const unsigned max_handles)
 : file_path_ {file_path}
 , impl_ {make_reader(file_path_)}
+, max_handles_ {std::max(max_handles, 1u)}
+, duplicates_ {}
+, idle_handles_ {impl_.get()}
 {}
 
 ReadReader::ReadReader(ReadReader&& other)
 {
     std::lock_guard<std::mutex> lock {other.mutex_};
-    file_path_ = std::move(other.file_path_);
-    impl_  = std::move(other.impl_);
+    file_path_    = std::move(other.file_path_);
+    impl_         = std::move(other.impl_);
+    max_handles_  = other.max_handles_;
+    duplicates_   = std::move(other.duplicates_);
+    idle_handles_ = std::move(other.idle_handles_);
 }
 
 void swap(ReadReader& lhs, ReadReader& rhs) noexcept
@@ -97,6 +103,9 @@ void swap(ReadReader& lhs, ReadReader& rhs) noexcept
     using std::swap;
     swap(lhs.file_path_, rhs.file_path_);
     swap(lhs.impl_, rhs.impl_);
+    swap(lhs.max_handles_, rhs.max_handles_);
+    swap(lhs.duplicates_, rhs.duplicates_);
+    swap(lhs.idle_handles_, rhs.idle_handles_);
 }
 
 bool ReadReader::is_open() const noexcept
@@ -113,7 +122,10 @@ void ReadReader::open()
 
 void ReadReader::close()
 {
-    std::lock_guard<std::mutex> lock {mutex_};
+    std::unique_lock<std::mutex> lock {mutex_};
+    handle_returned_.wait(lock, [this] () { return all_handles_idle(); });
+    duplicates_.clear();
+    idle_handles_.assign({impl_.get()});
     impl_->close();
 }
 
@@ -122,6 +134,18 @@ const ReadReader::Path& ReadReader::path() const noexcept
     return file_path_;
 }
 
+unsigned ReadReader::max_handles() const noexcept
+{
+    std::lock_guard<std::mutex> lock {mutex_};
+    return max_handles_;
+}
+
+unsigned ReadReader::num_handles() const noexcept
+{
+    std::lock_guard<std::mutex> lock {mutex_};
+    return static_cast<unsigned>(duplicates_.size()) + (impl_ ? 1 : 0);
+}
+
 std::vector<ReadReader::SampleName> ReadReader::extract_samples() const
 {
     std::lock_guard<std::mutex> lock {mutex_};
@@ -161,126 +185,171 @@ boost::optional<std::vector<GenomicRegion>> ReadReader::mapped_regions() const
 bool ReadReader::iterate(const GenomicRegion& region,
                          AlignedReadReadVisitor visitor) const
 {
-    std::lock_guard<std::mutex> lock {mutex_};
-    return impl_->iterate(region, visitor);
+    const BorrowedHandle handle {*this};
+    return handle->iterate(region, visitor);
 }
 
 bool ReadReader::iterate(const SampleName& sample,
                          const GenomicRegion& region,
                          AlignedReadReadVisitor visitor) const
 {
-    std::lock_guard<std::mutex> lock {mutex_};
-    return impl_->iterate(sample, region, visitor);
+    const BorrowedHandle handle {*this};
+    return handle->iterate(sample, region, visitor);
 }
 
 bool ReadReader::iterate(const std::vector<SampleName>& samples,
                          const GenomicRegion& region,
                          AlignedReadReadVisitor visitor) const
 {
-    std::lock_guard<std::mutex> lock {mutex_};
-    return impl_->iterate(samples, region, visitor);
+    const BorrowedHandle handle {*this};
+    return handle->iterate(samples, region, visitor);
 }
 
 bool ReadReader::iterate(const GenomicRegion& region,
                          ContigRegionVisitor visitor) const
 {
-    std::lock_guard<std::mutex> lock {mutex_};
-    return impl_->iterate(region, visitor);
+    const BorrowedHandle handle {*this};
+    return handle->iterate(region, visitor);
 }
 
 bool ReadReader::iterate(const SampleName& sample,
                          const GenomicRegion& region,
                          ContigRegionVisitor visitor) const
 {
-    std::lock_guard<std::mutex> lock {mutex_};
-    return impl_->iterate(sample, region, visitor);
+    const BorrowedHandle handle {*this};
+    return handle->iterate(sample, region, visitor);
 }
 
 bool ReadReader::iterate(const std::vector<SampleName>& samples,
                          const GenomicRegion& region,
                          ContigRegionVisitor visitor) const
 {
-    std::lock_guard<std::mutex> lock {mutex_};
-    return impl_->iterate(samples, region, visitor);
+    const BorrowedHandle handle {*this};
+    return handle->iterate(samples, region, visitor);
 }
 
 bool ReadReader::has_reads(const GenomicRegion& region) const
 {
-    std::lock_guard<std::mutex> lock {mutex_};
-    return impl_->has_reads(region);
+    const BorrowedHandle handle {*this};
+    return handle->has_reads(region);
 }
 
 bool ReadReader::has_reads(const SampleName& sample, const GenomicRegion& region) const
 {
-    std::lock_guard<std::mutex> lock {mutex_};
-    return impl_->has_reads(sample, region);
+    const BorrowedHandle handle {*this};
+    return handle->has_reads(sample, region);
 }
 
 bool ReadReader::has_reads(const std::vector<SampleName>& samples,
                            const GenomicRegion& region) const
 {
-    std::lock_guard<std::mutex> lock {mutex_};
-    return impl_->has_reads(samples, region);
+    const BorrowedHandle handle {*this};
+    return handle->has_reads(samples, region);
 }
 
 std::size_t ReadReader::count_reads(const GenomicRegion& region) const
 {
-    std::lock_guard<std::mutex> lock {mutex_};
-    return impl_->count_reads(region);
+    const BorrowedHandle handle {*this};
+    return handle->count_reads(region);
 }
 
 std::size_t ReadReader::count_reads(const SampleName& sample, const GenomicRegion& region) const
 {
-    std::lock_guard<std::mutex> lock {mutex_};
-    return impl_->count_reads(sample, region);
+    const BorrowedHandle handle {*this};
+    return handle->count_reads(sample, region);
 }
 
 std::size_t ReadReader::count_reads(const std::vector<SampleName>& samples, const GenomicRegion& region) const
 {
-    std::lock_guard<std::mutex> lock {mutex_};
-    return impl_->count_reads(samples, region);
+    const BorrowedHandle handle {*this};
+    return handle->count_reads(samples, region);
 }
 
 ReadReader::PositionList
 ReadReader::extract_read_positions(const GenomicRegion& region, std::size_t max_coverage) const
 {
-    std::lock_guard<std::mutex> lock {mutex_};
-    return impl_->extract_read_positions(region, max_coverage);
+    const BorrowedHandle handle {*this};
+    return handle->extract_read_positions(region, max_coverage);
 }
 
 ReadReader::PositionList
 ReadReader::extract_read_positions(const SampleName& sample, const GenomicRegion& region,
                                    std::size_t max_coverage) const
 {
-    std::lock_guard<std::mutex> lock {mutex_};
-    return impl_->extract_read_positions(sample, region, max_coverage);
+    const BorrowedHandle handle {*this};
+    return handle->extract_read_positions(sample, region, max_coverage);
 }
 
 ReadReader::PositionList
 ReadReader::extract_read_positions(const std::vector<SampleName>& samples,
                                    const GenomicRegion& region, std::size_t max_coverage) const
 {
-    std::lock_guard<std::mutex> lock {mutex_};
-    return impl_->extract_read_positions(samples, region, max_coverage);
+    const BorrowedHandle handle {*this};
+    return handle->extract_read_positions(samples, region, max_coverage);
 }
 
 ReadReader::SampleReadMap ReadReader::fetch_reads(const GenomicRegion& region) const
 {
-    std::lock_guard<std::mutex> lock {mutex_};
-    return impl_->fetch_reads(region);
+    const BorrowedHandle handle {*this};
+    return handle->fetch_reads(region);
 }
 
 ReadReader::ReadContainer ReadReader::fetch_reads(const SampleName& sample, const GenomicRegion& region) const
 {
-    std::lock_guard<std::mutex> lock {mutex_};
-    return impl_->fetch_reads(sample, region);
+    const BorrowedHandle handle {*this};
+    return handle->fetch_reads(sample, region);
 }
 
 ReadReader::SampleReadMap ReadReader::fetch_reads(const std::vector<SampleName>& samples,
                                                   const GenomicRegion& region) const
 {
-    std::lock_guard<std::mutex> lock {mutex_};
-    return impl_->fetch_reads(samples, region);
+    const BorrowedHandle handle {*this};
+    return handle->fetch_reads(samples, region);
+}
+
+// private methods
+
+ReadReader::BorrowedHandle::BorrowedHandle(const ReadReader& reader)
+: reader_ {reader}
+, handle_ {reader.acquire_handle()}
+{}
+
+ReadReader::BorrowedHandle::~BorrowedHandle()
+{
+    reader_.release_handle(handle_);
+}
+
+const IReadReaderImpl* ReadReader::acquire_handle() const
+{
+    std::unique_lock<std::mutex> lock {mutex_};
+    while (idle_handles_.empty()) {
+        if (duplicates_.size() + 1 < max_handles_) {
+            auto duplicate = impl_->duplicate();
+            if (duplicate) {
+                duplicates_.push_back(std::move(duplicate));
+                return duplicates_.back().get();
+            }
+            max_handles_ = static_cast<unsigned>(duplicates_.size()) + 1; // the file cannot be duplicated, so don't try again
+        }
+        handle_returned_.wait(lock);
+    }
+    const auto result = idle_handles_.back();
+    idle_handles_.pop_back();
+    return result;
+}
+
+void ReadReader::release_handle(const IReadReaderImpl* handle) const
+{
+    {
+        std::lock_guard<std::mutex> lock {mutex_};
+        idle_handles_.push_back(handle);
+    }
+    handle_returned_.notify_all();
+}
+
+bool ReadReader::all_handles_idle() const noexcept
+{
+    return idle_handles_.size() == duplicates_.size() + (impl_ ? 1 : 0);
 }
 
 bool operator==(const ReadReader& lhs, const ReadReader& rhs)
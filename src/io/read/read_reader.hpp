@@ -8,6 +8,7 @@
 #include <cstddef>
 #include <memory>
 #include <mutex>
+#include <condition_variable>
 #include <utility>
 #include <functional>
 
@@ -25,7 +26,11 @@ class AlignedRead;
 namespace io {
 
 /*
- ReadReader is a simple RAII threadsafe wrapper around a IReadReaderImpl
+ ReadReader is a simple RAII threadsafe wrapper around a IReadReaderImpl.
+ 
+ Read queries are served from a pool of up to max_handles independent handles on the
+ same file (created on demand by duplicating the primary handle), so concurrent
+ queries only contend for the pool, not for the file.
  */
 class ReadReader : public Equitable<ReadReader>
 {
@@ -41,7 +46,7 @@ public:
     
     ReadReader() = default;
     
-    ReadReader(const Path& file_path);
+    ReadReader(const Path& file_path, unsigned max_handles = 1);
     
     ReadReader(const ReadReader&)            = delete;
     ReadReader& operator=(const ReadReader&) = delete;
@@ -58,6 +63,9 @@ public:
     
     const Path& path() const noexcept;
     
+    unsigned max_handles() const noexcept;
+    unsigned num_handles() const noexcept;
+    
     std::vector<SampleName> extract_samples() const;
     
     std::vector<std::string> extract_read_groups(const SampleName& sample) const;
@@ -113,10 +121,35 @@ public:
                               const GenomicRegion& region) const;
     
 private:
+    class BorrowedHandle
+    {
+    public:
+        BorrowedHandle() = delete;
+        BorrowedHandle(const ReadReader& reader);
+        BorrowedHandle(const BorrowedHandle&)            = delete;
+        BorrowedHandle& operator=(const BorrowedHandle&) = delete;
+        ~BorrowedHandle();
+        
+        const IReadReaderImpl* operator->() const noexcept { return handle_; }
+        
+    private:
+        const ReadReader& reader_;
+        const IReadReaderImpl* handle_;
+    };
+    
     Path file_path_;
     std::unique_ptr<IReadReaderImpl> impl_;
+    mutable unsigned max_handles_ = 1;
+    
+    mutable std::vector<std::unique_ptr<IReadReaderImpl>> duplicates_;
+    mutable std::vector<const IReadReaderImpl*> idle_handles_;
     
     mutable std::mutex mutex_;
+    mutable std::condition_variable handle_returned_;
+    
+    const IReadReaderImpl* acquire_handle() const;
+    void release_handle(const IReadReaderImpl* handle) const;
+    bool all_handles_idle() const noexcept;
 };
 
 bool operator==(const ReadReader& lhs, const ReadReader& rhs);
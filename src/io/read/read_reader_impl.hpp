@@ -7,6 +7,7 @@
 #include <string>
 #include <vector>
 #include <cstddef>
+#include <memory>
 #include <unordered_map>
 #include <utility>
 #include <functional>
@@ -87,6 +88,10 @@ public:
     
     virtual boost::optional<std::vector<GenomicRegion::ContigName>> mapped_contigs() const { return boost::none; };
     virtual boost::optional<std::vector<GenomicRegion>> mapped_regions() const { return boost::none; };
+    
+    // Opens another independent handle on the same file, sharing any read-only state.
+    // Returns nullptr if the implementation cannot be duplicated.
+    virtual std::unique_ptr<IReadReaderImpl> duplicate() const { return nullptr; };
 };
 
 } // namespace io
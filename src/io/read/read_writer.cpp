@@ -4,12 +4,47 @@
 #include "read_writer.hpp"
 
 #include <utility>
+#include <array>
+#include <algorithm>
+#include <iterator>
+#include <cstring>
+
+#include <htslib/sam.h>
+#include <htslib/bgzf.h>
 
 #include "basics/aligned_read.hpp"
+#include "exceptions/missing_file_error.hpp"
+#include "exceptions/malformed_file_error.hpp"
+#include "exceptions/unwritable_file_error.hpp"
 #include "annotated_aligned_read.hpp"
 
 namespace octopus { namespace io {
 
+namespace {
+
+class MissingConcatenationBAM : public MissingFileError
+{
+    std::string do_where() const override { return "concatenate"; }
+public:
+    MissingConcatenationBAM(boost::filesystem::path file) : MissingFileError {std::move(file), "bam"} {}
+};
+
+class MalformedConcatenationBAM : public MalformedFileError
+{
+    std::string do_where() const override { return "concatenate"; }
+public:
+    MalformedConcatenationBAM(boost::filesystem::path file) : MalformedFileError {std::move(file), "bam"} {}
+};
+
+class UnwritableConcatenationBAM : public UnwritableFileError
+{
+    std::string do_where() const override { return "concatenate"; }
+public:
+    UnwritableConcatenationBAM(boost::filesystem::path file) : UnwritableFileError {std::move(file), "bam"} {}
+};
+
+} // namespace
+
 ReadWriter::ReadWriter(Path bam_out, Path bam_template)
 : path_ {std::move(bam_out)}
 , impl_ {std::make_unique<HtslibSamFacade>(path_, std::move(bam_template))}
@@ -61,5 +96,79 @@ ReadWriter& operator<<(ReadWriter& dst, const AnnotatedAlignedRead& read)
     return dst;
 }
 
+namespace {
+
+struct BGZFDeleter
+{
+    void operator()(BGZF* file) const { bgzf_close(file); }
+};
+struct BamHeaderDeleter
+{
+    void operator()(bam_hdr_t* header) const { bam_hdr_destroy(header); }
+};
+
+using BGZFPtr = std::unique_ptr<BGZF, BGZFDeleter>;
+using BamHeaderPtr = std::unique_ptr<bam_hdr_t, BamHeaderDeleter>;
+
+// Every BGZF file ends with this empty block. It is dropped from each input so the output only has one.
+constexpr std::array<char, 28> bgzf_eof_block
+{
+    '\x1f', '\x8b', '\x08', '\x04', '\x00', '\x00', '\x00', '\x00', '\x00', '\xff', '\x06', '\x00', '\x42', '\x43',
+    '\x02', '\x00', '\x1b', '\x00', '\x03', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00'
+};
+
+void copy_records(BGZF* src, BGZF* dst, const ReadWriter::Path& src_path, const ReadWriter::Path& dst_path)
+{
+    // The header may end part way through a block, so the rest of that block has to be recompressed
+    if (src->block_offset < src->block_length) {
+        const auto remaining = static_cast<char*>(src->uncompressed_block) + src->block_offset;
+        if (bgzf_write(dst, remaining, src->block_length - src->block_offset) < 0 || bgzf_flush(dst) != 0) {
+            throw UnwritableConcatenationBAM {dst_path};
+        }
+    }
+    // Hold back enough bytes to recognise the end-of-file block
+    static constexpr std::size_t buffer_size {1 << 16};
+    std::vector<char> buffer(buffer_size + bgzf_eof_block.size());
+    std::size_t num_held {0};
+    while (true) {
+        const auto num_read = bgzf_raw_read(src, buffer.data() + num_held, buffer_size);
+        if (num_read < 0) throw MalformedConcatenationBAM {src_path};
+        if (num_read == 0) break;
+        const auto num_buffered = num_held + static_cast<std::size_t>(num_read);
+        num_held = std::min(num_buffered, bgzf_eof_block.size());
+        const auto num_writable = num_buffered - num_held;
+        if (num_writable > 0 && bgzf_raw_write(dst, buffer.data(), num_writable) < 0) {
+            throw UnwritableConcatenationBAM {dst_path};
+        }
+        std::memmove(buffer.data(), buffer.data() + num_writable, num_held);
+    }
+    if (num_held > 0 && !(num_held == bgzf_eof_block.size() && std::equal(std::cbegin(bgzf_eof_block), std::cend(bgzf_eof_block), buffer.data()))) {
+        if (bgzf_raw_write(dst, buffer.data(), num_held) < 0) throw UnwritableConcatenationBAM {dst_path};
+    }
+}
+
+} // namespace
+
+void concatenate(const std::vector<ReadWriter::Path>& bams, const ReadWriter::Path& dst)
+{
+    if (bams.empty()) return;
+    BGZFPtr out {bgzf_open(dst.c_str(), "w")};
+    if (!out) throw UnwritableConcatenationBAM {dst};
+    for (std::size_t i {0}; i < bams.size(); ++i) {
+        BGZFPtr in {bgzf_open(bams[i].c_str(), "r")};
+        if (!in) throw MissingConcatenationBAM {bams[i]};
+        BamHeaderPtr header {bam_hdr_read(in.get())};
+        if (!header) throw MalformedConcatenationBAM {bams[i]};
+        if (i == 0) {
+            if (bam_hdr_write(out.get(), header.get()) < 0 || bgzf_flush(out.get()) != 0) {
+                throw UnwritableConcatenationBAM {dst};
+            }
+        }
+        copy_records(in.get(), out.get(), bams[i], dst);
+    }
+    if (bgzf_close(out.release()) != 0) throw UnwritableConcatenationBAM {dst};
+    if (sam_index_build(dst.c_str(), 0) < 0) throw UnwritableConcatenationBAM {dst};
+}
+
 } // namespace io
 } // namespace octopus
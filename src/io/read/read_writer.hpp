@@ -6,6 +6,7 @@
 
 #include <memory>
 #include <mutex>
+#include <vector>
 
 #include <boost/filesystem/path.hpp>
 
@@ -66,6 +67,10 @@ ReadWriter& operator<<(ReadWriter& dst, const Container& reads)
     return dst;
 }
 
+// Concatenates BAMs with identical headers, in the given order, by copying their compressed
+// blocks. The result is only sorted if each BAM is sorted and covers a later region than the last.
+void concatenate(const std::vector<ReadWriter::Path>& bams, const ReadWriter::Path& dst);
+
 } // namespace io
 } // namespace octopus
 
@@ -13,6 +13,7 @@
 #include <cstring>
 #include <cstdint>
 #include <cmath>
+#include <mutex>
 
 #include <boost/filesystem/operations.hpp>
 #include <boost/optional.hpp>
@@ -110,7 +111,7 @@ HtslibBcfFacade::HtslibBcfFacade(Path file_path, Mode mode)
             if (!file_) {
                 throw FileOpenError {file_path_};
             }
-            header_.reset(bcf_hdr_read(file_.get()));
+            header_.reset(bcf_hdr_read(file_.get()), HtsHeaderDeleter {});
             if (!header_) {
                 throw std::runtime_error {"HtslibBcfFacade: could not make header for file " + file_path_.string()};
             }
@@ -123,14 +124,14 @@ HtslibBcfFacade::HtslibBcfFacade(Path file_path, Mode mode)
         if (!file_) {
             throw FileOpenError {file_path_};
         }
-        header_.reset(bcf_hdr_init(hts_mode.c_str()));
+        header_.reset(bcf_hdr_init(hts_mode.c_str()), HtsHeaderDeleter {});
     } else {
         const auto hts_read_mode = get_hts_mode(file_path_, Mode::read);
         file_.reset(bcf_open(file_path_.c_str(), hts_read_mode.c_str()));
         if (!file_) {
             throw FileOpenError {file_path_};
         }
-        header_.reset(bcf_hdr_read(file_.get()));
+        header_.reset(bcf_hdr_read(file_.get()), HtsHeaderDeleter {});
         file_.reset();
         file_.reset(bcf_open(file_path_.c_str(), hts_mode.c_str()));
         if (!file_) {
@@ -139,7 +140,7 @@ HtslibBcfFacade::HtslibBcfFacade(Path file_path, Mode mode)
         if (header_) {
             samples_ = extract_samples(header_.get());
         } else {
-            header_.reset(bcf_hdr_init(hts_mode.c_str()));
+            header_.reset(bcf_hdr_init(hts_mode.c_str()), HtsHeaderDeleter {});
         }
     }
 }
@@ -388,7 +389,7 @@ void HtslibBcfFacade::write(const VcfHeader& header)
     if (bcf_hdr_write(file_.get(), hdr) < 0) {
         throw std::runtime_error {"HtslibBcfFacade: header write failed"};
     }
-    header_.reset(hdr);
+    header_.reset(hdr, HtsHeaderDeleter {});
     samples_ = extract_samples(header_.get());
 }
 
@@ -720,8 +721,148 @@ auto extract_format(const bcf_hdr_t* header, const bcf1_t* record)
     return result;
 }
 
-void extract_samples(const bcf_hdr_t* header, bcf1_t* record, VcfRecord::Builder& builder)
+std::vector<std::vector<std::string>> extract_format_values(const bcf_hdr_t* header, bcf1_t* record, const std::string& key)
 {
+    const auto num_samples = record->n_sample;
+    std::vector<std::vector<std::string>> values(num_samples, std::vector<std::string> {});
+    int* intformat {nullptr};
+    float* floatformat {nullptr};
+    char** stringformat {nullptr};
+    int nintformat {}, nfloatformat {}, nstringformat {};
+    switch (bcf_hdr_id2type(header, BCF_HL_FMT, bcf_hdr_id2int(header, BCF_DT_ID, key.c_str()))) {
+        case BCF_HT_INT: {
+            const auto num_values_written = bcf_get_format_int32(header, record, key.c_str(), &intformat, &nintformat);
+            if (num_values_written > 0) {
+                const auto num_values_per_sample = num_values_written / num_samples;
+                auto ptr = intformat;
+                for (unsigned sample {0}; sample < num_samples; ++sample, ptr += num_values_per_sample) {
+                    const static auto is_pad = [] (auto x) noexcept { return x == bcf_int32_vector_end; };
+                    const auto pad_ritr = std::find_if_not(std::make_reverse_iterator(ptr + num_values_per_sample), std::make_reverse_iterator(ptr), is_pad);
+                    const auto num_pad_values = std::distance(std::make_reverse_iterator(ptr + num_values_per_sample), pad_ritr);
+                    assert(num_pad_values <= num_values_per_sample);
+                    const auto num_sample_values = num_values_per_sample - num_pad_values;
+                    values[sample].reserve(num_sample_values);
+                    std::transform(ptr, ptr + num_sample_values, std::back_inserter(values[sample]),
+                                   [] (auto v) {
+                                       return v != bcf_int32_missing ? std::to_string(v) : bcf_missing_str;
+                                   });
+                }
+            }
+            break;
+        }
+        case BCF_HT_REAL: {
+            const auto num_values_written = bcf_get_format_float(header, record, key.c_str(), &floatformat, &nfloatformat);
+            if (num_values_written > 0) {
+                const auto num_values_per_sample = num_values_written / num_samples;
+                auto ptr = floatformat;
+                for (unsigned sample {0}; sample < num_samples; ++sample, ptr += num_values_per_sample) {
+                    const static auto is_pad = [] (auto x) noexcept { return bcf_float_is_vector_end(x); };
+                    const auto pad_ritr = std::find_if_not(std::make_reverse_iterator(ptr + num_values_per_sample), std::make_reverse_iterator(ptr), is_pad);
+                    const auto num_pad_values = std::distance(std::make_reverse_iterator(ptr + num_values_per_sample), pad_ritr);
+                    assert(num_pad_values <= num_values_per_sample);
+                    const auto num_sample_values = num_values_per_sample - num_pad_values;
+                    values[sample].reserve(num_sample_values);
+                    std::transform(ptr, ptr + num_sample_values, std::back_inserter(values[sample]),
+                                   [] (auto v) {
+                                       return v != bcf_float_missing ? std::to_string(v) : bcf_missing_str;
+                                   });
+                }
+            }
+            break;
+        }
+        case BCF_HT_STR:
+            // TODO: Check this usage is correct. What if more than one value per sample?
+            if (bcf_get_format_string(header, record, key.c_str(), &stringformat, &nstringformat) > 0) {
+                unsigned sample {0};
+                std::for_each(stringformat, stringformat + num_samples,
+                              [&values, &sample] (const char* str) {
+                                  values[sample++].emplace_back(str);
+                              });
+            }
+            break;
+    }
+    if (intformat != nullptr) std::free(intformat);
+    if (floatformat != nullptr) std::free(floatformat);
+    if (stringformat != nullptr) {
+        // bcf_get_format_string allocates two arrays
+        std::free(stringformat[0]);
+        std::free(stringformat);
+    }
+    return values;
+}
+
+/*
+    Keeps a copy of the raw record so non-GT FORMAT values are only decoded if they're requested,
+    and can be copied straight into an output record if they're not.
+ */
+class HtslibFormatDecoder : public VcfRecord::SampleDataDecoder
+{
+public:
+    HtslibFormatDecoder(std::shared_ptr<bcf_hdr_t> header, bcf1_t* record)
+    : header_ {std::move(header)}
+    , record_ {bcf_dup(record)}
+    {
+        bcf_unpack(record_, BCF_UN_FMT);
+    }
+    
+    HtslibFormatDecoder(const HtslibFormatDecoder&)            = delete;
+    HtslibFormatDecoder& operator=(const HtslibFormatDecoder&) = delete;
+    
+    ~HtslibFormatDecoder() override { bcf_destroy(record_); }
+    
+    boost::optional<std::size_t> sample_index(const VcfRecord::SampleName& sample) const override
+    {
+        const auto result = bcf_hdr_id2int(header_.get(), BCF_DT_SAMPLE, sample.c_str());
+        if (result < 0) return boost::none;
+        return static_cast<std::size_t>(result);
+    }
+    
+    std::vector<std::vector<VcfRecord::ValueType>> decode(const VcfRecord::KeyType& key) const override
+    {
+        std::lock_guard<std::mutex> lock {mutex_};
+        return extract_format_values(header_.get(), record_, key);
+    }
+    
+    bool has_sample_order(const std::vector<std::string>& samples) const
+    {
+        if (samples.size() != static_cast<std::size_t>(bcf_hdr_nsamples(header_.get()))) return false;
+        for (std::size_t s {0}; s < samples.size(); ++s) {
+            if (samples[s] != header_->samples[s]) return false;
+        }
+        return true;
+    }
+    
+    // Copies the encoded values for key if the destination header has the same type
+    bool copy(const VcfRecord::KeyType& key, const bcf_hdr_t* dest_header, bcf1_t* dest) const
+    {
+        const auto source_id = bcf_hdr_id2int(header_.get(), BCF_DT_ID, key.c_str());
+        const auto dest_id = bcf_hdr_id2int(dest_header, BCF_DT_ID, key.c_str());
+        if (!bcf_hdr_idinfo_exists(header_.get(), BCF_HL_FMT, source_id)
+         || !bcf_hdr_idinfo_exists(dest_header, BCF_HL_FMT, dest_id)) return false;
+        const auto type = bcf_hdr_id2type(header_.get(), BCF_HL_FMT, source_id);
+        if (type == BCF_HT_FLAG || type != bcf_hdr_id2type(dest_header, BCF_HL_FMT, dest_id)) return false;
+        void* values {nullptr};
+        int num_values_allocated {};
+        int num_values {};
+        {
+            std::lock_guard<std::mutex> lock {mutex_};
+            num_values = bcf_get_format_values(header_.get(), record_, key.c_str(), &values, &num_values_allocated, type);
+        }
+        const auto copied = num_values > 0 && bcf_update_format(dest_header, dest, key.c_str(), values, num_values, type) == 0;
+        if (values != nullptr) std::free(values);
+        return copied;
+    }
+    
+private:
+    std::shared_ptr<bcf_hdr_t> header_;
+    bcf1_t* record_;
+    mutable std::mutex mutex_;
+};
+
+void extract_samples(const std::shared_ptr<bcf_hdr_t>& hdr, bcf1_t* record, VcfRecord::Builder& builder,
+                     const std::vector<std::string>& samples)
+{
+    const auto header = hdr.get();
     auto format = extract_format(header, record);
     const auto num_samples = record->n_sample;
     builder.reserve_samples(num_samples);
@@ -757,77 +898,11 @@ void extract_samples(const bcf_hdr_t* header, bcf1_t* record, VcfRecord::Builder
         std::free(gt);
         ++first_format;
     }
-    int* intformat {nullptr};
-    float* floatformat {nullptr};
-    char** stringformat {nullptr};
-    int nintformat {}, nfloatformat {}, nstringformat {};
-    for (auto itr = first_format, end = std::cend(format); itr != end; ++itr) {
-        const auto& key = *itr;
-        std::vector<std::vector<std::string>> values(num_samples, std::vector<std::string> {});
-        switch (bcf_hdr_id2type(header, BCF_HL_FMT, bcf_hdr_id2int(header, BCF_DT_ID, key.c_str()))) {
-            case BCF_HT_INT: {
-                const auto num_values_written = bcf_get_format_int32(header, record, key.c_str(), &intformat, &nintformat);
-                if (num_values_written > 0) {
-                    const auto num_values_per_sample = num_values_written / num_samples;
-                    auto ptr = intformat;
-                    for (unsigned sample {0}; sample < num_samples; ++sample, ptr += num_values_per_sample) {
-                        const static auto is_pad = [] (auto x) noexcept { return x == bcf_int32_vector_end; };
-                        const auto pad_ritr = std::find_if_not(std::make_reverse_iterator(ptr + num_values_per_sample), std::make_reverse_iterator(ptr), is_pad);
-                        const auto num_pad_values = std::distance(std::make_reverse_iterator(ptr + num_values_per_sample), pad_ritr);
-                        assert(num_pad_values <= num_values_per_sample);
-                        const auto num_sample_values = num_values_per_sample - num_pad_values;
-                        values[sample].reserve(num_sample_values);
-                        std::transform(ptr, ptr + num_sample_values, std::back_inserter(values[sample]),
-                                       [] (auto v) {
-                                           return v != bcf_int32_missing ? std::to_string(v) : bcf_missing_str;
-                                       });
-                    }
-                }
-                break;
-            }
-            case BCF_HT_REAL: {
-                const auto num_values_written = bcf_get_format_float(header, record, key.c_str(), &floatformat, &nfloatformat);
-                if (num_values_written > 0) {
-                    const auto num_values_per_sample = num_values_written / num_samples;
-                    auto ptr = floatformat;
-                    for (unsigned sample {0}; sample < num_samples; ++sample, ptr += num_values_per_sample) {
-                        const static auto is_pad = [] (auto x) noexcept { return bcf_float_is_vector_end(x); };
-                        const auto pad_ritr = std::find_if_not(std::make_reverse_iterator(ptr + num_values_per_sample), std::make_reverse_iterator(ptr), is_pad);
-                        const auto num_pad_values = std::distance(std::make_reverse_iterator(ptr + num_values_per_sample), pad_ritr);
-                        assert(num_pad_values <= num_values_per_sample);
-                        const auto num_sample_values = num_values_per_sample - num_pad_values;
-                        values[sample].reserve(num_sample_values);
-                        std::transform(ptr, ptr + num_sample_values, std::back_inserter(values[sample]),
-                                       [] (auto v) {
-                                           return v != bcf_float_missing ? std::to_string(v) : bcf_missing_str;
-                                       });
-                    }
-                }
-                break;
-            }
-            case BCF_HT_STR:
-                // TODO: Check this usage is correct. What if more than one value per sample?
-                if (bcf_get_format_string(header, record, key.c_str(), &stringformat, &nstringformat) > 0) {
-                    unsigned sample {0};
-                    std::for_each(stringformat, stringformat + num_samples,
-                                  [&values, &sample] (const char* str) {
-                                      values[sample++].emplace_back(str);
-                                  });
-                }
-                break;
-        }
-        for (unsigned sample {0}; sample < num_samples; ++sample) {
-            builder.set_format(header->samples[sample], key, std::move(values[sample]));
-        }
+    if (first_format != std::cend(format)) {
+        builder.set_format_decoder(std::make_shared<HtslibFormatDecoder>(hdr, record),
+                                   {first_format, std::cend(format)}, samples);
     }
     builder.set_format(std::move(format));
-    if (intformat != nullptr) std::free(intformat);
-    if (floatformat != nullptr) std::free(floatformat);
-    if (stringformat != nullptr) {
-        // bcf_get_format_string allocates two arrays
-        std::free(stringformat[0]);
-        std::free(stringformat);
-    }
 }
 
 auto to_bcf_gt_number(const VcfRecord::AlleleIndex index, const bool is_phased)
@@ -889,7 +964,16 @@ void set_samples(const bcf_hdr_t* header, bcf1_t* dest, const VcfRecord& source,
         ++first_format;
     }
     std::vector<std::string> str_buffer {};
+    boost::optional<bool> is_same_sample_order {};
     std::for_each(first_format, std::cend(format), [&] (const auto& key) {
+        // Values that were never decoded can be copied without a round trip through strings
+        const auto decoder = dynamic_cast<const HtslibFormatDecoder*>(source.format_decoder(key));
+        if (decoder) {
+            if (!is_same_sample_order) {
+                is_same_sample_order = samples.size() == source.num_samples() && decoder->has_sample_order(samples);
+            }
+            if (*is_same_sample_order && decoder->copy(key, header, dest)) return;
+        }
         const auto key_cardinality = source.format_cardinality(key);
         int num_values {};
         if (key_cardinality) {
@@ -986,7 +1070,7 @@ VcfRecord HtslibBcfFacade::fetch_record(const bcf_srs_t* sr, UnpackPolicy level)
     extract_filter(header_.get(), hts_record, record_builder);
     extract_info(header_.get(), hts_record, record_builder);
     if (level == UnpackPolicy::all && has_samples(header_.get())) {
-        extract_samples(header_.get(), hts_record, record_builder);
+        extract_samples(header_, hts_record, record_builder, samples_);
     }
     return record_builder.build_once();
 }
@@ -71,7 +71,7 @@ private:
     };
     struct HtsHeaderDeleter
     {
-        void operator()(bcf_hdr_t* header) const { bcf_hdr_destroy(header); }
+        void operator()(bcf_hdr_t* header) const { if (header) bcf_hdr_destroy(header); }
     };
     struct HtsSrsDeleter
     {
@@ -87,7 +87,7 @@ private:
     
     Path file_path_;
     std::unique_ptr<htsFile, HtsFileDeleter> file_;
-    std::unique_ptr<bcf_hdr_t, HtsHeaderDeleter> header_;
+    std::shared_ptr<bcf_hdr_t> header_; // shared with lazily decoded records
     std::vector<std::string> samples_;
     
     bool is_bcf() const noexcept;
@@ -5,6 +5,7 @@
 
 #include <algorithm>
 #include <iterator>
+#include <stdexcept>
 
 #include <boost/lexical_cast.hpp>
 
@@ -94,7 +95,7 @@ boost::optional<unsigned> VcfRecord::format_cardinality(const KeyType& key) cons
     boost::optional<unsigned> result {};
     if (has_format(key)) {
         for (const auto& p : samples_) {
-            const auto sample_format_cardinality = p.second.other.at(key).size();
+            const auto sample_format_cardinality = get_sample_value(p.first, key).size();
             if (result) {
                 if (*result != sample_format_cardinality) return boost::none;
             } else {
@@ -184,7 +185,19 @@ const std::vector<VcfRecord::AlleleIndex>& VcfRecord::genotype(const SampleName&
 
 const std::vector<VcfRecord::ValueType>& VcfRecord::get_sample_value(const SampleName& sample, const KeyType& key) const
 {
-    return samples_.at(sample).other.at(key);
+    const auto& data = samples_.at(sample).other;
+    const auto itr = data.find(key);
+    if (itr != std::cend(data)) return itr->second;
+    if (is_lazy(key)) {
+        const auto sample_index = lazy_samples_->decoder->sample_index(sample);
+        if (sample_index) return lazy_samples_->get(key).at(*sample_index);
+    }
+    throw std::out_of_range {"VcfRecord: no FORMAT value for key " + key};
+}
+
+const VcfRecord::SampleDataDecoder* VcfRecord::format_decoder(const KeyType& key) const noexcept
+{
+    return is_lazy(key) ? lazy_samples_->decoder.get() : nullptr;
 }
 
 // helper non-members needed for printing
@@ -215,6 +228,21 @@ std::ostream& operator<<(std::ostream& os, const std::vector<T>& v)
 
 // private methods
 
+const std::vector<std::vector<VcfRecord::ValueType>>& VcfRecord::LazySampleData::get(const KeyType& key) const
+{
+    std::lock_guard<std::mutex> lock {mutex};
+    auto itr = values.find(key);
+    if (itr == std::cend(values)) {
+        itr = values.emplace(key, decoder->decode(key)).first;
+    }
+    return itr->second;
+}
+
+bool VcfRecord::is_lazy(const KeyType& key) const noexcept
+{
+    return std::find(std::cbegin(lazy_format_), std::cend(lazy_format_), key) != std::cend(lazy_format_);
+}
+
 std::vector<VcfRecord::SampleName> VcfRecord::samples() const
 {
     std::vector<SampleName> result {};
@@ -461,6 +489,8 @@ VcfRecord::Builder::Builder(const VcfRecord& call)
 , info_ {call.info_}
 , format_ {call.format()}
 , samples_ {call.samples_}
+, lazy_format_ {call.lazy_format_}
+, lazy_samples_ {call.lazy_samples_}
 {}
 
 VcfRecord::Builder& VcfRecord::Builder::set_chrom(std::string name)
@@ -604,16 +634,28 @@ VcfRecord::Builder& VcfRecord::Builder::clear_info(const KeyType& key)
     return *this;
 }
 
+namespace {
+
+template <typename Container>
+bool contains(const Container& keys, const VcfRecord::KeyType& key)
+{
+    return std::find(std::cbegin(keys), std::cend(keys), key) != std::cend(keys);
+}
+
+} // namespace
+
 VcfRecord::Builder& VcfRecord::Builder::set_format(std::vector<KeyType> format)
 {
     format_ = std::move(format);
+    lazy_format_.erase(std::remove_if(std::begin(lazy_format_), std::end(lazy_format_),
+                                      [this] (const auto& key) { return !contains(format_, key); }),
+                       std::end(lazy_format_));
     return *this;
 }
 
 VcfRecord::Builder& VcfRecord::Builder::set_format(std::initializer_list<KeyType> format)
 {
-    format_ = std::move(format);
-    return *this;
+    return this->set_format(std::vector<KeyType> {format});
 }
 
 VcfRecord::Builder& VcfRecord::Builder::add_format(KeyType key)
@@ -699,6 +741,7 @@ VcfRecord::Builder& VcfRecord::Builder::set_format(const SampleName& sample, con
 
 VcfRecord::Builder& VcfRecord::Builder::set_format(const SampleName& sample, const KeyType& key, std::vector<ValueType> values)
 {
+    decode_format(key);
     samples_[sample].other[key] = std::move(values);
     return *this;
 }
@@ -713,10 +756,24 @@ VcfRecord::Builder& VcfRecord::Builder::set_format_missing(const SampleName& sam
     return this->set_format(sample, key, std::string {vcfspec::missingValue});
 }
 
+VcfRecord::Builder& VcfRecord::Builder::set_format_decoder(std::shared_ptr<const SampleDataDecoder> decoder,
+                                                           std::vector<KeyType> keys,
+                                                           const std::vector<SampleName>& samples)
+{
+    for (const auto& sample : samples) samples_[sample];
+    auto lazy_samples = std::make_shared<LazySampleData>();
+    lazy_samples->decoder = std::move(decoder);
+    lazy_samples_ = std::move(lazy_samples);
+    lazy_format_ = std::move(keys);
+    return *this;
+}
+
 VcfRecord::Builder& VcfRecord::Builder::clear_format() noexcept
 {
     format_.clear();
     samples_.clear();
+    lazy_format_.clear();
+    lazy_samples_.reset();
     return *this;
 }
 
@@ -726,11 +783,12 @@ VcfRecord::Builder& VcfRecord::Builder::clear_format(const SampleName& sample) n
     return *this;
 }
 
-VcfRecord::Builder& VcfRecord::Builder::clear_format(const SampleName& sample, const KeyType& key) noexcept
+VcfRecord::Builder& VcfRecord::Builder::clear_format(const SampleName& sample, const KeyType& key)
 {
     if (key == vcfspec::format::genotype) {
         clear_genotype(sample);
     } else {
+        decode_format(key);
         const auto sample_itr = samples_.find(sample);
         if (sample_itr != std::cend(samples_)) {
             sample_itr->second.other.erase(key);
@@ -756,16 +814,17 @@ VcfRecord::Builder& VcfRecord::Builder::set_filter(const SampleName& sample, std
 
 VcfRecord::Builder& VcfRecord::Builder::add_filter(const SampleName& sample, KeyType filter)
 {
+    decode_format(vcfspec::format::filter);
     samples_[sample].other[vcfspec::format::filter].push_back(std::move(filter));
     return *this;
 }
 
-VcfRecord::Builder& VcfRecord::Builder::clear_filter(const SampleName& sample) noexcept
+VcfRecord::Builder& VcfRecord::Builder::clear_filter(const SampleName& sample)
 {
     return this->clear_format(sample, vcfspec::format::filter);
 }
 
-VcfRecord::Builder& VcfRecord::Builder::clear_all_sample_filters() noexcept
+VcfRecord::Builder& VcfRecord::Builder::clear_all_sample_filters()
 {
     for (const auto& p : samples_) {
         this->clear_filter(p.first);
@@ -824,14 +883,18 @@ VcfRecord VcfRecord::Builder::build() const
             return VcfRecord {chrom_, pos_, id_, ref_, alt_, qual_, filter_, info_};
         }
     } else {
+        VcfRecord result {};
         if (end_) {
             GenomicRegion region {chrom_, pos_ - 1, *end_ - 1};
-            return VcfRecord {std::move(region), id_, ref_, alt_, qual_, filter_,
-                              info_, format_, samples_};
+            result = VcfRecord {std::move(region), id_, ref_, alt_, qual_, filter_,
+                                info_, format_, samples_};
         } else {
-            return VcfRecord {chrom_, pos_, id_, ref_, alt_, qual_, filter_,
-                             info_, format_, samples_};
+            result = VcfRecord {chrom_, pos_, id_, ref_, alt_, qual_, filter_,
+                                info_, format_, samples_};
         }
+        result.lazy_format_ = lazy_format_;
+        result.lazy_samples_ = lazy_samples_;
+        return result;
     }
 }
 
@@ -847,17 +910,35 @@ VcfRecord VcfRecord::Builder::build_once() noexcept
                               std::move(alt_), qual_, std::move(filter_), std::move(info_)};
         }
     } else {
+        VcfRecord result {};
         if (end_) {
             GenomicRegion region {std::move(chrom_), pos_ - 1, *end_ - 1};
-            return VcfRecord {std::move(region), std::move(id_), std::move(ref_),
-                              std::move(alt_), qual_, std::move(filter_), std::move(info_),
-                              std::move(format_), std::move(samples_)};
+            result = VcfRecord {std::move(region), std::move(id_), std::move(ref_),
+                                std::move(alt_), qual_, std::move(filter_), std::move(info_),
+                                std::move(format_), std::move(samples_)};
         } else {
-            return VcfRecord {std::move(chrom_), pos_, std::move(id_), std::move(ref_),
-                              std::move(alt_), qual_, std::move(filter_), std::move(info_),
-                              std::move(format_), std::move(samples_)};
+            result = VcfRecord {std::move(chrom_), pos_, std::move(id_), std::move(ref_),
+                                std::move(alt_), qual_, std::move(filter_), std::move(info_),
+                                std::move(format_), std::move(samples_)};
         }
+        result.lazy_format_ = std::move(lazy_format_);
+        result.lazy_samples_ = std::move(lazy_samples_);
+        return result;
+    }
+}
+
+// private methods
+
+void VcfRecord::Builder::decode_format(const KeyType& key)
+{
+    const auto itr = std::find(std::cbegin(lazy_format_), std::cend(lazy_format_), key);
+    if (itr == std::cend(lazy_format_)) return;
+    const auto& values = lazy_samples_->get(key);
+    for (auto& p : samples_) {
+        const auto sample_index = lazy_samples_->decoder->sample_index(p.first);
+        if (sample_index) p.second.other[key] = values[*sample_index];
     }
+    lazy_format_.erase(itr);
 }
 
 } // namespace octopus
@@ -5,6 +5,7 @@
 #define vcf_record_hpp
 
 #include <cstdint>
+#include <cstddef>
 #include <string>
 #include <vector>
 #include <map>
@@ -13,6 +14,8 @@
 #include <utility>
 #include <initializer_list>
 #include <functional>
+#include <memory>
+#include <mutex>
 
 #include <boost/optional.hpp>
 #include <boost/container/flat_map.hpp>
@@ -38,6 +41,19 @@ public:
     using ValueType          = std::string;
     using AlleleIndex        = std::int8_t;
     
+    /*
+        A SampleDataDecoder provides FORMAT values on demand, so that a record read from file
+        only pays for decoding the sample keys that are actually requested.
+     */
+    class SampleDataDecoder
+    {
+    public:
+        virtual ~SampleDataDecoder() = default;
+        virtual boost::optional<std::size_t> sample_index(const SampleName& sample) const = 0;
+        // Values for every sample, in sample_index order
+        virtual std::vector<std::vector<ValueType>> decode(const KeyType& key) const = 0;
+    };
+    
     VcfRecord() = default;
     
     // Constructor without genotype fields
@@ -111,6 +127,7 @@ public:
     bool has_alt_allele(const SampleName& sample) const;
     const std::vector<AlleleIndex>& genotype(const SampleName& sample) const;
     const std::vector<ValueType>& get_sample_value(const SampleName& sample, const KeyType& key) const;
+    const SampleDataDecoder* format_decoder(const KeyType& key) const noexcept; // nullptr if key is already decoded
     
     friend std::ostream& operator<<(std::ostream& os, const VcfRecord& record);
     friend Builder;
@@ -128,6 +145,13 @@ private:
         ValueMap other;
     };
     using SampleDataMap = boost::container::flat_map<SampleName, SampleData>;
+    struct LazySampleData
+    {
+        std::shared_ptr<const SampleDataDecoder> decoder;
+        mutable std::mutex mutex;
+        mutable std::map<KeyType, std::vector<std::vector<ValueType>>> values; // node based for reference stability
+        const std::vector<std::vector<ValueType>>& get(const KeyType& key) const;
+    };
     
     // mandatory fields
     GenomicRegion region_;
@@ -140,7 +164,10 @@ private:
     // optional fields
     std::vector<KeyType> format_;
     SampleDataMap samples_;
+    std::vector<KeyType> lazy_format_;
+    std::shared_ptr<const LazySampleData> lazy_samples_;
     
+    bool is_lazy(const KeyType& key) const noexcept;
     const Genotype& get_genotype(const SampleName& sample) const;
     std::string get_allele_number(const NucleotideSequence& allele) const;
     std::vector<SampleName> samples() const;
@@ -237,14 +264,16 @@ public:
     Builder& set_format(const SampleName& sample, const KeyType& key, std::initializer_list<ValueType> values);
     Builder& set_format_missing(const SampleName& sample, const KeyType& key);
     Builder& clear_format() noexcept;
+    Builder& set_format_decoder(std::shared_ptr<const SampleDataDecoder> decoder, std::vector<KeyType> keys,
+                                const std::vector<SampleName>& samples);
     Builder& clear_format(const SampleName& sample) noexcept;
-    Builder& clear_format(const SampleName& sample, const KeyType& key) noexcept;
+    Builder& clear_format(const SampleName& sample, const KeyType& key);
     Builder& set_passed(const SampleName& sample);
     Builder& set_filter(const SampleName& sample, std::vector<KeyType> filter);
     Builder& set_filter(const SampleName& sample, std::initializer_list<KeyType> filter);
     Builder& add_filter(const SampleName& sample, KeyType filter);
-    Builder& clear_filter(const SampleName& sample) noexcept;
-    Builder& clear_all_sample_filters() noexcept;
+    Builder& clear_filter(const SampleName& sample);
+    Builder& clear_all_sample_filters();
     
     Builder& set_somatic();
     Builder& set_denovo();
@@ -270,7 +299,11 @@ private:
     decltype(VcfRecord::info_) info_ = {};
     decltype(VcfRecord::format_) format_ = {};
     decltype(VcfRecord::samples_) samples_ = {};
+    decltype(VcfRecord::lazy_format_) lazy_format_ = {};
+    decltype(VcfRecord::lazy_samples_) lazy_samples_ = {};
     boost::optional<GenomicRegion::Position> end_;
+    
+    void decode_format(const KeyType& key);
 };
 
 template <typename String1, typename String2, typename Sequence1, typename Sequence2,
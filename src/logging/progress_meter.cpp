@@ -9,6 +9,7 @@
 #include <cmath>
 #include <utility>
 #include <initializer_list>
+#include <unordered_map>
 #include <cassert>
 
 #include "utils/mappable_algorithms.hpp"
@@ -59,6 +60,13 @@ unsigned calculate_position_tab_length(const T& region)
     return std::max(18u, max_position_str_length(region));
 }
 
+std::atomic<std::size_t> num_progress_meters {0};
+
+std::size_t num_worker_slots()
+{
+    return 2 * std::max(std::thread::hardware_concurrency(), 1u);
+}
+
 } // namespace
 
 ProgressMeter::ProgressMeter(InputRegionMap regions)
@@ -75,6 +83,12 @@ ProgressMeter::ProgressMeter(InputRegionMap regions)
 , position_tab_length_ {}
 , block_compute_times_ {}
 , log_ {}
+, id_ {num_progress_meters++}
+, worker_slots_ {}
+, num_registered_workers_ {0}
+, reporter_ {}
+, stop_reporter_ {false}
+, is_reporting_ {false}
 {
     for (auto& p : target_regions_) {
         auto covered_regions = extract_covered_regions(p.second);
@@ -87,6 +101,8 @@ ProgressMeter::ProgressMeter(InputRegionMap regions)
     if (!target_regions_.empty()) {
         position_tab_length_ = calculate_position_tab_length(target_regions_);
     }
+    worker_slots_.resize(num_worker_slots());
+    for (auto& slot : worker_slots_) slot = std::make_unique<WorkerSlot>();
 }
 
 ProgressMeter::ProgressMeter(GenomicRegion region)
@@ -94,7 +110,14 @@ ProgressMeter::ProgressMeter(GenomicRegion region)
 {}
 
 ProgressMeter::ProgressMeter(ProgressMeter&& other)
-{
+: id_ {}
+, worker_slots_ {}
+, num_registered_workers_ {0}
+, reporter_ {}
+, stop_reporter_ {false}
+, is_reporting_ {false}
+{
+    assert(!other.reporter_.joinable());
     std::lock_guard<std::mutex> lock {other.mutex_};
     using std::move;
     target_regions_       = move(other.target_regions_);
@@ -112,11 +135,17 @@ ProgressMeter::ProgressMeter(ProgressMeter&& other)
     position_tab_length_  = move(other.position_tab_length_);
     block_compute_times_  = move(other.block_compute_times_);
     log_                  = move(other.log_);
+    id_                   = move(other.id_);
+    worker_slots_         = move(other.worker_slots_);
+    num_registered_workers_ = other.num_registered_workers_.load();
+    report_interval_      = move(other.report_interval_);
+    other.id_ = num_progress_meters++;
 }
 
 ProgressMeter& ProgressMeter::operator=(ProgressMeter&& other)
 {
     if (this != &other) {
+        assert(!reporter_.joinable() && !other.reporter_.joinable());
         std::unique_lock<std::mutex> lock_lhs {mutex_, std::defer_lock}, lock_rhs {other.mutex_, std::defer_lock};
         std::lock(lock_lhs, lock_rhs);
         using std::move;
@@ -135,6 +164,11 @@ ProgressMeter& ProgressMeter::operator=(ProgressMeter&& other)
         position_tab_length_  = move(other.position_tab_length_);
         block_compute_times_  = move(other.block_compute_times_);
         log_                  = move(other.log_);
+        id_                   = move(other.id_);
+        worker_slots_         = move(other.worker_slots_);
+        num_registered_workers_ = other.num_registered_workers_.load();
+        report_interval_      = move(other.report_interval_);
+        other.id_ = num_progress_meters++;
     }
     return *this;
 }
@@ -224,6 +258,8 @@ auto estimate_ttc(const std::chrono::system_clock::time_point now,
 
 ProgressMeter::~ProgressMeter()
 {
+    stop_reporter();
+    flush();
     if (!done_ && !target_regions_.empty() && num_bp_completed_ > 0) {
         const TimeInterval duration {start_, std::chrono::system_clock::now()};
         const auto time_taken = to_string(duration);
@@ -236,6 +272,7 @@ ProgressMeter::~ProgressMeter()
 
 void ProgressMeter::set_max_tick_size(double percent)
 {
+    std::lock_guard<std::mutex> lock {mutex_};
     block_compute_times_.clear(); // TODO: can we use old block times to estimate new block times?
     max_tick_size_ = percent;
     percent_until_tick_  = std::min(percent, percent_until_tick_);
@@ -244,12 +281,16 @@ void ProgressMeter::set_max_tick_size(double percent)
 
 void ProgressMeter::start()
 {
-    if (!target_regions_.empty()) {
-        completed_regions_.reserve(target_regions_.size());
-        write_header();
+    {
+        std::lock_guard<std::mutex> lock {mutex_};
+        if (!target_regions_.empty()) {
+            completed_regions_.reserve(target_regions_.size());
+            write_header();
+        }
+        start_ = std::chrono::system_clock::now();
+        last_tick_ = start_;
     }
-    start_ = std::chrono::system_clock::now();
-    last_tick_ = start_;
+    if (!target_regions_.empty()) start_reporter();
 }
 
 void ProgressMeter::resume()
@@ -264,6 +305,10 @@ void ProgressMeter::pause()
 
 void ProgressMeter::stop()
 {
+    stop_reporter();
+    flush();
+    std::lock_guard<std::mutex> lock {mutex_};
+    log_worker_throughputs();
     if (!done_ && !target_regions_.empty()) {
         const TimeInterval duration {start_, std::chrono::system_clock::now()};
         const auto time_taken = to_string(duration);
@@ -278,6 +323,8 @@ void ProgressMeter::stop()
 void ProgressMeter::reset()
 {
     if (!done_) stop();
+    std::lock_guard<std::mutex> lock {mutex_};
+    reset_worker_slots();
     completed_regions_.clear();
     num_bp_to_search_ = sum_region_sizes(target_regions_);
     num_bp_completed_ = 0;
@@ -296,12 +343,19 @@ void ProgressMeter::reset()
 
 void ProgressMeter::log_completed(const GenomicRegion& region)
 {
-    std::lock_guard<std::mutex> lock {mutex_};
-    const auto new_bp_processed = merge(region);
-    const auto new_percent_done = percent_completed(new_bp_processed, num_bp_to_search_);
-    num_bp_completed_ += new_bp_processed;
-    percent_until_tick_ -= new_percent_done;
-    if (percent_until_tick_ <= 0) output_log(region);
+    log_completed(region, 0);
+}
+
+void ProgressMeter::log_completed(const GenomicRegion& region, const std::size_t num_reads)
+{
+    auto& slot = worker_slot();
+    {
+        std::lock_guard<std::mutex> lock {slot.mutex};
+        slot.completed_regions.push_back(region);
+    }
+    slot.num_regions.fetch_add(1, std::memory_order_relaxed);
+    slot.num_reads.fetch_add(num_reads, std::memory_order_relaxed);
+    if (!is_reporting_.load(std::memory_order_acquire)) flush();
 }
 
 void ProgressMeter::log_completed(const GenomicRegion::ContigName& contig)
@@ -313,8 +367,150 @@ void ProgressMeter::log_completed(const GenomicRegion::ContigName& contig)
     }
 }
 
+ProgressMeter::Throughput ProgressMeter::throughput() const
+{
+    std::size_t num_bases {0}, num_regions {0}, num_reads {0};
+    std::lock_guard<std::mutex> lock {mutex_};
+    for (const auto& slot : worker_slots_) {
+        num_bases   += slot->num_bases;
+        num_regions += slot->num_regions.load(std::memory_order_relaxed);
+        num_reads   += slot->num_reads.load(std::memory_order_relaxed);
+    }
+    return make_throughput(num_bases, num_regions, num_reads);
+}
+
+std::vector<ProgressMeter::Throughput> ProgressMeter::worker_throughputs() const
+{
+    std::vector<Throughput> result {};
+    std::lock_guard<std::mutex> lock {mutex_};
+    const auto num_workers = std::min(num_registered_workers_.load(), worker_slots_.size());
+    result.reserve(num_workers);
+    std::transform(std::cbegin(worker_slots_), std::next(std::cbegin(worker_slots_), num_workers), std::back_inserter(result),
+                   [this] (const auto& slot) {
+                       return make_throughput(slot->num_bases, slot->num_regions.load(std::memory_order_relaxed),
+                                              slot->num_reads.load(std::memory_order_relaxed));
+                   });
+    return result;
+}
+
 // private methods
 
+ProgressMeter::WorkerSlot& ProgressMeter::worker_slot()
+{
+    // Threads are assigned slots in the order they first log; if there are more
+    // threads than slots then some slots are shared
+    thread_local std::unordered_map<std::size_t, std::size_t> slot_indices {};
+    auto slot_itr = slot_indices.find(id_);
+    if (slot_itr == std::cend(slot_indices)) {
+        const auto slot_index = num_registered_workers_.fetch_add(1, std::memory_order_relaxed) % worker_slots_.size();
+        slot_itr = slot_indices.emplace(id_, slot_index).first;
+    }
+    return *worker_slots_[slot_itr->second];
+}
+
+void ProgressMeter::start_reporter()
+{
+    if (reporter_.joinable()) return;
+    {
+        std::lock_guard<std::mutex> lock {reporter_mutex_};
+        stop_reporter_ = false;
+    }
+    is_reporting_.store(true, std::memory_order_release);
+    reporter_ = std::thread {&ProgressMeter::report_until_stopped, this};
+}
+
+void ProgressMeter::stop_reporter()
+{
+    if (reporter_.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock {reporter_mutex_};
+            stop_reporter_ = true;
+        }
+        reporter_cv_.notify_one();
+        reporter_.join();
+    }
+    is_reporting_.store(false, std::memory_order_release);
+}
+
+void ProgressMeter::report_until_stopped()
+{
+    std::unique_lock<std::mutex> lock {reporter_mutex_};
+    while (!reporter_cv_.wait_for(lock, report_interval_, [this] () { return stop_reporter_; })) {
+        lock.unlock();
+        flush();
+        lock.lock();
+    }
+}
+
+void ProgressMeter::flush()
+{
+    std::lock_guard<std::mutex> lock {mutex_};
+    std::vector<GenomicRegion> completed_regions {};
+    for (auto& slot : worker_slots_) {
+        {
+            std::lock_guard<std::mutex> slot_lock {slot->mutex};
+            std::swap(completed_regions, slot->completed_regions);
+        }
+        for (const auto& region : completed_regions) {
+            const auto new_bp_processed = merge(region);
+            slot->num_bases += new_bp_processed;
+            update(region, new_bp_processed);
+        }
+        completed_regions.clear();
+    }
+}
+
+void ProgressMeter::reset_worker_slots()
+{
+    for (auto& slot : worker_slots_) {
+        std::lock_guard<std::mutex> slot_lock {slot->mutex};
+        slot->completed_regions.clear();
+        slot->num_regions = 0;
+        slot->num_reads = 0;
+        slot->num_bases = 0;
+    }
+}
+
+ProgressMeter::Throughput
+ProgressMeter::make_throughput(const std::size_t num_bases, const std::size_t num_regions, const std::size_t num_reads) const
+{
+    Throughput result {};
+    result.num_bases   = num_bases;
+    result.num_regions = num_regions;
+    result.num_reads   = num_reads;
+    const std::chrono::duration<double> duration {std::chrono::system_clock::now() - start_};
+    if (duration.count() > 0) {
+        result.bases_per_second   = num_bases / duration.count();
+        result.regions_per_second = num_regions / duration.count();
+        result.reads_per_second   = num_reads / duration.count();
+    }
+    return result;
+}
+
+void ProgressMeter::log_worker_throughputs() const
+{
+    auto debug_log = logging::get_debug_log();
+    if (debug_log) {
+        const auto num_workers = std::min(num_registered_workers_.load(), worker_slots_.size());
+        for (std::size_t i {0}; i < num_workers; ++i) {
+            const auto& slot = *worker_slots_[i];
+            const auto throughput = make_throughput(slot.num_bases, slot.num_regions, slot.num_reads);
+            stream(*debug_log) << "Progress worker " << i << " completed " << throughput.num_bases << "bp ("
+                               << throughput.bases_per_second << "bp/s) in " << throughput.num_regions << " regions ("
+                               << throughput.regions_per_second << "/s) using " << throughput.num_reads << " reads ("
+                               << throughput.reads_per_second << "/s)";
+        }
+    }
+}
+
+void ProgressMeter::update(const GenomicRegion& region, const RegionSizeType new_bp_processed)
+{
+    const auto new_percent_done = percent_completed(new_bp_processed, num_bp_to_search_);
+    num_bp_completed_ += new_bp_processed;
+    percent_until_tick_ -= new_percent_done;
+    if (percent_until_tick_ <= 0) output_log(region);
+}
+
 ProgressMeter::RegionSizeType ProgressMeter::merge(const GenomicRegion& region)
 {
     RegionSizeType result {0};
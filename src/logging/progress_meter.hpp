@@ -8,7 +8,12 @@
 #include <cstddef>
 #include <chrono>
 #include <deque>
+#include <vector>
+#include <memory>
 #include <mutex>
+#include <atomic>
+#include <thread>
+#include <condition_variable>
 
 #include "config/common.hpp"
 #include "basics/contig_region.hpp"
@@ -18,9 +23,20 @@
 
 namespace octopus {
 
+/*
+    Workers log completed regions into their own slot, so logging never waits on region merging
+    or output formatting. A reporting thread, started by start(), periodically merges the slots
+    and writes progress. If the meter is not started, regions are merged by the logging thread.
+ */
 class ProgressMeter
 {
 public:
+    struct Throughput
+    {
+        std::size_t num_bases = 0, num_regions = 0, num_reads = 0;
+        double bases_per_second = 0, regions_per_second = 0, reads_per_second = 0;
+    };
+    
     ProgressMeter() = delete;
     
     ProgressMeter(InputRegionMap regions);
@@ -42,13 +58,25 @@ public:
     void reset();
     
     void log_completed(const GenomicRegion& region);
+    void log_completed(const GenomicRegion& region, std::size_t num_reads);
     void log_completed(const GenomicRegion::ContigName& contig);
     
+    Throughput throughput() const;
+    std::vector<Throughput> worker_throughputs() const;
+    
 private:
     using RegionSizeType = ContigRegion::Position;
     using ContigRegionMap = MappableSetMap<ContigName, ContigRegion>;
     using DurationUnits = std::chrono::milliseconds;
     
+    struct WorkerSlot
+    {
+        std::mutex mutex; // only contended when the slot is drained
+        std::vector<GenomicRegion> completed_regions;
+        std::atomic<std::size_t> num_regions {0}, num_reads {0};
+        RegionSizeType num_bases = 0; // guarded by ProgressMeter::mutex_
+    };
+    
     InputRegionMap target_regions_;
     ContigRegionMap completed_regions_;
     RegionSizeType num_bp_to_search_, num_bp_completed_;
@@ -63,7 +91,26 @@ private:
     mutable std::mutex mutex_;
     logging::InfoLogger log_;
     
+    std::size_t id_;
+    std::vector<std::unique_ptr<WorkerSlot>> worker_slots_;
+    std::atomic<std::size_t> num_registered_workers_;
+    std::thread reporter_;
+    std::mutex reporter_mutex_;
+    std::condition_variable reporter_cv_;
+    bool stop_reporter_;
+    std::atomic<bool> is_reporting_;
+    DurationUnits report_interval_ = std::chrono::milliseconds {500};
+    
+    WorkerSlot& worker_slot();
+    void start_reporter();
+    void stop_reporter();
+    void report_until_stopped();
+    void flush();
+    void reset_worker_slots();
+    Throughput make_throughput(std::size_t num_bases, std::size_t num_regions, std::size_t num_reads) const;
+    void log_worker_throughputs() const;
     RegionSizeType merge(const GenomicRegion& region);
+    void update(const GenomicRegion& region, RegionSizeType new_bp_processed);
     
     void write_header();
     void output_log(const GenomicRegion& region);
@@ -0,0 +1,80 @@
+// Copyright (c) 2015-2020 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#include "read_annotations.hpp"
+
+#include <string>
+#include <utility>
+
+#include <boost/functional/hash.hpp>
+
+namespace octopus {
+
+ReadAnnotationMap::ReadAnnotationMap(const ReadMap& reads)
+: annotations_ {}
+{
+    std::size_t num_reads {0};
+    for (const auto& p : reads) num_reads += p.second.size();
+    annotations_.reserve(num_reads);
+    for (const auto& p : reads) {
+        for (const auto& read : p.second) {
+            annotate(read);
+        }
+    }
+}
+
+void ReadAnnotationMap::annotate(const AlignedRead& read)
+{
+    annotations_.emplace(std::cref(read), octopus::annotate(read));
+}
+
+bool ReadAnnotationMap::empty() const noexcept
+{
+    return annotations_.empty();
+}
+
+std::size_t ReadAnnotationMap::size() const noexcept
+{
+    return annotations_.size();
+}
+
+boost::optional<const ReadAnnotationMap::Annotation&> ReadAnnotationMap::find(const AlignedRead& read) const
+{
+    const auto itr = annotations_.find(std::cref(read));
+    if (itr == std::cend(annotations_)) return boost::none;
+    return itr->second;
+}
+
+// private methods
+
+std::size_t ReadAnnotationMap::ReadIdentityHash::operator()(const AlignedRead& read) const
+{
+    std::size_t result {std::hash<std::string>()(read.name())};
+    boost::hash_combine(result, mapped_begin(read));
+    boost::hash_combine(result, read.is_marked_first_template_segment());
+    return result;
+}
+
+bool ReadAnnotationMap::ReadIdentityEqual::operator()(const AlignedRead& lhs, const AlignedRead& rhs) const noexcept
+{
+    // The sequence size check guards against reads that are modified after annotation, e.g. by realignment
+    return lhs.mapped_region() == rhs.mapped_region()
+        && lhs.name() == rhs.name()
+        && lhs.sequence().size() == rhs.sequence().size()
+        && lhs.is_marked_first_template_segment() == rhs.is_marked_first_template_segment()
+        && lhs.is_marked_reverse_mapped() == rhs.is_marked_reverse_mapped()
+        && lhs.is_marked_secondary_alignment() == rhs.is_marked_secondary_alignment()
+        && lhs.is_marked_supplementary_alignment() == rhs.is_marked_supplementary_alignment()
+        && lhs.cigar() == rhs.cigar();
+}
+
+// non-member methods
+
+ReadAnnotationMap::Annotation annotate(const AlignedRead& read)
+{
+    ReadAnnotationMap::Annotation result {};
+    result.kmer_hashes = compute_kmer_hashes<ReadAnnotationMap::kmer_size>(read.sequence());
+    return result;
+}
+
+} // namespace octopus
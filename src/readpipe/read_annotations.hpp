@@ -0,0 +1,75 @@
+// Copyright (c) 2015-2020 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#ifndef read_annotations_hpp
+#define read_annotations_hpp
+
+#include <unordered_map>
+#include <functional>
+#include <cstddef>
+
+#include <boost/optional.hpp>
+
+#include "config/common.hpp"
+#include "basics/aligned_read.hpp"
+#include "utils/kmer_mapper.hpp"
+
+namespace octopus {
+
+/*
+    ReadAnnotationMap is a sidecar for a ReadMap holding per-read features that several calling
+    stages would otherwise recompute from the same reads, e.g. the kmer hashes used to map reads
+    to haplotypes, which are needed again for every active region a read overlaps.
+
+    Annotations are keyed by the read's identity (name, mapping and segment flags) rather than its
+    address, so copies of annotated reads (e.g. the reads copied into each active region) find the
+    original annotation. The ReadMap the annotations were made from must outlive the map.
+ */
+class ReadAnnotationMap
+{
+public:
+    static constexpr unsigned char kmer_size {6};
+    
+    struct Annotation
+    {
+        KmerPerfectHashes kmer_hashes;
+    };
+    
+    ReadAnnotationMap() = default;
+    
+    ReadAnnotationMap(const ReadMap& reads);
+    
+    ReadAnnotationMap(const ReadAnnotationMap&)            = default;
+    ReadAnnotationMap& operator=(const ReadAnnotationMap&) = default;
+    ReadAnnotationMap(ReadAnnotationMap&&)                 = default;
+    ReadAnnotationMap& operator=(ReadAnnotationMap&&)      = default;
+    
+    ~ReadAnnotationMap() = default;
+    
+    void annotate(const AlignedRead& read);
+    
+    bool empty() const noexcept;
+    std::size_t size() const noexcept;
+    
+    boost::optional<const Annotation&> find(const AlignedRead& read) const;
+    
+private:
+    using ReadRef = std::reference_wrapper<const AlignedRead>;
+    
+    struct ReadIdentityHash
+    {
+        std::size_t operator()(const AlignedRead& read) const;
+    };
+    struct ReadIdentityEqual
+    {
+        bool operator()(const AlignedRead& lhs, const AlignedRead& rhs) const noexcept;
+    };
+    
+    std::unordered_map<ReadRef, Annotation, ReadIdentityHash, ReadIdentityEqual> annotations_;
+};
+
+ReadAnnotationMap::Annotation annotate(const AlignedRead& read);
+
+} // namespace octopus
+
+#endif
@@ -0,0 +1,82 @@
+// Copyright (c) 2015-2020 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#ifndef bounded_queue_hpp
+#define bounded_queue_hpp
+
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <utility>
+
+#include <boost/optional.hpp>
+
+namespace octopus {
+
+/*
+    A FIFO queue for passing items between pipeline stages running on different threads.
+    push blocks while the queue is full and pop blocks while it's empty, so a fast producer
+    can't run arbitrarily far ahead of its consumer. Once closed, push discards items and pop
+    drains the remaining items and then returns none.
+ */
+template <typename T>
+class BoundedQueue
+{
+public:
+    BoundedQueue() = delete;
+
+    explicit BoundedQueue(std::size_t capacity) : capacity_ {capacity > 0 ? capacity : 1}, items_ {}, closed_ {false} {}
+
+    BoundedQueue(const BoundedQueue&)            = delete;
+    BoundedQueue& operator=(const BoundedQueue&) = delete;
+    BoundedQueue(BoundedQueue&&)                 = delete;
+    BoundedQueue& operator=(BoundedQueue&&)      = delete;
+
+    ~BoundedQueue() = default;
+
+    // Returns false if the queue was closed before the item could be added
+    bool push(T item)
+    {
+        std::unique_lock<std::mutex> lock {mutex_};
+        not_full_.wait(lock, [this] () { return closed_ || items_.size() < capacity_; });
+        if (closed_) return false;
+        items_.push_back(std::move(item));
+        lock.unlock();
+        not_empty_.notify_one();
+        return true;
+    }
+
+    boost::optional<T> pop()
+    {
+        std::unique_lock<std::mutex> lock {mutex_};
+        not_empty_.wait(lock, [this] () { return closed_ || !items_.empty(); });
+        if (items_.empty()) return boost::none;
+        boost::optional<T> result {std::move(items_.front())};
+        items_.pop_front();
+        lock.unlock();
+        not_full_.notify_one();
+        return result;
+    }
+
+    void close()
+    {
+        {
+            std::lock_guard<std::mutex> lock {mutex_};
+            closed_ = true;
+        }
+        not_full_.notify_all();
+        not_empty_.notify_all();
+    }
+
+private:
+    const std::size_t capacity_;
+    std::deque<T> items_;
+    bool closed_;
+    std::mutex mutex_;
+    std::condition_variable not_full_, not_empty_;
+};
+
+} // namespace octopus
+
+#endif
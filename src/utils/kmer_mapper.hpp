@@ -93,7 +93,6 @@ void populate_kmer_hash_table(const std::string& sequence, KmerHashTable& result
     for (std::size_t index {0}; index <= last_index; ++index, ++it) {
         result.first[perfect_kmer_hash<K>(it)].push_back(index);
     }
-    for (auto& bin : result.first) bin.shrink_to_fit();
     result.second = sequence.size() - K + 1;
 }
 
@@ -102,6 +101,7 @@ KmerHashTable make_kmer_hash_table(const std::string& sequence)
 {
     auto result = init_kmer_hash_table<K>();
     populate_kmer_hash_table<K>(sequence, result);
+    for (auto& bin : result.first) bin.shrink_to_fit();
     return result;
 }
 
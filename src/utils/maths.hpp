@@ -28,6 +28,7 @@
 #include <boost/math/distributions/normal.hpp>
 
 #include "fmath.hpp"
+#include "simd_maths.hpp"
 
 namespace octopus { namespace maths {
 
@@ -1129,6 +1130,44 @@ auto normalise_exp(Range& logs)
     return normalise_exp(std::begin(logs), std::end(logs));
 }
 
+template <typename Range>
+void digamma_each(Range& values)
+{
+    for (auto& v : values) v = boost::math::digamma(v);
+}
+
+// Vectorised overloads for the common contiguous double case
+
+inline double log_sum_exp(const std::vector<double>& values)
+{
+    return simd::log_sum_exp(values.data(), values.size());
+}
+
+inline void log_each(std::vector<double>& values)
+{
+    simd::log(values.data(), values.size(), values.data());
+}
+
+inline void exp_each(std::vector<double>& values)
+{
+    simd::exp(values.data(), values.size(), values.data());
+}
+
+inline void digamma_each(std::vector<double>& values)
+{
+    simd::digamma(values.data(), values.size(), values.data());
+}
+
+inline double normalise_logs(std::vector<double>& logs)
+{
+    return simd::normalise_logs(logs.data(), logs.size());
+}
+
+inline double normalise_exp(std::vector<double>& logs)
+{
+    return simd::normalise_exp(logs.data(), logs.size());
+}
+
 } // namespace maths
 } // namespace octopus
 
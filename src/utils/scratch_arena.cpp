@@ -0,0 +1,108 @@
+// Copyright (c) 2015-2020 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#include "scratch_arena.hpp"
+
+#include <algorithm>
+#include <iterator>
+#include <cstdint>
+#include <cassert>
+
+namespace octopus {
+
+namespace {
+
+std::size_t align_up(const std::size_t offset, const std::size_t alignment) noexcept
+{
+    return (offset + alignment - 1) / alignment * alignment;
+}
+
+} // namespace
+
+ScratchArena::ScratchArena(const std::size_t block_size)
+: blocks_ {}
+, block_size_ {std::max(block_size, std::size_t {1})}
+, current_block_ {0}
+, current_offset_ {0}
+, bytes_in_use_ {0}
+, peak_bytes_in_use_ {0}
+{}
+
+void* ScratchArena::allocate(const std::size_t bytes, const std::size_t alignment)
+{
+    assert(alignment > 0 && (alignment & (alignment - 1)) == 0);
+    if (current_block_ < blocks_.size()) {
+        const auto offset = align_up(current_offset_, alignment);
+        if (offset + bytes <= blocks_[current_block_].size) {
+            bytes_in_use_ += offset + bytes - current_offset_;
+            peak_bytes_in_use_ = std::max(peak_bytes_in_use_, bytes_in_use_);
+            current_offset_ = offset + bytes;
+            return blocks_[current_block_].data.get() + offset;
+        }
+        // The rest of this block is left unused until the arena is rewound past it
+        bytes_in_use_ += blocks_[current_block_].size - current_offset_;
+        ++current_block_;
+    }
+    // Block data is allocated with new, so is aligned for any fundamental type
+    const auto min_block_size = bytes + (alignment > alignof(std::max_align_t) ? alignment : 0);
+    if (current_block_ == blocks_.size() || blocks_[current_block_].size < min_block_size) {
+        const auto size = std::max(block_size_, min_block_size);
+        blocks_.insert(std::next(std::begin(blocks_), current_block_), Block {std::make_unique<char[]>(size), size});
+    }
+    auto& block = blocks_[current_block_];
+    const auto base = reinterpret_cast<std::uintptr_t>(block.data.get());
+    const auto offset = align_up(base, alignment) - base;
+    bytes_in_use_ += offset + bytes;
+    peak_bytes_in_use_ = std::max(peak_bytes_in_use_, bytes_in_use_);
+    current_offset_ = offset + bytes;
+    return block.data.get() + offset;
+}
+
+std::size_t ScratchArena::bytes_in_use() const noexcept
+{
+    return bytes_in_use_;
+}
+
+std::size_t ScratchArena::peak_bytes_in_use() const noexcept
+{
+    return peak_bytes_in_use_;
+}
+
+std::size_t ScratchArena::capacity() const noexcept
+{
+    std::size_t result {0};
+    for (const auto& block : blocks_) result += block.size;
+    return result;
+}
+
+ScratchArena::Scope::Scope(ScratchArena& arena) noexcept
+: arena_ {arena}
+, block_ {arena.current_block_}
+, offset_ {arena.current_offset_}
+, bytes_in_use_ {arena.bytes_in_use_}
+, peak_bytes_in_use_ {arena.peak_bytes_in_use_}
+{
+    arena_.peak_bytes_in_use_ = arena_.bytes_in_use_;
+}
+
+ScratchArena::Scope::~Scope()
+{
+    assert(arena_.current_block_ >= block_);
+    arena_.current_block_ = block_;
+    arena_.current_offset_ = offset_;
+    arena_.bytes_in_use_ = bytes_in_use_;
+    arena_.peak_bytes_in_use_ = std::max(peak_bytes_in_use_, arena_.peak_bytes_in_use_);
+}
+
+std::size_t ScratchArena::Scope::peak_bytes_in_use() const noexcept
+{
+    return arena_.peak_bytes_in_use_ - bytes_in_use_;
+}
+
+ScratchArena& thread_scratch_arena()
+{
+    thread_local ScratchArena result {};
+    return result;
+}
+
+} // namespace octopus
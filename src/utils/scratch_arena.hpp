@@ -0,0 +1,109 @@
+// Copyright (c) 2015-2020 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#ifndef scratch_arena_hpp
+#define scratch_arena_hpp
+
+#include <cstddef>
+#include <vector>
+#include <memory>
+
+namespace octopus {
+
+/*
+    A ScratchArena is a monotonic allocator for short-lived buffers on the calling hot path.
+    Allocating bumps a pointer in the current block and deallocating does nothing. Memory is
+    only reclaimed when a Scope closes, which rewinds the arena to where it was when the Scope
+    was opened. Blocks are kept after rewinding, so once the arena has grown to fit a typical
+    calling window later windows don't go to the system allocator at all.
+
+    Arenas aren't thread safe; use thread_scratch_arena to get the calling thread's arena.
+ */
+class ScratchArena
+{
+public:
+    class Scope;
+
+    ScratchArena(std::size_t block_size = 1 << 20);
+
+    ScratchArena(const ScratchArena&)            = delete;
+    ScratchArena& operator=(const ScratchArena&) = delete;
+    ScratchArena(ScratchArena&&)                 = delete;
+    ScratchArena& operator=(ScratchArena&&)      = delete;
+
+    ~ScratchArena() = default;
+
+    void* allocate(std::size_t bytes, std::size_t alignment = alignof(std::max_align_t));
+    void deallocate(void* p, std::size_t bytes) noexcept {}
+
+    std::size_t bytes_in_use() const noexcept;
+    std::size_t peak_bytes_in_use() const noexcept;
+    std::size_t capacity() const noexcept;
+
+private:
+    struct Block
+    {
+        std::unique_ptr<char[]> data;
+        std::size_t size;
+    };
+
+    std::vector<Block> blocks_;
+    std::size_t block_size_, current_block_, current_offset_;
+    std::size_t bytes_in_use_, peak_bytes_in_use_;
+};
+
+// Everything allocated while a Scope is open is released when it closes. Scopes must nest.
+class ScratchArena::Scope
+{
+public:
+    Scope() = delete;
+
+    Scope(ScratchArena& arena) noexcept;
+
+    Scope(const Scope&)            = delete;
+    Scope& operator=(const Scope&) = delete;
+    Scope(Scope&&)                 = delete;
+    Scope& operator=(Scope&&)      = delete;
+
+    ~Scope();
+
+    // The most bytes in use at once since the Scope was opened
+    std::size_t peak_bytes_in_use() const noexcept;
+
+private:
+    ScratchArena& arena_;
+    std::size_t block_, offset_, bytes_in_use_, peak_bytes_in_use_;
+};
+
+template <typename T>
+class ScratchAllocator
+{
+public:
+    using value_type = T;
+
+    ScratchAllocator(ScratchArena& arena) noexcept : arena_ {&arena} {}
+    template <typename U>
+    ScratchAllocator(const ScratchAllocator<U>& other) noexcept : arena_ {other.arena_} {}
+
+    T* allocate(std::size_t n) { return static_cast<T*>(arena_->allocate(n * sizeof(T), alignof(T))); }
+    void deallocate(T* p, std::size_t n) noexcept { arena_->deallocate(p, n * sizeof(T)); }
+
+    template <typename U>
+    bool operator==(const ScratchAllocator<U>& other) const noexcept { return arena_ == other.arena_; }
+    template <typename U>
+    bool operator!=(const ScratchAllocator<U>& other) const noexcept { return arena_ != other.arena_; }
+
+private:
+    ScratchArena* arena_;
+
+    template <typename U> friend class ScratchAllocator;
+};
+
+template <typename T>
+using ScratchVector = std::vector<T, ScratchAllocator<T>>;
+
+ScratchArena& thread_scratch_arena();
+
+} // namespace octopus
+
+#endif
@@ -8,6 +8,8 @@
 #include <algorithm>
 #include <iterator>
 #include <queue>
+#include <numeric>
+#include <functional>
 #include <cstddef>
 #include <cmath>
 #include <utility>
@@ -71,6 +73,38 @@ select_top_k_indices(const std::vector<T>& values, const std::size_t k,
     }
 }
 
+// Selects the indices of the k greatest exact(i), in descending order, where upper_bounds[i] >= exact(i).
+// Indices are evaluated in descending order of bound, stopping as soon as no remaining bound can
+// beat the k-th greatest exact value found so far, so the result is the same as evaluating every index.
+template <typename T, typename ExactFunction>
+std::vector<Index>
+select_top_k_indices_with_upper_bounds(const std::vector<T>& upper_bounds, const std::size_t k, ExactFunction&& exact)
+{
+    if (k == 0) return {};
+    std::vector<Index> order(upper_bounds.size());
+    std::iota(std::begin(order), std::end(order), 0);
+    std::sort(std::begin(order), std::end(order), [&] (Index lhs, Index rhs) { return upper_bounds[lhs] > upper_bounds[rhs]; });
+    using ValueIndexPair = std::pair<T, Index>;
+    std::vector<ValueIndexPair> heap_storage {};
+    heap_storage.reserve(std::min(k, order.size()));
+    std::priority_queue<ValueIndexPair, decltype(heap_storage), std::greater<>> min_heap {std::greater<> {}, std::move(heap_storage)};
+    for (const auto idx : order) {
+        if (min_heap.size() == k && upper_bounds[idx] < min_heap.top().first) break;
+        const T value = exact(idx);
+        if (min_heap.size() < k) {
+            min_heap.emplace(value, idx);
+        } else if (value > min_heap.top().first) {
+            min_heap.pop();
+            min_heap.emplace(value, idx);
+        }
+    }
+    std::vector<Index> result(min_heap.size());
+    for (auto itr = std::rbegin(result); !min_heap.empty(); ++itr, min_heap.pop()) {
+        *itr = min_heap.top().second;
+    }
+    return result;
+}
+
 namespace detail {
 
 template <typename T>
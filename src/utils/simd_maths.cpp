@@ -0,0 +1,563 @@
+// Copyright (c) 2015-2020 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#include "simd_maths.hpp"
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <numeric>
+#include <limits>
+#include <cassert>
+
+#include <boost/math/special_functions/digamma.hpp>
+
+#include "system.hpp"
+
+#if (defined(__AVX2__) && AVX2_AVAILABLE) || (defined(__AVX512F__) && AVX512_AVAILABLE)
+#include <immintrin.h>
+#endif
+
+#if __GNUC__ >= 6
+#pragma GCC diagnostic ignored "-Wignored-attributes"
+#endif
+#if defined(__AVX512F__) && AVX512_AVAILABLE && !defined(__clang__)
+// GCC warns on the _mm512_undefined_pd passthrough operand used inside the AVX-512 intrinsics
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+
+namespace octopus { namespace maths { namespace simd {
+
+namespace {
+
+namespace scalar {
+
+double sum(const double* first, const std::size_t n) noexcept
+{
+    return std::accumulate(first, first + n, 0.0);
+}
+
+double max(const double* first, const std::size_t n) noexcept
+{
+    assert(n > 0);
+    return *std::max_element(first, first + n);
+}
+
+void exp(const double* first, const std::size_t n, double* result) noexcept
+{
+    std::transform(first, first + n, result, [] (double x) noexcept { return std::exp(x); });
+}
+
+void log(const double* first, const std::size_t n, double* result) noexcept
+{
+    std::transform(first, first + n, result, [] (double x) noexcept { return std::log(x); });
+}
+
+void log1p(const double* first, const std::size_t n, double* result) noexcept
+{
+    std::transform(first, first + n, result, [] (double x) noexcept { return std::log1p(x); });
+}
+
+// Tests the exponent bits, as -ffast-math lets the compiler assume std::isfinite is always true
+bool is_finite(const double x) noexcept
+{
+    std::uint64_t bits;
+    std::memcpy(&bits, &x, sizeof(bits));
+    return (bits & 0x7FF0000000000000ull) != 0x7FF0000000000000ull;
+}
+
+// NaN for non-finite x and at the poles x = 0, -1, -2, ..., and +/-infinity on overflow near a pole
+double digamma(const double x) noexcept
+{
+    namespace bmp = boost::math::policies;
+    using policy = bmp::policy<bmp::domain_error<bmp::ignore_error>, bmp::pole_error<bmp::ignore_error>,
+                               bmp::overflow_error<bmp::ignore_error>, bmp::evaluation_error<bmp::ignore_error>>;
+    if (!is_finite(x) || (x <= 0 && std::floor(x) == x)) return std::numeric_limits<double>::quiet_NaN();
+    return boost::math::digamma(x, policy {});
+}
+
+void digamma(const double* first, const std::size_t n, double* result) noexcept
+{
+    std::transform(first, first + n, result, [] (double x) noexcept { return digamma(x); });
+}
+
+} // namespace scalar
+
+// Constants for the Cephes exp and log approximations
+
+constexpr double log2e {1.4426950408889634073599};
+constexpr double expC1 {6.93145751953125E-1}, expC2 {1.42860682030941723212E-6};
+constexpr double expP0 {1.26177193074810590878E-4}, expP1 {3.02994407707441961300E-2}, expP2 {9.99999999999999999910E-1};
+constexpr double expQ0 {3.00198505138664455042E-6}, expQ1 {2.52448340349684104192E-3},
+                 expQ2 {2.27265548208155028766E-1}, expQ3 {2.00000000000000000009E0};
+constexpr double minExpArg {-745.13}, maxExpArg {709.782712893384}; // log(DBL_MAX)
+
+constexpr double logP0 {1.01875663804580931796E-4}, logP1 {4.97494994976747001425E-1}, logP2 {4.70579119878881725854E0},
+                 logP3 {1.44989225341610930846E1}, logP4 {1.79368678507819816313E1}, logP5 {7.70838733755885391666E0};
+constexpr double logQ0 {1.12873587189167450590E1}, logQ1 {4.52279145837532221105E1}, logQ2 {8.29875266912776603211E1},
+                 logQ3 {7.11544750618563894466E1}, logQ4 {2.31251620126765340583E1};
+constexpr double logC1 {0.693359375}, logC2 {-2.121944400546905827679e-4};
+constexpr double sqrtHalf {0.70710678118654752440}, sqrtTwo {1.41421356237309504880};
+
+constexpr double digammaAsymptoticThreshold {10.0};
+
+// Each instruction set provides the same primitive operations, from which the kernels are built.
+
+#if defined(__AVX2__) && AVX2_AVAILABLE
+
+struct AVX2Ops
+{
+    using Vector = __m256d;
+    using Mask   = __m256d;
+    static constexpr std::size_t width {4};
+
+    static Vector load(const double* p) noexcept { return _mm256_loadu_pd(p); }
+    static void store(double* p, const Vector x) noexcept { _mm256_storeu_pd(p, x); }
+    static Vector set1(const double x) noexcept { return _mm256_set1_pd(x); }
+    static Vector add(const Vector a, const Vector b) noexcept { return _mm256_add_pd(a, b); }
+    static Vector sub(const Vector a, const Vector b) noexcept { return _mm256_sub_pd(a, b); }
+    static Vector mul(const Vector a, const Vector b) noexcept { return _mm256_mul_pd(a, b); }
+    static Vector div(const Vector a, const Vector b) noexcept { return _mm256_div_pd(a, b); }
+    static Vector min(const Vector a, const Vector b) noexcept { return _mm256_min_pd(a, b); }
+    static Vector max(const Vector a, const Vector b) noexcept { return _mm256_max_pd(a, b); }
+    static Vector round(const Vector x) noexcept { return _mm256_round_pd(x, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+    static Mask less(const Vector a, const Vector b) noexcept { return _mm256_cmp_pd(a, b, _CMP_LT_OQ); }
+    static Mask less_equal(const Vector a, const Vector b) noexcept { return _mm256_cmp_pd(a, b, _CMP_LE_OQ); }
+    static Mask equal(const Vector a, const Vector b) noexcept { return _mm256_cmp_pd(a, b, _CMP_EQ_OQ); }
+    static Mask is_nan(const Vector x) noexcept { return _mm256_cmp_pd(x, x, _CMP_UNORD_Q); }
+    static Mask mask_and(const Mask a, const Mask b) noexcept { return _mm256_and_pd(a, b); }
+    static Mask mask_or(const Mask a, const Mask b) noexcept { return _mm256_or_pd(a, b); }
+    static bool any(const Mask m) noexcept { return _mm256_movemask_pd(m) != 0; }
+    static Vector select(const Mask m, const Vector if_true, const Vector if_false) noexcept
+    {
+        return _mm256_blendv_pd(if_false, if_true, m);
+    }
+    static double reduce_add(const Vector x) noexcept
+    {
+        const auto lo = _mm256_castpd256_pd128(x), hi = _mm256_extractf128_pd(x, 1);
+        const auto pair = _mm_add_pd(lo, hi);
+        return _mm_cvtsd_f64(_mm_add_sd(pair, _mm_unpackhi_pd(pair, pair)));
+    }
+    static double reduce_max(const Vector x) noexcept
+    {
+        const auto lo = _mm256_castpd256_pd128(x), hi = _mm256_extractf128_pd(x, 1);
+        const auto pair = _mm_max_pd(lo, hi);
+        return _mm_cvtsd_f64(_mm_max_sd(pair, _mm_unpackhi_pd(pair, pair)));
+    }
+    // 2^n for integral n in [-1022, 1023]
+    static Vector pow2n(const Vector n) noexcept
+    {
+        const auto magic = _mm256_set1_pd(4503599627370496.0); // 2^52
+        const auto biased = _mm256_castpd_si256(_mm256_add_pd(_mm256_add_pd(n, _mm256_set1_pd(1023.0)), magic));
+        const auto exponent = _mm256_sub_epi64(biased, _mm256_castpd_si256(magic));
+        return _mm256_castsi256_pd(_mm256_slli_epi64(exponent, 52));
+    }
+    // x = mantissa * 2^exponent, mantissa in [0.5, 1), for positive normal finite x
+    static void frexp(const Vector x, Vector& mantissa, Vector& exponent) noexcept
+    {
+        const auto bits = _mm256_castpd_si256(x);
+        const auto magic = _mm256_set1_pd(4503599627370496.0); // 2^52
+        const auto biased = _mm256_or_si256(_mm256_srli_epi64(bits, 52), _mm256_castpd_si256(magic));
+        exponent = _mm256_sub_pd(_mm256_sub_pd(_mm256_castsi256_pd(biased), magic), _mm256_set1_pd(1022.0));
+        const auto fraction = _mm256_and_si256(bits, _mm256_set1_epi64x(0x000FFFFFFFFFFFFFll));
+        mantissa = _mm256_castsi256_pd(_mm256_or_si256(fraction, _mm256_set1_epi64x(0x3FE0000000000000ll)));
+    }
+};
+
+#endif // defined(__AVX2__) && AVX2_AVAILABLE
+
+#if defined(__AVX512F__) && AVX512_AVAILABLE
+
+struct AVX512Ops
+{
+    using Vector = __m512d;
+    using Mask   = __mmask8;
+    static constexpr std::size_t width {8};
+
+    static Vector load(const double* p) noexcept { return _mm512_loadu_pd(p); }
+    static void store(double* p, const Vector x) noexcept { _mm512_storeu_pd(p, x); }
+    static Vector set1(const double x) noexcept { return _mm512_set1_pd(x); }
+    static Vector add(const Vector a, const Vector b) noexcept { return _mm512_add_pd(a, b); }
+    static Vector sub(const Vector a, const Vector b) noexcept { return _mm512_sub_pd(a, b); }
+    static Vector mul(const Vector a, const Vector b) noexcept { return _mm512_mul_pd(a, b); }
+    static Vector div(const Vector a, const Vector b) noexcept { return _mm512_div_pd(a, b); }
+    static Vector min(const Vector a, const Vector b) noexcept { return _mm512_min_pd(a, b); }
+    static Vector max(const Vector a, const Vector b) noexcept { return _mm512_max_pd(a, b); }
+    static Vector round(const Vector x) noexcept { return _mm512_roundscale_pd(x, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+    static Mask less(const Vector a, const Vector b) noexcept { return _mm512_cmp_pd_mask(a, b, _CMP_LT_OQ); }
+    static Mask less_equal(const Vector a, const Vector b) noexcept { return _mm512_cmp_pd_mask(a, b, _CMP_LE_OQ); }
+    static Mask equal(const Vector a, const Vector b) noexcept { return _mm512_cmp_pd_mask(a, b, _CMP_EQ_OQ); }
+    static Mask is_nan(const Vector x) noexcept { return _mm512_cmp_pd_mask(x, x, _CMP_UNORD_Q); }
+    static Mask mask_and(const Mask a, const Mask b) noexcept { return a & b; }
+    static Mask mask_or(const Mask a, const Mask b) noexcept { return a | b; }
+    static bool any(const Mask m) noexcept { return m != 0; }
+    static Vector select(const Mask m, const Vector if_true, const Vector if_false) noexcept
+    {
+        return _mm512_mask_blend_pd(m, if_false, if_true);
+    }
+    static double reduce_add(const Vector x) noexcept { return _mm512_reduce_add_pd(x); }
+    static double reduce_max(const Vector x) noexcept { return _mm512_reduce_max_pd(x); }
+    static Vector pow2n(const Vector n) noexcept
+    {
+        return _mm512_scalef_pd(_mm512_set1_pd(1.0), n);
+    }
+    static void frexp(const Vector x, Vector& mantissa, Vector& exponent) noexcept
+    {
+        // getexp gives floor(log2(x)) and getmant a mantissa in [0.5, 1)
+        exponent = _mm512_add_pd(_mm512_getexp_pd(x), _mm512_set1_pd(1.0));
+        mantissa = _mm512_getmant_pd(x, _MM_MANT_NORM_p5_1, _MM_MANT_SIGN_src);
+    }
+};
+
+#endif // defined(__AVX512F__) && AVX512_AVAILABLE
+
+constexpr double infinity {std::numeric_limits<double>::infinity()};
+constexpr double nan {std::numeric_limits<double>::quiet_NaN()};
+constexpr double minNormal {std::numeric_limits<double>::min()};
+constexpr double twoPow52 {4503599627370496.0};
+
+template <typename Ops>
+typename Ops::Vector vector_exp(typename Ops::Vector x) noexcept
+{
+    using O = Ops;
+    const auto arg = x;
+    const auto underflow = O::less(x, O::set1(minExpArg));
+    const auto overflow = O::less(O::set1(maxExpArg), x);
+    x = O::min(O::max(x, O::set1(minExpArg)), O::set1(maxExpArg));
+    const auto n = O::round(O::mul(x, O::set1(log2e)));
+    x = O::sub(x, O::mul(n, O::set1(expC1)));
+    x = O::sub(x, O::mul(n, O::set1(expC2)));
+    const auto xx = O::mul(x, x);
+    const auto px = O::mul(x, O::add(O::mul(O::add(O::mul(O::set1(expP0), xx), O::set1(expP1)), xx), O::set1(expP2)));
+    const auto qx = O::add(O::mul(O::add(O::mul(O::add(O::mul(O::set1(expQ0), xx), O::set1(expQ1)), xx), O::set1(expQ2)), xx), O::set1(expQ3));
+    x = O::div(px, O::sub(qx, px));
+    x = O::add(O::set1(1.0), O::add(x, x));
+    // Scale in two steps so results in the subnormal and near overflow ranges are representable
+    const auto n1 = O::round(O::mul(n, O::set1(0.5)));
+    x = O::mul(O::mul(x, O::pow2n(n1)), O::pow2n(O::sub(n, n1)));
+    // The clamping above maps NaN to a finite argument, so restore the special cases
+    x = O::select(underflow, O::set1(0.0), x);
+    x = O::select(overflow, O::set1(infinity), x);
+    return O::select(O::is_nan(arg), arg, x);
+}
+
+// log(1 + x) for x in [sqrt(1/2) - 1, sqrt(2) - 1], with extra exponent term e * ln(2)
+template <typename Ops>
+typename Ops::Vector log1p_reduced(const typename Ops::Vector x, const typename Ops::Vector e) noexcept
+{
+    using O = Ops;
+    const auto z = O::mul(x, x);
+    auto p = O::set1(logP0);
+    p = O::add(O::mul(p, x), O::set1(logP1));
+    p = O::add(O::mul(p, x), O::set1(logP2));
+    p = O::add(O::mul(p, x), O::set1(logP3));
+    p = O::add(O::mul(p, x), O::set1(logP4));
+    p = O::add(O::mul(p, x), O::set1(logP5));
+    auto q = O::add(x, O::set1(logQ0));
+    q = O::add(O::mul(q, x), O::set1(logQ1));
+    q = O::add(O::mul(q, x), O::set1(logQ2));
+    q = O::add(O::mul(q, x), O::set1(logQ3));
+    q = O::add(O::mul(q, x), O::set1(logQ4));
+    auto y = O::mul(x, O::div(O::mul(z, p), q));
+    y = O::add(y, O::mul(e, O::set1(logC2)));
+    y = O::sub(y, O::mul(z, O::set1(0.5)));
+    return O::add(O::add(x, y), O::mul(e, O::set1(logC1)));
+}
+
+template <typename Ops>
+typename Ops::Vector vector_log(const typename Ops::Vector x) noexcept
+{
+    using O = Ops;
+    // Subnormals are scaled into the normal range before splitting off the exponent
+    const auto subnormal = O::less(x, O::set1(minNormal));
+    typename O::Vector m, e;
+    O::frexp(O::select(subnormal, O::mul(x, O::set1(twoPow52)), x), m, e);
+    e = O::sub(e, O::select(subnormal, O::set1(52.0), O::set1(0.0)));
+    const auto small = O::less(m, O::set1(sqrtHalf));
+    e = O::sub(e, O::select(small, O::set1(1.0), O::set1(0.0)));
+    const auto r = O::add(O::sub(m, O::set1(1.0)), O::select(small, m, O::set1(0.0)));
+    auto result = log1p_reduced<Ops>(r, e);
+    result = O::select(O::equal(x, O::set1(0.0)), O::set1(-infinity), result);
+    result = O::select(O::equal(x, O::set1(infinity)), O::set1(infinity), result);
+    return O::select(O::mask_or(O::less(x, O::set1(0.0)), O::is_nan(x)), O::set1(nan), result);
+}
+
+template <typename Ops>
+typename Ops::Vector vector_log1p(const typename Ops::Vector x) noexcept
+{
+    using O = Ops;
+    const auto u = O::add(x, O::set1(1.0));
+    const auto in_range = O::mask_and(O::less_equal(O::set1(sqrtHalf), u), O::less_equal(u, O::set1(sqrtTwo)));
+    const auto reduced = log1p_reduced<Ops>(x, O::set1(0.0));
+    return O::select(in_range, reduced, vector_log<Ops>(u));
+}
+
+template <typename Ops>
+typename Ops::Vector vector_digamma(typename Ops::Vector x) noexcept
+{
+    using O = Ops;
+    // Shift x above the asymptotic threshold with psi(x) = psi(x + 1) - 1 / x
+    auto shift = O::set1(0.0);
+    const auto threshold = O::set1(digammaAsymptoticThreshold);
+    for (auto small = O::less(x, threshold); O::any(small); small = O::less(x, threshold)) {
+        shift = O::sub(shift, O::select(small, O::div(O::set1(1.0), x), O::set1(0.0)));
+        x = O::add(x, O::select(small, O::set1(1.0), O::set1(0.0)));
+    }
+    const auto inv = O::div(O::set1(1.0), x);
+    const auto inv2 = O::mul(inv, inv);
+    auto series = O::sub(O::set1(1.0 / 240), O::mul(inv2, O::set1(1.0 / 132)));
+    series = O::sub(O::set1(1.0 / 252), O::mul(inv2, series));
+    series = O::sub(O::set1(1.0 / 120), O::mul(inv2, series));
+    series = O::sub(O::set1(1.0 / 12), O::mul(inv2, series));
+    series = O::mul(inv2, series);
+    const auto result = O::sub(O::sub(vector_log<Ops>(x), O::mul(inv, O::set1(0.5))), series);
+    return O::add(result, shift);
+}
+
+template <typename Ops>
+typename Ops::Vector vector_digamma_checked(const typename Ops::Vector x) noexcept
+{
+    using O = Ops;
+    // The shift recurrence only terminates for finite positive x, so rare out of range blocks use the scalar function
+    const auto out_of_range = O::mask_or(O::mask_or(O::less_equal(x, O::set1(0.0)), O::is_nan(x)),
+                                         O::equal(x, O::set1(infinity)));
+    if (!O::any(out_of_range)) return vector_digamma<Ops>(x);
+    double values[O::width];
+    O::store(values, x);
+    for (auto& value : values) value = scalar::digamma(value);
+    return O::load(values);
+}
+
+template <typename Ops>
+double sum(const double* first, const std::size_t n) noexcept
+{
+    std::size_t i {0};
+    auto acc = Ops::set1(0.0);
+    for (; i + Ops::width <= n; i += Ops::width) {
+        acc = Ops::add(acc, Ops::load(first + i));
+    }
+    auto result = Ops::reduce_add(acc);
+    for (; i < n; ++i) result += first[i];
+    return result;
+}
+
+template <typename Ops>
+double max(const double* first, const std::size_t n) noexcept
+{
+    assert(n > 0);
+    if (n < Ops::width) return scalar::max(first, n);
+    std::size_t i {0};
+    auto acc = Ops::load(first);
+    for (i += Ops::width; i + Ops::width <= n; i += Ops::width) {
+        acc = Ops::max(acc, Ops::load(first + i));
+    }
+    auto result = Ops::reduce_max(acc);
+    for (; i < n; ++i) result = std::max(result, first[i]);
+    return result;
+}
+
+template <typename Ops, typename VectorFunction, typename ScalarFunction>
+void transform(const double* first, const std::size_t n, double* result, VectorFunction vf, ScalarFunction sf) noexcept
+{
+    std::size_t i {0};
+    for (; i + Ops::width <= n; i += Ops::width) {
+        Ops::store(result + i, vf(Ops::load(first + i)));
+    }
+    for (; i < n; ++i) result[i] = sf(first[i]);
+}
+
+template <typename Ops>
+void exp(const double* first, const std::size_t n, double* result) noexcept
+{
+    transform<Ops>(first, n, result, vector_exp<Ops>, [] (double x) noexcept { return std::exp(x); });
+}
+
+template <typename Ops>
+void log(const double* first, const std::size_t n, double* result) noexcept
+{
+    transform<Ops>(first, n, result, vector_log<Ops>, [] (double x) noexcept { return std::log(x); });
+}
+
+template <typename Ops>
+void log1p(const double* first, const std::size_t n, double* result) noexcept
+{
+    transform<Ops>(first, n, result, vector_log1p<Ops>, [] (double x) noexcept { return std::log1p(x); });
+}
+
+template <typename Ops>
+void digamma(const double* first, const std::size_t n, double* result) noexcept
+{
+    transform<Ops>(first, n, result, vector_digamma_checked<Ops>, [] (double x) noexcept { return scalar::digamma(x); });
+}
+
+template <typename Ops>
+double sum_exp(const double* first, const std::size_t n, const double offset) noexcept
+{
+    std::size_t i {0};
+    const auto offsets = Ops::set1(offset);
+    auto acc = Ops::set1(0.0);
+    for (; i + Ops::width <= n; i += Ops::width) {
+        acc = Ops::add(acc, vector_exp<Ops>(Ops::sub(Ops::load(first + i), offsets)));
+    }
+    auto result = Ops::reduce_add(acc);
+    for (; i < n; ++i) result += std::exp(first[i] - offset);
+    return result;
+}
+
+template <typename Ops>
+double log_sum_exp(const double* first, const std::size_t n) noexcept
+{
+    assert(n > 0);
+    const auto max_value = max<Ops>(first, n);
+    return max_value + std::log(sum_exp<Ops>(first, n, max_value));
+}
+
+template <typename Ops>
+double normalise_logs(double* first, const std::size_t n) noexcept
+{
+    if (n == 0) return 0;
+    const auto norm = log_sum_exp<Ops>(first, n);
+    const auto norms = Ops::set1(norm);
+    transform<Ops>(first, n, first,
+                   [norms] (const typename Ops::Vector x) noexcept { return Ops::sub(x, norms); },
+                   [norm] (const double x) noexcept { return x - norm; });
+    return norm;
+}
+
+template <typename Ops>
+double normalise_exp(double* first, const std::size_t n) noexcept
+{
+    if (n == 0) return 0;
+    const auto norm = log_sum_exp<Ops>(first, n);
+    const auto norms = Ops::set1(norm);
+    transform<Ops>(first, n, first,
+                   [norms] (const typename Ops::Vector x) noexcept { return vector_exp<Ops>(Ops::sub(x, norms)); },
+                   [norm] (const double x) noexcept { return std::exp(x - norm); });
+    return norm;
+}
+
+struct Kernels
+{
+    InstructionSet instruction_set;
+    double (*sum)(const double*, std::size_t) noexcept;
+    double (*max)(const double*, std::size_t) noexcept;
+    void (*exp)(const double*, std::size_t, double*) noexcept;
+    void (*log)(const double*, std::size_t, double*) noexcept;
+    void (*log1p)(const double*, std::size_t, double*) noexcept;
+    void (*digamma)(const double*, std::size_t, double*) noexcept;
+    double (*log_sum_exp)(const double*, std::size_t) noexcept;
+    double (*normalise_logs)(double*, std::size_t) noexcept;
+    double (*normalise_exp)(double*, std::size_t) noexcept;
+};
+
+template <typename Ops>
+Kernels make_kernels(const InstructionSet instruction_set) noexcept
+{
+    return {instruction_set, sum<Ops>, max<Ops>, exp<Ops>, log<Ops>, log1p<Ops>, digamma<Ops>,
+            log_sum_exp<Ops>, normalise_logs<Ops>, normalise_exp<Ops>};
+}
+
+double scalar_log_sum_exp(const double* first, const std::size_t n) noexcept
+{
+    assert(n > 0);
+    const auto max_value = scalar::max(first, n);
+    return max_value + std::log(std::accumulate(first, first + n, 0.0,
+                                                [max_value] (double curr, double x) noexcept { return curr + std::exp(x - max_value); }));
+}
+
+double scalar_normalise_logs(double* first, const std::size_t n) noexcept
+{
+    if (n == 0) return 0;
+    const auto norm = scalar_log_sum_exp(first, n);
+    std::for_each(first, first + n, [norm] (double& x) noexcept { x -= norm; });
+    return norm;
+}
+
+double scalar_normalise_exp(double* first, const std::size_t n) noexcept
+{
+    if (n == 0) return 0;
+    const auto norm = scalar_log_sum_exp(first, n);
+    std::for_each(first, first + n, [norm] (double& x) noexcept { x = std::exp(x - norm); });
+    return norm;
+}
+
+Kernels make_scalar_kernels() noexcept
+{
+    return {InstructionSet::scalar, scalar::sum, scalar::max, scalar::exp, scalar::log, scalar::log1p, scalar::digamma,
+            scalar_log_sum_exp, scalar_normalise_logs, scalar_normalise_exp};
+}
+
+Kernels select_kernels() noexcept
+{
+#if defined(__AVX512F__) && AVX512_AVAILABLE
+    if (__builtin_cpu_supports("avx512f")) return make_kernels<AVX512Ops>(InstructionSet::avx512);
+#endif
+#if defined(__AVX2__) && AVX2_AVAILABLE
+    if (__builtin_cpu_supports("avx2")) return make_kernels<AVX2Ops>(InstructionSet::avx2);
+#endif
+    return make_scalar_kernels();
+}
+
+const Kernels& kernels() noexcept
+{
+    static const Kernels result {select_kernels()};
+    return result;
+}
+
+} // namespace
+
+InstructionSet instruction_set() noexcept
+{
+    return kernels().instruction_set;
+}
+
+double sum(const double* first, const std::size_t n) noexcept
+{
+    return kernels().sum(first, n);
+}
+
+double max(const double* first, const std::size_t n) noexcept
+{
+    return kernels().max(first, n);
+}
+
+void exp(const double* first, const std::size_t n, double* result) noexcept
+{
+    kernels().exp(first, n, result);
+}
+
+void log(const double* first, const std::size_t n, double* result) noexcept
+{
+    kernels().log(first, n, result);
+}
+
+void log1p(const double* first, const std::size_t n, double* result) noexcept
+{
+    kernels().log1p(first, n, result);
+}
+
+void digamma(const double* first, const std::size_t n, double* result) noexcept
+{
+    kernels().digamma(first, n, result);
+}
+
+double log_sum_exp(const double* first, const std::size_t n) noexcept
+{
+    return kernels().log_sum_exp(first, n);
+}
+
+double normalise_logs(double* first, const std::size_t n) noexcept
+{
+    return kernels().normalise_logs(first, n);
+}
+
+double normalise_exp(double* first, const std::size_t n) noexcept
+{
+    return kernels().normalise_exp(first, n);
+}
+
+} // namespace simd
+} // namespace maths
+} // namespace octopus
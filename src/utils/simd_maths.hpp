@@ -0,0 +1,43 @@
+// Copyright (c) 2015-2020 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#ifndef simd_maths_hpp
+#define simd_maths_hpp
+
+#include <cstddef>
+
+namespace octopus { namespace maths { namespace simd {
+
+/*
+    Range kernels for the hot transcendental functions used by the genotype models.
+
+    The widest instruction set compiled into the binary (AVX-512 or AVX2) is used if the
+    running CPU supports it, otherwise the kernels fall back to the scalar std:: functions.
+    Vectorised results agree with the scalar functions to within a few ulps. Special values
+    (zeros, infinities, NaNs, subnormals, out of domain arguments) are only tested without
+    -ffast-math, which the release build enables, so callers should not rely on them; the
+    exception is digamma, which always returns NaN for non-finite x and at the poles.
+ */
+
+enum class InstructionSet { scalar, avx2, avx512 };
+
+InstructionSet instruction_set() noexcept;
+
+double sum(const double* first, std::size_t n) noexcept;
+double max(const double* first, std::size_t n) noexcept;
+
+void exp(const double* first, std::size_t n, double* result) noexcept;
+void log(const double* first, std::size_t n, double* result) noexcept; // x > 0
+void log1p(const double* first, std::size_t n, double* result) noexcept; // x > -1
+void digamma(const double* first, std::size_t n, double* result) noexcept; // x not in {0, -1, -2, ...}
+
+double log_sum_exp(const double* first, std::size_t n) noexcept;
+// Returns the log normalisation constant
+double normalise_logs(double* first, std::size_t n) noexcept;
+double normalise_exp(double* first, std::size_t n) noexcept;
+
+} // namespace simd
+} // namespace maths
+} // namespace octopus
+
+#endif
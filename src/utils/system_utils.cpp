@@ -3,8 +3,21 @@
 
 #include "system_utils.hpp"
 
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <iterator>
+#include <cctype>
+
 #include <sys/resource.h>
 
+#ifdef __linux__
+#include <sched.h>
+#include <pthread.h>
+#endif
+
+#include <boost/filesystem.hpp>
+
 namespace octopus {
 
 std::size_t get_max_open_files()
@@ -14,4 +27,94 @@ std::size_t get_max_open_files()
     return lim.rlim_cur;
 }
 
+CpuList parse_cpu_list(const std::string& cpu_list)
+{
+    CpuList result {};
+    std::istringstream ss {cpu_list};
+    std::string range {};
+    while (std::getline(ss, range, ',')) {
+        if (range.empty()) continue;
+        try {
+            const auto dash_pos = range.find('-');
+            const auto first = std::stoul(range.substr(0, dash_pos));
+            const auto last = dash_pos == std::string::npos ? first : std::stoul(range.substr(dash_pos + 1));
+            for (auto cpu = first; cpu <= last; ++cpu) {
+                result.push_back(static_cast<unsigned>(cpu));
+            }
+        } catch (const std::logic_error&) {
+            return {};
+        }
+    }
+    std::sort(std::begin(result), std::end(result));
+    result.erase(std::unique(std::begin(result), std::end(result)), std::end(result));
+    return result;
+}
+
+namespace {
+
+#ifdef __linux__
+
+CpuList get_allowed_cpus()
+{
+    CpuList result {};
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    if (sched_getaffinity(0, sizeof(cpus), &cpus) == 0) {
+        for (unsigned cpu {0}; cpu < CPU_SETSIZE; ++cpu) {
+            if (CPU_ISSET(cpu, &cpus)) result.push_back(cpu);
+        }
+    }
+    return result;
+}
+
+#endif
+
+} // namespace
+
+std::vector<CpuList> get_numa_node_cpus()
+{
+    std::vector<CpuList> result {};
+#ifdef __linux__
+    namespace fs = boost::filesystem;
+    const fs::path node_dir {"/sys/devices/system/node"};
+    boost::system::error_code ec {};
+    if (!fs::is_directory(node_dir, ec)) return result;
+    const auto allowed_cpus = get_allowed_cpus();
+    if (allowed_cpus.empty()) return result;
+    std::vector<std::pair<unsigned, CpuList>> nodes {};
+    for (fs::directory_iterator itr {node_dir, ec}, end; !ec && itr != end; itr.increment(ec)) {
+        const auto name = itr->path().filename().string();
+        if (name.size() <= 4 || name.compare(0, 4, "node") != 0
+            || !std::all_of(std::next(std::cbegin(name), 4), std::cend(name), [] (char c) { return std::isdigit(c); })) continue;
+        std::ifstream cpu_list_file {(itr->path() / "cpulist").string()};
+        std::string cpu_list {};
+        if (!std::getline(cpu_list_file, cpu_list)) continue;
+        CpuList node_cpus {};
+        const auto cpus = parse_cpu_list(cpu_list);
+        std::set_intersection(std::cbegin(cpus), std::cend(cpus), std::cbegin(allowed_cpus), std::cend(allowed_cpus),
+                              std::back_inserter(node_cpus));
+        if (!node_cpus.empty()) nodes.emplace_back(std::stoul(name.substr(4)), std::move(node_cpus));
+    }
+    std::sort(std::begin(nodes), std::end(nodes));
+    result.reserve(nodes.size());
+    for (auto& node : nodes) result.push_back(std::move(node.second));
+#endif
+    return result;
+}
+
+bool bind_current_thread(const CpuList& cpus)
+{
+#ifdef __linux__
+    if (cpus.empty()) return false;
+    cpu_set_t cpu_set;
+    CPU_ZERO(&cpu_set);
+    for (const auto cpu : cpus) {
+        if (cpu < CPU_SETSIZE) CPU_SET(cpu, &cpu_set);
+    }
+    return pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set) == 0;
+#else
+    return false;
+#endif
+}
+
 } // namespace octopus
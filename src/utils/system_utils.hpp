@@ -5,11 +5,24 @@
 #define system_utils_hpp
 
 #include <cstddef>
+#include <vector>
+#include <string>
 
 namespace octopus {
 
 std::size_t get_max_open_files();
 
+using CpuList = std::vector<unsigned>;
+
+// Parses a kernel cpu list, e.g. "0-3,8,10-11"
+CpuList parse_cpu_list(const std::string& cpu_list);
+
+// The CPUs this process may run on, grouped by NUMA node. Empty if the topology can't be detected.
+std::vector<CpuList> get_numa_node_cpus();
+
+// Restricts the calling thread to the given CPUs. Returns false if this isn't possible.
+bool bind_current_thread(const CpuList& cpus);
+
 } // namespace octopus
 
 #endif
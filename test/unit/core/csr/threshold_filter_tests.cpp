@@ -0,0 +1,198 @@
+// Copyright (c) 2015-2020 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#include <boost/test/unit_test.hpp>
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <limits>
+#include <cmath>
+#include <cstddef>
+
+#include "core/csr/measures/measure.hpp"
+#include "core/csr/measures/measure_column.hpp"
+#include "core/csr/filters/threshold_filter.hpp"
+
+namespace octopus { namespace test {
+
+using namespace csr;
+
+namespace {
+
+class TestMeasure : public Measure
+{
+public:
+    TestMeasure(ResultCardinality cardinality) : cardinality_ {cardinality} {}
+
+private:
+    ResultCardinality cardinality_;
+
+    std::unique_ptr<Measure> do_clone() const override { return std::make_unique<TestMeasure>(*this); }
+    ValueType get_value_type() const override { return double {}; }
+    ResultType do_evaluate(const VcfRecord& call, const FacetMap& facets) const override { return ValueType {0.0}; }
+    ResultCardinality do_cardinality() const noexcept override { return cardinality_; }
+    const std::string& do_name() const override { static const std::string result {"TEST"}; return result; }
+    std::string do_describe() const override { return "Test measure"; }
+};
+
+using ValueType = Measure::ValueType;
+template <typename T> using Array = Measure::Array<T>;
+template <typename T> using Optional = Measure::Optional<T>;
+using MeasureBlock = std::vector<std::vector<Measure::ResultType>>;
+
+const double nan {std::numeric_limits<double>::quiet_NaN()};
+
+// One measure per call, with missing, NaN and mixed values
+MeasureBlock make_call_block()
+{
+    return {
+        {ValueType {1.0}},
+        {ValueType {2.0}},
+        {ValueType {3.5}},
+        {ValueType {nan}},
+        {ValueType {2}},
+        {ValueType {std::size_t {4}}},
+        {ValueType {true}},
+        {Optional<ValueType> {}},
+        {Optional<ValueType> {2.0}},
+        {Optional<ValueType> {nan}},
+        {Array<ValueType> {}},
+        {Array<ValueType> {1.0, 3.0}},
+        {Array<ValueType> {2.0, 2.0}},
+        {Array<ValueType> {1.0, nan, 3.0}},
+        {Array<ValueType> {2.0, nan}},
+        {Array<ValueType> {nan, nan}},
+        {Array<Optional<ValueType>> {Optional<ValueType> {}, ValueType {2.0}}},
+        {Array<Optional<ValueType>> {Optional<ValueType> {}, ValueType {nan}}},
+        {Optional<Array<ValueType>> {}},
+        {Optional<Array<ValueType>> {Array<ValueType> {nan, 5.0}}}
+    };
+}
+
+// One value per sample for two samples
+MeasureBlock make_sample_block()
+{
+    return {
+        {Array<ValueType> {1.0, 2.0}},
+        {Array<ValueType> {nan, 3.0}},
+        {Array<ValueType> {std::size_t {2}, std::size_t {0}}},
+        {Array<Optional<ValueType>> {Optional<ValueType> {}, ValueType {nan}}},
+        {Array<Optional<ValueType>> {ValueType {2.0}, Optional<ValueType> {}}},
+        {Optional<Array<ValueType>> {}},
+        {Optional<Array<ValueType>> {Array<ValueType> {nan, 2.0}}}
+    };
+}
+
+// Several values per sample for two samples
+MeasureBlock make_sample_allele_block()
+{
+    return {
+        {Array<Array<ValueType>> {{1.0, 3.0}, {2.0}}},
+        {Array<Array<ValueType>> {{2.0, nan}, {nan}}},
+        {Array<Array<ValueType>> {{}, {nan, 1.0, 5.0}}},
+        {Array<Array<Optional<ValueType>>> {{Optional<ValueType> {}, ValueType {2.0}}, {ValueType {nan}, Optional<ValueType> {}}}},
+        {Array<Optional<Array<ValueType>>> {Optional<Array<ValueType>> {}, Array<ValueType> {2.0, 2.0}}}
+    };
+}
+
+auto make_thresholds()
+{
+    using Wrapper = ThresholdVariantCallFilter::ThresholdWrapper;
+    std::vector<Wrapper> result {};
+    for (const double target : {-1.0, 0.0, 1.0, 2.0, 3.0, 5.0}) {
+        result.push_back(make_wrapped_threshold<EqualThreshold<>>(target));
+        result.push_back(make_wrapped_threshold<NotEqualThreshold<>>(target));
+        result.push_back(make_wrapped_threshold<LessThreshold<>>(target));
+        result.push_back(make_wrapped_threshold<LessEqualThreshold<>>(target));
+        result.push_back(make_wrapped_threshold<GreaterThreshold<>>(target));
+        result.push_back(make_wrapped_threshold<GreaterEqualThreshold<>>(target));
+    }
+    for (const int target : {0, 2}) {
+        result.push_back(make_wrapped_threshold<EqualThreshold<int>>(target));
+        result.push_back(make_wrapped_threshold<NotEqualThreshold<int>>(target));
+        result.push_back(make_wrapped_threshold<LessThreshold<int>>(target));
+        result.push_back(make_wrapped_threshold<GreaterEqualThreshold<int>>(target));
+    }
+    return result;
+}
+
+// Returns the number of thresholds evaluated on columns
+std::size_t check_column_evaluation_matches_per_call(const MeasureBlock& block, const MeasureWrapper& measure, const std::size_t num_samples)
+{
+    const auto column = make_measure_column(block, 0, measure, num_samples);
+    BOOST_REQUIRE_EQUAL(column.size(), block.size() * num_samples);
+    std::size_t result {0};
+    const auto thresholds = make_thresholds();
+    for (std::size_t threshold_idx {0}; threshold_idx < thresholds.size(); ++threshold_idx) {
+        const auto& threshold = thresholds[threshold_idx];
+        MeasureColumn::Mask passes(column.size(), 1);
+        if (!threshold.evaluate(column, passes)) continue;
+        ++result;
+        for (std::size_t call_idx {0}; call_idx < block.size(); ++call_idx) {
+            for (std::size_t sample_idx {0}; sample_idx < num_samples; ++sample_idx) {
+                BOOST_TEST_CONTEXT("threshold " << threshold_idx << " call " << call_idx << " sample " << sample_idx) {
+                    const auto expected = threshold(get_sample_value(block[call_idx][0], measure, sample_idx));
+                    BOOST_CHECK_EQUAL(static_cast<bool>(passes[call_idx * num_samples + sample_idx]), expected);
+                }
+            }
+        }
+    }
+    return result;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(core)
+BOOST_AUTO_TEST_SUITE(csr)
+BOOST_AUTO_TEST_SUITE(threshold_filter)
+
+BOOST_AUTO_TEST_CASE(column_evaluation_matches_per_call_evaluation_for_call_measures)
+{
+    const MeasureWrapper measure {std::make_unique<TestMeasure>(Measure::ResultCardinality::one)};
+    const auto num_evaluated = check_column_evaluation_matches_per_call(make_call_block(), measure, 2);
+    BOOST_CHECK_GT(num_evaluated, 0);
+}
+
+BOOST_AUTO_TEST_CASE(column_evaluation_matches_per_call_evaluation_for_sample_measures)
+{
+    const MeasureWrapper measure {std::make_unique<TestMeasure>(Measure::ResultCardinality::samples)};
+    const auto num_evaluated = check_column_evaluation_matches_per_call(make_sample_block(), measure, 2);
+    BOOST_CHECK_GT(num_evaluated, 0);
+}
+
+BOOST_AUTO_TEST_CASE(column_evaluation_matches_per_call_evaluation_for_sample_allele_measures)
+{
+    const MeasureWrapper measure {std::make_unique<TestMeasure>(Measure::ResultCardinality::samples_and_alleles)};
+    const auto num_evaluated = check_column_evaluation_matches_per_call(make_sample_allele_block(), measure, 2);
+    BOOST_CHECK_GT(num_evaluated, 0);
+}
+
+BOOST_AUTO_TEST_CASE(measure_columns_flag_nan_values_separately_from_min_and_max)
+{
+    const MeasureWrapper measure {std::make_unique<TestMeasure>(Measure::ResultCardinality::one)};
+    const MeasureBlock block {
+        {Array<ValueType> {1.0, nan, 3.0}},
+        {ValueType {nan}},
+        {ValueType {2.0}},
+        {Optional<ValueType> {}}
+    };
+    const auto column = make_measure_column(block, 0, measure, 1);
+    BOOST_REQUIRE_EQUAL(column.size(), 4);
+    BOOST_CHECK_EQUAL(column.min[0], 1.0);
+    BOOST_CHECK_EQUAL(column.max[0], 3.0);
+    BOOST_CHECK(column.has_nan[0]);
+    BOOST_CHECK(std::isnan(column.min[1]) && std::isnan(column.max[1]));
+    BOOST_CHECK(column.has_nan[1]);
+    BOOST_CHECK(!column.missing[1]);
+    BOOST_CHECK(!column.has_nan[2]);
+    BOOST_CHECK(column.missing[3]);
+    BOOST_CHECK(!column.has_nan[3]);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace test
+} // namespace octopus
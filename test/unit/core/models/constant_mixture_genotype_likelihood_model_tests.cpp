@@ -0,0 +1,94 @@
+// Copyright (c) 2015-2020 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#include <boost/test/unit_test.hpp>
+
+#include <string>
+#include <vector>
+#include <cstddef>
+
+#include "mock/mock_reference.hpp"
+
+#include "config/common.hpp"
+#include "basics/aligned_read.hpp"
+#include "basics/cigar_string.hpp"
+#include "core/types/haplotype.hpp"
+#include "core/types/indexed_haplotype.hpp"
+#include "core/types/genotype.hpp"
+#include "core/models/haplotype_likelihood_array.hpp"
+#include "core/models/genotype/constant_mixture_genotype_likelihood_model.hpp"
+
+namespace octopus { namespace test {
+
+using model::ConstantMixtureGenotypeLikelihoodModel;
+
+namespace {
+
+const GenomicRegion haplotype_region {"1", 50, 200};
+const GenomicRegion read_region {"1", 100, 140};
+const SampleName sample {"sample"};
+
+auto make_haplotype(const ReferenceGenome& reference, const std::vector<GenomicRegion::Position>& snv_positions)
+{
+    auto sequence = reference.fetch_sequence(haplotype_region);
+    for (const auto position : snv_positions) {
+        auto& base = sequence[position - haplotype_region.begin()];
+        base = base == 'A' ? 'C' : 'A';
+    }
+    return Haplotype {haplotype_region, std::move(sequence), reference};
+}
+
+// Reads cycle through the haplotypes with varying base qualities so each read has different likelihoods
+auto make_reads(const MappableBlock<Haplotype>& haplotypes, const std::size_t n)
+{
+    ReadMap result {};
+    auto& sample_reads = result[sample];
+    for (std::size_t i {0}; i < n; ++i) {
+        const auto sequence = haplotypes[i % haplotypes.size()].sequence(read_region);
+        AlignedRead::BaseQualityVector qualities(sequence.size());
+        for (std::size_t j {0}; j < qualities.size(); ++j) qualities[j] = 5 + (i + 7 * j) % 35;
+        sample_reads.emplace(std::to_string(i), read_region, sequence, std::move(qualities),
+                             parse_cigar(std::to_string(sequence.size()) + "M"), 60, AlignedRead::Flags {}, "", "");
+    }
+    return result;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(core)
+BOOST_AUTO_TEST_SUITE(models)
+BOOST_AUTO_TEST_SUITE(constant_mixture_genotype_likelihood_model)
+
+BOOST_AUTO_TEST_CASE(batched_evaluation_matches_per_genotype_evaluation_over_several_read_tiles)
+{
+    const auto reference = mock::make_reference();
+    const MappableBlock<Haplotype> haplotypes {
+        make_haplotype(reference, {}), make_haplotype(reference, {110}),
+        make_haplotype(reference, {125}), make_haplotype(reference, {110, 125})
+    };
+    // More than two 256 read tiles, with a partial last tile
+    const std::size_t num_reads {601};
+    HaplotypeLikelihoodArray likelihoods {static_cast<unsigned>(haplotypes.size()), {sample}};
+    likelihoods.populate(make_reads(haplotypes, num_reads), haplotypes);
+    likelihoods.prime(sample);
+    BOOST_REQUIRE_EQUAL(likelihoods.num_likelihoods(), num_reads);
+    const ConstantMixtureGenotypeLikelihoodModel model {likelihoods};
+    const auto indexed_haplotypes = index(haplotypes);
+    for (const unsigned ploidy : {1u, 2u, 3u, 4u, 5u}) {
+        const auto genotypes = generate_all_genotypes(indexed_haplotypes, ploidy);
+        const auto batched = model.evaluate(genotypes);
+        BOOST_REQUIRE_EQUAL(batched.size(), genotypes.size());
+        for (std::size_t i {0}; i < genotypes.size(); ++i) {
+            BOOST_TEST_CONTEXT("ploidy " << ploidy << " genotype " << i) {
+                BOOST_CHECK_CLOSE(batched[i], model.evaluate(genotypes[i]), 1e-9);
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace test
+} // namespace octopus
@@ -0,0 +1,267 @@
+// Copyright (c) 2015-2020 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#include <boost/test/unit_test.hpp>
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstddef>
+
+#include <boost/optional.hpp>
+
+#include "mock/mock_reference.hpp"
+
+#include "config/common.hpp"
+#include "basics/aligned_read.hpp"
+#include "basics/cigar_string.hpp"
+#include "core/types/haplotype.hpp"
+#include "core/models/error/indel_error_model.hpp"
+#include "core/models/error/error_model_factory.hpp"
+#include "core/models/haplotype_likelihood_model.hpp"
+#include "core/models/haplotype_likelihood_array.hpp"
+
+namespace octopus { namespace test {
+
+namespace {
+
+const GenomicRegion haplotype_region {"1", 20, 300};
+const GenomicRegion read_region {"1", 120, 160};
+const GenomicRegion::Position read_snv {140}, lhs_snv {40}, rhs_snv {280};
+const SampleName sample {"sample"};
+
+auto make_haplotype(const ReferenceGenome& reference, const std::vector<GenomicRegion::Position>& snv_positions,
+                    const GenomicRegion& region = haplotype_region)
+{
+    auto sequence = reference.fetch_sequence(region);
+    for (const auto position : snv_positions) {
+        auto& base = sequence[position - region.begin()];
+        base = base == 'A' ? 'C' : 'A';
+    }
+    return Haplotype {region, std::move(sequence), reference};
+}
+
+AlignedRead make_read(const std::string& name, const GenomicRegion& region, AlignedRead::NucleotideSequence sequence,
+                      const std::string& cigar)
+{
+    AlignedRead::BaseQualityVector qualities(sequence.size());
+    for (std::size_t i {0}; i < qualities.size(); ++i) qualities[i] = 10 + (3 * i) % 30;
+    return AlignedRead {name, region, std::move(sequence), std::move(qualities), parse_cigar(cigar), 40, AlignedRead::Flags {}, "", ""};
+}
+
+// Reads whose likelihoods depend on bases, flank state and gap penalties around read_snv
+auto make_reads(const ReferenceGenome& reference)
+{
+    const auto reference_sequence = reference.fetch_sequence(read_region);
+    const auto snv_sequence = make_haplotype(reference, {read_snv}).sequence(read_region);
+    const auto deletion_offset = read_snv - read_region.begin();
+    auto deletion_sequence = reference_sequence;
+    deletion_sequence.erase(deletion_offset, 1);
+    const GenomicRegion deletion_region {read_region.contig_name(), read_region.begin(), read_region.end() + 1};
+    deletion_sequence += reference.fetch_sequence(GenomicRegion {read_region.contig_name(), read_region.end(), read_region.end() + 1});
+    const auto deletion_cigar = std::to_string(deletion_offset) + "M1D" + std::to_string(reference_sequence.size() - deletion_offset) + "M";
+    ReadMap result {};
+    result[sample].insert(make_read("ref", read_region, reference_sequence, "40M"));
+    result[sample].insert(make_read("snv", read_region, snv_sequence, "40M"));
+    result[sample].insert(make_read("del", deletion_region, deletion_sequence, deletion_cigar));
+    return result;
+}
+
+// Gap open penalties around read_snv are lowered if the haplotype has a non-reference base at context,
+// so, as with repeat context, haplotypes that are identical near a read can still differ in penalties there
+class ContextIndelErrorModel : public IndelErrorModel
+{
+public:
+    ContextIndelErrorModel(const ReferenceGenome& reference, GenomicRegion::Position context)
+    : context_ {haplotype_region.contig_name(), context, context + 1}
+    , reference_base_ {reference.fetch_sequence(context_)}
+    {}
+
+private:
+    GenomicRegion context_;
+    AlignedRead::NucleotideSequence reference_base_;
+
+    std::unique_ptr<IndelErrorModel> do_clone() const override
+    {
+        return std::make_unique<ContextIndelErrorModel>(*this);
+    }
+    void do_set_penalties(const Haplotype& haplotype, PenaltyVector& gap_open_penalties, PenaltyType& gap_extend_penalty) const override
+    {
+        const auto has_context = haplotype.sequence(context_) != reference_base_;
+        gap_open_penalties.assign(sequence_size(haplotype), 45);
+        if (has_context) {
+            const auto snv_offset = static_cast<std::size_t>(read_snv - mapped_begin(haplotype));
+            for (auto i = snv_offset - 3; i < snv_offset + 3; ++i) gap_open_penalties[i] = 10;
+        }
+        gap_extend_penalty = 3;
+    }
+    void do_set_penalties(const Haplotype& haplotype, PenaltyVector& gap_open_penalties, PenaltyVector& gap_extend_penalties) const override
+    {
+        PenaltyType gap_extend_penalty {};
+        do_set_penalties(haplotype, gap_open_penalties, gap_extend_penalty);
+        gap_extend_penalties.assign(sequence_size(haplotype), gap_extend_penalty);
+    }
+};
+
+HaplotypeLikelihoodModel make_context_model(const ReferenceGenome& reference)
+{
+    return HaplotypeLikelihoodModel {make_snv_error_model(), std::make_unique<ContextIndelErrorModel>(reference, lhs_snv)};
+}
+
+using FlankState = HaplotypeLikelihoodArray::FlankState;
+
+// Each haplotype's likelihoods evaluated in a fresh array, so nothing can be reused
+void check_equal_to_fresh_evaluation(const HaplotypeLikelihoodArray& likelihoods, const ReadMap& reads,
+                                     const MappableBlock<Haplotype>& haplotypes, const HaplotypeLikelihoodModel& model,
+                                     boost::optional<FlankState> flank_state = boost::none)
+{
+    for (const auto& haplotype : haplotypes) {
+        HaplotypeLikelihoodArray fresh {model, 1, {sample}};
+        fresh.populate(reads, MappableBlock<Haplotype> {haplotype}, flank_state);
+        const auto& expected = fresh(sample, haplotype);
+        const auto& actual = likelihoods(sample, haplotype);
+        BOOST_REQUIRE_EQUAL(actual.size(), expected.size());
+        for (std::size_t i {0}; i < actual.size(); ++i) {
+            BOOST_CHECK_EQUAL(actual[i], expected[i]);
+        }
+    }
+}
+
+auto fingerprint(HaplotypeLikelihoodModel& model, const Haplotype& haplotype, const AlignedRead& read,
+                 const HaplotypeLikelihoodModel::MappingPositionVector& mapping_positions,
+                 boost::optional<FlankState> flank_state = boost::none)
+{
+    model.reset(haplotype, flank_state);
+    const auto result = model.window_fingerprint(read, std::cbegin(mapping_positions), std::cend(mapping_positions));
+    BOOST_REQUIRE(result);
+    return *result;
+}
+
+auto evaluate(HaplotypeLikelihoodModel& model, const Haplotype& haplotype, const AlignedRead& read,
+              const HaplotypeLikelihoodModel::MappingPositionVector& mapping_positions,
+              boost::optional<FlankState> flank_state = boost::none)
+{
+    model.reset(haplotype, flank_state);
+    return model.evaluate(read, mapping_positions);
+}
+
+auto mapping_position(const Haplotype& haplotype, const AlignedRead& read)
+{
+    return static_cast<HaplotypeLikelihoodModel::MappingPosition>(begin_distance(haplotype, read));
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(core)
+BOOST_AUTO_TEST_SUITE(models)
+BOOST_AUTO_TEST_SUITE(haplotype_likelihood_array)
+
+BOOST_AUTO_TEST_CASE(reused_likelihoods_equal_fresh_evaluation)
+{
+    const auto reference = mock::make_reference();
+    const auto reads = make_reads(reference);
+    const HaplotypeLikelihoodModel model {};
+    // Most haplotypes only differ away from the reads, so have likelihoods reused from each other
+    const MappableBlock<Haplotype> haplotypes {
+        make_haplotype(reference, {}),
+        make_haplotype(reference, {lhs_snv}),
+        make_haplotype(reference, {rhs_snv}),
+        make_haplotype(reference, {lhs_snv, rhs_snv}),
+        make_haplotype(reference, {read_snv}),
+        make_haplotype(reference, {lhs_snv, read_snv})
+    };
+    HaplotypeLikelihoodArray likelihoods {model, static_cast<unsigned>(haplotypes.size()), {sample}};
+    likelihoods.populate(reads, haplotypes);
+    check_equal_to_fresh_evaluation(likelihoods, reads, haplotypes, model);
+    // The next population reuses likelihoods from the previous one, including for haplotypes on other regions
+    const GenomicRegion next_region {haplotype_region.contig_name(), 50, 320};
+    const MappableBlock<Haplotype> next_haplotypes {
+        make_haplotype(reference, {}, next_region),
+        make_haplotype(reference, {rhs_snv}, next_region),
+        make_haplotype(reference, {read_snv, 300}, next_region)
+    };
+    likelihoods.populate(reads, next_haplotypes);
+    check_equal_to_fresh_evaluation(likelihoods, reads, next_haplotypes, model);
+}
+
+BOOST_AUTO_TEST_CASE(flank_state_inside_the_read_window_forces_fresh_evaluation)
+{
+    const auto reference = mock::make_reference();
+    const auto reads = make_reads(reference);
+    const auto model = make_context_model(reference);
+    const MappableBlock<Haplotype> haplotypes {make_haplotype(reference, {}), make_haplotype(reference, {rhs_snv})};
+    HaplotypeLikelihoodArray likelihoods {model, static_cast<unsigned>(haplotypes.size()), {sample}};
+    likelihoods.populate(reads, haplotypes);
+    const auto unflanked = likelihoods(sample, haplotypes.front());
+    // The lhs flank covers read_snv, so the snv read is not penalised for it
+    const FlankState flank_state {static_cast<ContigRegion::Position>(read_snv + 5 - haplotype_region.begin()), 10};
+    likelihoods.populate(reads, haplotypes, flank_state);
+    check_equal_to_fresh_evaluation(likelihoods, reads, haplotypes, model, flank_state);
+    BOOST_CHECK(likelihoods(sample, haplotypes.front()) != unflanked);
+}
+
+BOOST_AUTO_TEST_CASE(gap_penalties_inside_the_read_window_force_fresh_evaluation)
+{
+    const auto reference = mock::make_reference();
+    const auto reads = make_reads(reference);
+    const auto model = make_context_model(reference);
+    // The second haplotype only differs from the first away from the reads, but has lower gap open penalties near them
+    const MappableBlock<Haplotype> haplotypes {make_haplotype(reference, {}), make_haplotype(reference, {lhs_snv})};
+    HaplotypeLikelihoodArray likelihoods {model, static_cast<unsigned>(haplotypes.size()), {sample}};
+    likelihoods.populate(reads, haplotypes);
+    check_equal_to_fresh_evaluation(likelihoods, reads, haplotypes, model);
+    BOOST_CHECK(likelihoods(sample, haplotypes[0]) != likelihoods(sample, haplotypes[1]));
+}
+
+BOOST_AUTO_TEST_CASE(window_fingerprint_ignores_haplotype_differences_away_from_the_read)
+{
+    const auto reference = mock::make_reference();
+    const auto reads = make_reads(reference);
+    HaplotypeLikelihoodModel model {};
+    const auto ref = make_haplotype(reference, {});
+    const auto alt = make_haplotype(reference, {lhs_snv, rhs_snv});
+    const auto shifted = make_haplotype(reference, {}, GenomicRegion {haplotype_region.contig_name(), 60, 250});
+    for (const auto& read : reads.at(sample)) {
+        const auto position = mapping_position(ref, read);
+        const auto shifted_position = mapping_position(shifted, read);
+        const auto expected_fingerprint = fingerprint(model, ref, read, {position, position + 2});
+        const auto expected_likelihood = evaluate(model, ref, read, {position, position + 2});
+        BOOST_CHECK_EQUAL(fingerprint(model, alt, read, {position, position + 2}), expected_fingerprint);
+        BOOST_CHECK_EQUAL(evaluate(model, alt, read, {position, position + 2}), expected_likelihood);
+        BOOST_CHECK_EQUAL(fingerprint(model, shifted, read, {shifted_position, shifted_position + 2}), expected_fingerprint);
+        BOOST_CHECK_EQUAL(evaluate(model, shifted, read, {shifted_position, shifted_position + 2}), expected_likelihood);
+        // Flanks that end outside the read window look the same as no flanks to the read
+        const FlankState distant_flank_state {10, 10};
+        BOOST_CHECK_EQUAL(fingerprint(model, ref, read, {position}, distant_flank_state), fingerprint(model, ref, read, {position}));
+        BOOST_CHECK_EQUAL(evaluate(model, ref, read, {position}, distant_flank_state), evaluate(model, ref, read, {position}));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(window_fingerprint_changes_with_the_haplotype_inside_the_read_window)
+{
+    const auto reference = mock::make_reference();
+    const auto reads = make_reads(reference);
+    auto model = make_context_model(reference);
+    const auto ref = make_haplotype(reference, {});
+    const auto lowered_gap_penalties = make_haplotype(reference, {lhs_snv});
+    const auto snv = make_haplotype(reference, {read_snv});
+    const auto lhs_flank_size = static_cast<ContigRegion::Position>(read_snv - haplotype_region.begin());
+    const auto rhs_flank_size = static_cast<ContigRegion::Position>(haplotype_region.end() - read_snv);
+    for (const auto& read : reads.at(sample)) {
+        const auto position = mapping_position(ref, read);
+        const auto expected = fingerprint(model, ref, read, {position});
+        BOOST_CHECK_NE(fingerprint(model, snv, read, {position}), expected);
+        BOOST_CHECK_NE(fingerprint(model, lowered_gap_penalties, read, {position}), expected);
+        BOOST_CHECK_NE(fingerprint(model, ref, read, {position}, FlankState {lhs_flank_size, 0}), expected);
+        BOOST_CHECK_NE(fingerprint(model, ref, read, {position}, FlankState {0, rhs_flank_size}), expected);
+        BOOST_CHECK_NE(fingerprint(model, ref, read, {position, position + 3}), expected);
+        BOOST_CHECK_NE(fingerprint(model, ref, read, {position - 1}), expected);
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace test
+} // namespace octopus
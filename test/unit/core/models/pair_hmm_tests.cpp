@@ -11,6 +11,8 @@
 #include <iostream>
 
 #include "core/models/pairhmm/simd_pair_hmm_factory.hpp"
+#include "core/models/pairhmm/ungapped_score.hpp"
+#include "core/models/pairhmm/pair_hmm.hpp"
 
 namespace octopus { namespace test {
 
@@ -712,6 +714,112 @@ BOOST_AUTO_TEST_CASE(avx2_check_alignments)
 }
 #endif /* __AVX2__ */
 
+template <typename HMM>
+auto
+bounded_align_score_helper(TestCase test, HMM hmm, int max_score)
+{
+    return hmm.align(test.target.data(), test.query.data(), test.base_qualities.data(),
+                     static_cast<int>(test.target.size()), static_cast<int>(test.query.size()),
+                     test.gap_open.data(), test.gap_extend, test.nuc_prior, max_score);
+}
+
+BOOST_AUTO_TEST_CASE(sse2_bounded_alignments)
+{
+    SSE2PairHMM<8, short> sse_short_hmm;
+    SSE2PairHMM<8, int> sse_int_hmm;
+    const auto score = band8_speed_expected_alignment.score;
+    
+    // Bounds the score doesn't exceed don't change it
+    BOOST_CHECK_EQUAL(bounded_align_score_helper(band8_speed_test, sse_short_hmm, score), score);
+    BOOST_CHECK_EQUAL(bounded_align_score_helper(band8_speed_test, sse_int_hmm, score), score);
+    BOOST_CHECK_EQUAL(bounded_align_score_helper(band8_speed_test, sse_short_hmm, 10 * score), score);
+    
+    // Otherwise the result is still above the bound but no more than the score
+    for (const int max_score : {0, 10, score - 1}) {
+        const auto short_result = bounded_align_score_helper(band8_speed_test, sse_short_hmm, max_score);
+        BOOST_CHECK_GT(short_result, max_score);
+        BOOST_CHECK_LE(short_result, score);
+        const auto int_result = bounded_align_score_helper(band8_speed_test, sse_int_hmm, max_score);
+        BOOST_CHECK_GT(int_result, max_score);
+        BOOST_CHECK_LE(int_result, score);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(sse2_ungapped_alignments)
+{
+    SSE2PairHMM<8, short> sse_short_hmm;
+    const std::string query {"ACGTTGCAACGTACGTTTGCAAGGCTTACGATC"};
+    TestCase test {"GGGGGGGG" + query + "CCCCCCC", query,
+                   std::vector<std::int8_t>(query.size(), 30),
+                   std::vector<std::int8_t>(query.size() + 15, 45),
+                   1, 4};
+    test.query[5] = 'A'; test.base_qualities[5] = 20;
+    test.query[20] = 'T'; test.base_qualities[20] = 15;
+    CHECK_TEST(test, sse_short_hmm)
+    const auto truth = test.target.data() + sse_short_hmm.band_size();
+    const auto target_len = static_cast<int>(query.size());
+    const auto score = ungapped_score(truth, test.query.data(), test.base_qualities.data(), target_len, 1000);
+    BOOST_CHECK_EQUAL(score, 35);
+    BOOST_CHECK_EQUAL(align_score_helper(test, sse_short_hmm), score);
+    
+    // Mismatches to the SNV mask are capped by the SNV prior
+    const std::vector<char> snv_mask(truth, truth + target_len);
+    std::vector<std::int8_t> snv_priors(target_len, 10);
+    BOOST_CHECK_EQUAL(ungapped_score(truth, test.query.data(), test.base_qualities.data(), target_len,
+                                     snv_mask.data(), snv_priors.data(), 1000), score);
+    auto masked = snv_mask;
+    masked[20] = 'T';
+    BOOST_CHECK_EQUAL(ungapped_score(truth, test.query.data(), test.base_qualities.data(), target_len,
+                                     masked.data(), snv_priors.data(), 1000), 30);
+    
+    // Scoring may stop once the bound is reached
+    BOOST_CHECK_GE(ungapped_score(truth, test.query.data(), test.base_qualities.data(), target_len, 20), 20);
+}
+
+
+BOOST_AUTO_TEST_CASE(simd_evaluate_falls_back_to_banded_alignment_for_gapped_reads)
+{
+    const auto& hmm = octopus::hmm::default_hmm;
+    const std::string flank(hmm.band_size() + 4, 'T');
+    const std::string region {"ACGTTGCAACGTACGGATCAAGGCTTACGATCGGACTAGCATG"};
+    const std::string truth {flank + region + flank};
+    auto read = region;
+    read.erase(20, 1);
+    const std::vector<std::uint8_t> qualities(read.size(), 30);
+    octopus::hmm::FlatGapMutationModel model {15, 3};
+    model.mismatch = 30;
+    const auto target_offset = flank.size();
+    const auto alignment_offset = static_cast<int>(target_offset) - hmm.band_size();
+    const auto truth_alignment_size = static_cast<int>(read.size()) + 2 * hmm.band_size() - 1;
+    int ungapped_score;
+    BOOST_CHECK(!octopus::hmm::detail::try_ungapped_evaluate(truth, read, qualities, target_offset, alignment_offset,
+                                                            truth_alignment_size, model, ungapped_score));
+    const auto score = octopus::hmm::detail::align(truth, read, qualities, alignment_offset, hmm, model);
+    BOOST_CHECK_LT(score, ungapped_score);
+    BOOST_CHECK_EQUAL(octopus::hmm::detail::simd_evaluate(truth, read, qualities, target_offset, hmm, model),
+                      -octopus::hmm::ln10Div10<> * score);
+}
+
+BOOST_AUTO_TEST_CASE(ungapped_evaluation_scores_truth_ns_the_same_as_banded_alignment)
+{
+    const auto& hmm = octopus::hmm::default_hmm;
+    const std::string flank(hmm.band_size() + 4, 'T');
+    const std::string region {"ACGTTGCAACGTACGGATCAAGGCTTACGATCGGACTAGCATG"};
+    std::string truth {flank + region + flank};
+    const auto target_offset = flank.size();
+    truth[target_offset + 10] = 'N';
+    const std::vector<std::uint8_t> qualities(region.size(), 30);
+    octopus::hmm::FlatGapMutationModel model {15, 3};
+    model.mismatch = 30;
+    const auto alignment_offset = static_cast<int>(target_offset) - hmm.band_size();
+    const auto truth_alignment_size = static_cast<int>(region.size()) + 2 * hmm.band_size() - 1;
+    int ungapped_score;
+    BOOST_REQUIRE(octopus::hmm::detail::try_ungapped_evaluate(truth, region, qualities, target_offset, alignment_offset,
+                                                             truth_alignment_size, model, ungapped_score));
+    BOOST_CHECK_EQUAL(ungapped_score, n_penalty);
+    BOOST_CHECK_EQUAL(octopus::hmm::detail::align(truth, region, qualities, alignment_offset, hmm, model), ungapped_score);
+}
+
 
 // Speed tests
 
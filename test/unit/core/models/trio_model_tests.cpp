@@ -0,0 +1,244 @@
+// Copyright (c) 2015-2020 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#include <boost/test/unit_test.hpp>
+
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <limits>
+#include <cmath>
+
+#include "mock/mock_reference.hpp"
+
+#include "config/common.hpp"
+#include "basics/trio.hpp"
+#include "basics/aligned_read.hpp"
+#include "basics/cigar_string.hpp"
+#include "core/types/haplotype.hpp"
+#include "core/types/indexed_haplotype.hpp"
+#include "core/types/genotype.hpp"
+#include "core/models/haplotype_likelihood_array.hpp"
+#include "core/models/mutation/coalescent_model.hpp"
+#include "core/models/mutation/denovo_model.hpp"
+#include "core/models/genotype/coalescent_population_prior_model.hpp"
+#include "core/models/genotype/trio_model.hpp"
+
+namespace octopus { namespace test {
+
+using model::TrioModel;
+
+namespace {
+
+const GenomicRegion haplotype_region {"1", 50, 200};
+const GenomicRegion read_region {"1", 100, 140};
+
+auto make_haplotype(const ReferenceGenome& reference, const std::vector<GenomicRegion::Position>& snv_positions)
+{
+    auto sequence = reference.fetch_sequence(haplotype_region);
+    for (const auto position : snv_positions) {
+        auto& base = sequence[position - haplotype_region.begin()];
+        base = base == 'A' ? 'C' : 'A';
+    }
+    return Haplotype {haplotype_region, std::move(sequence), reference};
+}
+
+auto make_reads(const Haplotype& haplotype, const unsigned n, const std::string& name)
+{
+    std::vector<AlignedRead> result {};
+    const auto sequence = haplotype.sequence(read_region);
+    for (unsigned i {0}; i < n; ++i) {
+        result.emplace_back(name + std::to_string(i), read_region, sequence,
+                            AlignedRead::BaseQualityVector(sequence.size(), 30),
+                            parse_cigar(std::to_string(sequence.size()) + "M"), 60, AlignedRead::Flags {}, "", "");
+    }
+    return result;
+}
+
+void add_reads(ReadMap& reads, const SampleName& sample, std::vector<AlignedRead> sample_reads)
+{
+    auto& container = reads[sample];
+    container.insert(std::make_move_iterator(std::begin(sample_reads)), std::make_move_iterator(std::end(sample_reads)));
+}
+
+bool contains(const Genotype<IndexedHaplotype<>>& genotype, const Haplotype& haplotype)
+{
+    return std::any_of(std::cbegin(genotype), std::cend(genotype), [&] (const auto& h) { return h.haplotype() == haplotype; });
+}
+
+template <typename Container>
+auto concat(Container lhs, const Container& rhs)
+{
+    lhs.insert(std::end(lhs), std::cbegin(rhs), std::cend(rhs));
+    return lhs;
+}
+
+struct TrioTestData
+{
+    ReferenceGenome reference;
+    Trio trio;
+    MappableBlock<Haplotype> haplotypes;
+    HaplotypeLikelihoodArray likelihoods;
+
+    TrioTestData()
+    : reference {mock::make_reference()}
+    , trio {Trio::Mother {"mother"}, Trio::Father {"father"}, Trio::Child {"child"}}
+    , haplotypes {}
+    , likelihoods {}
+    {
+        const auto ref  = make_haplotype(reference, {});
+        const auto alt1 = make_haplotype(reference, {110});
+        const auto alt2 = make_haplotype(reference, {125});
+        const auto alt3 = make_haplotype(reference, {110, 125});
+        haplotypes = MappableBlock<Haplotype> {ref, alt1, alt2, alt3};
+        ReadMap reads {};
+        add_reads(reads, trio.mother(), concat(make_reads(ref, 5, "m"), make_reads(alt1, 5, "m_alt")));
+        add_reads(reads, trio.father(), concat(make_reads(ref, 5, "f"), make_reads(alt2, 5, "f_alt")));
+        add_reads(reads, trio.child(), concat(make_reads(alt1, 5, "c"), make_reads(alt2, 5, "c_alt")));
+        likelihoods = HaplotypeLikelihoodArray {static_cast<unsigned>(haplotypes.size()), {trio.mother(), trio.father(), trio.child()}};
+        likelihoods.populate(reads, haplotypes);
+    }
+};
+
+auto evaluate(const TrioTestData& data, const TrioModel::Options& options)
+{
+    CoalescentPopulationPriorModel prior_model {CoalescentModel {Haplotype {haplotype_region, data.reference}, {}}};
+    prior_model.prime(data.haplotypes);
+    DeNovoModel denovo_model {{1.3e-8, 1e-9}, data.haplotypes.size(), DeNovoModel::CachingStrategy::none};
+    denovo_model.prime(data.haplotypes);
+    const TrioModel model {data.trio, prior_model, denovo_model, options};
+    const auto indexed_haplotypes = index(data.haplotypes);
+    const auto genotypes = generate_all_genotypes(indexed_haplotypes, 2);
+    return std::make_pair(genotypes, model.evaluate(genotypes, data.likelihoods));
+}
+
+auto evaluate_allosome(const TrioTestData& data, const TrioModel::Options& options)
+{
+    CoalescentPopulationPriorModel prior_model {CoalescentModel {Haplotype {haplotype_region, data.reference}, {}}};
+    prior_model.prime(data.haplotypes);
+    DeNovoModel denovo_model {{1.3e-8, 1e-9}, data.haplotypes.size(), DeNovoModel::CachingStrategy::none};
+    denovo_model.prime(data.haplotypes);
+    const TrioModel model {data.trio, prior_model, denovo_model, options};
+    const auto indexed_haplotypes = index(data.haplotypes);
+    const auto genotypes = generate_all_genotypes(indexed_haplotypes, 1);
+    return std::make_pair(genotypes, model.evaluate({}, genotypes, genotypes, data.likelihoods));
+}
+
+auto find(const TrioModel::Latents::JointProbabilityVector& joints, const TrioModel::Latents::JointProbability& joint)
+{
+    return std::find_if(std::cbegin(joints), std::cend(joints), [&] (const auto& other) {
+        return other.maternal == joint.maternal && other.paternal == joint.paternal && other.child == joint.child;
+    });
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(core)
+BOOST_AUTO_TEST_SUITE(models)
+BOOST_AUTO_TEST_SUITE(trio_model)
+
+BOOST_AUTO_TEST_CASE(pruned_joint_search_agrees_with_exhaustive_evaluation)
+{
+    const TrioTestData data {};
+    TrioModel::Options exhaustive_options {};
+    exhaustive_options.max_individual_log_probability_loss = std::numeric_limits<double>::lowest();
+    exhaustive_options.max_joint_log_probability_loss = std::numeric_limits<double>::lowest();
+    const auto exhaustive = evaluate(data, exhaustive_options);
+    const auto& exhaustive_joints = exhaustive.second.posteriors.joint_genotype_probabilities;
+    const auto num_genotypes = exhaustive.first.size();
+    BOOST_REQUIRE_EQUAL(exhaustive_joints.size(), num_genotypes * num_genotypes * num_genotypes);
+
+    TrioModel::Options pruned_options {};
+    pruned_options.max_joint_log_probability_loss = -25;
+    const auto pruned = evaluate(data, pruned_options);
+    const auto& pruned_joints = pruned.second.posteriors.joint_genotype_probabilities;
+    BOOST_CHECK_LT(pruned_joints.size(), exhaustive_joints.size());
+    BOOST_CHECK_CLOSE(pruned.second.log_evidence, exhaustive.second.log_evidence, 1e-6);
+
+    // Every joint genotype with non-negligible posterior mass is kept, with the same posterior
+    for (const auto& joint : exhaustive_joints) {
+        const auto pruned_joint = find(pruned_joints, joint);
+        if (joint.probability > 1e-10) {
+            BOOST_REQUIRE(pruned_joint != std::cend(pruned_joints));
+            BOOST_CHECK_SMALL(pruned_joint->probability - joint.probability, 1e-8);
+        }
+    }
+    const auto map_joint = std::max_element(std::cbegin(pruned_joints), std::cend(pruned_joints),
+                                            [] (const auto& lhs, const auto& rhs) { return lhs.probability < rhs.probability; });
+    const auto& genotypes = pruned.first;
+    BOOST_CHECK(contains(genotypes[map_joint->maternal], make_haplotype(data.reference, {110})));
+    BOOST_CHECK(contains(genotypes[map_joint->paternal], make_haplotype(data.reference, {125})));
+}
+
+BOOST_AUTO_TEST_CASE(truncated_joint_search_keeps_parents_with_top_child_haplotypes)
+{
+    const TrioTestData data {};
+    TrioModel::Options options {};
+    options.max_genotype_combinations = 20;
+    const auto latents = evaluate(data, options);
+    const auto& genotypes = latents.first;
+    const auto& joints = latents.second.posteriors.joint_genotype_probabilities;
+    BOOST_REQUIRE(!joints.empty());
+    const auto map_joint = std::max_element(std::cbegin(joints), std::cend(joints),
+                                            [] (const auto& lhs, const auto& rhs) { return lhs.probability < rhs.probability; });
+    for (const auto& haplotype : genotypes[map_joint->child]) {
+        const auto is_inherited = std::any_of(std::cbegin(joints), std::cend(joints), [&] (const auto& joint) {
+            return contains(genotypes[joint.maternal], haplotype.haplotype()) || contains(genotypes[joint.paternal], haplotype.haplotype());
+        });
+        BOOST_CHECK(is_inherited);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(truncated_joint_search_respects_max_genotype_combinations)
+{
+    const TrioTestData data {};
+    for (const std::size_t max_genotype_combinations : {1, 2, 5, 10, 20, 50}) {
+        TrioModel::Options options {};
+        options.max_genotype_combinations = max_genotype_combinations;
+        const auto latents = evaluate(data, options);
+        const auto& joints = latents.second.posteriors.joint_genotype_probabilities;
+        BOOST_TEST_CONTEXT("max_genotype_combinations " << max_genotype_combinations) {
+            BOOST_CHECK(!joints.empty());
+            BOOST_CHECK_LE(joints.size(), max_genotype_combinations);
+            BOOST_CHECK(latents.second.estimated_lost_log_posterior_mass);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(allosome_joint_search_agrees_with_exhaustive_evaluation)
+{
+    const TrioTestData data {};
+    TrioModel::Options exhaustive_options {};
+    exhaustive_options.max_individual_log_probability_loss = std::numeric_limits<double>::lowest();
+    exhaustive_options.max_joint_log_probability_loss = std::numeric_limits<double>::lowest();
+    const auto exhaustive = evaluate_allosome(data, exhaustive_options);
+    const auto& exhaustive_joints = exhaustive.second.posteriors.joint_genotype_probabilities;
+    const auto num_genotypes = exhaustive.first.size();
+    BOOST_REQUIRE_EQUAL(exhaustive_joints.size(), num_genotypes * num_genotypes);
+    
+    TrioModel::Options pruned_options {};
+    pruned_options.max_joint_log_probability_loss = -25;
+    const auto pruned = evaluate_allosome(data, pruned_options);
+    const auto& pruned_joints = pruned.second.posteriors.joint_genotype_probabilities;
+    BOOST_CHECK_LT(pruned_joints.size(), exhaustive_joints.size());
+    BOOST_CHECK_CLOSE(pruned.second.log_evidence, exhaustive.second.log_evidence, 1e-6);
+    for (const auto& joint : exhaustive_joints) {
+        const auto pruned_joint = find(pruned_joints, joint);
+        if (joint.probability > 1e-10) {
+            BOOST_REQUIRE(pruned_joint != std::cend(pruned_joints));
+            BOOST_CHECK_SMALL(pruned_joint->probability - joint.probability, 1e-8);
+        }
+    }
+    
+    TrioModel::Options capped_options {};
+    capped_options.max_genotype_combinations = 3;
+    const auto capped = evaluate_allosome(data, capped_options);
+    BOOST_CHECK_LE(capped.second.posteriors.joint_genotype_probabilities.size(), 3);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace test
+} // namespace octopus
@@ -4,6 +4,8 @@
 #include <boost/test/unit_test.hpp>
 
 #include <exception>
+#include <algorithm>
+#include <iterator>
 
 #include "core/tools/vargen/utils/assembler.hpp"
 
@@ -72,6 +74,98 @@ BOOST_AUTO_TEST_CASE(assembler_throws_if_reference_sequence_is_inserted_twice)
     BOOST_CHECK_THROW(assembler.insert_reference(reference), std::exception);
 }
 
+BOOST_AUTO_TEST_CASE(removing_a_read_restores_the_graph)
+{
+    const Assembler::NucleotideSequence reference {"ACGTTGCAATCGGATCCTAG"};
+    const Assembler::NucleotideSequence read {"ACGTTGCATTCGGATCCTAG"};
+    const Assembler::BaseQualityVector base_qualities(read.size(), 30);
+    
+    constexpr unsigned kmerSize {5};
+    
+    Assembler assembler {{kmerSize}, reference};
+    const auto num_reference_kmers = assembler.num_kmers();
+    
+    assembler.insert_read(read, base_qualities, Assembler::Direction::forward);
+    
+    BOOST_REQUIRE(!assembler.is_all_reference());
+    
+    assembler.remove_read(read, base_qualities, Assembler::Direction::forward);
+    
+    BOOST_CHECK(assembler.is_all_reference());
+    BOOST_CHECK_EQUAL(assembler.num_kmers(), num_reference_kmers);
+}
+
+BOOST_AUTO_TEST_CASE(slid_reference_matches_newly_inserted_reference)
+{
+    const Assembler::NucleotideSequence reference {"ACGTTGCAATCGGATCCTAG"};
+    const Assembler::NucleotideSequence lhs_window {reference.substr(0, 12)}, rhs_window {reference.substr(4)};
+    const Assembler::NucleotideSequence read {"GCAATCGG"};
+    const Assembler::BaseQualityVector base_qualities(read.size(), 30);
+    
+    constexpr unsigned kmerSize {5};
+    
+    Assembler slid {{kmerSize}, lhs_window}, fresh {{kmerSize}, rhs_window};
+    slid.insert_read(read, base_qualities, Assembler::Direction::forward);
+    fresh.insert_read(read, base_qualities, Assembler::Direction::forward);
+    
+    BOOST_REQUIRE_NO_THROW(slid.slide_reference(rhs_window, 4));
+    
+    BOOST_CHECK(slid.is_unique_reference());
+    BOOST_CHECK(slid.is_all_reference());
+    BOOST_CHECK_EQUAL(slid.num_kmers(), fresh.num_kmers());
+    
+    const Assembler::NucleotideSequence disjoint_window {"TTTTTTTTTT"};
+    BOOST_CHECK_THROW(slid.slide_reference(disjoint_window, 0), std::exception);
+}
+
+BOOST_AUTO_TEST_CASE(slid_references_are_released_once_no_kmers_view_them)
+{
+    const Assembler::NucleotideSequence reference {"ACGTTGCAATCGGATCCTAGGCTTACGAAC"};
+    const Assembler::NucleotideSequence first_window {reference.substr(0, 12)}, second_window {reference.substr(4, 16)},
+                                        third_window {reference.substr(12)};
+    const Assembler::NucleotideSequence read {reference.substr(6, 8)};
+    const Assembler::BaseQualityVector base_qualities(read.size(), 30);
+    
+    constexpr unsigned kmerSize {5};
+    
+    Assembler assembler {{kmerSize}, first_window};
+    assembler.insert_read(read, base_qualities, Assembler::Direction::forward);
+    assembler.slide_reference(second_window, 4);
+    BOOST_CHECK(assembler.is_viewing(first_window));
+    assembler.slide_reference(third_window, 8);
+    // The read still supports kmers from the first window
+    BOOST_CHECK(assembler.is_viewing(first_window));
+    assembler.remove_read(read, base_qualities, Assembler::Direction::forward);
+    BOOST_CHECK(!assembler.is_viewing(first_window));
+    BOOST_CHECK(assembler.is_viewing(third_window));
+    BOOST_CHECK(assembler.is_all_reference());
+}
+
+BOOST_AUTO_TEST_CASE(read_base_qualities_stay_aligned_along_reference_runs)
+{
+    const Assembler::NucleotideSequence reference {"ACGTTGCAATCGGATCCTAGGCTTACGAAC"};
+    // Starts off the reference, rejoins it for a run of reference kmers, then has a SNV at position 20
+    const Assembler::NucleotideSequence read {"TCGTTGCAATCGGATCCTAGTCTTACGAAC"};
+    // Only the SNV and the bases after it are high quality
+    Assembler::BaseQualityVector base_qualities(read.size(), 2);
+    std::fill(std::next(std::begin(base_qualities), 20), std::end(base_qualities), 40);
+    
+    constexpr unsigned kmerSize {5};
+    
+    Assembler assembler {{kmerSize}, reference};
+    for (int i {0}; i < 5; ++i) {
+        assembler.insert_read(read, base_qualities, Assembler::Direction::forward);
+    }
+    assembler.cleanup();
+    
+    const auto variants = assembler.extract_variants(10, 3.0);
+    BOOST_REQUIRE_EQUAL(variants.size(), 1);
+    // Bubble alleles include the flanking kmer bases
+    BOOST_CHECK_EQUAL(variants.front().begin_pos, 15);
+    BOOST_CHECK_EQUAL(variants.front().ref, "CCTAGGCTTA");
+    BOOST_CHECK_EQUAL(variants.front().alt, "CCTAGTCTTA");
+}
+
 
 
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,141 @@
+// Copyright (c) 2015-2020 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#include <boost/test/unit_test.hpp>
+
+#include <vector>
+#include <fstream>
+#include <cstdint>
+#include <stdexcept>
+
+#include <boost/filesystem.hpp>
+
+#include "basics/genomic_region.hpp"
+#include "core/types/variant.hpp"
+#include "exceptions/malformed_file_error.hpp"
+#include "core/tools/vargen/utils/candidate_store.hpp"
+
+namespace octopus { namespace test {
+
+using octopus::coretools::CandidateStore;
+
+namespace {
+
+struct TemporaryStorePath
+{
+    boost::filesystem::path path {boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("%%%%-%%%%.ocs")};
+    ~TemporaryStorePath() { boost::system::error_code ec {}; boost::filesystem::remove(path, ec); }
+};
+
+template <typename T>
+T read_value(const boost::filesystem::path& file, const std::uint64_t offset)
+{
+    std::ifstream in {file.string(), std::ios::binary};
+    in.seekg(offset);
+    T result {};
+    in.read(reinterpret_cast<char*>(&result), sizeof(T));
+    return result;
+}
+
+template <typename T>
+void write_value(const boost::filesystem::path& file, const std::uint64_t offset, const T value)
+{
+    std::fstream out {file.string(), std::ios::binary | std::ios::in | std::ios::out};
+    out.seekp(offset);
+    out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+auto fetch_variants(const CandidateStore& store, const GenomicRegion& region)
+{
+    std::vector<Variant> result {};
+    for (auto& candidate : store.fetch(region)) result.push_back(std::move(candidate.variant));
+    return result;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(core)
+BOOST_AUTO_TEST_SUITE(candidate_store)
+
+BOOST_AUTO_TEST_CASE(candidate_store_fetches_written_candidates_by_region)
+{
+    const TemporaryStorePath file {};
+    const std::vector<Variant> chr1 {
+        {"1", 10, "A", "C"}, {"1", 10, "A", "T"}, {"1", 20, "", "ACGTN"},
+        {"1", 25, "ACGTACGTA", "A"}, {"1", 100, "G", "A"}, {"1", 1'000'000, "T", "TTTTTTTTTTTTTT"}
+    };
+    const std::vector<Variant> chr2 {{"2", 5, "C", "G"}};
+    {
+        CandidateStore::Writer::Options options {};
+        options.block_size = 2;
+        options.store_allele_frequencies = true;
+        CandidateStore::Writer writer {file.path, options};
+        for (const auto& variant : chr1) writer.write(variant, 0.5f);
+        writer.write(chr2.front());
+    }
+    BOOST_REQUIRE(CandidateStore::is_candidate_store(file.path));
+    const CandidateStore store {file.path};
+    BOOST_CHECK(store.has_allele_frequencies());
+    BOOST_CHECK_EQUAL(store.contigs().size(), 2);
+    BOOST_CHECK(fetch_variants(store, GenomicRegion {"1", 0, 2'000'000}) == chr1);
+    BOOST_CHECK(fetch_variants(store, GenomicRegion {"2", 0, 100}) == chr2);
+    BOOST_CHECK(fetch_variants(store, GenomicRegion {"3", 0, 100}).empty());
+    const std::vector<Variant> overlapping {chr1[2], chr1[3]};
+    BOOST_CHECK(fetch_variants(store, GenomicRegion {"1", 20, 30}) == overlapping);
+    const std::vector<Variant> spanning {chr1[3]};
+    BOOST_CHECK(fetch_variants(store, GenomicRegion {"1", 30, 31}) == spanning);
+    const auto candidates = store.fetch(GenomicRegion {"1", 100, 101});
+    BOOST_REQUIRE_EQUAL(candidates.size(), 1);
+    BOOST_REQUIRE(candidates.front().allele_frequency);
+    BOOST_CHECK_EQUAL(*candidates.front().allele_frequency, 0.5f);
+    BOOST_CHECK(!store.fetch(GenomicRegion {"2", 5, 6}).front().allele_frequency);
+}
+
+BOOST_AUTO_TEST_CASE(candidate_store_writer_requires_sorted_candidates)
+{
+    const TemporaryStorePath file {};
+    CandidateStore::Writer writer {file.path};
+    writer.write({"1", 10, "A", "C"});
+    BOOST_CHECK_THROW(writer.write({"1", 5, "A", "C"}), std::runtime_error);
+    writer.write({"2", 5, "A", "C"});
+    BOOST_CHECK_THROW(writer.write({"1", 20, "A", "C"}), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(candidate_store_keeps_metadata)
+{
+    const TemporaryStorePath file {};
+    {
+        CandidateStore::Writer::Options options {};
+        options.metadata = "source=a.vcf;min_quality=10";
+        CandidateStore::Writer writer {file.path, options};
+        writer.write({"1", 10, "A", "C"});
+    }
+    const CandidateStore store {file.path};
+    BOOST_CHECK_EQUAL(store.metadata(), "source=a.vcf;min_quality=10");
+    BOOST_CHECK_EQUAL(store.fetch(GenomicRegion {"1", 0, 100}).size(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(candidate_store_rejects_blocks_and_alleles_outside_the_file)
+{
+    const TemporaryStorePath file {};
+    {
+        CandidateStore::Writer writer {file.path};
+        writer.write({"1", 10, "A", "C"});
+    }
+    const auto index_offset = read_value<std::uint64_t>(file.path, 16);
+    const auto first_block_entry_offset = index_offset + 4 + 4 + 1 + 4; // num contigs, name length, "1", num blocks
+    const auto block_offset = read_value<std::uint64_t>(file.path, first_block_entry_offset);
+    write_value(file.path, block_offset + 8, std::uint32_t {1'000'000}); // the record's allele offset
+    {
+        const CandidateStore store {file.path};
+        BOOST_CHECK_THROW(store.fetch(GenomicRegion {"1", 0, 100}), MalformedFileError);
+    }
+    write_value(file.path, first_block_entry_offset, std::uint64_t {1'000'000});
+    BOOST_CHECK_THROW(CandidateStore {file.path}, MalformedFileError);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace test
+} // namespace octopus
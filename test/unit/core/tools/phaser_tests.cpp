@@ -3,14 +3,136 @@
 
 #include <boost/test/unit_test.hpp>
 
+#include <string>
+#include <vector>
+#include <numeric>
+#include <cmath>
+#include <cstddef>
+
+#include "mock/mock_reference.hpp"
+
+#include "basics/genomic_region.hpp"
+#include "core/types/haplotype.hpp"
+#include "core/types/indexed_haplotype.hpp"
+#include "core/types/genotype.hpp"
 #include "core/tools/phaser/phaser.hpp"
 
 namespace octopus { namespace test {
 
+namespace {
+
+const GenomicRegion haplotype_region {"1", 50, 200};
+
+auto make_haplotype(const ReferenceGenome& reference, const std::vector<GenomicRegion::Position>& snv_positions)
+{
+    auto sequence = reference.fetch_sequence(haplotype_region);
+    for (const auto position : snv_positions) {
+        auto& base = sequence[position - haplotype_region.begin()];
+        base = base == 'A' ? 'C' : 'A';
+    }
+    return Haplotype {haplotype_region, std::move(sequence), reference};
+}
+
+const std::vector<GenomicRegion> sites {
+    GenomicRegion {"1", 100, 101}, GenomicRegion {"1", 120, 121}, GenomicRegion {"1", 140, 141}, GenomicRegion {"1", 160, 161}
+};
+
+struct PhaseTestData
+{
+    ReferenceGenome reference;
+    MappableBlock<Haplotype> haplotypes;
+    
+    PhaseTestData()
+    : reference {mock::make_reference()}
+    , haplotypes {make_haplotype(reference, {}), make_haplotype(reference, {100, 140}), make_haplotype(reference, {120, 160}),
+                  make_haplotype(reference, {100, 120}), make_haplotype(reference, {140}), make_haplotype(reference, {100, 120, 140, 160})}
+    {}
+};
+
+// Two samples with fixed posteriors over every genotype of the given ploidy, each with one dominant genotype
+auto make_genotype_posteriors(const MappableBlock<Haplotype>& haplotypes, const unsigned ploidy)
+{
+    const auto genotypes = generate_all_genotypes(index(haplotypes), ploidy);
+    Phaser::GenotypePosteriorMap result {std::cbegin(genotypes), std::cend(genotypes)};
+    for (unsigned s {0}; s < 2; ++s) {
+        std::vector<double> posteriors(genotypes.size());
+        for (std::size_t i {0}; i < posteriors.size(); ++i) {
+            posteriors[i] = std::pow(0.5, (i * (3 + 2 * s)) % 7) + (i == 4 + 3 * s ? 20.0 : 0.0);
+        }
+        const auto norm = std::accumulate(std::cbegin(posteriors), std::cend(posteriors), 0.0);
+        for (auto& p : posteriors) p /= norm;
+        insert_sample("s" + std::to_string(s), posteriors, result);
+    }
+    return result;
+}
+
+struct ExpectedPhaseSet
+{
+    std::vector<std::size_t> site_indices;
+    double quality;
+};
+
+void check_phase_sets(const Phaser::PhaseSetMap& phasings, const SampleName& sample, const std::vector<ExpectedPhaseSet>& expected)
+{
+    BOOST_TEST_CONTEXT("sample " << sample) {
+        const auto& phase_sets = phasings.at(sample);
+        BOOST_REQUIRE_EQUAL(phase_sets.size(), expected.size());
+        for (std::size_t i {0}; i < expected.size(); ++i) {
+            BOOST_CHECK_EQUAL_COLLECTIONS(std::cbegin(phase_sets[i].site_indices), std::cend(phase_sets[i].site_indices),
+                                          std::cbegin(expected[i].site_indices), std::cend(expected[i].site_indices));
+            BOOST_CHECK_CLOSE(phase_sets[i].quality.score(), expected[i].quality, 1e-6);
+        }
+    }
+}
+
+const Phaser uncapped_phaser {{Phaser::GenotypeMatchType::exact, Phred<double> {10}, boost::none}};
+
+} // namespace
+
 BOOST_AUTO_TEST_SUITE(core)
 BOOST_AUTO_TEST_SUITE(phaser)
 
+// The expected qualities were computed with the map based phase scorer that preceded the allele bitset scorer
+
+BOOST_AUTO_TEST_CASE(pairwise_phase_qualities_match_reference_values)
+{
+    const PhaseTestData data {};
+    const auto posteriors = make_genotype_posteriors(data.haplotypes, 2);
+    struct PairwiseCase { std::size_t lhs, rhs; double s0_quality, s1_quality; };
+    const std::vector<PairwiseCase> cases {
+        {0, 1, 14.14189658, 15.39128395},
+        {0, 2, 32.20369632, 23.17279645},
+        {0, 3, 14.14189658, 23.17279645},
+        {1, 2, 17.15219654, 26.18309641},
+        {1, 3, 3076.526556, 3076.526556},
+        {2, 3, 15.39128395, 16.64067132}
+    };
+    for (const auto& c : cases) {
+        BOOST_TEST_CONTEXT("sites " << c.lhs << " & " << c.rhs) {
+            const auto phasings = uncapped_phaser.phase(data.haplotypes, posteriors, {sites[c.lhs], sites[c.rhs]});
+            check_phase_sets(phasings, "s0", {{{0, 1}, c.s0_quality}});
+            check_phase_sets(phasings, "s1", {{{0, 1}, c.s1_quality}});
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(block_phase_qualities_match_reference_values)
+{
+    const PhaseTestData data {};
+    const auto posteriors = make_genotype_posteriors(data.haplotypes, 2);
+    const auto phasings = uncapped_phaser.phase(data.haplotypes, posteriors, sites);
+    check_phase_sets(phasings, "s0", {{{0, 1, 2, 3}, 14.14189658}});
+    check_phase_sets(phasings, "s1", {{{0, 1, 2, 3}, 15.39128395}});
+}
 
+BOOST_AUTO_TEST_CASE(polyploid_block_phase_qualities_match_reference_values)
+{
+    const PhaseTestData data {};
+    const auto posteriors = make_genotype_posteriors(data.haplotypes, 3);
+    const auto phasings = uncapped_phaser.phase(data.haplotypes, posteriors, sites);
+    check_phase_sets(phasings, "s0", {{{0}, 3076.526556}, {{1, 3}, 15.41427948}, {{2}, 3076.526556}});
+    check_phase_sets(phasings, "s1", {{{0}, 3076.526556}, {{1, 3}, 15.09713535}, {{2}, 3076.526556}});
+}
 
 BOOST_AUTO_TEST_SUITE_END()
 BOOST_AUTO_TEST_SUITE_END()
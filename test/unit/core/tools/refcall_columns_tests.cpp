@@ -0,0 +1,249 @@
+// Copyright (c) 2015-2020 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#include <boost/test/unit_test.hpp>
+
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <numeric>
+#include <functional>
+#include <cmath>
+#include <cstddef>
+
+#include <boost/optional.hpp>
+
+#include "mock/mock_reference.hpp"
+
+#include "config/common.hpp"
+#include "basics/genomic_region.hpp"
+#include "basics/aligned_read.hpp"
+#include "basics/cigar_string.hpp"
+#include "basics/read_pileup.hpp"
+#include "basics/phred.hpp"
+#include "io/reference/reference_genome.hpp"
+#include "utils/maths.hpp"
+#include "core/tools/refcall_columns.hpp"
+
+namespace octopus { namespace test {
+
+namespace {
+
+const GenomicRegion region {"1", 100, 130};
+
+char mutate(const char base)
+{
+    return base == 'A' ? 'C' : 'A';
+}
+
+// Builds a read from the reference following the CIGAR, with inserted and soft clipped bases set to 'T'
+// and the bases at the given read offsets substituted. Soft clipped bases are mapped, as in octopus.
+AlignedRead make_read(const ReferenceGenome& reference, const GenomicRegion::Position begin, const std::string& cigar_str,
+                      const std::vector<std::size_t>& substitutions = {})
+{
+    const auto cigar = parse_cigar(cigar_str);
+    const GenomicRegion read_region {region.contig_name(), begin, begin + static_cast<GenomicRegion::Position>(reference_size(cigar))};
+    const auto reference_sequence = reference.fetch_sequence(read_region);
+    AlignedRead::NucleotideSequence sequence {};
+    std::size_t reference_idx {0};
+    for (const auto& op : cigar) {
+        if (is_match_or_substitution(op)) {
+            sequence += reference_sequence.substr(reference_idx, op.size());
+            reference_idx += op.size();
+        } else if (op.flag() == CigarOperation::Flag::softClipped) {
+            sequence.append(op.size(), 'T');
+            reference_idx += op.size();
+        } else if (advances_reference(op)) {
+            reference_idx += op.size();
+        } else if (advances_sequence(op)) {
+            sequence.append(op.size(), 'T');
+        }
+    }
+    for (const auto idx : substitutions) sequence[idx] = mutate(sequence[idx]);
+    AlignedRead::BaseQualityVector qualities(sequence.size());
+    for (std::size_t i {0}; i < qualities.size(); ++i) qualities[i] = 5 + (7 * i + begin) % 35;
+    return AlignedRead {"read" + std::to_string(begin) + cigar_str, read_region, std::move(sequence), std::move(qualities),
+                        cigar, 60, AlignedRead::Flags {}, "", ""};
+}
+
+// The pileup reference confidence calculation of the individual caller for a single reference base
+Phred<double> compute_homozygous_posterior(const ReadPileup& pileup, const char reference_base, unsigned& depth)
+{
+    const AlignedRead::NucleotideSequence reference_sequence(1, reference_base);
+    auto reference_qualities = pileup.base_qualities(reference_sequence);
+    auto non_reference_qualities = pileup.base_qualities_not(reference_sequence);
+    depth = reference_qualities.size() + non_reference_qualities.size();
+    if (depth == 0) return Phred<double> {3.0};
+    for (auto& q : reference_qualities) q = std::max(q, AlignedRead::BaseQuality {1});
+    for (auto& q : non_reference_qualities) q = std::max(q, AlignedRead::BaseQuality {1});
+    const auto phred_to_ln = [] (double phred) { return phred * -maths::constants::ln10Div10<>; };
+    const auto phred_to_not_ln = [] (double phred) { return std::log(1.0 - std::pow(10.0, -phred / 10.0)); };
+    double hom_ref_ln_likelihood {0}, het_ln_likelihood {0};
+    for (const auto q : reference_qualities) {
+        hom_ref_ln_likelihood += phred_to_not_ln(q);
+        het_ln_likelihood += maths::log_sum_exp(phred_to_not_ln(q), phred_to_ln(q)) - std::log(2);
+    }
+    for (const auto q : non_reference_qualities) {
+        hom_ref_ln_likelihood += phred_to_ln(q);
+        het_ln_likelihood += maths::log_sum_exp(phred_to_ln(q), phred_to_not_ln(q)) - std::log(2);
+    }
+    const auto het_ln_posterior = het_ln_likelihood - maths::log_sum_exp(hom_ref_ln_likelihood, het_ln_likelihood);
+    return log_probability_false_to_phred(het_ln_posterior);
+}
+
+// Per-position reference calls capped at max_posterior, then merged as Caller::squash_reference_calls does
+std::vector<RefCallBlock> squash_reference_calls(const std::vector<Phred<double>>& posteriors, const RefCallBlockParameters& parameters)
+{
+    std::vector<RefCallBlock> calls {};
+    for (std::size_t offset {0}; offset < posteriors.size(); ++offset) {
+        if (posteriors[offset] >= parameters.min_posterior) {
+            auto quality = posteriors[offset];
+            if (parameters.max_posterior) quality = std::min(quality, *parameters.max_posterior);
+            const auto position = static_cast<GenomicRegion::Position>(region.begin() + offset);
+            calls.push_back({GenomicRegion {region.contig_name(), position, position + 1}, quality, posteriors[offset]});
+        }
+    }
+    if (!parameters.merge_threshold) return calls;
+    std::vector<RefCallBlock> result {}, buffer {};
+    const auto flush = [&] () {
+        auto block = buffer.front();
+        block.region = encompassing_region(buffer.front().region, buffer.back().region);
+        for (const auto& call : buffer) block.quality = std::min(block.quality, call.quality);
+        result.push_back(std::move(block));
+        buffer.clear();
+    };
+    for (const auto& call : calls) {
+        if (!buffer.empty() && !(are_adjacent(buffer.back().region, call.region)
+            && std::abs(buffer.front().quality.score() - call.quality.score()) < parameters.merge_threshold->score())) {
+            flush();
+        }
+        buffer.push_back(call);
+    }
+    if (!buffer.empty()) flush();
+    return result;
+}
+
+struct RefCallTestData
+{
+    ReferenceGenome reference;
+    ReadContainer reads;
+    RefCallColumns columns;
+    ReadPileups pileups;
+
+    RefCallTestData(std::function<std::vector<AlignedRead>(const ReferenceGenome&)> make_reads)
+    : reference {mock::make_reference()}
+    , reads {}
+    , columns {region, reference.fetch_sequence(region)}
+    , pileups {}
+    {
+        auto sample_reads = make_reads(reference);
+        std::sort(std::begin(sample_reads), std::end(sample_reads));
+        reads.insert(std::cbegin(sample_reads), std::cend(sample_reads));
+        for (const auto& read : reads) columns.add(read);
+        pileups = make_pileups(reads, region);
+    }
+};
+
+void check_posteriors_match_pileups(const RefCallTestData& data)
+{
+    BOOST_REQUIRE_EQUAL(data.columns.size(), data.pileups.size());
+    const auto& reference_sequence = data.columns.reference_sequence();
+    for (std::size_t offset {0}; offset < data.columns.size(); ++offset) {
+        BOOST_TEST_CONTEXT("position " << region.begin() + offset) {
+            unsigned expected_depth {};
+            const auto expected = compute_homozygous_posterior(data.pileups[offset], reference_sequence[offset], expected_depth);
+            BOOST_CHECK_EQUAL(data.columns.depth(offset), expected_depth);
+            BOOST_CHECK_CLOSE(data.columns.homozygous_reference_posterior(offset).score(), expected.score(), 1e-6);
+        }
+    }
+}
+
+auto make_cigar_reads(const ReferenceGenome& reference)
+{
+    return std::vector<AlignedRead> {
+        make_read(reference, 90, "20M", {3, 12}),       // overhangs the region begin
+        make_read(reference, 92, "8M2I10M"),            // insertion before the first region position
+        make_read(reference, 95, "3M4D15M", {10}),      // deletion spanning the region begin
+        make_read(reference, 100, "5S15M"),             // front soft clip at the region begin
+        make_read(reference, 100, "2I18M"),             // leading insertion at the region begin
+        make_read(reference, 104, "10M2I10M", {1}),     // insertion inside the region
+        make_read(reference, 108, "6M1D6M1I6M"),        // adjacent deletion and insertion
+        make_read(reference, 112, "15M4S"),             // back soft clip at the region end
+        make_read(reference, 115, "12M3D10M", {0, 5}),  // deletion spanning the region end
+        make_read(reference, 122, "8M2I8M"),            // insertion just after the last region position
+        make_read(reference, 125, "4M1I6M")             // insertion at the last region position
+    };
+}
+
+auto make_uniform_reads(const ReferenceGenome& reference)
+{
+    std::vector<AlignedRead> result {};
+    for (GenomicRegion::Position begin {90}; begin < 130; begin += 2) {
+        result.push_back(make_read(reference, begin, "20M"));
+    }
+    // A few non-reference bases so qualities vary along the region
+    result.push_back(make_read(reference, 110, "10M", {2, 3}));
+    result.push_back(make_read(reference, 111, "10M", {4}));
+    return result;
+}
+
+void check_blocks_match_squashed_calls(const RefCallTestData& data, const RefCallBlockParameters& parameters)
+{
+    std::vector<Phred<double>> posteriors(data.columns.size());
+    for (std::size_t offset {0}; offset < data.columns.size(); ++offset) {
+        posteriors[offset] = data.columns.homozygous_reference_posterior(offset);
+    }
+    const auto expected = squash_reference_calls(posteriors, parameters);
+    const auto blocks = make_blocks(data.columns, parameters);
+    BOOST_REQUIRE_EQUAL(blocks.size(), expected.size());
+    for (std::size_t i {0}; i < blocks.size(); ++i) {
+        BOOST_CHECK_EQUAL(blocks[i].region, expected[i].region);
+        BOOST_CHECK_EQUAL(blocks[i].quality.score(), expected[i].quality.score());
+        BOOST_CHECK_EQUAL(blocks[i].posterior.score(), expected[i].posterior.score());
+    }
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(core)
+BOOST_AUTO_TEST_SUITE(tools)
+BOOST_AUTO_TEST_SUITE(refcall_columns)
+
+BOOST_AUTO_TEST_CASE(posteriors_match_pileup_posteriors_for_indels_and_soft_clips_at_region_edges)
+{
+    const RefCallTestData data {make_cigar_reads};
+    check_posteriors_match_pileups(data);
+}
+
+BOOST_AUTO_TEST_CASE(posteriors_match_pileup_posteriors_for_matched_reads)
+{
+    const RefCallTestData data {make_uniform_reads};
+    check_posteriors_match_pileups(data);
+}
+
+BOOST_AUTO_TEST_CASE(uncovered_positions_have_the_default_posterior)
+{
+    const RefCallTestData data {[] (const ReferenceGenome& reference) { return std::vector<AlignedRead> {make_read(reference, 110, "5M")}; }};
+    BOOST_CHECK_EQUAL(data.columns.depth(0), 0);
+    BOOST_CHECK_EQUAL(data.columns.homozygous_reference_posterior(0).score(), 3.0);
+    BOOST_CHECK_EQUAL(data.columns.depth(10), 1);
+}
+
+BOOST_AUTO_TEST_CASE(blocks_match_squashed_reference_calls)
+{
+    for (const auto make_reads : {make_cigar_reads, make_uniform_reads}) {
+        const RefCallTestData data {make_reads};
+        check_blocks_match_squashed_calls(data, {Phred<double> {2}, boost::none, boost::none});
+        check_blocks_match_squashed_calls(data, {Phred<double> {2}, Phred<double> {50}, boost::none});
+        check_blocks_match_squashed_calls(data, {Phred<double> {2}, boost::none, Phred<double> {10}});
+        check_blocks_match_squashed_calls(data, {Phred<double> {10}, Phred<double> {60}, Phred<double> {5}});
+        check_blocks_match_squashed_calls(data, {Phred<double> {0}, Phred<double> {20}, Phred<double> {100}});
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace test
+} // namespace octopus
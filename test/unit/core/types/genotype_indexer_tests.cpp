@@ -0,0 +1,91 @@
+// Copyright (c) 2015-2020 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#include <boost/test/unit_test.hpp>
+
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+
+#include "core/types/genotype_indexer.hpp"
+
+namespace octopus { namespace test {
+
+namespace {
+
+using ElementIndex = GenotypeIndexer::ElementIndex;
+
+// Same enumeration as generate_all_genotypes, with indices sorted ascending
+auto enumerate_all(const unsigned num_elements, const unsigned ploidy)
+{
+    std::vector<std::vector<ElementIndex>> result {};
+    std::vector<unsigned> indices(ploidy, 0);
+    while (true) {
+        if (indices[0] == num_elements) {
+            unsigned i {0};
+            while (++i < ploidy && indices[i] == num_elements - 1);
+            if (i == ploidy) break;
+            ++indices[i];
+            std::fill_n(std::begin(indices), i + 1, indices[i]);
+        }
+        result.emplace_back(std::crbegin(indices), std::crend(indices));
+        ++indices[0];
+    }
+    return result;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(core)
+BOOST_AUTO_TEST_SUITE(genotype_indexer)
+
+BOOST_AUTO_TEST_CASE(ranks_follow_generate_all_genotypes_order)
+{
+    for (unsigned num_elements {1}; num_elements <= 6; ++num_elements) {
+        for (unsigned ploidy {1}; ploidy <= 6; ++ploidy) {
+            const GenotypeIndexer indexer {num_elements, ploidy};
+            const auto genotypes = enumerate_all(num_elements, ploidy);
+            BOOST_REQUIRE_EQUAL(indexer.size(), genotypes.size());
+            std::vector<ElementIndex> indices(ploidy);
+            for (std::size_t rank {0}; rank < genotypes.size(); ++rank) {
+                BOOST_CHECK_EQUAL(indexer.rank(genotypes[rank].data()), rank);
+                indexer.unrank(rank, indices.data());
+                BOOST_CHECK(indices == genotypes[rank]);
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(batch_unranking_stores_genotypes_contiguously)
+{
+    const GenotypeIndexer indexer {5, 4};
+    const auto genotypes = enumerate_all(5, 4);
+    std::vector<ElementIndex> indices {};
+    indexer.unrank(10, 30, indices);
+    BOOST_REQUIRE_EQUAL(indices.size(), 20 * 4);
+    for (std::size_t i {0}; i < 20; ++i) {
+        BOOST_CHECK(std::equal(std::cbegin(genotypes[10 + i]), std::cend(genotypes[10 + i]), std::next(std::cbegin(indices), 4 * i)));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(next_stops_after_the_last_genotype)
+{
+    const GenotypeIndexer indexer {3, 2};
+    std::vector<ElementIndex> indices(2, 0);
+    std::size_t count {1};
+    while (indexer.next(indices.data())) ++count;
+    BOOST_CHECK_EQUAL(count, indexer.size());
+    BOOST_CHECK(indices == std::vector<ElementIndex>(2, 2));
+}
+
+BOOST_AUTO_TEST_CASE(too_many_genotypes_throws)
+{
+    BOOST_CHECK_EQUAL(GenotypeIndexer(200, 6).size(), 95746959700);
+    BOOST_CHECK_THROW(GenotypeIndexer(60000, 12), std::overflow_error);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace test
+} // namespace octopus
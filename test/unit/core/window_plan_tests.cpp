@@ -0,0 +1,87 @@
+// Copyright (c) 2015-2020 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#include <boost/test/unit_test.hpp>
+
+#include <fstream>
+
+#include <boost/filesystem.hpp>
+
+#include "basics/genomic_region.hpp"
+#include "core/window_plan.hpp"
+#include "exceptions/user_error.hpp"
+
+namespace octopus { namespace test {
+
+namespace {
+
+struct TemporaryPlanPath
+{
+    boost::filesystem::path path {boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("%%%%-%%%%.plan")};
+    ~TemporaryPlanPath() { boost::system::error_code ec {}; boost::filesystem::remove(path, ec); }
+};
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(core)
+BOOST_AUTO_TEST_SUITE(window_plan)
+
+BOOST_AUTO_TEST_CASE(window_plans_round_trip_through_files)
+{
+    WindowPlan plan {};
+    plan.add(GenomicRegion {"1", 0, 5'000}, 120);
+    plan.add(GenomicRegion {"1", 5'000, 20'000}, 300);
+    plan.add(GenomicRegion {"X", 100, 200}, 0);
+    TemporaryPlanPath file {};
+    write(plan, file.path);
+    const auto read_plan = read_window_plan(file.path);
+    BOOST_REQUIRE_EQUAL(read_plan.size(), plan.size());
+    BOOST_REQUIRE(read_plan.contigs() == plan.contigs());
+    for (const auto& contig : plan.contigs()) {
+        const auto& expected = plan.windows(contig);
+        const auto& actual = read_plan.windows(contig);
+        BOOST_REQUIRE_EQUAL(actual.size(), expected.size());
+        for (std::size_t i {0}; i < expected.size(); ++i) {
+            BOOST_CHECK_EQUAL(actual[i].region, expected[i].region);
+            BOOST_CHECK_EQUAL(actual[i].num_reads, expected[i].num_reads);
+            BOOST_CHECK_CLOSE(actual[i].cost, expected[i].cost, 1e-3);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(find_window_returns_the_first_window_ending_after_the_region_begins)
+{
+    WindowPlan plan {};
+    plan.add(GenomicRegion {"1", 0, 5'000}, 1);
+    plan.add(GenomicRegion {"1", 5'000, 20'000}, 1);
+    BOOST_CHECK_EQUAL(plan.find_window(GenomicRegion {"1", 0, 100})->region, (GenomicRegion {"1", 0, 5'000}));
+    BOOST_CHECK_EQUAL(plan.find_window(GenomicRegion {"1", 5'000, 6'000})->region, (GenomicRegion {"1", 5'000, 20'000}));
+    BOOST_CHECK(!plan.find_window(GenomicRegion {"1", 20'000, 30'000}));
+    BOOST_CHECK(!plan.find_window(GenomicRegion {"2", 0, 100}));
+}
+
+BOOST_AUTO_TEST_CASE(read_window_plan_rejects_malformed_plans)
+{
+    TemporaryPlanPath file {};
+    {
+        std::ofstream out {file.path.string()};
+        out << "##fileformat=octopus-window-plan-v1\n1\t100\t200\t1\t1\n1\t150\t300\t1\t1\n";
+    }
+    BOOST_CHECK_THROW(read_window_plan(file.path), UserError);
+}
+
+BOOST_AUTO_TEST_CASE(repeat_fraction_counts_bases_in_short_tandem_repeats)
+{
+    BOOST_CHECK_EQUAL(calculate_repeat_fraction("ACGTACGATCGATCAGCTAGCATCGA"), 0.0);
+    BOOST_CHECK_EQUAL(calculate_repeat_fraction("NNNNNNNNNNNNNNNN"), 0.0);
+    BOOST_CHECK_CLOSE(calculate_repeat_fraction("AAAAAAAAAAAAACGTGCA"), 13.0 / 19, 1e-6);
+    BOOST_CHECK_CLOSE(calculate_repeat_fraction("GTCAGCAGCAGCAGTG"), 12.0 / 16, 1e-6);
+    BOOST_CHECK_GT(estimate_calling_cost(GenomicRegion {"1", 0, 100}, 10, 0.5),
+                   estimate_calling_cost(GenomicRegion {"1", 0, 100}, 10, 0.0));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace test
+} // namespace octopus
@@ -0,0 +1,80 @@
+// Copyright (c) 2015-2020 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#include <boost/test/unit_test.hpp>
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <stdexcept>
+
+#include <boost/optional.hpp>
+
+#include "io/variant/vcf_record.hpp"
+
+namespace octopus { namespace test {
+
+namespace {
+
+struct CountingDecoder : public VcfRecord::SampleDataDecoder
+{
+    mutable unsigned num_decodes = 0;
+    boost::optional<std::size_t> sample_index(const VcfRecord::SampleName& sample) const override
+    {
+        if (sample == "A") return std::size_t {0};
+        if (sample == "B") return std::size_t {1};
+        return boost::none;
+    }
+    std::vector<std::vector<VcfRecord::ValueType>> decode(const VcfRecord::KeyType& key) const override
+    {
+        ++num_decodes;
+        return {{key + "A"}, {key + "B"}};
+    }
+};
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(io)
+BOOST_AUTO_TEST_SUITE(vcf_record)
+
+BOOST_AUTO_TEST_CASE(lazy_format_values_are_decoded_on_first_access)
+{
+    auto decoder = std::make_shared<CountingDecoder>();
+    VcfRecord::Builder builder {};
+    builder.set_chrom("1").set_pos(100).set_ref("A").set_alt("C");
+    builder.set_format({"DP", "GQ"});
+    builder.set_format_decoder(decoder, {"DP", "GQ"}, {"A", "B"});
+    const auto record = builder.build_once();
+    BOOST_CHECK_EQUAL(decoder->num_decodes, 0);
+    BOOST_CHECK(record.format_decoder("DP") == decoder.get());
+    BOOST_CHECK_EQUAL(record.get_sample_value("B", "DP").front(), "DPB");
+    BOOST_CHECK_EQUAL(record.get_sample_value("A", "DP").front(), "DPA");
+    BOOST_CHECK_EQUAL(decoder->num_decodes, 1);
+    BOOST_CHECK_THROW(record.get_sample_value("C", "DP"), std::out_of_range);
+}
+
+BOOST_AUTO_TEST_CASE(annotating_a_record_only_decodes_modified_format_keys)
+{
+    auto decoder = std::make_shared<CountingDecoder>();
+    VcfRecord::Builder builder {};
+    builder.set_chrom("1").set_pos(100).set_ref("A").set_alt("C");
+    builder.set_format({"DP", "GQ"});
+    builder.set_format_decoder(decoder, {"DP", "GQ"}, {"A", "B"});
+    const auto record = builder.build_once();
+    VcfRecord::Builder annotator {record};
+    annotator.set_format("A", "GQ", std::string {"0"});
+    const auto annotated = annotator.build_once();
+    BOOST_CHECK_EQUAL(decoder->num_decodes, 1);
+    BOOST_CHECK(annotated.format_decoder("GQ") == nullptr);
+    BOOST_CHECK(annotated.format_decoder("DP") != nullptr);
+    BOOST_CHECK_EQUAL(annotated.get_sample_value("A", "GQ").front(), "0");
+    BOOST_CHECK_EQUAL(annotated.get_sample_value("B", "GQ").front(), "GQB");
+    BOOST_CHECK_EQUAL(annotated.get_sample_value("B", "DP").front(), "DPB");
+    BOOST_CHECK_EQUAL(decoder->num_decodes, 2);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace test
+} // namespace octopus
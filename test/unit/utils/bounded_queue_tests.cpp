@@ -0,0 +1,49 @@
+// Copyright (c) 2015-2020 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#include <boost/test/unit_test.hpp>
+
+#include <thread>
+#include <vector>
+
+#include "utils/bounded_queue.hpp"
+
+namespace octopus { namespace test {
+
+BOOST_AUTO_TEST_SUITE(utils)
+BOOST_AUTO_TEST_SUITE(bounded_queue)
+
+BOOST_AUTO_TEST_CASE(items_are_popped_in_push_order_across_threads)
+{
+    BoundedQueue<int> queue {3};
+    const int num_items {10'000};
+    std::thread producer {[&] () {
+        for (int i {0}; i < num_items; ++i) queue.push(i);
+        queue.close();
+    }};
+    std::vector<int> popped {};
+    while (auto item = queue.pop()) popped.push_back(*item);
+    producer.join();
+    BOOST_REQUIRE_EQUAL(popped.size(), num_items);
+    for (int i {0}; i < num_items; ++i) {
+        BOOST_CHECK_EQUAL(popped[i], i);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(closed_queue_drains_remaining_items_and_rejects_new_ones)
+{
+    BoundedQueue<int> queue {2};
+    BOOST_CHECK(queue.push(1));
+    BOOST_CHECK(queue.push(2));
+    queue.close();
+    BOOST_CHECK(!queue.push(3));
+    BOOST_CHECK_EQUAL(*queue.pop(), 1);
+    BOOST_CHECK_EQUAL(*queue.pop(), 2);
+    BOOST_CHECK(!queue.pop());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace test
+} // namespace octopus
@@ -0,0 +1,82 @@
+// Copyright (c) 2015-2020 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#include <boost/test/unit_test.hpp>
+
+#include <cstdint>
+#include <numeric>
+
+#include "utils/scratch_arena.hpp"
+
+namespace octopus { namespace test {
+
+BOOST_AUTO_TEST_SUITE(utils)
+BOOST_AUTO_TEST_SUITE(scratch_arena)
+
+BOOST_AUTO_TEST_CASE(allocations_are_aligned_and_grow_past_the_block_size)
+{
+    ScratchArena arena {64};
+    const auto p1 = arena.allocate(3, 1);
+    const auto p2 = arena.allocate(8, 8);
+    const auto p3 = arena.allocate(100, 16);
+    BOOST_CHECK(p1 != p2);
+    BOOST_CHECK_EQUAL(reinterpret_cast<std::uintptr_t>(p2) % 8, 0);
+    BOOST_CHECK_EQUAL(reinterpret_cast<std::uintptr_t>(p3) % 16, 0);
+    BOOST_CHECK_GE(arena.capacity(), 164);
+    BOOST_CHECK_GE(arena.bytes_in_use(), 111);
+}
+
+BOOST_AUTO_TEST_CASE(closing_a_scope_rewinds_the_arena_and_keeps_its_blocks)
+{
+    ScratchArena arena {128};
+    arena.allocate(16);
+    const auto bytes_before_scope = arena.bytes_in_use();
+    void* first_in_scope {nullptr};
+    std::size_t capacity {0};
+    {
+        const ScratchArena::Scope scope {arena};
+        first_in_scope = arena.allocate(64);
+        arena.allocate(256);
+        capacity = arena.capacity();
+        BOOST_CHECK_GE(scope.peak_bytes_in_use(), 320);
+    }
+    BOOST_CHECK_EQUAL(arena.bytes_in_use(), bytes_before_scope);
+    {
+        const ScratchArena::Scope scope {arena};
+        BOOST_CHECK_EQUAL(arena.allocate(64), first_in_scope);
+        arena.allocate(256);
+        BOOST_CHECK_EQUAL(arena.capacity(), capacity);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(nested_scopes_report_their_own_peaks)
+{
+    ScratchArena arena {1024};
+    const ScratchArena::Scope outer {arena};
+    arena.allocate(100, 1);
+    {
+        const ScratchArena::Scope inner {arena};
+        arena.allocate(50, 1);
+        BOOST_CHECK_EQUAL(inner.peak_bytes_in_use(), 50);
+    }
+    BOOST_CHECK_EQUAL(outer.peak_bytes_in_use(), 150);
+    arena.allocate(10, 1);
+    BOOST_CHECK_EQUAL(outer.peak_bytes_in_use(), 150);
+}
+
+BOOST_AUTO_TEST_CASE(scratch_vectors_allocate_from_the_arena)
+{
+    ScratchArena arena {};
+    const ScratchArena::Scope scope {arena};
+    ScratchVector<int> values {arena};
+    values.resize(1000);
+    std::iota(std::begin(values), std::end(values), 0);
+    BOOST_CHECK_EQUAL(values.back(), 999);
+    BOOST_CHECK_GE(arena.bytes_in_use(), 1000 * sizeof(int));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace test
+} // namespace octopus
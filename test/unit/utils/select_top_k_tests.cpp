@@ -0,0 +1,59 @@
+// Copyright (c) 2015-2020 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#include <boost/test/unit_test.hpp>
+
+#include <vector>
+#include <random>
+#include <cstddef>
+
+#include "utils/select_top_k.hpp"
+
+namespace octopus { namespace test {
+
+BOOST_AUTO_TEST_SUITE(utils)
+BOOST_AUTO_TEST_SUITE(select_top_k)
+
+BOOST_AUTO_TEST_CASE(select_top_k_indices_with_upper_bounds_matches_exhaustive_selection)
+{
+    std::mt19937 generator {42};
+    std::uniform_real_distribution<double> value_dist {-100.0, 0.0}, slack_dist {0.0, 10.0};
+    const std::size_t n {1000};
+    std::vector<double> values(n), upper_bounds(n);
+    for (std::size_t i {0}; i < n; ++i) {
+        values[i] = value_dist(generator);
+        upper_bounds[i] = values[i] + slack_dist(generator);
+    }
+    for (const std::size_t k : {0, 1, 10, 100, 1000, 2000}) {
+        std::size_t num_evaluated {0};
+        const auto result = select_top_k_indices_with_upper_bounds(upper_bounds, k, [&] (std::size_t i) {
+            ++num_evaluated;
+            return values[i];
+        });
+        const auto expected = select_top_k_indices(values, k);
+        BOOST_CHECK_EQUAL_COLLECTIONS(result.begin(), result.end(), expected.begin(), expected.end());
+        BOOST_CHECK_LE(num_evaluated, n);
+        if (k > 0 && k < 100) {
+            BOOST_CHECK_LT(num_evaluated, n / 2);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(select_top_k_indices_with_upper_bounds_evaluates_everything_when_bounds_are_uninformative)
+{
+    const std::vector<double> values {3, 1, 4, 1, 5, 9, 2, 6}, upper_bounds(values.size(), 10.0);
+    std::size_t num_evaluated {0};
+    const auto result = select_top_k_indices_with_upper_bounds(upper_bounds, 3, [&] (std::size_t i) {
+        ++num_evaluated;
+        return values[i];
+    });
+    BOOST_CHECK_EQUAL(num_evaluated, values.size());
+    const std::vector<Index> expected {5, 7, 4};
+    BOOST_CHECK_EQUAL_COLLECTIONS(result.begin(), result.end(), expected.begin(), expected.end());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace test
+} // namespace octopus
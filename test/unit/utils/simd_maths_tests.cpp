@@ -0,0 +1,173 @@
+// Copyright (c) 2015-2020 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#include <boost/test/unit_test.hpp>
+
+#include <vector>
+#include <random>
+#include <cmath>
+#include <cstddef>
+#include <algorithm>
+#include <numeric>
+#include <limits>
+
+#include <boost/math/special_functions/digamma.hpp>
+
+#include "utils/simd_maths.hpp"
+
+namespace octopus { namespace test {
+
+namespace {
+
+constexpr double relative_tolerance {1e-12};
+
+auto make_uniform_values(const double min, const double max, const std::size_t n)
+{
+    std::mt19937 generator {42};
+    std::uniform_real_distribution<> dist {min, max};
+    std::vector<double> result(n);
+    std::generate(std::begin(result), std::end(result), [&] () { return dist(generator); });
+    return result;
+}
+
+template <typename VectorFunction, typename ScalarFunction>
+void check_agrees_with_scalar(const std::vector<double>& values, VectorFunction vf, ScalarFunction sf, const double tolerance)
+{
+    std::vector<double> result(values.size());
+    vf(values.data(), values.size(), result.data());
+    for (std::size_t i {0}; i < values.size(); ++i) {
+        const auto expected = sf(values[i]);
+        BOOST_REQUIRE_SMALL(std::abs(result[i] - expected), tolerance * std::max(1.0, std::abs(expected)));
+    }
+}
+
+// Repeats the values so every lane of the widest vector sees each of them
+auto make_lane_filling_values(const std::vector<double>& values)
+{
+    std::vector<double> result {};
+    for (std::size_t i {0}; i < 8; ++i) {
+        result.insert(std::end(result), std::cbegin(values), std::cend(values));
+    }
+    return result;
+}
+
+template <typename VectorFunction, typename ScalarFunction>
+void check_special_values_agree_with_scalar(const std::vector<double>& values, VectorFunction vf, ScalarFunction sf)
+{
+    const auto test_values = make_lane_filling_values(values);
+    std::vector<double> result(test_values.size());
+    vf(test_values.data(), test_values.size(), result.data());
+    for (std::size_t i {0}; i < test_values.size(); ++i) {
+        const auto expected = sf(test_values[i]);
+        BOOST_TEST_CONTEXT("x = " << test_values[i]) {
+            if (std::isnan(expected)) {
+                BOOST_CHECK(std::isnan(result[i]));
+            } else if (std::isinf(expected) || expected == 0) {
+                BOOST_CHECK_EQUAL(result[i], expected);
+            } else {
+                BOOST_CHECK_SMALL(std::abs(result[i] - expected), relative_tolerance * std::max(1.0, std::abs(expected)));
+            }
+        }
+    }
+}
+
+constexpr double infinity {std::numeric_limits<double>::infinity()};
+constexpr double nan {std::numeric_limits<double>::quiet_NaN()};
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(utils)
+BOOST_AUTO_TEST_SUITE(simd_maths)
+
+BOOST_AUTO_TEST_CASE(exp_agrees_with_std_exp)
+{
+    // odd size so the scalar tail is exercised
+    const auto values = make_uniform_values(-700, 700, 10'001);
+    check_agrees_with_scalar(values, maths::simd::exp, [] (double x) { return std::exp(x); }, relative_tolerance);
+    std::vector<double> underflow {-1e300, -800.0, -746.0};
+    std::vector<double> result(underflow.size());
+    maths::simd::exp(underflow.data(), underflow.size(), result.data());
+    for (auto x : result) BOOST_CHECK_EQUAL(x, 0.0);
+}
+
+BOOST_AUTO_TEST_CASE(log_agrees_with_std_log)
+{
+    auto values = make_uniform_values(-300, 300, 10'001);
+    for (auto& x : values) x = std::pow(10.0, x);
+    check_agrees_with_scalar(values, maths::simd::log, [] (double x) { return std::log(x); }, relative_tolerance);
+}
+
+BOOST_AUTO_TEST_CASE(exp_handles_special_values)
+{
+    check_special_values_agree_with_scalar({0.0, -0.0, 709.5, 709.78, 710.0, 1e300, infinity, -infinity, nan, -745.0, -745.2},
+                                           maths::simd::exp, [] (double x) { return std::exp(x); });
+}
+
+BOOST_AUTO_TEST_CASE(log_handles_special_values)
+{
+    const auto min_normal = std::numeric_limits<double>::min(), max = std::numeric_limits<double>::max();
+    const auto min_subnormal = std::numeric_limits<double>::denorm_min();
+    check_special_values_agree_with_scalar({0.0, -0.0, -1.0, -infinity, infinity, nan, min_subnormal, 1e-310, min_normal / 3,
+                                            min_normal, max, 1.0},
+                                           maths::simd::log, [] (double x) { return std::log(x); });
+}
+
+BOOST_AUTO_TEST_CASE(log1p_handles_special_values)
+{
+    check_special_values_agree_with_scalar({-1.0, -2.0, infinity, nan, 0.0},
+                                           maths::simd::log1p, [] (double x) { return std::log1p(x); });
+}
+
+BOOST_AUTO_TEST_CASE(log1p_agrees_with_std_log1p)
+{
+    auto values = make_uniform_values(-0.999, 10, 10'001);
+    values.push_back(1e-12);
+    values.push_back(-1e-15);
+    check_agrees_with_scalar(values, maths::simd::log1p, [] (double x) { return std::log1p(x); }, relative_tolerance);
+}
+
+BOOST_AUTO_TEST_CASE(digamma_agrees_with_boost_digamma)
+{
+    auto values = make_uniform_values(1e-3, 500, 10'001);
+    values.push_back(1e-6);
+    check_agrees_with_scalar(values, maths::simd::digamma, [] (double x) { return boost::math::digamma(x); }, 1e-11);
+}
+
+BOOST_AUTO_TEST_CASE(digamma_is_nan_for_non_finite_values_and_poles)
+{
+    const auto lowest = std::numeric_limits<double>::lowest();
+    check_special_values_agree_with_scalar({infinity, -infinity, nan, 0.0, -0.0, -1.0, -2.0, -1e300, lowest},
+                                           maths::simd::digamma, [] (double x) { return nan; });
+}
+
+BOOST_AUTO_TEST_CASE(digamma_agrees_with_boost_digamma_for_negative_non_integers)
+{
+    check_special_values_agree_with_scalar({-0.5, -2.5, -10.25, -1e3 - 0.5, 3.0, 0.25},
+                                           maths::simd::digamma, [] (double x) { return boost::math::digamma(x); });
+}
+
+BOOST_AUTO_TEST_CASE(log_sum_exp_agrees_with_scalar)
+{
+    for (const std::size_t n : {1, 3, 4, 7, 8, 9, 1'000, 1'001}) {
+        const auto values = make_uniform_values(-1'000, 0, n);
+        const auto max = *std::max_element(std::cbegin(values), std::cend(values));
+        const auto expected = max + std::log(std::accumulate(std::cbegin(values), std::cend(values), 0.0,
+                                                             [=] (double curr, double x) { return curr + std::exp(x - max); }));
+        BOOST_CHECK_CLOSE(maths::simd::log_sum_exp(values.data(), values.size()), expected, relative_tolerance);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(normalise_exp_sums_to_one)
+{
+    auto values = make_uniform_values(-50, 0, 1'001);
+    const auto expected_norm = maths::simd::log_sum_exp(values.data(), values.size());
+    const auto norm = maths::simd::normalise_exp(values.data(), values.size());
+    BOOST_CHECK_CLOSE(norm, expected_norm, relative_tolerance);
+    BOOST_CHECK_CLOSE(std::accumulate(std::cbegin(values), std::cend(values), 0.0), 1.0, relative_tolerance);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace test
+} // namespace octopus